@@ -0,0 +1,58 @@
+// ---------------------------------------------------------------------------
+// Shared fixtures for logos_core_bench: the synthetic dependency graph every
+// benchmark runs over, and a loader that never spawns anything.
+//
+// Graphs come from tools/synthetic_graph.h with layers ~sqrt(N) deep and up to
+// three dependencies per module: chains grow with N, fan-out is wide at the
+// low layers and diamonds are everywhere — the shape the resolver and the
+// reverse-edge walks are sensitive to.
+// ---------------------------------------------------------------------------
+#pragma once
+
+#include "module_loader.h"
+#include "module_registry.h"
+#include "synthetic_graph.h"
+
+#include <algorithm>
+#include <cmath>
+#include <string>
+#include <unordered_set>
+
+namespace LogosBench {
+
+inline SyntheticGraph::Graph makeGraph(int modules)
+{
+    SyntheticGraph::Options options;
+    options.seed = 42;
+    options.modules = modules;
+    options.depth = std::max(1, static_cast<int>(std::sqrt(static_cast<double>(modules))));
+    options.minFanIn = 1;
+    options.maxFanIn = 3;
+    return SyntheticGraph::generate(options);
+}
+
+// The deepest module: the last one generated sits in the top layer.
+inline const std::string& topModule(const SyntheticGraph::Graph& g) { return g.names.back(); }
+// A bottom-layer module: the widest dependent closure.
+inline const std::string& rootModule(const SyntheticGraph::Graph& g) { return g.names.front(); }
+
+// Accepts every descriptor and "launches" by recording the name.
+struct BenchModuleLoader : public LogosCore::ModuleLoader {
+    std::string id() const override { return "bench"; }
+    bool canHandle(const LogosCore::ModuleDescriptor&) const override { return true; }
+    bool load(const LogosCore::ModuleDescriptor& desc,
+              std::function<void(const std::string&)>,
+              LogosCore::LoadedModuleHandle& out) override {
+        out.name = desc.name;
+        active.insert(desc.name);
+        return true;
+    }
+    bool sendToken(const std::string&, const std::string&) override { return true; }
+    void terminate(const std::string& name) override { active.erase(name); }
+    void terminateAll() override { active.clear(); }
+    bool hasModule(const std::string& name) const override { return active.count(name) > 0; }
+
+    std::unordered_set<std::string> active;
+};
+
+} // namespace LogosBench
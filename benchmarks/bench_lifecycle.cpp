@@ -0,0 +1,83 @@
+// =============================================================================
+// ModuleManager load/unload overhead with a loader that launches nothing, so
+// what is measured is core's own path: loader selection, token minting,
+// registry updates, restriction refresh, metrics and the unload cascade.
+// =============================================================================
+#include <benchmark/benchmark.h>
+#include "bench_graph.h"
+#include "module_manager.h"
+#include "module_registry.h"
+
+#include <memory>
+
+using namespace LogosBench;
+
+namespace {
+
+// Install the bench loader and an N-module graph into the process-wide
+// ModuleManager. Cheap to repeat for the same N: the registry is rebuilt only
+// when the size changes.
+const SyntheticGraph::Graph& installGraph(int modules)
+{
+    static int installed = -1;
+    static SyntheticGraph::Graph graph;
+    ModuleManager::terminateAll();
+    if (installed != modules) {
+        ModuleManager::clear();
+        ModuleManager::loaders().clearForTests();
+        ModuleManager::loaders().registerLoader(std::make_shared<BenchModuleLoader>());
+        graph = makeGraph(modules);
+        SyntheticGraph::registerInto(ModuleManager::registry(), graph);
+        installed = modules;
+    }
+    return graph;
+}
+
+void graphSizes(benchmark::internal::Benchmark* b)
+{
+    b->RangeMultiplier(10)->Range(10, 10000);
+}
+
+// One module with no dependencies, loaded and unloaded each iteration.
+void BM_LoadUnloadLeaf(benchmark::State& state)
+{
+    const auto& g = installGraph(static_cast<int>(state.range(0)));
+    const char* name = rootModule(g).c_str();
+    for (auto _ : state) {
+        if (!ModuleManager::loadModule(name) || !ModuleManager::unloadModule(name)) {
+            state.SkipWithError("load/unload failed");
+            break;
+        }
+    }
+}
+BENCHMARK(BM_LoadUnloadLeaf)->Apply(graphSizes);
+
+// The deepest module with its whole dependency closure, then a cascade unload
+// from the bottom layer. Reports modules loaded per second.
+void BM_LoadClosureAndCascadeUnload(benchmark::State& state)
+{
+    const auto& g = installGraph(static_cast<int>(state.range(0)));
+    const std::size_t closure = ModuleManager::registry().moduleDependencies(topModule(g), true).size() + 1;
+    for (auto _ : state) {
+        if (!ModuleManager::loadModuleWithDependencies(topModule(g).c_str())) {
+            state.SkipWithError("loadModuleWithDependencies failed");
+            break;
+        }
+        state.PauseTiming();
+        // Everything still loaded is in top's closure; unload from each root
+        // it reached so the next iteration starts clean.
+        const auto loaded = ModuleManager::registry().loadedModuleNames();
+        state.ResumeTiming();
+        for (const auto& name : loaded) {
+            if (ModuleManager::registry().isLoaded(name)
+                && ModuleManager::registry().moduleDependencies(name).empty())
+                ModuleManager::unloadModuleWithDependents(name.c_str());
+        }
+    }
+    state.counters["closure"] = static_cast<double>(closure);
+    state.counters["modules/s"] = benchmark::Counter(
+        static_cast<double>(closure), benchmark::Counter::kIsIterationInvariantRate);
+}
+BENCHMARK(BM_LoadClosureAndCascadeUnload)->Apply(graphSizes)->Unit(benchmark::kMicrosecond);
+
+} // anonymous namespace
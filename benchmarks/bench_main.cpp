@@ -0,0 +1,20 @@
+// logos_core_bench entry point. Same as benchmark_main, except that logging is
+// silenced (every load and unload logs at info) unless LOGOS_LOG_LEVEL asks
+// for it, so the library's output doesn't interleave with the results.
+#include <benchmark/benchmark.h>
+#include <spdlog/spdlog.h>
+
+#include <cstdlib>
+
+int main(int argc, char** argv)
+{
+    if (!std::getenv("LOGOS_LOG_LEVEL"))
+        spdlog::set_level(spdlog::level::off);
+
+    benchmark::Initialize(&argc, argv);
+    if (benchmark::ReportUnrecognizedArguments(argc, argv))
+        return 1;
+    benchmark::RunSpecifiedBenchmarks();
+    benchmark::Shutdown();
+    return 0;
+}
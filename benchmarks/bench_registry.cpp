@@ -0,0 +1,167 @@
+// =============================================================================
+// ModuleRegistry and DependencyResolver over synthetic graphs of 10 to 10,000
+// modules: point queries, transitive walks, reverse-edge rebuilds, the
+// allModulesInfo() serialization, topological resolution, and discovery of
+// the same graphs written out as stub packages.
+// =============================================================================
+#include <benchmark/benchmark.h>
+#include "bench_graph.h"
+#include "dependency_resolver.h"
+#include "module_registry.h"
+
+#include <filesystem>
+#include <map>
+#include <memory>
+#include <unistd.h>
+
+using namespace LogosBench;
+
+namespace {
+
+struct RegisteredGraph {
+    SyntheticGraph::Graph graph;
+    ModuleRegistry registry;
+};
+
+// Each size is built once and shared by every benchmark (and repetition)
+// that asks for it.
+RegisteredGraph& registeredGraph(int modules)
+{
+    static std::map<int, std::unique_ptr<RegisteredGraph>> cache;
+    auto& slot = cache[modules];
+    if (!slot) {
+        slot = std::make_unique<RegisteredGraph>();
+        slot->graph = makeGraph(modules);
+        SyntheticGraph::registerInto(slot->registry, slot->graph);
+    }
+    return *slot;
+}
+
+void graphSizes(benchmark::internal::Benchmark* b)
+{
+    b->RangeMultiplier(10)->Range(10, 10000)->Complexity();
+}
+
+void BM_RegistryIsKnown(benchmark::State& state)
+{
+    auto& g = registeredGraph(static_cast<int>(state.range(0)));
+    std::size_t i = 0;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(g.registry.isKnown(g.graph.names[i]));
+        i = (i + 1) % g.graph.names.size();
+    }
+    state.SetComplexityN(state.range(0));
+}
+BENCHMARK(BM_RegistryIsKnown)->Apply(graphSizes);
+
+void BM_RegistryDependenciesRecursive(benchmark::State& state)
+{
+    auto& g = registeredGraph(static_cast<int>(state.range(0)));
+    for (auto _ : state)
+        benchmark::DoNotOptimize(g.registry.moduleDependencies(topModule(g.graph), /*recursive=*/true));
+    state.SetComplexityN(state.range(0));
+}
+BENCHMARK(BM_RegistryDependenciesRecursive)->Apply(graphSizes);
+
+void BM_RegistryDependentsRecursive(benchmark::State& state)
+{
+    auto& g = registeredGraph(static_cast<int>(state.range(0)));
+    for (auto _ : state)
+        benchmark::DoNotOptimize(g.registry.moduleDependents(rootModule(g.graph), /*recursive=*/true));
+    state.SetComplexityN(state.range(0));
+}
+BENCHMARK(BM_RegistryDependentsRecursive)->Apply(graphSizes);
+
+void BM_RegistryLoadedDependents(benchmark::State& state)
+{
+    auto& g = registeredGraph(static_cast<int>(state.range(0)));
+    for (const auto& name : g.graph.names)
+        g.registry.markLoaded(name);
+    for (auto _ : state)
+        benchmark::DoNotOptimize(g.registry.loadedDependents(rootModule(g.graph)));
+    g.registry.clearLoaded();
+    state.SetComplexityN(state.range(0));
+}
+BENCHMARK(BM_RegistryLoadedDependents)->Apply(graphSizes);
+
+// registerDependencies() rewrites one module's edges and rebuilds every
+// reverse edge (recomputeDependentsLocked), which is what this measures.
+void BM_RegistryRecomputeDependents(benchmark::State& state)
+{
+    auto& g = registeredGraph(static_cast<int>(state.range(0)));
+    const std::size_t last = g.graph.names.size() - 1;
+    for (auto _ : state)
+        g.registry.registerDependencies(g.graph.names[last], g.graph.dependencies[last]);
+    state.SetComplexityN(state.range(0));
+}
+BENCHMARK(BM_RegistryRecomputeDependents)->Apply(graphSizes);
+
+void BM_RegistryAllModulesInfo(benchmark::State& state)
+{
+    auto& g = registeredGraph(static_cast<int>(state.range(0)));
+    for (auto _ : state)
+        benchmark::DoNotOptimize(g.registry.allModulesInfo().dump());
+    state.SetComplexityN(state.range(0));
+}
+BENCHMARK(BM_RegistryAllModulesInfo)->Apply(graphSizes);
+
+void BM_ResolveDeepestModule(benchmark::State& state)
+{
+    auto& g = registeredGraph(static_cast<int>(state.range(0)));
+    auto isKnown = [&](const std::string& n) { return g.registry.isKnown(n); };
+    auto depsOf = [&](const std::string& n) { return g.registry.moduleDependencies(n); };
+    for (auto _ : state)
+        benchmark::DoNotOptimize(DependencyResolver::resolve({topModule(g.graph)}, isKnown, depsOf));
+    state.SetComplexityN(state.range(0));
+}
+BENCHMARK(BM_ResolveDeepestModule)->Apply(graphSizes);
+
+void BM_ResolveEveryModule(benchmark::State& state)
+{
+    auto& g = registeredGraph(static_cast<int>(state.range(0)));
+    auto isKnown = [&](const std::string& n) { return g.registry.isKnown(n); };
+    auto depsOf = [&](const std::string& n) { return g.registry.moduleDependencies(n); };
+    for (auto _ : state)
+        benchmark::DoNotOptimize(DependencyResolver::resolve(g.graph.names, isKnown, depsOf));
+    state.SetComplexityN(state.range(0));
+}
+BENCHMARK(BM_ResolveEveryModule)->Apply(graphSizes);
+
+// Discovery end to end: package scan, metadata extraction from every stub
+// plugin, and the reverse-edge rebuild. Packages are written once per size.
+void BM_DiscoverStubPackages(benchmark::State& state)
+{
+    static std::map<int, std::string> dirs;
+    const int modules = static_cast<int>(state.range(0));
+    auto& dir = dirs[modules];
+    if (dir.empty()) {
+        char tmpl[] = "/tmp/logos_bench_packages_XXXXXX";
+        std::string error;
+        if (!::mkdtemp(tmpl)
+            || !SyntheticGraph::writePackages(makeGraph(modules), tmpl, &error)) {
+            state.SkipWithError(("cannot write packages: " + error).c_str());
+            return;
+        }
+        dir = tmpl;
+        std::atexit([] {
+            std::error_code ec;
+            for (const auto& [n, d] : dirs)
+                std::filesystem::remove_all(d, ec);
+        });
+    }
+
+    std::size_t known = 0;
+    for (auto _ : state) {
+        ModuleRegistry registry;
+        registry.setModulesDir(dir);
+        registry.discoverInstalledModules();
+        known = registry.knownModuleNames().size();
+    }
+    if (known != static_cast<std::size_t>(modules))
+        state.SkipWithError("the metadata reader did not accept every stub plugin");
+}
+// No Complexity() fit here: it would run over no reports when every size was
+// skipped with an error.
+BENCHMARK(BM_DiscoverStubPackages)->RangeMultiplier(10)->Range(10, 10000)->Unit(benchmark::kMillisecond);
+
+} // anonymous namespace
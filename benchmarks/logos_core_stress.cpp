@@ -0,0 +1,353 @@
+// =============================================================================
+// logos_core_stress: concurrent load / cascade-unload / query churn through the
+// C API, reporting throughput and per-call latency percentiles.
+//
+//   logos_core_stress [--threads N] [--ops N] [--modules N] [--depth N]
+//                     [--seed N] [--mix LOAD:UNLOAD:QUERY] [--load-us N]
+//                     [--modules-dir DIR] [--json PATH]
+//
+// Each of --threads workers issues --ops calls, picking a random module and a
+// random operation by the --mix weights: logos_core_load_module(name, true),
+// logos_core_unload_module(name, true), or one of the read-only queries
+// (loaded modules, dependencies, dependents). By default the modules are a
+// SyntheticGraph served by a loader that launches nothing; --load-us makes
+// each load sleep that long, standing in for a process start. With
+// --modules-dir the modules installed there are discovered and loaded with
+// the default subprocess loader instead.
+//
+// Afterwards every loaded module must have its dependencies loaded, and in
+// fake-loader mode the loader's running set must equal the registry's loaded
+// set; a violation is reported and the exit status is 1. Build with
+// -DLOGOS_SANITIZE_THREAD=ON to run the same churn under ThreadSanitizer.
+// =============================================================================
+#include "logos_core.h"
+#include "module_manager.h"
+#include "module_registry.h"
+#include "module_loader.h"
+#include "module_loader_registry.h"
+#include "synthetic_graph.h"
+
+#include <nlohmann/json.hpp>
+#include <spdlog/spdlog.h>
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <random>
+#include <string>
+#include <thread>
+#include <unordered_set>
+#include <vector>
+
+namespace {
+
+enum Op : std::size_t { Load, Unload, QueryLoaded, QueryDependencies, QueryDependents, OpCount };
+
+const char* const kOpNames[OpCount] = {
+    "load_module", "unload_module", "get_loaded_modules",
+    "get_module_dependencies", "get_module_dependents",
+};
+
+// Stands in for a container: remembers what is "running", nothing else.
+// Locked because queries may reach hasModule() outside the load lock.
+class ChurnModuleLoader : public LogosCore::ModuleLoader {
+public:
+    explicit ChurnModuleLoader(int loadUs) : m_loadUs(loadUs) {}
+
+    std::string id() const override { return "stress"; }
+    bool canHandle(const LogosCore::ModuleDescriptor&) const override { return true; }
+    bool load(const LogosCore::ModuleDescriptor& desc,
+              std::function<void(const std::string&)>,
+              LogosCore::LoadedModuleHandle& out) override {
+        if (m_loadUs > 0)
+            std::this_thread::sleep_for(std::chrono::microseconds(m_loadUs));
+        out.name = desc.name;
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_running.insert(desc.name);
+        return true;
+    }
+    bool sendToken(const std::string&, const std::string&) override { return true; }
+    void terminate(const std::string& name) override {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_running.erase(name);
+    }
+    void terminateAll() override {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_running.clear();
+    }
+    bool hasModule(const std::string& name) const override {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_running.count(name) > 0;
+    }
+    std::unordered_set<std::string> running() const {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_running;
+    }
+
+private:
+    const int m_loadUs;
+    mutable std::mutex m_mutex;
+    std::unordered_set<std::string> m_running;
+};
+
+struct Config {
+    int threads = 8;
+    int ops = 10000;                 // per thread
+    int modules = 200;
+    int depth = 0;                   // 0 = sqrt(modules)
+    uint32_t seed = 1;
+    std::array<int, 3> mix{40, 20, 40};   // load : unload : query
+    int loadUs = 0;
+    std::string modulesDir;
+    std::string jsonPath;
+};
+
+// Samples one thread took, per operation, in nanoseconds.
+struct ThreadSamples {
+    std::array<std::vector<uint64_t>, OpCount> ns;
+    std::array<uint64_t, OpCount> failed{};
+};
+
+void freeNames(char** names)
+{
+    if (!names)
+        return;
+    for (char** p = names; *p; ++p)
+        delete[] *p;
+    delete[] names;
+}
+
+// Returns false when the call reported failure. An unload of a module that is
+// not loaded counts as a failure too; the mix keeps those common on purpose.
+bool runOp(Op op, const char* name)
+{
+    switch (op) {
+    case Load:
+        return logos_core_load_module(name, true) == 1;
+    case Unload:
+        return logos_core_unload_module(name, true) == 1;
+    case QueryLoaded:
+        freeNames(logos_core_get_loaded_modules());
+        return true;
+    case QueryDependencies:
+        freeNames(logos_core_get_module_dependencies(name, true));
+        return true;
+    case QueryDependents:
+        freeNames(logos_core_get_module_dependents(name, true));
+        return true;
+    default:
+        return false;
+    }
+}
+
+void worker(const Config& config, const std::vector<std::string>& names, int index,
+            ThreadSamples& out)
+{
+    std::mt19937 rng(config.seed + static_cast<uint32_t>(index) * 7919u);
+    std::uniform_int_distribution<std::size_t> pickModule(0, names.size() - 1);
+    std::discrete_distribution<int> pickKind(config.mix.begin(), config.mix.end());
+    std::uniform_int_distribution<int> pickQuery(QueryLoaded, QueryDependents);
+    for (auto& v : out.ns)
+        v.reserve(static_cast<std::size_t>(config.ops) / 2);
+
+    for (int i = 0; i < config.ops; ++i) {
+        const int kind = pickKind(rng);
+        const Op op = kind == 0 ? Load : kind == 1 ? Unload : static_cast<Op>(pickQuery(rng));
+        const char* name = names[pickModule(rng)].c_str();
+        const auto start = std::chrono::steady_clock::now();
+        const bool ok = runOp(op, name);
+        const auto elapsed = std::chrono::steady_clock::now() - start;
+        out.ns[op].push_back(static_cast<uint64_t>(
+            std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count()));
+        if (!ok)
+            ++out.failed[op];
+    }
+}
+
+// Nearest-rank quantile of sorted samples.
+uint64_t quantile(const std::vector<uint64_t>& sorted, double q)
+{
+    if (sorted.empty())
+        return 0;
+    const auto rank = static_cast<std::size_t>(std::ceil(q * static_cast<double>(sorted.size())));
+    return sorted[std::min(sorted.size(), std::max<std::size_t>(rank, 1)) - 1];
+}
+
+// Loaded modules whose dependencies are not all loaded, and (fake mode) any
+// disagreement between the loader and the registry.
+std::vector<std::string> consistencyErrors(const ChurnModuleLoader* loader)
+{
+    std::vector<std::string> errors;
+    ModuleRegistry& registry = ModuleManager::registry();
+    const auto loaded = registry.loadedModuleNames();
+    for (const auto& name : loaded) {
+        for (const auto& dep : registry.moduleDependencies(name)) {
+            if (!registry.isLoaded(dep))
+                errors.push_back(name + " is loaded but its dependency " + dep + " is not");
+        }
+    }
+    if (loader) {
+        const auto running = loader->running();
+        for (const auto& name : loaded) {
+            if (!running.count(name))
+                errors.push_back(name + " is loaded but not running");
+        }
+        for (const auto& name : running) {
+            if (!registry.isLoaded(name))
+                errors.push_back(name + " is running but not loaded");
+        }
+    }
+    return errors;
+}
+
+bool parseMix(const char* text, std::array<int, 3>& mix)
+{
+    std::array<int, 3> parsed{};
+    if (std::sscanf(text, "%d:%d:%d", &parsed[0], &parsed[1], &parsed[2]) != 3)
+        return false;
+    if (parsed[0] < 0 || parsed[1] < 0 || parsed[2] < 0 || parsed[0] + parsed[1] + parsed[2] == 0)
+        return false;
+    mix = parsed;
+    return true;
+}
+
+bool parseArgs(int argc, char** argv, Config& config)
+{
+    for (int i = 1; i < argc; ++i) {
+        const char* arg = argv[i];
+        const char* value = i + 1 < argc ? argv[i + 1] : nullptr;
+        if (!value)
+            return false;
+        if (std::strcmp(arg, "--threads") == 0)
+            config.threads = std::atoi(value);
+        else if (std::strcmp(arg, "--ops") == 0)
+            config.ops = std::atoi(value);
+        else if (std::strcmp(arg, "--modules") == 0)
+            config.modules = std::atoi(value);
+        else if (std::strcmp(arg, "--depth") == 0)
+            config.depth = std::atoi(value);
+        else if (std::strcmp(arg, "--seed") == 0)
+            config.seed = static_cast<uint32_t>(std::strtoul(value, nullptr, 10));
+        else if (std::strcmp(arg, "--mix") == 0) {
+            if (!parseMix(value, config.mix))
+                return false;
+        } else if (std::strcmp(arg, "--load-us") == 0)
+            config.loadUs = std::atoi(value);
+        else if (std::strcmp(arg, "--modules-dir") == 0)
+            config.modulesDir = value;
+        else if (std::strcmp(arg, "--json") == 0)
+            config.jsonPath = value;
+        else
+            return false;
+        ++i;
+    }
+    return config.threads > 0 && config.ops > 0 && config.modules > 0 && config.loadUs >= 0;
+}
+
+} // anonymous namespace
+
+int main(int argc, char** argv)
+{
+    Config config;
+    if (!parseArgs(argc, argv, config)) {
+        std::cerr << "usage: logos_core_stress [--threads N] [--ops N] [--modules N] [--depth N]\n"
+                     "                         [--seed N] [--mix LOAD:UNLOAD:QUERY] [--load-us N]\n"
+                     "                         [--modules-dir DIR] [--json PATH]\n";
+        return 2;
+    }
+    if (!std::getenv("LOGOS_LOG_LEVEL"))
+        spdlog::set_level(spdlog::level::off);
+
+    std::shared_ptr<ChurnModuleLoader> loader;
+    std::vector<std::string> names;
+    if (config.modulesDir.empty()) {
+        loader = std::make_shared<ChurnModuleLoader>(config.loadUs);
+        ModuleManager::loaders().clearForTests();
+        ModuleManager::loaders().registerLoader(loader);
+        SyntheticGraph::Options options;
+        options.seed = config.seed;
+        options.modules = config.modules;
+        options.depth = config.depth > 0
+            ? config.depth
+            : std::max(1, static_cast<int>(std::lround(std::sqrt(config.modules))));
+        const auto graph = SyntheticGraph::generate(options);
+        SyntheticGraph::registerInto(ModuleManager::registry(), graph);
+        names = graph.names;
+    } else {
+        logos_core_add_modules_dir(config.modulesDir.c_str());
+        ModuleManager::registry().discoverInstalledModules();
+        names = ModuleManager::registry().knownModuleNames();
+        if (names.empty()) {
+            std::cerr << "no modules found in " << config.modulesDir << '\n';
+            return 1;
+        }
+    }
+
+    std::vector<ThreadSamples> samples(static_cast<std::size_t>(config.threads));
+    std::vector<std::thread> threads;
+    const auto start = std::chrono::steady_clock::now();
+    for (int t = 0; t < config.threads; ++t)
+        threads.emplace_back(worker, std::cref(config), std::cref(names), t, std::ref(samples[t]));
+    for (auto& t : threads)
+        t.join();
+    const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    const auto errors = consistencyErrors(loader.get());
+    ModuleManager::terminateAll();
+
+    nlohmann::json report = {
+        {"threads", config.threads},
+        {"modules", names.size()},
+        {"loader", loader ? "fake" : "subprocess"},
+        {"seconds", seconds},
+        {"operations", nlohmann::json::object()},
+        {"consistency_errors", errors},
+    };
+    uint64_t total = 0;
+    std::printf("%-24s %10s %8s %12s %10s %10s %10s\n",
+                "operation", "calls", "failed", "calls/s", "p50 us", "p99 us", "p999 us");
+    for (std::size_t op = 0; op < OpCount; ++op) {
+        std::vector<uint64_t> all;
+        uint64_t failed = 0;
+        for (const auto& s : samples) {
+            all.insert(all.end(), s.ns[op].begin(), s.ns[op].end());
+            failed += s.failed[op];
+        }
+        std::sort(all.begin(), all.end());
+        total += all.size();
+        const double p50 = quantile(all, 0.50) / 1000.0;
+        const double p99 = quantile(all, 0.99) / 1000.0;
+        const double p999 = quantile(all, 0.999) / 1000.0;
+        const double rate = static_cast<double>(all.size()) / seconds;
+        std::printf("%-24s %10zu %8llu %12.0f %10.1f %10.1f %10.1f\n", kOpNames[op], all.size(),
+                    static_cast<unsigned long long>(failed), rate, p50, p99, p999);
+        report["operations"][kOpNames[op]] = {
+            {"calls", all.size()}, {"failed", failed}, {"calls_per_second", rate},
+            {"p50_us", p50}, {"p99_us", p99}, {"p999_us", p999},
+        };
+    }
+    report["calls_per_second"] = static_cast<double>(total) / seconds;
+    std::printf("%-24s %10llu %8s %12.0f   (%d threads, %.2f s)\n", "total",
+                static_cast<unsigned long long>(total), "", static_cast<double>(total) / seconds,
+                config.threads, seconds);
+
+    if (!config.jsonPath.empty()) {
+        std::ofstream out(config.jsonPath);
+        out << report.dump(2) << '\n';
+        if (!out) {
+            std::cerr << "cannot write " << config.jsonPath << '\n';
+            return 1;
+        }
+    }
+    for (const auto& e : errors)
+        std::cerr << "inconsistent: " << e << '\n';
+    return errors.empty() ? 0 : 1;
+}
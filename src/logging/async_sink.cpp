@@ -0,0 +1,239 @@
+#include "async_sink.h"
+
+#include <chrono>
+#include <string>
+
+namespace logos {
+namespace {
+
+// Idle flusher wake-up backstop; producers normally wake it directly.
+constexpr auto kIdlePoll = std::chrono::milliseconds(100);
+
+std::size_t roundUpPow2(std::size_t n) {
+    std::size_t cap = 2;
+    while (cap < n && cap < (std::size_t{1} << 24))
+        cap <<= 1;
+    return cap;
+}
+
+} // namespace
+
+AsyncSink::AsyncSink(std::shared_ptr<spdlog::sinks::sink> inner)
+    : m_inner(std::move(inner)) {}
+
+AsyncSink::~AsyncSink() {
+    stop();
+}
+
+bool AsyncSink::start(std::size_t capacity, OverflowPolicy overflow,
+                      spdlog::level::level_enum flushLevel) {
+    std::lock_guard lifecycle(m_lifecycleMutex);
+    if (m_running.load())
+        return false;
+
+    // Positions keep counting across restarts so flush() tickets stay
+    // monotonic; re-seed each slot for the lap starting at the current tail.
+    const std::size_t cap = roundUpPow2(capacity);
+    const std::size_t base = m_tail.load();
+    m_slots.reset(new Slot[cap]);
+    m_mask = cap - 1;
+    for (std::size_t i = 0; i < cap; ++i)
+        m_slots[(base + i) & m_mask].seq.store(base + i, std::memory_order_relaxed);
+
+    m_overflow = overflow;
+    m_flushLevel = flushLevel;
+    m_dropped.store(0);
+    m_droppedReported = 0;
+    m_stopping.store(false);
+    m_flusherDone.store(false);
+    m_running.store(true);
+    m_thread = std::thread(&AsyncSink::run, this);
+    return true;
+}
+
+void AsyncSink::stop() {
+    std::lock_guard lifecycle(m_lifecycleMutex);
+    if (!m_running.load())
+        return;
+
+    // New messages now bypass the queue. Let producers that already chose the
+    // queue finish pushing (a blocked one needs the flusher still running),
+    // then have the flusher write out the rest and exit.
+    m_running.store(false);
+    while (m_inflight.load() != 0)
+        std::this_thread::yield();
+    m_stopping.store(true);
+    {
+        std::lock_guard lk(m_wakeMutex);
+        m_wake.notify_one();
+    }
+    m_thread.join();
+    m_inner->flush();
+}
+
+// ── Queue (Vyukov bounded MPMC) ─────────────────────────────────────────────
+
+bool AsyncSink::tryPush(const spdlog::details::log_msg& msg, std::size_t& pos) {
+    pos = m_tail.load(std::memory_order_relaxed);
+    for (;;) {
+        Slot& slot = m_slots[pos & m_mask];
+        const std::size_t seq = slot.seq.load(std::memory_order_acquire);
+        const auto diff = static_cast<std::intptr_t>(seq) - static_cast<std::intptr_t>(pos);
+        if (diff == 0) {
+            if (m_tail.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+                break;
+        } else if (diff < 0) {
+            return false;   // full
+        } else {
+            pos = m_tail.load(std::memory_order_relaxed);
+        }
+    }
+    Slot& slot = m_slots[pos & m_mask];
+    slot.msg = spdlog::details::log_msg_buffer(msg);
+    slot.seq.store(pos + 1, std::memory_order_release);
+    return true;
+}
+
+bool AsyncSink::tryPop(spdlog::details::log_msg_buffer* out, std::size_t& pos) {
+    pos = m_head.load(std::memory_order_relaxed);
+    for (;;) {
+        Slot& slot = m_slots[pos & m_mask];
+        const std::size_t seq = slot.seq.load(std::memory_order_acquire);
+        const auto diff = static_cast<std::intptr_t>(seq) - static_cast<std::intptr_t>(pos + 1);
+        if (diff == 0) {
+            if (m_head.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+                break;
+        } else if (diff < 0) {
+            return false;   // empty, or the next slot is still being filled
+        } else {
+            pos = m_head.load(std::memory_order_relaxed);
+        }
+    }
+    Slot& slot = m_slots[pos & m_mask];
+    if (out)
+        *out = slot.msg;   // copy out so the slot frees up before the (slow) write
+    slot.seq.store(pos + m_mask + 1, std::memory_order_release);
+    return true;
+}
+
+// ── Producer side ───────────────────────────────────────────────────────────
+
+void AsyncSink::log(const spdlog::details::log_msg& msg) {
+    m_inflight.fetch_add(1);
+    if (!m_running.load()) {
+        m_inflight.fetch_sub(1);
+        m_inner->log(msg);
+        return;
+    }
+
+    std::size_t pos = 0;
+    bool queued = false;
+    while (!(queued = tryPush(msg, pos))) {
+        if (m_overflow == OverflowPolicy::DiscardNew) {
+            m_dropped.fetch_add(1, std::memory_order_relaxed);
+            break;
+        }
+        if (m_overflow == OverflowPolicy::OverrunOldest && tryPop(nullptr, pos)) {
+            m_dropped.fetch_add(1, std::memory_order_relaxed);
+            continue;
+        }
+        // Block (or an overrun that lost the race for the oldest slot):
+        // nudge the flusher and retry.
+        wakeFlusher();
+        std::this_thread::yield();
+    }
+    if (queued)
+        wakeFlusher();
+    m_inflight.fetch_sub(1);
+
+    if (queued && msg.level >= m_flushLevel)
+        waitWritten(pos + 1);
+}
+
+void AsyncSink::flush() {
+    if (!m_running.load()) {
+        m_inner->flush();
+        return;
+    }
+    wakeFlusher();
+    waitWritten(m_tail.load());
+    m_inner->flush();
+}
+
+void AsyncSink::set_pattern(const std::string& pattern) {
+    m_inner->set_pattern(pattern);
+}
+
+void AsyncSink::set_formatter(std::unique_ptr<spdlog::formatter> formatter) {
+    m_inner->set_formatter(std::move(formatter));
+}
+
+void AsyncSink::wakeFlusher() {
+    // Pairs with the fence in run(): either we see the flusher idle, or it
+    // sees our push before it sleeps.
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (m_flusherIdle.load(std::memory_order_relaxed)) {
+        std::lock_guard lk(m_wakeMutex);
+        m_wake.notify_one();
+    }
+}
+
+void AsyncSink::waitWritten(uint64_t target) {
+    std::unique_lock lk(m_writtenMutex);
+    m_waiters.fetch_add(1);
+    m_writtenCv.wait(lk, [&] {
+        return m_writtenPos.load() >= target || m_flusherDone.load();
+    });
+    m_waiters.fetch_sub(1);
+}
+
+// ── Flusher ─────────────────────────────────────────────────────────────────
+
+void AsyncSink::reportDrops() {
+    const uint64_t dropped = m_dropped.load(std::memory_order_relaxed);
+    if (dropped == m_droppedReported)
+        return;
+    const std::string text = std::to_string(dropped - m_droppedReported)
+                           + " log message(s) dropped: async queue full";
+    m_droppedReported = dropped;
+    m_inner->log(spdlog::details::log_msg("logging", spdlog::level::warn, text));
+}
+
+void AsyncSink::run() {
+    spdlog::details::log_msg_buffer msg;
+    for (;;) {
+        std::size_t pos = 0;
+        if (tryPop(&msg, pos)) {
+            m_inner->log(msg);
+            // Overrun discards can leave gaps; positions below ours are gone
+            // either way, so the high-water mark is what flush() waits on.
+            m_writtenPos.store(pos + 1);
+            if (m_waiters.load() != 0) {
+                std::lock_guard lk(m_writtenMutex);
+                m_writtenCv.notify_all();
+            }
+            continue;
+        }
+
+        reportDrops();
+        m_inner->flush();
+        if (m_stopping.load() && m_head.load() == m_tail.load())
+            break;
+
+        std::unique_lock lk(m_wakeMutex);
+        m_flusherIdle.store(true, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        m_wake.wait_for(lk, kIdlePoll, [&] {
+            return m_stopping.load() || m_head.load() != m_tail.load();
+        });
+        m_flusherIdle.store(false, std::memory_order_relaxed);
+    }
+
+    {
+        std::lock_guard lk(m_writtenMutex);
+        m_flusherDone.store(true);
+    }
+    m_writtenCv.notify_all();
+}
+
+} // namespace logos
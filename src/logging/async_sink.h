@@ -0,0 +1,115 @@
+#ifndef LOGOS_LOGGING_ASYNC_SINK_H
+#define LOGOS_LOGGING_ASYNC_SINK_H
+
+#include <spdlog/details/log_msg_buffer.h>
+#include <spdlog/sinks/sink.h>
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+namespace logos {
+
+// What a producer does when the async queue is full.
+enum class OverflowPolicy {
+    Block,         // wait for the flusher to make room; nothing is lost
+    DiscardNew,    // drop the incoming message
+    OverrunOldest, // drop the oldest queued message to make room
+};
+
+// Sink that hands messages to a background flusher instead of writing them on
+// the caller's thread.
+//
+// Wraps the real sink. Until start() (and again after stop()) it is a plain
+// pass-through, so loggers can hold it from the moment they are created and
+// async mode can be switched on later without re-plumbing them.
+//
+// While running, log() copies the message into a bounded lock-free MPMC ring
+// (no mutex on the producer path) and the flusher formats and writes it to the
+// wrapped sink. Messages at or above the flush level are still queued, but
+// log() then waits until the flusher has written them — a critical line
+// logged right before abort() reaches stderr. Per-thread order is preserved;
+// lines from different threads are written in the order they were queued.
+//
+// Levels are filtered by the loggers before a message gets here, so
+// LOGOS_LOG_LEVEL behaves the same in both modes.
+class AsyncSink final : public spdlog::sinks::sink {
+public:
+    explicit AsyncSink(std::shared_ptr<spdlog::sinks::sink> inner);
+    ~AsyncSink() override;
+
+    AsyncSink(const AsyncSink&) = delete;
+    AsyncSink& operator=(const AsyncSink&) = delete;
+
+    // Start the flusher with a queue of `capacity` messages (rounded up to a
+    // power of two, minimum 2). Returns false if already running.
+    bool start(std::size_t capacity, OverflowPolicy overflow,
+               spdlog::level::level_enum flushLevel = spdlog::level::err);
+
+    // Write out everything queued, join the flusher and revert to
+    // pass-through. No-op when not running.
+    void stop();
+
+    bool running() const { return m_running.load(std::memory_order_acquire); }
+
+    // Messages lost to DiscardNew / OverrunOldest since start().
+    uint64_t droppedMessages() const { return m_dropped.load(std::memory_order_relaxed); }
+
+    // sink interface
+    void log(const spdlog::details::log_msg& msg) override;
+    void flush() override;   // waits until everything queued so far is written
+    void set_pattern(const std::string& pattern) override;
+    void set_formatter(std::unique_ptr<spdlog::formatter> formatter) override;
+
+private:
+    struct Slot {
+        std::atomic<std::size_t> seq{0};
+        spdlog::details::log_msg_buffer msg;
+    };
+
+    bool tryPush(const spdlog::details::log_msg& msg, std::size_t& pos);
+    // Pop the oldest message into `out` (or discard it when null).
+    bool tryPop(spdlog::details::log_msg_buffer* out, std::size_t& pos);
+    void wakeFlusher();
+    void waitWritten(uint64_t target);
+    void reportDrops();
+    void run();
+
+    std::shared_ptr<spdlog::sinks::sink> m_inner;
+
+    std::unique_ptr<Slot[]> m_slots;
+    std::size_t m_mask = 0;
+    alignas(64) std::atomic<std::size_t> m_tail{0};
+    alignas(64) std::atomic<std::size_t> m_head{0};
+    alignas(64) std::atomic<int> m_inflight{0};   // producers between the running check and their push
+
+    // flush() and flush-level messages wait for the flusher to write past a
+    // queue position.
+    alignas(64) std::atomic<uint64_t> m_writtenPos{0};
+    std::atomic<int> m_waiters{0};
+    std::mutex m_writtenMutex;
+    std::condition_variable m_writtenCv;
+
+    std::atomic<uint64_t> m_dropped{0};
+    uint64_t m_droppedReported = 0;   // flusher only
+
+    OverflowPolicy m_overflow = OverflowPolicy::Block;
+    spdlog::level::level_enum m_flushLevel = spdlog::level::err;
+
+    std::atomic<bool> m_running{false};
+    std::atomic<bool> m_stopping{false};
+    std::atomic<bool> m_flusherDone{false};
+    std::atomic<bool> m_flusherIdle{false};
+    std::mutex m_wakeMutex;
+    std::condition_variable m_wake;
+    std::mutex m_lifecycleMutex;
+    std::thread m_thread;
+};
+
+} // namespace logos
+
+#endif // LOGOS_LOGGING_ASYNC_SINK_H
@@ -4,8 +4,10 @@
 #include <spdlog/sinks/stdout_color_sinks.h>
 
 #include <cstdlib>
+#include <cstring>
 #include <memory>
 #include <mutex>
+#include <string>
 
 namespace logos {
 namespace {
@@ -18,18 +20,53 @@ constexpr const char* kPattern = "[%Y-%m-%d %H:%M:%S.%e] [%^%l%$] [%n] %v";
 
 // One shared stderr colour sink behind every channel. A single sink means one
 // mutex serialising writes (no interleaved lines) and exactly one place
-// writing to stderr.
-std::shared_ptr<spdlog::sinks::sink>& sharedSink() {
-    static std::shared_ptr<spdlog::sinks::sink> sink =
-        std::make_shared<spdlog::sinks::stderr_color_sink_mt>();
+// writing to stderr. It sits behind an AsyncSink, which passes straight
+// through until async mode is started — every logger holds the same wrapper
+// whichever mode is in effect.
+std::shared_ptr<AsyncSink>& sharedSink() {
+    static std::shared_ptr<AsyncSink> sink = std::make_shared<AsyncSink>(
+        std::make_shared<spdlog::sinks::stderr_color_sink_mt>());
     return sink;
 }
 
 } // namespace
 
+LoggingOptions loggingOptionsFromEnvironment() {
+    LoggingOptions options;
+    const char* mode = std::getenv("LOGOS_LOG_ASYNC");
+    if (mode == nullptr || *mode == '\0' || std::strcmp(mode, "0") == 0
+        || std::strcmp(mode, "off") == 0)
+        return options;
+
+    if (std::strcmp(mode, "1") == 0 || std::strcmp(mode, "on") == 0
+        || std::strcmp(mode, "block") == 0) {
+        options.overflow = OverflowPolicy::Block;
+    } else if (std::strcmp(mode, "drop") == 0) {
+        options.overflow = OverflowPolicy::DiscardNew;
+    } else if (std::strcmp(mode, "overrun") == 0) {
+        options.overflow = OverflowPolicy::OverrunOldest;
+    } else {
+        // Not logged: this runs before the logging it would configure.
+        return options;
+    }
+    options.async = true;
+
+    if (const char* size = std::getenv("LOGOS_LOG_QUEUE_SIZE")) {
+        char* end = nullptr;
+        const unsigned long long n = std::strtoull(size, &end, 10);
+        if (end != size && *end == '\0' && n > 0)
+            options.queueSize = static_cast<std::size_t>(n);
+    }
+    return options;
+}
+
 void initLogging() {
+    initLogging(loggingOptionsFromEnvironment());
+}
+
+void initLogging(const LoggingOptions& options) {
     static std::once_flag once;
-    std::call_once(once, []() {
+    std::call_once(once, [&options]() {
         // Default logger ("logos") on the shared sink, so the existing
         // spdlog::info/warn/... free-function call sites share the same stream.
         spdlog::set_default_logger(
@@ -47,9 +84,27 @@ void initLogging() {
                                  ? "LOGOS_LOG_LEVEL"
                                  : "SPDLOG_LEVEL";
         spdlog::cfg::load_env_levels(lvlVar);
+
+        // Last, so nothing above races the flusher. atexit() handlers run
+        // before the sink's static is destroyed, so queued lines are written
+        // on a normal exit even without shutdownLogging().
+        if (options.async && sharedSink()->start(options.queueSize, options.overflow))
+            std::atexit(&shutdownLogging);
     });
 }
 
+void flushLogging() {
+    sharedSink()->flush();
+}
+
+void shutdownLogging() {
+    sharedSink()->stop();
+}
+
+uint64_t droppedLogMessages() {
+    return sharedSink()->droppedMessages();
+}
+
 spdlog::logger& logger(const char* channel) {
     if (auto existing = spdlog::get(channel))
         return *existing;
@@ -1,8 +1,13 @@
 #ifndef LOGOS_LOGGING_LOG_H
 #define LOGOS_LOGGING_LOG_H
 
+#include "async_sink.h"
+
 #include <spdlog/spdlog.h>
 
+#include <cstddef>
+#include <cstdint>
+
 // Standalone logging foundation for liblogos.
 //
 // Deliberately independent of every other subsystem — it depends only on
@@ -17,13 +22,41 @@
 // Runtime level control via LOGOS_LOG_LEVEL (falling back to SPDLOG_LEVEL):
 //   LOGOS_LOG_LEVEL=debug                    # everything at debug
 //   LOGOS_LOG_LEVEL="info,subprocess=warn"   # per-channel overrides
+//
+// Optional asynchronous output via LOGOS_LOG_ASYNC (see AsyncSink): callers
+// enqueue, a background thread formats and writes to stderr.
+//   LOGOS_LOG_ASYNC=1 | block     # full queue: wait for room (lossless)
+//   LOGOS_LOG_ASYNC=drop          # full queue: drop the new message
+//   LOGOS_LOG_ASYNC=overrun       # full queue: drop the oldest message
+//   LOGOS_LOG_QUEUE_SIZE=8192     # queue capacity in messages
 namespace logos {
 
+struct LoggingOptions {
+    bool async = false;
+    std::size_t queueSize = 8192;
+    OverflowPolicy overflow = OverflowPolicy::Block;
+};
+
+// Options from LOGOS_LOG_ASYNC / LOGOS_LOG_QUEUE_SIZE (synchronous when unset).
+LoggingOptions loggingOptionsFromEnvironment();
+
 // Initialise process-wide logging: a shared stderr colour sink, a uniform
-// pattern, the shared default logger, and env-var level control. Idempotent
-// and thread-safe — only the first call has any effect. Call once early, e.g.
-// from logos_core_start().
+// pattern, the shared default logger, env-var level control and, if asked
+// for, the async flusher. Idempotent and thread-safe — only the first call
+// has any effect. Call once early, e.g. from logos_core_start().
 void initLogging();
+void initLogging(const LoggingOptions& options);
+
+// Block until every line logged so far has been written. Cheap no-op in
+// synchronous mode.
+void flushLogging();
+
+// Write out anything queued, stop the flusher and return to synchronous
+// output. Registered with atexit() when async mode starts.
+void shutdownLogging();
+
+// Lines lost to a full queue under the drop / overrun policies.
+uint64_t droppedLogMessages();
 
 // Return the logger for the named channel, creating it (backed by the shared
 // sink, with the uniform pattern and env-configured level) on first use.
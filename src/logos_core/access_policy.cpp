@@ -49,4 +49,13 @@ std::optional<AccessPolicy> parseAccessPolicy(const std::string& json)
     return policy;
 }
 
+CompiledAccessPolicy compileAccessPolicy(const AccessPolicy& policy)
+{
+    CompiledAccessPolicy compiled;
+    compiled.explicitCallers.reserve(policy.restrictions.size());
+    for (const auto& r : policy.restrictions)
+        compiled.explicitCallers.emplace(r.target, r.allowedCallers);
+    return compiled;
+}
+
 } // namespace LogosCore
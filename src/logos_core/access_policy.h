@@ -3,6 +3,7 @@
 
 #include <optional>
 #include <string>
+#include <unordered_map>
 #include <vector>
 
 // Inter-module access policy model + parser (Qt-free). Parses the JSON set
@@ -28,6 +29,24 @@ struct AccessPolicy {
     bool enforce() const { return mode == "enforce"; }
 };
 
+// Lookup form of an enforce-mode policy, built once when the policy is set so
+// the per-load derivation never scans the restriction list.
+struct CompiledAccessPolicy {
+    // Explicit allowedCallers keyed by target. First entry wins on duplicates,
+    // matching the linear scan this replaces.
+    std::unordered_map<std::string, std::vector<std::string>> explicitCallers;
+
+    // The explicit allowlist for `target`, or nullptr when the policy does not
+    // name it (the derived allowlist applies).
+    const std::vector<std::string>* explicitFor(const std::string& target) const
+    {
+        auto it = explicitCallers.find(target);
+        return it != explicitCallers.end() ? &it->second : nullptr;
+    }
+};
+
+CompiledAccessPolicy compileAccessPolicy(const AccessPolicy& policy);
+
 // Returns nullopt only on invalid JSON. Otherwise tolerant: unknown keys
 // ignored, missing "restrictions"/"allowedCallers" yield empty lists.
 std::optional<AccessPolicy> parseAccessPolicy(const std::string& json);
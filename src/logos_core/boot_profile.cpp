@@ -0,0 +1,302 @@
+#include "boot_profile.h"
+#include "dependency_resolver.h"
+
+#include <spdlog/spdlog.h>
+#include <algorithm>
+#include <numeric>
+#include <unordered_set>
+
+namespace LogosCore {
+
+std::optional<BootProfile> parseBootProfile(const std::string& json, std::string* error)
+{
+    auto fail = [&](const std::string& why) -> std::optional<BootProfile> {
+        if (error)
+            *error = why;
+        return std::nullopt;
+    };
+
+    const auto doc = nlohmann::json::parse(json, nullptr, /*allow_exceptions=*/false);
+    if (doc.is_discarded())
+        return fail("boot profile is not valid JSON");
+    const nlohmann::json* sets = &doc;
+    if (doc.is_object()) {
+        auto it = doc.find("sets");
+        if (it == doc.end())
+            return fail("boot profile has no \"sets\"");
+        sets = &*it;
+    }
+    if (!sets->is_array())
+        return fail("boot profile sets must be an array");
+
+    BootProfile profile;
+    for (std::size_t i = 0; i < sets->size(); ++i) {
+        const auto& entry = (*sets)[i];
+        const std::string where = "boot profile set " + std::to_string(i);
+        if (!entry.is_object())
+            return fail(where + " is not an object");
+        BootSet set;
+        set.name = "set" + std::to_string(i);
+        if (auto it = entry.find("name"); it != entry.end()) {
+            if (!it->is_string())
+                return fail(where + ": \"name\" must be a string");
+            set.name = it->get<std::string>();
+        }
+        if (auto it = entry.find("priority"); it != entry.end()) {
+            if (!it->is_number_integer())
+                return fail(where + ": \"priority\" must be an integer");
+            set.priority = it->get<int>();
+        }
+        if (auto it = entry.find("required"); it != entry.end()) {
+            if (!it->is_boolean())
+                return fail(where + ": \"required\" must be a boolean");
+            set.required = it->get<bool>();
+        }
+        auto modules = entry.find("modules");
+        if (modules == entry.end() || !modules->is_array())
+            return fail(where + ": \"modules\" must be an array of module names");
+        for (const auto& m : *modules) {
+            if (!m.is_string() || m.get<std::string>().empty())
+                return fail(where + ": \"modules\" must be an array of module names");
+            set.modules.push_back(m.get<std::string>());
+        }
+        profile.sets.push_back(std::move(set));
+    }
+    return profile;
+}
+
+BootProfileRunner::BootProfileRunner(BootProfile profile, Hooks hooks)
+    : m_profile(std::move(profile))
+    , m_hooks(std::move(hooks))
+{
+    plan();
+}
+
+BootProfileRunner::~BootProfileRunner()
+{
+    stop();
+}
+
+void BootProfileRunner::plan()
+{
+    std::vector<std::size_t> setOrder(m_profile.sets.size());
+    std::iota(setOrder.begin(), setOrder.end(), 0);
+    std::stable_sort(setOrder.begin(), setOrder.end(), [this](std::size_t a, std::size_t b) {
+        const auto& x = m_profile.sets[a];
+        const auto& y = m_profile.sets[b];
+        if (x.required != y.required)
+            return x.required;
+        return x.priority > y.priority;
+    });
+
+    std::unordered_set<std::string> planned;
+    for (std::size_t s : setOrder) {
+        const BootSet& set = m_profile.sets[s];
+        auto resolved = DependencyResolver::resolve(set.modules, m_hooks.isKnown, m_hooks.dependenciesOf);
+        for (const auto& name : resolved.order) {
+            if (planned.insert(name).second)
+                m_steps.push_back({name, s, set.required, StepStatus::Pending});
+        }
+        // Requested modules the resolver could not order (unknown, or on a
+        // cycle), and unknown dependencies, never load.
+        std::vector<std::string> unresolved = resolved.missing;
+        for (const auto& name : set.modules) {
+            if (std::find(resolved.order.begin(), resolved.order.end(), name) == resolved.order.end())
+                unresolved.push_back(name);
+        }
+        for (const auto& name : unresolved) {
+            if (planned.insert(name).second)
+                m_steps.push_back({name, s, set.required, StepStatus::Unresolved});
+        }
+    }
+    updateReadyLocked();
+}
+
+void BootProfileRunner::start()
+{
+    std::lock_guard lock(m_mutex);
+    if (m_thread.joinable() || m_finished || m_cancel)
+        return;
+    m_started = std::chrono::steady_clock::now();
+    updateReadyLocked();
+    m_thread = std::thread([this] { run(); });
+}
+
+void BootProfileRunner::stop()
+{
+    std::thread worker;
+    {
+        std::lock_guard lock(m_mutex);
+        m_cancel = true;
+        worker = std::move(m_thread);   // one caller joins it
+        if (m_started == std::chrono::steady_clock::time_point{} && !m_finished) {
+            // Never started: nothing will run the steps.
+            for (auto& step : m_steps) {
+                if (step.status == StepStatus::Pending)
+                    step.status = StepStatus::Cancelled;
+            }
+            updateReadyLocked();
+            if (m_ready == Ready::Pending)
+                m_ready = Ready::Unreachable;
+            m_finished = true;
+            m_changed.notify_all();
+        }
+    }
+    if (worker.joinable())
+        worker.join();
+}
+
+void BootProfileRunner::run()
+{
+    for (std::size_t i = 0;; ++i) {
+        std::string module;
+        bool required = false;
+        {
+            std::lock_guard lock(m_mutex);
+            if (i >= m_steps.size())
+                break;
+            if (m_cancel) {
+                for (std::size_t j = i; j < m_steps.size(); ++j) {
+                    if (m_steps[j].status == StepStatus::Pending)
+                        m_steps[j].status = StepStatus::Cancelled;
+                }
+                updateReadyLocked();
+                break;
+            }
+            if (m_steps[i].status != StepStatus::Pending)
+                continue;
+            module = m_steps[i].module;
+            required = m_steps[i].required;
+        }
+
+        StepStatus result = StepStatus::Loaded;
+        for (const auto& dep : m_hooks.dependenciesOf(module)) {
+            if (!m_hooks.isLoaded(dep)) {
+                result = StepStatus::Skipped;
+                break;
+            }
+        }
+        if (result == StepStatus::Loaded && !m_hooks.isLoaded(module) && !m_hooks.load(module, required))
+            result = StepStatus::Failed;
+        if (result != StepStatus::Loaded)
+            spdlog::warn("Boot profile: {} {}", module, statusName(result));
+
+        std::lock_guard lock(m_mutex);
+        m_steps[i].status = result;
+        updateReadyLocked();
+        m_changed.notify_all();
+    }
+
+    std::lock_guard lock(m_mutex);
+    m_finished = true;
+    m_finishedMs = std::chrono::duration<double, std::milli>(
+        std::chrono::steady_clock::now() - m_started).count();
+    if (m_ready == Ready::Pending)
+        m_ready = Ready::Unreachable;   // cancelled before the required sets were up
+    spdlog::info("Boot profile finished in {:.1f} ms", *m_finishedMs);
+    m_changed.notify_all();
+}
+
+void BootProfileRunner::updateReadyLocked()
+{
+    if (m_ready != Ready::Pending)
+        return;
+    bool allUp = true;
+    for (const auto& step : m_steps) {
+        if (!step.required)
+            continue;
+        if (step.status == StepStatus::Pending) {
+            allUp = false;
+        } else if (step.status != StepStatus::Loaded) {
+            m_ready = Ready::Unreachable;
+            spdlog::warn("Boot profile: ready milestone unreachable ({} {})",
+                         step.module, statusName(step.status));
+            return;
+        }
+    }
+    // Decided only once running: before start() nothing is up yet.
+    if (allUp && m_started != std::chrono::steady_clock::time_point{}) {
+        m_ready = Ready::Reached;
+        m_readyMs = std::chrono::duration<double, std::milli>(
+            std::chrono::steady_clock::now() - m_started).count();
+        spdlog::info("Boot profile: ready in {:.1f} ms", *m_readyMs);
+    }
+}
+
+BootProfileRunner::Ready BootProfileRunner::waitReady(std::chrono::milliseconds timeout) const
+{
+    std::unique_lock lock(m_mutex);
+    auto decided = [this] { return m_ready != Ready::Pending; };
+    if (timeout.count() < 0)
+        m_changed.wait(lock, decided);
+    else
+        m_changed.wait_for(lock, timeout, decided);
+    return m_ready;
+}
+
+bool BootProfileRunner::waitFinished(std::chrono::milliseconds timeout) const
+{
+    std::unique_lock lock(m_mutex);
+    auto done = [this] { return m_finished; };
+    if (timeout.count() < 0) {
+        m_changed.wait(lock, done);
+        return true;
+    }
+    return m_changed.wait_for(lock, timeout, done);
+}
+
+BootProfileRunner::Ready BootProfileRunner::ready() const
+{
+    std::lock_guard lock(m_mutex);
+    return m_ready;
+}
+
+bool BootProfileRunner::finished() const
+{
+    std::lock_guard lock(m_mutex);
+    return m_finished;
+}
+
+const char* BootProfileRunner::statusName(StepStatus status)
+{
+    switch (status) {
+    case StepStatus::Pending:    return "pending";
+    case StepStatus::Loaded:     return "loaded";
+    case StepStatus::Failed:     return "failed";
+    case StepStatus::Skipped:    return "skipped";
+    case StepStatus::Unresolved: return "unresolved";
+    case StepStatus::Cancelled:  return "cancelled";
+    }
+    return "unknown";
+}
+
+nlohmann::json BootProfileRunner::status() const
+{
+    std::lock_guard lock(m_mutex);
+    const char* state = "loading";
+    if (m_ready == Ready::Unreachable)
+        state = "failed";
+    else if (m_ready == Ready::Reached)
+        state = m_finished ? "done" : "ready";
+
+    nlohmann::json sets = nlohmann::json::array();
+    for (const auto& set : m_profile.sets) {
+        sets.push_back({
+            {"name", set.name},
+            {"priority", set.priority},
+            {"required", set.required},
+            {"modules", nlohmann::json::array()},
+        });
+    }
+    for (const auto& step : m_steps)
+        sets[step.set]["modules"].push_back({{"name", step.module}, {"status", statusName(step.status)}});
+
+    return {
+        {"state", state},
+        {"ready_ms", m_readyMs ? nlohmann::json(*m_readyMs) : nlohmann::json(nullptr)},
+        {"finished_ms", m_finishedMs ? nlohmann::json(*m_finishedMs) : nlohmann::json(nullptr)},
+        {"sets", sets},
+    };
+}
+
+} // namespace LogosCore
@@ -0,0 +1,125 @@
+#ifndef BOOT_PROFILE_H
+#define BOOT_PROFILE_H
+
+#include <nlohmann/json.hpp>
+
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace LogosCore {
+
+// Declarative preload for a host's boot (Qt-free): named module sets, each
+// with a priority and a "required for ready" flag, loaded by core on a
+// background thread instead of a hand-written loop of load calls.
+//
+// Required sets go first, then the rest; within each group higher priority
+// goes first, ties in profile order. Each set is expanded with its
+// dependency closure and every module is loaded once, after its
+// dependencies. The "ready" milestone is reached as soon as every module of
+// the required sets (dependencies included) is up; the remaining sets keep
+// loading afterwards. Loads go through the normal one-at-a-time load path,
+// one module per call, so a host's own load requests interleave with the
+// profile instead of waiting for it to finish.
+
+struct BootSet {
+    std::string name;
+    int priority = 0;                  // higher loads first
+    bool required = false;             // part of the ready milestone
+    std::vector<std::string> modules;
+};
+
+struct BootProfile {
+    std::vector<BootSet> sets;
+};
+
+// {"sets": [{"name", "priority", "required", "modules": [...]}, ...]}, or
+// just the array. Only "modules" is mandatory; a set without a name is
+// called "set<index>". Returns nullopt and sets `error` on malformed input.
+std::optional<BootProfile> parseBootProfile(const std::string& json, std::string* error = nullptr);
+
+class BootProfileRunner {
+public:
+    struct Hooks {
+        std::function<bool(const std::string&)> isKnown;
+        std::function<std::vector<std::string>(const std::string&)> dependenciesOf;
+        std::function<bool(const std::string&)> isLoaded;
+        // Load one module whose dependencies are already loaded. `required`:
+        // it is part of the ready milestone (core loads the others at
+        // background priority).
+        std::function<bool(const std::string&, bool required)> load;
+    };
+
+    enum class Ready {
+        Pending,       // still loading the required sets
+        Reached,
+        Unreachable,   // a required module failed, was skipped or is unknown
+    };
+
+    // Plans the load order immediately; nothing loads before start().
+    BootProfileRunner(BootProfile profile, Hooks hooks);
+    ~BootProfileRunner();
+
+    BootProfileRunner(const BootProfileRunner&) = delete;
+    BootProfileRunner& operator=(const BootProfileRunner&) = delete;
+
+    void start();
+    // Cancel the steps not yet started and join. The step in progress, if
+    // any, completes.
+    void stop();
+
+    // Block until the ready milestone is decided or `timeout` passes
+    // (negative: no limit). Returns the state at that point.
+    Ready waitReady(std::chrono::milliseconds timeout) const;
+    // Block until every step has been attempted; false on timeout.
+    bool waitFinished(std::chrono::milliseconds timeout) const;
+
+    Ready ready() const;
+    bool finished() const;
+
+    // {"state": "loading"|"ready"|"done"|"failed", "ready_ms", "finished_ms"
+    //  (null until then, relative to start()), "sets": [{name, priority,
+    //  required, "modules": [{name, status}]}]}. A set lists the modules it
+    //  brought in, dependencies included, in load order; status is one of
+    //  pending, loaded, failed, skipped (a dependency is not loaded),
+    //  unresolved (unknown, or on a dependency cycle), cancelled.
+    nlohmann::json status() const;
+
+private:
+    enum class StepStatus { Pending, Loaded, Failed, Skipped, Unresolved, Cancelled };
+
+    struct Step {
+        std::string module;
+        std::size_t set = 0;       // index into m_profile.sets
+        bool required = false;
+        StepStatus status = StepStatus::Pending;
+    };
+
+    void plan();
+    void run();
+    void updateReadyLocked();
+    static const char* statusName(StepStatus status);
+
+    BootProfile m_profile;
+    Hooks m_hooks;
+
+    mutable std::mutex m_mutex;
+    mutable std::condition_variable m_changed;
+    std::vector<Step> m_steps;
+    Ready m_ready = Ready::Pending;
+    bool m_finished = false;
+    bool m_cancel = false;
+    std::chrono::steady_clock::time_point m_started;
+    std::optional<double> m_readyMs;
+    std::optional<double> m_finishedMs;
+    std::thread m_thread;
+};
+
+} // namespace LogosCore
+
+#endif // BOOT_PROFILE_H
@@ -0,0 +1,180 @@
+#include "boot_schedule.h"
+
+#include <algorithm>
+#include <unordered_map>
+
+namespace LogosCore {
+
+namespace {
+
+// Durations come from microsecond histograms; anything closer than this is
+// the same instant.
+constexpr double kEpsilonMs = 1e-6;
+
+} // anonymous namespace
+
+BootPlan planBoot(const std::vector<BootTask>& tasks)
+{
+    BootPlan plan;
+    const std::size_t n = tasks.size();
+    std::unordered_map<std::string, std::size_t> index;
+    for (std::size_t i = 0; i < n; ++i)
+        index.emplace(tasks[i].name, i);
+
+    // deps[i]: distinct in-set dependencies; dependents[i]: the reverse.
+    std::vector<std::vector<std::size_t>> deps(n), dependents(n);
+    std::vector<std::size_t> pending(n, 0);
+    for (std::size_t i = 0; i < n; ++i) {
+        if (index.at(tasks[i].name) != i)
+            continue;   // duplicate name; the first occurrence carries it
+        for (const auto& dep : tasks[i].dependencies) {
+            auto it = index.find(dep);
+            if (it == index.end() || it->second == i)
+                continue;
+            if (std::find(deps[i].begin(), deps[i].end(), it->second) != deps[i].end())
+                continue;
+            deps[i].push_back(it->second);
+            dependents[it->second].push_back(i);
+            ++pending[i];
+        }
+    }
+
+    // Kahn's order, in input order among ready modules. Whatever never becomes
+    // ready sits on, or behind, a cycle.
+    std::vector<std::size_t> order;
+    std::vector<bool> seen(n, false);
+    for (std::size_t i = 0; i < n; ++i) {
+        if (index.at(tasks[i].name) == i && pending[i] == 0) {
+            order.push_back(i);
+            seen[i] = true;
+        }
+    }
+    for (std::size_t head = 0; head < order.size(); ++head) {
+        for (std::size_t d : dependents[order[head]]) {
+            if (--pending[d] == 0) {
+                order.push_back(d);
+                seen[d] = true;
+            }
+        }
+    }
+    for (std::size_t i = 0; i < n; ++i) {
+        if (index.at(tasks[i].name) == i && !seen[i])
+            plan.unschedulable.push_back(tasks[i].name);
+    }
+
+    // Forward pass: earliest start/finish. Backward pass: latest finish.
+    std::vector<double> start(n, 0), finish(n, 0), latest(n, 0);
+    for (std::size_t i : order) {
+        for (std::size_t d : deps[i])
+            start[i] = std::max(start[i], finish[d]);
+        finish[i] = start[i] + std::max(0.0, tasks[i].durationMs);
+        plan.minimumBootMs = std::max(plan.minimumBootMs, finish[i]);
+        plan.serialBootMs += std::max(0.0, tasks[i].durationMs);
+    }
+    for (auto it = order.rbegin(); it != order.rend(); ++it) {
+        const std::size_t i = *it;
+        latest[i] = plan.minimumBootMs;
+        for (std::size_t d : dependents[i]) {
+            if (!seen[d])
+                continue;   // on or behind a cycle: never scheduled, constrains nothing
+            latest[i] = std::min(latest[i], latest[d] - (finish[d] - start[d]));
+        }
+    }
+
+    for (std::size_t i : order) {
+        BootSlot slot;
+        slot.name = tasks[i].name;
+        slot.durationMs = finish[i] - start[i];
+        slot.startMs = start[i];
+        slot.finishMs = finish[i];
+        slot.slackMs = std::max(0.0, latest[i] - finish[i]);
+        slot.critical = slot.slackMs <= kEpsilonMs;
+        slot.measured = tasks[i].measured;
+        plan.schedule.push_back(std::move(slot));
+        if (!tasks[i].measured)
+            plan.unmeasured.push_back(tasks[i].name);
+    }
+    std::stable_sort(plan.schedule.begin(), plan.schedule.end(),
+                     [](const BootSlot& a, const BootSlot& b) {
+                         if (a.startMs != b.startMs)
+                             return a.startMs < b.startMs;
+                         return a.name < b.name;
+                     });
+
+    // One longest chain: from the first module finishing last, step back to
+    // the dependency that finished exactly when it started (the latest one).
+    if (!order.empty()) {
+        std::size_t cur = order.front();
+        for (std::size_t i : order) {
+            if (finish[i] > finish[cur] + kEpsilonMs)
+                cur = i;
+        }
+        for (;;) {
+            plan.criticalPath.push_back(tasks[cur].name);
+            std::size_t next = n;
+            for (std::size_t d : deps[cur]) {
+                if (finish[d] + kEpsilonMs >= start[cur] && (next == n || finish[d] > finish[next]))
+                    next = d;
+            }
+            if (next == n)
+                break;
+            cur = next;
+        }
+        std::reverse(plan.criticalPath.begin(), plan.criticalPath.end());
+    }
+
+    // Peak overlap of the [start, finish) intervals; a finish at t frees its
+    // slot before a start at t takes one.
+    std::vector<std::pair<double, int>> edges;
+    for (const auto& slot : plan.schedule) {
+        if (slot.durationMs <= kEpsilonMs)
+            continue;
+        edges.emplace_back(slot.startMs, 1);
+        edges.emplace_back(slot.finishMs, -1);
+    }
+    std::sort(edges.begin(), edges.end());
+    int running = 0;
+    for (const auto& [t, delta] : edges) {
+        running += delta;
+        plan.maxParallelism = std::max(plan.maxParallelism, running);
+    }
+    return plan;
+}
+
+nlohmann::json bootPlanToJson(const BootPlan& plan)
+{
+    std::vector<const BootSlot*> gating;
+    nlohmann::json schedule = nlohmann::json::array();
+    for (const auto& slot : plan.schedule) {
+        schedule.push_back({
+            {"name", slot.name},
+            {"duration_ms", slot.durationMs},
+            {"start_ms", slot.startMs},
+            {"finish_ms", slot.finishMs},
+            {"slack_ms", slot.slackMs},
+            {"critical", slot.critical},
+            {"measured", slot.measured},
+        });
+        if (slot.critical && slot.durationMs > kEpsilonMs)
+            gating.push_back(&slot);
+    }
+    std::stable_sort(gating.begin(), gating.end(), [](const BootSlot* a, const BootSlot* b) {
+        return a->durationMs > b->durationMs;
+    });
+    nlohmann::json gatingJson = nlohmann::json::array();
+    for (const BootSlot* slot : gating)
+        gatingJson.push_back({{"name", slot->name}, {"duration_ms", slot->durationMs}});
+
+    return {
+        {"minimum_boot_ms", plan.minimumBootMs},
+        {"serial_boot_ms", plan.serialBootMs},
+        {"max_parallelism", plan.maxParallelism},
+        {"critical_path", plan.criticalPath},
+        {"gating", gatingJson},
+        {"schedule", schedule},
+        {"unmeasured", plan.unmeasured},
+        {"unschedulable", plan.unschedulable},
+    };
+}
+
+} // namespace LogosCore
@@ -0,0 +1,60 @@
+#ifndef BOOT_SCHEDULE_H
+#define BOOT_SCHEDULE_H
+
+#include <nlohmann/json.hpp>
+#include <string>
+#include <vector>
+
+namespace LogosCore {
+
+// Critical-path analysis of a boot (Qt-free). Given how long each module
+// takes to load and what it depends on, computes the earliest-start schedule
+// a loader with unlimited parallelism could achieve: every module starts as
+// soon as its last dependency has finished. That schedule is optimal — its
+// length is the longest dependency chain by duration, the theoretical
+// minimum boot time — so the modules on that chain are the ones that gate
+// boot, and speeding up anything else cannot shorten it.
+//
+// ModuleManager feeds it the mean successful load time per module from
+// LifecycleMetrics; see logos_core_get_boot_report().
+
+struct BootTask {
+    std::string name;
+    std::vector<std::string> dependencies;   // edges outside the task set are ignored
+    double durationMs = 0;
+    bool measured = true;                    // false: duration is a guess (0)
+};
+
+struct BootSlot {
+    std::string name;
+    double durationMs = 0;
+    double startMs = 0;       // earliest start
+    double finishMs = 0;
+    double slackMs = 0;       // how much later it could finish without delaying boot
+    bool critical = false;    // zero slack
+    bool measured = true;
+};
+
+struct BootPlan {
+    std::vector<BootSlot> schedule;          // by start time, then name
+    std::vector<std::string> criticalPath;   // one longest chain, dependencies first
+    double minimumBootMs = 0;                // length of the schedule
+    double serialBootMs = 0;                 // sum of durations: one load at a time
+    int maxParallelism = 0;                  // most loads the schedule runs at once
+    std::vector<std::string> unmeasured;
+    // Modules on or behind a dependency cycle; they cannot be scheduled and
+    // are left out of everything above.
+    std::vector<std::string> unschedulable;
+};
+
+BootPlan planBoot(const std::vector<BootTask>& tasks);
+
+// {"minimum_boot_ms", "serial_boot_ms", "max_parallelism", "critical_path",
+//  "gating": [{name, duration_ms}] (critical modules, slowest first),
+//  "schedule": [{name, duration_ms, start_ms, finish_ms, slack_ms, critical,
+//  measured}], "unmeasured", "unschedulable"}
+nlohmann::json bootPlanToJson(const BootPlan& plan);
+
+} // namespace LogosCore
+
+#endif // BOOT_SCHEDULE_H
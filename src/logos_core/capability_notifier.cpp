@@ -0,0 +1,144 @@
+#include "capability_notifier.h"
+#include "lifecycle_trace.h"
+
+#include <spdlog/spdlog.h>
+#include <algorithm>
+#include <exception>
+
+namespace LogosCore {
+
+CapabilityNotifier::~CapabilityNotifier()
+{
+    {
+        std::lock_guard lock(m_mutex);
+        m_stopping = true;
+        m_queue.clear();
+    }
+    m_wake.notify_all();
+    if (m_worker.joinable())
+        m_worker.join();
+}
+
+void CapabilityNotifier::ensureWorkerLocked()
+{
+    if (!m_worker.joinable())
+        m_worker = std::thread([this]() { run(); });
+}
+
+CapabilityNotifier::Ticket CapabilityNotifier::enqueue(const std::string& module, Task task)
+{
+    return push(module, std::move(task), false);
+}
+
+CapabilityNotifier::Ticket CapabilityNotifier::enqueueUrgent(const std::string& module, Task task)
+{
+    return push(module, std::move(task), true);
+}
+
+CapabilityNotifier::Ticket CapabilityNotifier::push(const std::string& module, Task task, bool urgent)
+{
+    Ticket seq = 0;
+    {
+        std::lock_guard lock(m_mutex);
+        if (m_stopping)
+            return 0;
+        seq = m_nextSeq++;
+        m_lastSeqFor[module] = seq;
+        m_outstanding.emplace(seq, module);
+        auto at = m_queue.end();
+        if (urgent)
+            at = std::find_if(m_queue.begin(), m_queue.end(),
+                              [](const Entry& e) { return !e.urgent; });
+        m_queue.insert(at, Entry{seq, module, std::move(task), urgent});
+        ensureWorkerLocked();
+    }
+    m_wake.notify_one();
+    return seq;
+}
+
+void CapabilityNotifier::wait(Ticket ticket)
+{
+    if (ticket == 0)
+        return;
+    std::unique_lock lock(m_mutex);
+    m_done.wait(lock, [&]() { return !m_outstanding.count(ticket) || m_stopping; });
+}
+
+void CapabilityNotifier::waitFor(const std::string& module)
+{
+    std::unique_lock lock(m_mutex);
+    auto it = m_lastSeqFor.find(module);
+    if (it == m_lastSeqFor.end())
+        return;
+    const uint64_t target = it->second;
+    m_done.wait(lock, [&]() {
+        if (m_stopping)
+            return true;
+        for (auto o = m_outstanding.begin(); o != m_outstanding.end() && o->first <= target; ++o) {
+            if (o->second == module)
+                return false;
+        }
+        return true;
+    });
+}
+
+void CapabilityNotifier::drain()
+{
+    std::unique_lock lock(m_mutex);
+    m_done.wait(lock, [&]() { return (m_queue.empty() && !m_busy) || m_stopping; });
+}
+
+void CapabilityNotifier::cancelPending()
+{
+    std::unique_lock lock(m_mutex);
+    if (!m_queue.empty()) {
+        spdlog::debug("Dropping {} pending capability_module notification(s)",
+                      m_queue.size());
+        // Dropped tasks count as done so no barrier waits on them forever.
+        for (const auto& entry : m_queue)
+            m_outstanding.erase(entry.seq);
+        m_queue.clear();
+    }
+    m_done.wait(lock, [&]() { return !m_busy || m_stopping; });
+    m_done.notify_all();
+}
+
+std::size_t CapabilityNotifier::pending() const
+{
+    std::lock_guard lock(m_mutex);
+    return m_queue.size() + (m_busy ? 1 : 0);
+}
+
+void CapabilityNotifier::run()
+{
+    LifecycleTrace::setThreadName("capability-notifier");
+    std::unique_lock lock(m_mutex);
+    for (;;) {
+        m_wake.wait(lock, [&]() { return m_stopping || !m_queue.empty(); });
+        if (m_stopping)
+            return;
+
+        Entry entry = std::move(m_queue.front());
+        m_queue.pop_front();
+        m_busy = true;
+        lock.unlock();
+
+        // Notifications are best-effort (the inline versions only logged on
+        // failure too); an exception must not take the pipeline down with it.
+        try {
+            entry.task();
+        } catch (const std::exception& e) {
+            spdlog::warn("capability_module notification for {} threw: {}",
+                         entry.module, e.what());
+        } catch (...) {
+            spdlog::warn("capability_module notification for {} threw", entry.module);
+        }
+
+        lock.lock();
+        m_busy = false;
+        m_outstanding.erase(entry.seq);
+        m_done.notify_all();
+    }
+}
+
+} // namespace LogosCore
@@ -0,0 +1,109 @@
+#ifndef CAPABILITY_NOTIFIER_H
+#define CAPABILITY_NOTIFIER_H
+
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+
+namespace LogosCore {
+
+// Ordered asynchronous pipeline for the core -> capability_module IPC
+// (informModuleToken, registerRestriction). Qt-free.
+//
+// Those calls used to run inline in ModuleManager's load/unload path while
+// loadMutex() was held, so every load paid a capability_module round-trip
+// per notification. They now go through here instead:
+//
+//   - One worker thread runs tasks one at a time. Restriction pushes run in
+//     enqueue order, so a later push for a target always lands after an
+//     earlier one.
+//   - Token notifications are urgent: they run ahead of every queued
+//     restriction push (in order among themselves), so a load waiting on its
+//     own token is not held behind restriction traffic from earlier loads. A
+//     module's token is still informed before any restriction naming it.
+//   - enqueue returns a ticket; wait(ticket) blocks until that one task has
+//     run. Every task is also tagged with the module it concerns, and
+//     waitFor(module) returns once every task enqueued for that module so far
+//     has run.
+//
+// The worker is started lazily on the first enqueue, so hosts that never load
+// capability_module never spawn it.
+class CapabilityNotifier {
+public:
+    using Task = std::function<void()>;
+
+    CapabilityNotifier() = default;
+    ~CapabilityNotifier();
+
+    CapabilityNotifier(const CapabilityNotifier&) = delete;
+    CapabilityNotifier& operator=(const CapabilityNotifier&) = delete;
+
+    // Identifies one enqueued task; 0 is never handed out and wait(0)
+    // returns at once.
+    using Ticket = uint64_t;
+
+    // Queue `task` behind everything already queued. `module` is the barrier
+    // key (the module whose token/restriction the task carries).
+    Ticket enqueue(const std::string& module, Task task);
+
+    // Queue `task` ahead of every non-urgent task still waiting, behind
+    // earlier urgent ones.
+    Ticket enqueueUrgent(const std::string& module, Task task);
+
+    // Block until the task behind `ticket` has run (or was dropped by
+    // cancelPending). Does not wait for anything else.
+    void wait(Ticket ticket);
+
+    // Block until every task enqueued for `module` before this call has run
+    // (or was dropped by cancelPending). Returns immediately when nothing is
+    // outstanding for it.
+    void waitFor(const std::string& module);
+
+    // Block until the queue is empty and the worker is idle.
+    void drain();
+
+    // Drop every queued task that has not started yet and wait for the one in
+    // flight, if any. Used on teardown, where pending notifications would only
+    // target a capability_module that is about to be terminated.
+    void cancelPending();
+
+    // Number of tasks queued or running. Diagnostic / test use.
+    std::size_t pending() const;
+
+private:
+    struct Entry {
+        uint64_t seq;
+        std::string module;
+        Task task;
+        bool urgent;
+    };
+
+    void run();
+    void ensureWorkerLocked();
+    Ticket push(const std::string& module, Task task, bool urgent);
+
+    mutable std::mutex m_mutex;
+    std::condition_variable m_wake;   // worker: work available / stopping
+    std::condition_variable m_done;   // waiters: a task finished
+    std::deque<Entry> m_queue;        // urgent entries first
+    // Module of every task queued or running, by sequence number. Urgent
+    // tasks overtake, so completion is not in sequence order; the barriers
+    // look their tasks up here instead.
+    std::map<uint64_t, std::string> m_outstanding;
+    // Highest sequence number handed out to each module.
+    std::unordered_map<std::string, uint64_t> m_lastSeqFor;
+    uint64_t m_nextSeq = 1;
+    bool m_busy = false;
+    bool m_stopping = false;
+    std::thread m_worker;
+};
+
+} // namespace LogosCore
+
+#endif // CAPABILITY_NOTIFIER_H
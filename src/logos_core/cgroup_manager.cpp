@@ -0,0 +1,468 @@
+#include "cgroup_manager.h"
+
+#include <spdlog/spdlog.h>
+#include <algorithm>
+#include <cerrno>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+#ifdef __linux__
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace LogosCore {
+
+namespace {
+
+constexpr const char* kCoreLeaf = "logos-core";
+constexpr const char* kLeafPrefix = "module-";
+constexpr const char* kControllers[] = {"cpu", "memory", "pids"};
+
+// The module a process runs, for host policy lookups: an upgrade starts the
+// new build under another container key, with "upgrade_of" naming the module.
+std::string policyName(const ModuleDescriptor& desc)
+{
+    if (auto it = desc.loaderConfig.find("upgrade_of"); it != desc.loaderConfig.end() && it->is_string())
+        return it->get<std::string>();
+    return desc.name;
+}
+
+#ifdef __linux__
+bool readFile(const std::string& path, std::string& out)
+{
+    const int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0)
+        return false;
+    out.clear();
+    char buf[1024];
+    for (;;) {
+        const ssize_t n = ::read(fd, buf, sizeof(buf));
+        if (n <= 0) break;
+        out.append(buf, static_cast<std::size_t>(n));
+    }
+    ::close(fd);
+    return true;
+}
+
+// cgroupfs takes each value in a single write(); the kernel reports a bad
+// value or a refused move through its errno.
+bool writeFile(const std::string& path, const std::string& value)
+{
+    const int fd = ::open(path.c_str(), O_WRONLY | O_TRUNC | O_CLOEXEC);
+    if (fd < 0)
+        return false;
+    const ssize_t n = ::write(fd, value.data(), value.size());
+    const int err = errno;
+    ::close(fd);
+    errno = err;
+    return n == static_cast<ssize_t>(value.size());
+}
+
+bool readU64(const std::string& path, uint64_t& value)
+{
+    std::string text;
+    if (!readFile(path, text) || text.empty() || text[0] < '0' || text[0] > '9')
+        return false;   // also rejects "max"
+    value = std::strtoull(text.c_str(), nullptr, 10);
+    return true;
+}
+#endif // __linux__
+
+// Bytes from a JSON number or a string with an optional K/M/G/T suffix.
+std::optional<uint64_t> parseBytes(const nlohmann::json& v)
+{
+    if (v.is_number_unsigned())
+        return v.get<uint64_t>();
+    if (v.is_number_integer() && v.get<int64_t>() >= 0)
+        return static_cast<uint64_t>(v.get<int64_t>());
+    if (!v.is_string())
+        return std::nullopt;
+    const std::string s = v.get<std::string>();
+    char* end = nullptr;
+    const unsigned long long n = std::strtoull(s.c_str(), &end, 10);
+    if (end == s.c_str())
+        return std::nullopt;
+    uint64_t mult = 1;
+    switch (*end) {
+    case '\0': break;
+    case 'K': case 'k': mult = 1ull << 10; ++end; break;
+    case 'M': case 'm': mult = 1ull << 20; ++end; break;
+    case 'G': case 'g': mult = 1ull << 30; ++end; break;
+    case 'T': case 't': mult = 1ull << 40; ++end; break;
+    default: return std::nullopt;
+    }
+    if (*end != '\0')
+        return std::nullopt;
+    return static_cast<uint64_t>(n) * mult;
+}
+
+std::optional<std::string> parseCpuMax(const nlohmann::json& v)
+{
+    constexpr uint64_t kPeriodUs = 100000;
+    if (v.is_number()) {
+        const double cpus = v.get<double>();
+        if (!(cpus > 0.0))
+            return std::nullopt;
+        const auto quota = static_cast<uint64_t>(std::llround(cpus * kPeriodUs));
+        return std::to_string(std::max<uint64_t>(quota, 1000)) + " " + std::to_string(kPeriodUs);
+    }
+    if (!v.is_string())
+        return std::nullopt;
+    const std::string s = v.get<std::string>();
+    if (s == "max")
+        return s;
+    unsigned long long quota = 0, period = 0;
+    char quotaWord[4] = {0};
+    if (std::sscanf(s.c_str(), "%llu %llu", &quota, &period) == 2 && quota > 0 && period > 0)
+        return s;
+    if (std::sscanf(s.c_str(), "%3s %llu", quotaWord, &period) == 2
+        && std::strcmp(quotaWord, "max") == 0 && period > 0)
+        return s;
+    return std::nullopt;
+}
+
+std::optional<uint64_t> parseCount(const nlohmann::json& v, uint64_t lo, uint64_t hi)
+{
+    if (!v.is_number_integer())
+        return std::nullopt;
+    const int64_t n = v.get<int64_t>();
+    if (n < static_cast<int64_t>(lo) || static_cast<uint64_t>(n) > hi)
+        return std::nullopt;
+    return static_cast<uint64_t>(n);
+}
+
+} // namespace
+
+// ── CgroupLimits ────────────────────────────────────────────────────────────
+
+CgroupLimits CgroupLimits::fromJson(const nlohmann::json& j)
+{
+    CgroupLimits l;
+    if (!j.is_object())
+        return l;
+
+    auto field = [&](const char* key, auto parse, auto& target) {
+        auto it = j.find(key);
+        if (it == j.end())
+            return;
+        if (auto v = parse(*it))
+            target = *v;
+        else
+            spdlog::warn("cgroups: ignoring malformed resource limit {}: {}", key, it->dump());
+    };
+    field("cpu_weight", [](const nlohmann::json& v) { return parseCount(v, 1, 10000); }, l.cpuWeight);
+    field("cpu_max", parseCpuMax, l.cpuMax);
+    field("memory_max", parseBytes, l.memoryMax);
+    field("memory_high", parseBytes, l.memoryHigh);
+    field("pids_max", [](const nlohmann::json& v) { return parseCount(v, 1, UINT32_MAX); }, l.pidsMax);
+    return l;
+}
+
+void CgroupLimits::overlay(const CgroupLimits& over)
+{
+    if (over.cpuWeight) cpuWeight = over.cpuWeight;
+    if (over.cpuMax) cpuMax = over.cpuMax;
+    if (over.memoryMax) memoryMax = over.memoryMax;
+    if (over.memoryHigh) memoryHigh = over.memoryHigh;
+    if (over.pidsMax) pidsMax = over.pidsMax;
+}
+
+bool CgroupLimits::empty() const
+{
+    return !cpuWeight && !cpuMax && !memoryMax && !memoryHigh && !pidsMax;
+}
+
+// ── CgroupManager ───────────────────────────────────────────────────────────
+
+CgroupManager::CgroupManager(std::string root)
+    : m_root(std::move(root))
+{
+    while (m_root.size() > 1 && m_root.back() == '/')
+        m_root.pop_back();
+}
+
+std::string CgroupManager::ownCgroupDir()
+{
+#ifndef __linux__
+    return {};
+#else
+    std::string text;
+    if (!readFile("/proc/self/cgroup", text))
+        return {};
+    // The unified hierarchy's line is "0::<path>".
+    std::size_t pos = 0;
+    while (pos < text.size()) {
+        std::size_t end = text.find('\n', pos);
+        if (end == std::string::npos) end = text.size();
+        if (text.compare(pos, 3, "0::") == 0) {
+            std::string path = text.substr(pos + 3, end - pos - 3);
+            if (path == "/") path.clear();
+            return "/sys/fs/cgroup" + path;
+        }
+        pos = end + 1;
+    }
+    return {};
+#endif
+}
+
+bool CgroupManager::init()
+{
+#ifndef __linux__
+    spdlog::warn("cgroups: only available on Linux; modules run unconfined");
+    return false;
+#else
+    if (m_root.empty())
+        m_root = ownCgroupDir();
+    if (m_root.empty()) {
+        spdlog::warn("cgroups: no cgroup v2 hierarchy; modules run in the host's cgroup");
+        return false;
+    }
+    if (::access((m_root + "/cgroup.subtree_control").c_str(), W_OK) != 0
+        || ::access((m_root + "/cgroup.procs").c_str(), W_OK) != 0) {
+        spdlog::warn("cgroups: {} is not delegated to this process; modules run in the host's cgroup",
+                     m_root);
+        return false;
+    }
+
+    // cgroup v2's no-internal-processes rule: a cgroup handing controllers to
+    // children may not hold processes itself, so move out of the root first.
+    std::string procs;
+    readFile(m_root + "/cgroup.procs", procs);
+    const std::string self = std::to_string(::getpid());
+    bool inRoot = false;
+    for (std::size_t pos = 0; pos < procs.size();) {
+        std::size_t end = procs.find('\n', pos);
+        if (end == std::string::npos) end = procs.size();
+        if (procs.compare(pos, end - pos, self) == 0) { inRoot = true; break; }
+        pos = end + 1;
+    }
+    if (inRoot) {
+        const std::string core = m_root + "/" + kCoreLeaf;
+        if ((::mkdir(core.c_str(), 0755) != 0 && errno != EEXIST)
+            || !writeFile(core + "/cgroup.procs", self)) {
+            spdlog::warn("cgroups: cannot move the core into {}: {}; modules run in the host's cgroup",
+                         core, std::strerror(errno));
+            return false;
+        }
+    }
+
+    std::string available;
+    readFile(m_root + "/cgroup.controllers", available);
+    std::vector<std::string> enabled;
+    for (const char* c : kControllers) {
+        const std::string name(c);
+        bool offered = false;
+        for (std::size_t pos = 0; pos < available.size();) {
+            std::size_t end = available.find_first_of(" \n", pos);
+            if (end == std::string::npos) end = available.size();
+            if (available.compare(pos, end - pos, name) == 0) { offered = true; break; }
+            pos = end + 1;
+        }
+        if (!offered)
+            continue;
+        if (writeFile(m_root + "/cgroup.subtree_control", "+" + name))
+            enabled.push_back(name);
+        else
+            spdlog::warn("cgroups: cannot enable the {} controller under {}: {}",
+                         name, m_root, std::strerror(errno));
+    }
+
+    {
+        std::lock_guard lock(m_mutex);
+        m_controllers = std::move(enabled);
+    }
+    spdlog::info("cgroups: placing modules under {}", m_root);
+    return true;
+#endif
+}
+
+bool CgroupManager::hasController(const std::string& name) const
+{
+    std::lock_guard lock(m_mutex);
+    return std::find(m_controllers.begin(), m_controllers.end(), name) != m_controllers.end();
+}
+
+void CgroupManager::setPolicy(const nlohmann::json& policy)
+{
+    std::lock_guard lock(m_mutex);
+    m_policy = policy.is_object() ? policy : nlohmann::json::object();
+}
+
+CgroupLimits CgroupManager::limitsFor(const ModuleDescriptor& desc) const
+{
+    nlohmann::json fallback, pinned;
+    {
+        std::lock_guard lock(m_mutex);
+        fallback = m_policy.value("default", nlohmann::json::object());
+        if (auto modules = m_policy.find("modules"); modules != m_policy.end() && modules->is_object())
+            pinned = modules->value(policyName(desc), nlohmann::json::object());
+    }
+
+    CgroupLimits limits = CgroupLimits::fromJson(fallback);
+    if (auto it = desc.rawMetadata.find("resources"); it != desc.rawMetadata.end())
+        limits.overlay(CgroupLimits::fromJson(*it));
+    limits.overlay(CgroupLimits::fromJson(pinned));
+    return limits;
+}
+
+std::string CgroupManager::leafPath(const std::string& name) const
+{
+    return m_root + "/" + kLeafPrefix + name;
+}
+
+void CgroupManager::applyLimits(const std::string& leaf, const CgroupLimits& limits) const
+{
+#ifdef __linux__
+    auto set = [&](const char* controller, const char* file, const std::string& value) {
+        if (!hasController(controller)) {
+            spdlog::warn("cgroups: {} controller unavailable; not setting {} for {}", controller, file, leaf);
+            return;
+        }
+        if (!writeFile(leaf + "/" + file, value))
+            spdlog::warn("cgroups: cannot write {} = {} for {}: {}", file, value, leaf, std::strerror(errno));
+    };
+    if (limits.cpuWeight) set("cpu", "cpu.weight", std::to_string(*limits.cpuWeight));
+    if (limits.cpuMax) set("cpu", "cpu.max", *limits.cpuMax);
+    if (limits.memoryHigh) set("memory", "memory.high", std::to_string(*limits.memoryHigh));
+    if (limits.memoryMax) set("memory", "memory.max", std::to_string(*limits.memoryMax));
+    if (limits.pidsMax) set("pids", "pids.max", std::to_string(*limits.pidsMax));
+#else
+    (void)leaf;
+    (void)limits;
+#endif
+}
+
+bool CgroupManager::place(const ModuleDescriptor& desc, int64_t pid)
+{
+#ifndef __linux__
+    (void)desc;
+    (void)pid;
+    return false;
+#else
+    if (pid <= 0)
+        return false;
+    const std::string leaf = leafPath(desc.name);
+    if (::mkdir(leaf.c_str(), 0755) != 0 && errno != EEXIST) {
+        spdlog::warn("cgroups: cannot create {}: {}", leaf, std::strerror(errno));
+        return false;
+    }
+    applyLimits(leaf, limitsFor(desc));
+    if (!writeFile(leaf + "/cgroup.procs", std::to_string(pid))) {
+        spdlog::warn("cgroups: cannot move {} (pid {}) into {}: {}",
+                     desc.name, pid, leaf, std::strerror(errno));
+        ::rmdir(leaf.c_str());
+        return false;
+    }
+    std::lock_guard lock(m_mutex);
+    m_leaves[desc.name] = Leaf{leaf, pid};
+    return true;
+#endif
+}
+
+void CgroupManager::release(const std::string& name)
+{
+    std::string path;
+    {
+        std::lock_guard lock(m_mutex);
+        auto it = m_leaves.find(name);
+        if (it == m_leaves.end())
+            return;
+        path = std::move(it->second.path);
+        m_leaves.erase(it);
+    }
+#ifdef __linux__
+    if (::rmdir(path.c_str()) != 0 && errno != ENOENT)
+        spdlog::debug("cgroups: leaving {} in place: {}", path, std::strerror(errno));
+#endif
+}
+
+void CgroupManager::releaseAll()
+{
+    std::vector<std::string> names;
+    {
+        std::lock_guard lock(m_mutex);
+        for (const auto& [name, leaf] : m_leaves)
+            names.push_back(name);
+    }
+    for (const auto& name : names)
+        release(name);
+}
+
+std::optional<std::string> CgroupManager::leafOf(const std::string& name) const
+{
+    std::lock_guard lock(m_mutex);
+    auto it = m_leaves.find(name);
+    if (it == m_leaves.end())
+        return std::nullopt;
+    return it->second.path;
+}
+
+std::optional<CgroupStats> CgroupManager::stats(const std::string& name) const
+{
+    auto leaf = leafOf(name);
+    if (!leaf)
+        return std::nullopt;
+    return readStats(*leaf);
+}
+
+std::optional<CgroupStats> CgroupManager::statsForPid(int64_t pid) const
+{
+    std::string path;
+    {
+        std::lock_guard lock(m_mutex);
+        for (const auto& [name, leaf] : m_leaves) {
+            if (leaf.pid == pid) {
+                path = leaf.path;
+                break;
+            }
+        }
+    }
+    if (path.empty())
+        return std::nullopt;
+    return readStats(path);
+}
+
+std::optional<CgroupStats> CgroupManager::readStats(const std::string& leaf)
+{
+#ifndef __linux__
+    (void)leaf;
+    return std::nullopt;
+#else
+    // cpu.stat exists in every cgroup2 directory, controller or not.
+    std::string text;
+    if (!readFile(leaf + "/cpu.stat", text))
+        return std::nullopt;
+
+    CgroupStats s;
+    auto line = [&](const char* key, uint64_t& value) {
+        const std::size_t keyLen = std::strlen(key);
+        for (std::size_t pos = 0; pos < text.size();) {
+            std::size_t end = text.find('\n', pos);
+            if (end == std::string::npos) end = text.size();
+            if (text.compare(pos, keyLen, key) == 0 && text[pos + keyLen] == ' ') {
+                value = std::strtoull(text.c_str() + pos + keyLen + 1, nullptr, 10);
+                return;
+            }
+            pos = end + 1;
+        }
+    };
+    uint64_t usage = 0, user = 0, system = 0;
+    line("usage_usec", usage);
+    line("user_usec", user);
+    line("system_usec", system);
+    line("throttled_usec", s.throttledUs);
+    s.cpuSeconds = static_cast<double>(usage) / 1e6;
+    s.userSeconds = static_cast<double>(user) / 1e6;
+    s.systemSeconds = static_cast<double>(system) / 1e6;
+
+    readU64(leaf + "/memory.current", s.memoryBytes);
+    readU64(leaf + "/pids.current", s.pids);
+    return s;
+#endif
+}
+
+} // namespace LogosCore
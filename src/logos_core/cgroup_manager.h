@@ -0,0 +1,119 @@
+#ifndef CGROUP_MANAGER_H
+#define CGROUP_MANAGER_H
+
+#include <logos_container/module_descriptor.h>
+#include <nlohmann/json.hpp>
+#include <cstdint>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace LogosCore {
+
+// Resource limits for one module's cgroup. Unset fields leave the kernel
+// default ("max" / 100) in place.
+//
+// JSON form — the "resources" object of a module's metadata, or an entry of
+// the host policy:
+//   { "cpu_weight": 1..10000,
+//     "cpu_max":    0.5 | "50000 100000" | "max",   // CPUs, or cgroup syntax
+//     "memory_max": 536870912 | "512M",             // bytes, K/M/G suffixes
+//     "memory_high": ..., "pids_max": 64 }
+// Malformed values are ignored with a warning.
+struct CgroupLimits {
+    std::optional<uint64_t> cpuWeight;
+    std::optional<std::string> cpuMax;   // cpu.max line, e.g. "50000 100000"
+    std::optional<uint64_t> memoryMax;
+    std::optional<uint64_t> memoryHigh;
+    std::optional<uint64_t> pidsMax;
+
+    static CgroupLimits fromJson(const nlohmann::json& j);
+    // Fields set in `over` replace ours.
+    void overlay(const CgroupLimits& over);
+    bool empty() const;
+};
+
+// Accounting read from a module's cgroup: covers every process in the leaf,
+// not just the one the container launched.
+struct CgroupStats {
+    double cpuSeconds = 0.0;      // cpu.stat usage_usec
+    double userSeconds = 0.0;
+    double systemSeconds = 0.0;
+    uint64_t memoryBytes = 0;     // memory.current
+    uint64_t pids = 0;            // pids.current (tasks, i.e. threads)
+    uint64_t throttledUs = 0;     // cpu.stat throttled_usec
+};
+
+// Places each module process into its own cgroup v2 leaf under a delegated
+// root, with limits from the module's metadata ("resources") overlaid by a
+// host policy:
+//   { "default": {<limits>}, "modules": { "<name>": {<limits>} } }
+// Precedence, lowest first: policy default, module metadata, policy entry
+// for the module — so the host always has the last word.
+//
+// The root must be a cgroup2 directory this process may write to (systemd
+// Delegate=yes, or a subtree chowned to the user). With an empty root the
+// process's own cgroup is used; since cgroup v2 forbids processes in a
+// cgroup that distributes controllers to children, the core first moves
+// itself into a "logos-core" leaf. Anything that fails here makes init()
+// return false and the caller carries on without cgroups.
+//
+// Thread-safe.
+class CgroupManager {
+public:
+    explicit CgroupManager(std::string root = {});
+
+    CgroupManager(const CgroupManager&) = delete;
+    CgroupManager& operator=(const CgroupManager&) = delete;
+
+    // Resolve and prepare the root: move ourselves out if we live in it and
+    // enable the cpu/memory/pids controllers it offers for its children.
+    bool init();
+
+    const std::string& root() const { return m_root; }
+    bool hasController(const std::string& name) const;
+
+    void setPolicy(const nlohmann::json& policy);
+    CgroupLimits limitsFor(const ModuleDescriptor& desc) const;
+
+    // Create (or reuse) the module's leaf, apply its limits and move `pid`
+    // into it. False (with a warning) if the pid cannot be moved; the module
+    // then keeps running in the host's cgroup.
+    bool place(const ModuleDescriptor& desc, int64_t pid);
+
+    // Forget the module and remove its leaf. A leaf that still has live
+    // processes cannot be removed; it is reused on the next place().
+    void release(const std::string& name);
+    void releaseAll();
+
+    std::optional<std::string> leafOf(const std::string& name) const;
+    std::optional<CgroupStats> stats(const std::string& name) const;
+    std::optional<CgroupStats> statsForPid(int64_t pid) const;
+
+    // The process's own cgroup2 directory, from /proc/self/cgroup, under
+    // /sys/fs/cgroup. Empty if not on a unified hierarchy.
+    static std::string ownCgroupDir();
+
+private:
+    struct Leaf {
+        std::string path;
+        int64_t pid = 0;
+    };
+
+    std::string leafPath(const std::string& name) const;
+    void applyLimits(const std::string& leaf, const CgroupLimits& limits) const;
+    static std::optional<CgroupStats> readStats(const std::string& leaf);
+
+    std::string m_root;
+    std::vector<std::string> m_controllers;   // enabled in cgroup.subtree_control
+
+    mutable std::mutex m_mutex;
+    nlohmann::json m_policy = nlohmann::json::object();
+    std::unordered_map<std::string, Leaf> m_leaves;
+};
+
+} // namespace LogosCore
+
+#endif // CGROUP_MANAGER_H
@@ -1,7 +1,87 @@
 #include "composite_module_loader.h"
 
+#include <spdlog/spdlog.h>
+
+#include <exception>
+#include <functional>
+#include <iterator>
+#include <tuple>
+
 namespace LogosCore {
 
+namespace {
+
+constexpr int kTemplateFields = 4;
+// Each distinct set of non-templated inputs gets its own entry; past this
+// many, the least recently used one is forgotten.
+constexpr std::size_t kMaxArgTemplates = 256;
+
+// The fields a launch fills into an argument template, in ArgPiece::field
+// order.
+std::string* templateField(ModuleDescriptor& desc, int field)
+{
+    switch (field) {
+    case 0: return &desc.name;
+    case 1: return &desc.path;
+    case 2: return &desc.instancePersistencePath;
+    case 3: return &desc.transportSetJson;
+    }
+    return nullptr;
+}
+
+const std::string& templateField(const ModuleDescriptor& desc, int field)
+{
+    return *templateField(const_cast<ModuleDescriptor&>(desc), field);
+}
+
+// Stands in for a field while the template is built. Control characters keep
+// it from colliding with anything a format loader writes itself.
+std::string placeholder(int field)
+{
+    return "\x1f@logos-field-" + std::to_string(field) + "@\x1f";
+}
+
+std::string variantOf(const ModuleDescriptor& desc)
+{
+    auto it = desc.loaderConfig.find("variant");
+    return it != desc.loaderConfig.end() && it->is_string() ? it->get<std::string>() : std::string();
+}
+
+// Which fields are set: a format loader may leave out the flag of an empty
+// one, so each combination gets its own template.
+unsigned setFieldMask(const ModuleDescriptor& desc)
+{
+    unsigned mask = 0;
+    for (int f = 0; f < kTemplateFields; ++f)
+        if (!templateField(desc, f).empty())
+            mask |= 1u << f;
+    return mask;
+}
+
+void hashInto(std::size_t& seed, std::size_t value)
+{
+    seed ^= value + 0x9e3779b9 + (seed << 6) + (seed >> 2);
+}
+
+// Hash of everything else buildArguments() may read. A template only fills
+// in the four fields above, so the rest must match exactly for it to apply:
+// replica and upgrade launches differ from the primary only in loaderConfig.
+std::size_t templateHash(const ModuleDescriptor& desc, unsigned fields)
+{
+    std::size_t seed = std::hash<std::string>{}(desc.format);
+    hashInto(seed, fields);
+    hashInto(seed, std::hash<nlohmann::json>{}(desc.loaderConfig));
+    hashInto(seed, std::hash<nlohmann::json>{}(desc.rawMetadata));
+    for (const auto* list : {&desc.dependencies, &desc.modulesDirs}) {
+        hashInto(seed, list->size());
+        for (const auto& item : *list)
+            hashInto(seed, std::hash<std::string>{}(item));
+    }
+    return seed;
+}
+
+} // anonymous namespace
+
 CompositeModuleLoader::CompositeModuleLoader(std::shared_ptr<ModuleContainer> container,
                                              std::shared_ptr<ModuleFormatLoader> loader)
     : container_(std::move(container))
@@ -22,12 +102,210 @@ bool CompositeModuleLoader::load(const ModuleDescriptor& desc,
                                  std::function<void(const std::string& name)> onTerminated,
                                  LoadedModuleHandle& out)
 {
-    std::string host = loader_->resolveHostBinary(desc);
+    std::string host = hostFor(desc);
     if (host.empty())
         return false;
 
+    auto args = argumentsFor(desc);
+    auto cgroups = this->cgroups();
+    auto placement = this->placement();
+    auto capture = this->logCapture();
+    uint64_t captureId = 0;
+    if (capture) {
+        if (auto redirect = capture->open(desc.name)) {
+            std::tie(host, args) = LogCapture::wrapCommand(*redirect, host, args);
+            captureId = redirect->id;
+        } else {
+            capture.reset();   // launch uncaptured rather than not at all
+        }
+    }
+    if (!cgroups && !placement && !capture) {
+        if (container_->launch(desc, host, args, std::move(onTerminated), out))
+            return true;
+        std::lock_guard lock(launchCacheMutex_);
+        hosts_.erase({desc.format, variantOf(desc)});   // re-probe next time
+        return false;
+    }
+
+    // Drop the leaf / balancer slot / capture when the process goes away on
+    // its own, too.
+    auto released = [cgroups, placement, capture, captureId,
+                     onTerminated = std::move(onTerminated)](const std::string& name) {
+        if (cgroups)
+            cgroups->release(name);
+        if (placement)
+            placement->release(name);
+        if (capture)
+            capture->close(name, captureId);
+        if (onTerminated)
+            onTerminated(name);
+    };
+    if (!container_->launch(desc, host, args, std::move(released), out)) {
+        if (capture)
+            capture->close(desc.name, captureId);
+        std::lock_guard lock(launchCacheMutex_);
+        hosts_.erase({desc.format, variantOf(desc)});
+        return false;
+    }
+    if (out.pid > 0) {
+        if (cgroups)
+            cgroups->place(desc, out.pid);
+        if (placement)
+            placement->place(desc, out.pid);
+    }
+    return true;
+}
+
+std::string CompositeModuleLoader::hostFor(const ModuleDescriptor& desc)
+{
+    HostKey key{desc.format, variantOf(desc)};
+    {
+        std::lock_guard lock(launchCacheMutex_);
+        if (auto it = hosts_.find(key); it != hosts_.end())
+            return it->second;
+    }
+    // Resolve outside the lock: it probes the filesystem. A racing load may
+    // resolve the same key too; both get the same answer.
+    std::string host = loader_->resolveHostBinary(desc);
+    if (!host.empty()) {   // not found stays uncached, so a later install is seen
+        std::lock_guard lock(launchCacheMutex_);
+        hosts_.emplace(std::move(key), host);
+    }
+    return host;
+}
+
+CompositeModuleLoader::TemplateList::iterator
+CompositeModuleLoader::findTemplateLocked(std::size_t hash, const ModuleDescriptor& desc)
+{
+    const unsigned fields = setFieldMask(desc);
+    auto [begin, end] = templateIndex_.equal_range(hash);
+    for (auto it = begin; it != end; ++it) {
+        const TemplateEntry& e = *it->second;
+        if (e.fields == fields && e.format == desc.format && e.loaderConfig == desc.loaderConfig
+            && e.rawMetadata == desc.rawMetadata && e.dependencies == desc.dependencies
+            && e.modulesDirs == desc.modulesDirs)
+            return it->second;
+    }
+    return templates_.end();
+}
+
+std::vector<std::string> CompositeModuleLoader::argumentsFor(const ModuleDescriptor& desc)
+{
+    const std::size_t hash = templateHash(desc, setFieldMask(desc));
+    std::shared_ptr<const ArgTemplate> cached;
+    bool probe = false;
+    {
+        std::lock_guard lock(launchCacheMutex_);
+        auto it = findTemplateLocked(hash, desc);
+        if (it != templates_.end()) {
+            templates_.splice(templates_.begin(), templates_, it);
+            cached = it->tmpl;
+            probe = !it->probed;   // second load of the key: worth a template
+            it->probed = true;
+        } else {
+            // First load of the key: remember it, but don't pay for a
+            // template a module loaded once would never use.
+            if (templates_.size() >= kMaxArgTemplates) {
+                const auto last = std::prev(templates_.end());
+                auto [begin, end] = templateIndex_.equal_range(last->hash);
+                for (auto at = begin; at != end; ++at) {
+                    if (at->second == last) {
+                        templateIndex_.erase(at);
+                        break;
+                    }
+                }
+                templates_.erase(last);
+            }
+            templates_.push_front({hash, desc.format, setFieldMask(desc), desc.loaderConfig,
+                                   desc.rawMetadata, desc.dependencies, desc.modulesDirs});
+            templateIndex_.emplace(hash, templates_.begin());
+        }
+    }
+    if (cached)
+        return instantiate(*cached, desc);
+
     auto args = loader_->buildArguments(desc);
-    return container_->launch(desc, host, args, std::move(onTerminated), out);
+    if (!probe)
+        return args;
+    auto tmpl = makeTemplate(desc, args);
+    if (!tmpl) {
+        spdlog::debug("Arguments of format loader {} are not templatable; building them per load",
+                      loader_->id());
+        return args;
+    }
+    std::lock_guard lock(launchCacheMutex_);
+    if (auto it = findTemplateLocked(hash, desc); it != templates_.end())   // unless evicted meanwhile
+        it->tmpl = std::move(tmpl);
+    return args;
+}
+
+std::shared_ptr<const CompositeModuleLoader::ArgTemplate>
+CompositeModuleLoader::makeTemplate(const ModuleDescriptor& desc,
+                                    const std::vector<std::string>& args) const
+{
+    // Build once more with placeholders in the per-module fields and record
+    // where they land. Kept only if filling the fields back in reproduces
+    // `args`: a loader that rewrites a field (canonicalizes the path,
+    // re-serializes the transport set) or derives an argument from one can't
+    // be templated.
+    ModuleDescriptor probe = desc;
+    for (int f = 0; f < kTemplateFields; ++f)
+        if (!templateField(desc, f).empty())
+            *templateField(probe, f) = placeholder(f);
+
+    auto tmpl = std::make_shared<ArgTemplate>();
+    try {
+        for (const auto& arg : loader_->buildArguments(probe)) {
+            std::vector<ArgPiece> pieces;
+            std::size_t pos = 0;
+            while (pos < arg.size()) {
+                std::size_t next = std::string::npos;
+                int field = -1;
+                for (int f = 0; f < kTemplateFields; ++f) {
+                    auto at = arg.find(placeholder(f), pos);
+                    if (at < next) {
+                        next = at;
+                        field = f;
+                    }
+                }
+                if (next > pos)
+                    pieces.push_back({arg.substr(pos, next - pos)});
+                if (field < 0)
+                    break;
+                pieces.push_back({{}, field});
+                pos = next + placeholder(field).size();
+            }
+            tmpl->push_back(std::move(pieces));
+        }
+    } catch (const std::exception& e) {
+        spdlog::debug("Format loader {} rejected the template probe: {}", loader_->id(), e.what());
+        return nullptr;
+    }
+    if (instantiate(*tmpl, desc) != args)
+        return nullptr;
+    return tmpl;
+}
+
+std::vector<std::string> CompositeModuleLoader::instantiate(const ArgTemplate& tmpl,
+                                                            const ModuleDescriptor& desc)
+{
+    std::vector<std::string> args;
+    args.reserve(tmpl.size());
+    for (const auto& pieces : tmpl) {
+        std::string arg;
+        for (const auto& piece : pieces)
+            arg += piece.field < 0 ? piece.text : templateField(desc, piece.field);
+        args.push_back(std::move(arg));
+    }
+    return args;
+}
+
+void CompositeModuleLoader::clearLaunchCache()
+{
+    std::lock_guard lock(launchCacheMutex_);
+    hosts_.clear();
+    templates_.clear();
+    templateIndex_.clear();
 }
 
 bool CompositeModuleLoader::sendToken(const std::string& name, const std::string& token)
@@ -38,11 +316,23 @@ bool CompositeModuleLoader::sendToken(const std::string& name, const std::string
 void CompositeModuleLoader::terminate(const std::string& name)
 {
     container_->terminate(name);
+    if (auto cgroups = this->cgroups())
+        cgroups->release(name);
+    if (auto placement = this->placement())
+        placement->release(name);
+    if (auto capture = this->logCapture())
+        capture->close(name);
 }
 
 void CompositeModuleLoader::terminateAll()
 {
     container_->terminateAll();
+    if (auto cgroups = this->cgroups())
+        cgroups->releaseAll();
+    if (auto placement = this->placement())
+        placement->releaseAll();
+    if (auto capture = this->logCapture())
+        capture->closeAll();
 }
 
 bool CompositeModuleLoader::hasModule(const std::string& name) const
@@ -60,4 +350,34 @@ std::unordered_map<std::string, int64_t> CompositeModuleLoader::getAllPids() con
     return container_->getAllPids();
 }
 
+void CompositeModuleLoader::setCgroups(std::shared_ptr<CgroupManager> cgroups)
+{
+    std::atomic_store(&cgroups_, std::move(cgroups));
+}
+
+std::shared_ptr<CgroupManager> CompositeModuleLoader::cgroups() const
+{
+    return std::atomic_load(&cgroups_);
+}
+
+void CompositeModuleLoader::setPlacement(std::shared_ptr<CpuPlacement> placement)
+{
+    std::atomic_store(&placement_, std::move(placement));
+}
+
+std::shared_ptr<CpuPlacement> CompositeModuleLoader::placement() const
+{
+    return std::atomic_load(&placement_);
+}
+
+void CompositeModuleLoader::setLogCapture(std::shared_ptr<LogCapture> capture)
+{
+    std::atomic_store(&capture_, std::move(capture));
+}
+
+std::shared_ptr<LogCapture> CompositeModuleLoader::logCapture() const
+{
+    return std::atomic_load(&capture_);
+}
+
 } // namespace LogosCore
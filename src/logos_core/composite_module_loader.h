@@ -2,15 +2,36 @@
 #define COMPOSITE_MODULE_LOADER_H
 
 #include "module_loader.h"
+#include "cgroup_manager.h"
+#include "cpu_placement.h"
+#include "log_capture.h"
 #include <logos_container/module_container.h>
 #include <logos_module_loader/module_format_loader.h>
+#include <nlohmann/json.hpp>
+#include <list>
+#include <map>
 #include <memory>
+#include <mutex>
+#include <string>
+#include <tuple>
+#include <unordered_map>
+#include <vector>
 
 namespace LogosCore {
 
 // Pairs a ModuleContainer (where/how to run) with a ModuleFormatLoader (what to
 // load) and presents the combined result as a single ModuleLoader — the
 // interface that ModuleLoaderRegistry and ModuleManager already understand.
+//
+// Launch inputs are memoized: the host binary per (format, variant) — the
+// variant being loaderConfig["variant"], empty when absent — and the argument
+// vector as a template per (format, which per-module fields are set, all other
+// descriptor inputs: loaderConfig, rawMetadata, dependencies, modulesDirs),
+// into which each load fills its name, path, persistence path and transport
+// set. Since rawMetadata usually differs per module, a key's first load just
+// calls buildArguments(); the second also builds the template, which is only
+// kept if it reproduces buildArguments() for that load. The least recently
+// used keys are forgotten past a fixed number.
 class CompositeModuleLoader : public ModuleLoader {
 public:
     CompositeModuleLoader(std::shared_ptr<ModuleContainer> container,
@@ -33,9 +54,71 @@ public:
     ModuleContainer& container() { return *container_; }
     const ModuleContainer& container() const { return *container_; }
 
+    // Place every process launched from now on into its own cgroup leaf
+    // (see cgroup_manager.h); null turns placement off. Placement happens
+    // right after launch, so the module runs briefly in the host's cgroup.
+    void setCgroups(std::shared_ptr<CgroupManager> cgroups);
+    std::shared_ptr<CgroupManager> cgroups() const;
+
+    // Pin every process launched from now on to CPUs per `placement` (see
+    // cpu_placement.h), right after launch and after any cgroup move; null
+    // turns pinning off.
+    void setPlacement(std::shared_ptr<CpuPlacement> placement);
+    std::shared_ptr<CpuPlacement> placement() const;
+
+    // Capture stdout/stderr of every process launched from now on (see
+    // log_capture.h) by wrapping its launch command; null turns it off.
+    // Modules already running keep their capture until they terminate.
+    void setLogCapture(std::shared_ptr<LogCapture> capture);
+    std::shared_ptr<LogCapture> logCapture() const;
+
+    // Forget memoized host binaries and argument templates, e.g. after the
+    // host package was replaced. A failed launch also drops its host entry.
+    void clearLaunchCache();
+
 private:
+    // One argument of a template: literal text, or a per-module field
+    // (index into the name/path/persistence/transport quadruple).
+    struct ArgPiece {
+        std::string text;
+        int field = -1;
+    };
+    using ArgTemplate = std::vector<std::vector<ArgPiece>>;
+    using HostKey = std::tuple<std::string, std::string>;                // format, variant
+    // Every descriptor input buildArguments() may read besides the templated
+    // fields, and what is known about its arguments.
+    struct TemplateEntry {
+        std::size_t hash = 0;
+        std::string format;
+        unsigned fields = 0;   // which templated fields are set
+        nlohmann::json loaderConfig;
+        nlohmann::json rawMetadata;
+        std::vector<std::string> dependencies;
+        std::vector<std::string> modulesDirs;
+        bool probed = false;                        // a load has tried to build the template
+        std::shared_ptr<const ArgTemplate> tmpl;    // null: not (yet) templatable
+    };
+    using TemplateList = std::list<TemplateEntry>;   // most recently used first
+
+    std::string hostFor(const ModuleDescriptor& desc);
+    std::vector<std::string> argumentsFor(const ModuleDescriptor& desc);
+    TemplateList::iterator findTemplateLocked(std::size_t hash, const ModuleDescriptor& desc);
+    // Null when buildArguments() output for `desc` can't be templated.
+    std::shared_ptr<const ArgTemplate> makeTemplate(const ModuleDescriptor& desc,
+                                                    const std::vector<std::string>& args) const;
+    static std::vector<std::string> instantiate(const ArgTemplate& tmpl, const ModuleDescriptor& desc);
+
+
     std::shared_ptr<ModuleContainer> container_;
     std::shared_ptr<ModuleFormatLoader> loader_;
+    std::shared_ptr<CgroupManager> cgroups_;     // atomic_load/atomic_store only
+    std::shared_ptr<CpuPlacement> placement_;    // atomic_load/atomic_store only
+    std::shared_ptr<LogCapture> capture_;        // atomic_load/atomic_store only
+
+    std::mutex launchCacheMutex_;
+    std::map<HostKey, std::string> hosts_;
+    TemplateList templates_;
+    std::unordered_multimap<std::size_t, TemplateList::iterator> templateIndex_;   // by templateHash()
 };
 
 } // namespace LogosCore
@@ -0,0 +1,298 @@
+#include "cpu_placement.h"
+
+#include <spdlog/spdlog.h>
+#include <algorithm>
+#include <cctype>
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <limits>
+#include <sstream>
+
+#ifdef __linux__
+#include <dirent.h>
+#include <sched.h>
+#endif
+
+namespace LogosCore {
+
+namespace {
+
+std::string readLine(const std::string& path)
+{
+    std::ifstream in(path);
+    std::string line;
+    std::getline(in, line);
+    return line;
+}
+
+} // namespace
+
+std::optional<std::vector<int>> parseCpuList(const std::string& text)
+{
+    std::vector<int> cpus;
+    std::stringstream ss(text);
+    std::string range;
+    while (std::getline(ss, range, ',')) {
+        range.erase(std::remove_if(range.begin(), range.end(), ::isspace), range.end());
+        if (range.empty())
+            continue;
+        char* end = nullptr;
+        const long lo = std::strtol(range.c_str(), &end, 10);
+        long hi = lo;
+        if (end == range.c_str() || lo < 0)
+            return std::nullopt;
+        if (*end == '-') {
+            const char* start = end + 1;
+            hi = std::strtol(start, &end, 10);
+            if (end == start || hi < lo)
+                return std::nullopt;
+        }
+        if (*end != '\0' || hi > 65535)
+            return std::nullopt;
+        for (long c = lo; c <= hi; ++c)
+            cpus.push_back(static_cast<int>(c));
+    }
+    std::sort(cpus.begin(), cpus.end());
+    cpus.erase(std::unique(cpus.begin(), cpus.end()), cpus.end());
+    return cpus;
+}
+
+std::string formatCpuList(const std::vector<int>& cpus)
+{
+    std::string out;
+    for (std::size_t i = 0; i < cpus.size();) {
+        std::size_t j = i;
+        while (j + 1 < cpus.size() && cpus[j + 1] == cpus[j] + 1)
+            ++j;
+        if (!out.empty())
+            out += ',';
+        out += std::to_string(cpus[i]);
+        if (j > i)
+            out += '-' + std::to_string(cpus[j]);
+        i = j + 1;
+    }
+    return out;
+}
+
+// ── CpuTopology ─────────────────────────────────────────────────────────────
+
+CpuTopology CpuTopology::detect(const std::string& sysfsRoot)
+{
+    namespace fs = std::filesystem;
+    CpuTopology t;
+    const std::string cpuDir = sysfsRoot + "/devices/system/cpu";
+    t.online = parseCpuList(readLine(cpuDir + "/online")).value_or(std::vector<int>{});
+    t.isolated = parseCpuList(readLine(cpuDir + "/isolated")).value_or(std::vector<int>{});
+
+    std::error_code ec;
+    for (const auto& entry : fs::directory_iterator(sysfsRoot + "/devices/system/node", ec)) {
+        const std::string name = entry.path().filename().string();
+        if (name.size() <= 4 || name.compare(0, 4, "node") != 0
+            || name.find_first_not_of("0123456789", 4) != std::string::npos)
+            continue;
+        auto cpus = parseCpuList(readLine(entry.path().string() + "/cpulist"));
+        if (!cpus || cpus->empty())
+            continue;   // memory-only node
+        t.nodes.push_back({std::atoi(name.c_str() + 4), std::move(*cpus)});
+    }
+    std::sort(t.nodes.begin(), t.nodes.end(), [](const Node& a, const Node& b) { return a.id < b.id; });
+    if (t.nodes.empty() && !t.online.empty())
+        t.nodes.push_back({0, t.online});
+    return t;
+}
+
+// ── CpuPlacement ────────────────────────────────────────────────────────────
+
+CpuPlacement::CpuPlacement(CpuTopology topology, ApplyFn apply)
+    : m_topology(std::move(topology))
+    , m_apply(apply ? std::move(apply) : ApplyFn(&CpuPlacement::applyAffinity))
+{}
+
+void CpuPlacement::setPolicy(const nlohmann::json& policy)
+{
+    std::lock_guard lock(m_mutex);
+    m_policy = policy.is_object() ? policy : nlohmann::json::object();
+}
+
+std::vector<int> CpuPlacement::withoutIsolated(const std::vector<int>& cpus) const
+{
+    std::vector<int> out;
+    std::set_difference(cpus.begin(), cpus.end(),
+                        m_topology.isolated.begin(), m_topology.isolated.end(),
+                        std::back_inserter(out));
+    return out.empty() ? cpus : out;
+}
+
+std::optional<CpuPlacement::Assignment> CpuPlacement::resolveLocked(const ModuleDescriptor& desc) const
+{
+    nlohmann::json spec;
+    if (auto modules = m_policy.find("modules"); modules != m_policy.end() && modules->is_object())
+        spec = modules->value(desc.name, nlohmann::json());
+    if (!spec.is_object())
+        if (auto it = desc.rawMetadata.find("placement"); it != desc.rawMetadata.end())
+            spec = *it;
+    if (!spec.is_object())
+        spec = m_policy.value("default", nlohmann::json());
+    if (!spec.is_object())
+        spec = nlohmann::json::object();
+
+    auto flag = [&](const char* key) {
+        auto it = spec.find(key);
+        return it != spec.end() && it->is_boolean() && it->get<bool>();
+    };
+
+    if (flag("none"))
+        return std::nullopt;
+
+    if (auto it = spec.find("cpus"); it != spec.end()) {
+        auto cpus = it->is_string() ? parseCpuList(it->get<std::string>()) : std::nullopt;
+        std::vector<int> usable;
+        if (cpus)
+            std::set_intersection(cpus->begin(), cpus->end(),
+                                  m_topology.online.begin(), m_topology.online.end(),
+                                  std::back_inserter(usable));
+        if (usable.empty()) {
+            spdlog::warn("CPU placement: no online CPUs in {} for {}; leaving it unpinned",
+                         it->dump(), desc.name);
+            return std::nullopt;
+        }
+        return Assignment{std::move(usable), -1};
+    }
+
+    if (auto it = spec.find("numa_node"); it != spec.end()) {
+        const int id = it->is_number_integer() ? it->get<int>() : -1;
+        for (const auto& node : m_topology.nodes)
+            if (node.id == id)
+                return Assignment{withoutIsolated(node.cpus), node.id};
+        spdlog::warn("CPU placement: unknown NUMA node {} for {}; leaving it unpinned", it->dump(), desc.name);
+        return std::nullopt;
+    }
+
+    if (flag("isolated")) {
+        if (m_topology.isolated.empty()) {
+            spdlog::warn("CPU placement: {} asks for isolated CPUs but the host has none; leaving it unpinned",
+                         desc.name);
+            return std::nullopt;
+        }
+        return Assignment{m_topology.isolated, -1};
+    }
+
+    // Balancer.
+    if (m_topology.nodes.size() < 2)
+        return std::nullopt;
+    std::unordered_map<int, std::size_t> load;
+    for (const auto& [name, a] : m_assignments)
+        if (a.node >= 0 && name != desc.name)
+            ++load[a.node];
+    const CpuTopology::Node* best = nullptr;
+    std::size_t bestLoad = std::numeric_limits<std::size_t>::max();
+    for (const auto& node : m_topology.nodes) {
+        const std::size_t l = load[node.id];
+        if (l < bestLoad) {
+            best = &node;
+            bestLoad = l;
+        }
+    }
+    return Assignment{withoutIsolated(best->cpus), best->id};
+}
+
+std::optional<std::vector<int>> CpuPlacement::place(const ModuleDescriptor& desc, int64_t pid)
+{
+    if (pid <= 0)
+        return std::nullopt;
+
+    std::optional<Assignment> a;
+    {
+        std::lock_guard lock(m_mutex);
+        a = resolveLocked(desc);
+        if (!a) {
+            m_assignments.erase(desc.name);
+            return std::nullopt;
+        }
+        m_assignments[desc.name] = *a;   // reserve the balancer slot before applying
+    }
+
+    if (!m_apply(pid, a->cpus)) {
+        spdlog::warn("CPU placement: cannot pin {} (pid {}) to CPUs {}: {}",
+                     desc.name, pid, formatCpuList(a->cpus), std::strerror(errno));
+        std::lock_guard lock(m_mutex);
+        m_assignments.erase(desc.name);
+        return std::nullopt;
+    }
+    spdlog::debug("CPU placement: {} pinned to CPUs {}", desc.name, formatCpuList(a->cpus));
+    return a->cpus;
+}
+
+void CpuPlacement::release(const std::string& name)
+{
+    std::lock_guard lock(m_mutex);
+    m_assignments.erase(name);
+}
+
+void CpuPlacement::releaseAll()
+{
+    std::lock_guard lock(m_mutex);
+    m_assignments.clear();
+}
+
+std::optional<CpuPlacement::Assignment> CpuPlacement::assignmentOf(const std::string& name) const
+{
+    std::lock_guard lock(m_mutex);
+    auto it = m_assignments.find(name);
+    if (it == m_assignments.end())
+        return std::nullopt;
+    return it->second;
+}
+
+bool CpuPlacement::supported()
+{
+#ifdef __linux__
+    return true;
+#else
+    return false;
+#endif
+}
+
+bool CpuPlacement::applyAffinity(int64_t pid, const std::vector<int>& cpus)
+{
+#ifdef __linux__
+    if (pid <= 0 || cpus.empty())
+        return false;
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    for (int c : cpus)
+        if (c >= 0 && c < CPU_SETSIZE)
+            CPU_SET(c, &set);
+
+    // sched_setaffinity targets one thread; walk them all.
+    const std::string taskDir = "/proc/" + std::to_string(pid) + "/task";
+    DIR* dir = ::opendir(taskDir.c_str());
+    if (!dir)
+        return ::sched_setaffinity(static_cast<pid_t>(pid), sizeof(set), &set) == 0;
+    bool any = false;
+    bool ok = true;
+    while (const dirent* d = ::readdir(dir)) {
+        if (d->d_name[0] == '.')
+            continue;
+        const pid_t tid = static_cast<pid_t>(std::atol(d->d_name));
+        if (::sched_setaffinity(tid, sizeof(set), &set) == 0)
+            any = true;
+        else if (errno != ESRCH)   // a thread that just exited is fine
+            ok = false;
+    }
+    const int err = errno;
+    ::closedir(dir);
+    errno = err;
+    return any && ok;
+#else
+    (void)pid;
+    (void)cpus;
+    errno = ENOSYS;
+    return false;
+#endif
+}
+
+} // namespace LogosCore
@@ -0,0 +1,103 @@
+#ifndef CPU_PLACEMENT_H
+#define CPU_PLACEMENT_H
+
+#include <logos_container/module_descriptor.h>
+#include <nlohmann/json.hpp>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace LogosCore {
+
+// CPUs and NUMA nodes of the host, as the kernel reports them in sysfs.
+struct CpuTopology {
+    struct Node {
+        int id = 0;
+        std::vector<int> cpus;
+    };
+    std::vector<int> online;
+    std::vector<int> isolated;   // isolcpus= / nohz_full set aside by the admin
+    std::vector<Node> nodes;     // a single node 0 when NUMA is absent
+
+    // Read <sysfsRoot>/devices/system/{cpu,node}. Falls back to one node
+    // holding every online CPU.
+    static CpuTopology detect(const std::string& sysfsRoot = "/sys");
+};
+
+// "0-3,8,10-11" <-> {0,1,2,3,8,10,11}. Parsing returns nullopt on malformed
+// input; the output is sorted and de-duplicated.
+std::optional<std::vector<int>> parseCpuList(const std::string& text);
+std::string formatCpuList(const std::vector<int>& cpus);
+
+// Pins module processes to CPUs right after launch.
+//
+// Each module's placement comes, highest precedence first, from the host
+// policy's per-module entry, its "placement" metadata, or the policy default:
+//   { "cpus": "0-3" }        explicit core set
+//   { "numa_node": 1 }       every (non-isolated) CPU of one node
+//   { "isolated": true }     the host's isolated CPU list
+//   { "auto": true }         let the balancer choose (the default)
+//   { "none": true }         leave the scheduler's default affinity
+// Host policy: { "default": {...}, "modules": { "<name>": {...} } }.
+//
+// The balancer assigns each auto-placed module to the NUMA node with the
+// fewest modules currently placed on it (lowest id on ties) and pins it to
+// that node's non-isolated CPUs. On a single-node host it leaves affinity
+// alone — there is nothing to spread across.
+//
+// Affinity is applied to every thread the process has when it is placed;
+// threads it starts later inherit it. Memory is not migrated: with the
+// kernel's default local allocation it follows the pinned CPUs.
+//
+// Thread-safe.
+class CpuPlacement {
+public:
+    using ApplyFn = std::function<bool(int64_t pid, const std::vector<int>& cpus)>;
+
+    explicit CpuPlacement(CpuTopology topology = CpuTopology::detect(), ApplyFn apply = {});
+
+    CpuPlacement(const CpuPlacement&) = delete;
+    CpuPlacement& operator=(const CpuPlacement&) = delete;
+
+    void setPolicy(const nlohmann::json& policy);
+
+    // Resolve and apply `desc`'s placement to `pid`. Returns the CPUs it was
+    // pinned to, or nullopt when it was left alone or pinning failed (with a
+    // warning; the module keeps running unpinned).
+    std::optional<std::vector<int>> place(const ModuleDescriptor& desc, int64_t pid);
+
+    // Forget the module (its balancer slot frees up).
+    void release(const std::string& name);
+    void releaseAll();
+
+    struct Assignment {
+        std::vector<int> cpus;
+        int node = -1;   // -1 unless placed by numa_node or the balancer
+    };
+    std::optional<Assignment> assignmentOf(const std::string& name) const;
+
+    const CpuTopology& topology() const { return m_topology; }
+
+    // sched_setaffinity on every thread of `pid`. False off Linux.
+    static bool applyAffinity(int64_t pid, const std::vector<int>& cpus);
+    static bool supported();
+
+private:
+    std::optional<Assignment> resolveLocked(const ModuleDescriptor& desc) const;
+    std::vector<int> withoutIsolated(const std::vector<int>& cpus) const;
+
+    CpuTopology m_topology;
+    ApplyFn m_apply;
+
+    mutable std::mutex m_mutex;
+    nlohmann::json m_policy = nlohmann::json::object();
+    std::unordered_map<std::string, Assignment> m_assignments;
+};
+
+} // namespace LogosCore
+
+#endif // CPU_PLACEMENT_H
@@ -1,4 +1,5 @@
 #include "dependency_resolver.h"
+#include "lifecycle_trace.h"
 #include <spdlog/spdlog.h>
 #include <unordered_set>
 #include <unordered_map>
@@ -11,6 +12,7 @@ namespace DependencyResolver {
     ResolveResult resolve(const std::vector<std::string>& requested,
                           IsKnownFn isKnown,
                           GetDependenciesFn getDependencies) {
+        LifecycleTrace::Span span("resolve_dependencies", "resolver");
         ResolveResult out;
 
         std::unordered_set<std::string> modulesToLoad;
@@ -0,0 +1,423 @@
+#include "event_journal.h"
+
+#include <nlohmann/json.hpp>
+#include <spdlog/spdlog.h>
+#include <algorithm>
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <mutex>
+#include <thread>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+namespace EventJournal {
+
+namespace detail {
+std::atomic<bool> g_enabled{false};
+}
+
+namespace {
+
+constexpr std::size_t kNameChunk = 16;
+
+// stop() parks the reservation counter here, so a writer that raced past the
+// enabled() check gets an index no session can own and is not counted as a
+// drop.
+constexpr uint64_t kClosed = uint64_t{1} << 62;
+
+struct SessionState {
+    std::mutex mutex;             // start/stop and interning
+    int fd = -1;
+    void* mapping = nullptr;
+    std::size_t mappedBytes = 0;
+    std::unordered_map<std::string, uint32_t> ids;
+};
+
+SessionState& state()
+{
+    static SessionState s;
+    return s;
+}
+
+// Hot-path state, read by writers without the session mutex. start()
+// publishes g_records/g_capacity before resetting g_next.
+std::atomic<Record*> g_records{nullptr};
+std::atomic<uint64_t> g_capacity{0};
+std::atomic<uint64_t> g_next{kClosed};
+std::atomic<uint64_t> g_committed{0};
+std::atomic<uint64_t> g_dropped{0};
+
+// Bumped by start(), so each thread drops module ids cached in an earlier
+// session.
+std::atomic<uint64_t> g_session{0};
+
+// Per-thread copy of the session's name -> id table: once a thread has seen
+// a module, its events resolve the id without touching the session mutex.
+struct IdCache {
+    uint64_t session = 0;
+    std::unordered_map<std::string, uint32_t> ids;
+};
+
+IdCache& idCache()
+{
+    thread_local IdCache cache;
+    return cache;
+}
+
+void write(Record rec) noexcept
+{
+    const uint64_t idx = g_next.fetch_add(1, std::memory_order_acquire);
+    if (idx >= g_capacity.load(std::memory_order_relaxed)) {
+        if (idx < kClosed)
+            g_dropped.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+    Record* slot = g_records.load(std::memory_order_relaxed) + idx;
+    // Publish the type last so a reader of a live file never sees a
+    // half-written record as valid.
+    const uint16_t type = rec.type;
+    rec.type = 0;
+    std::memcpy(slot, &rec, sizeof rec);
+    __atomic_store_n(&slot->type, type, __ATOMIC_RELEASE);
+    g_committed.fetch_add(1, std::memory_order_release);
+}
+
+void journalError(std::string* error, std::string message)
+{
+    if (error)
+        *error = std::move(message);
+}
+
+uint32_t internLocked(const std::string& name)
+{
+    SessionState& s = state();
+    std::lock_guard lock(s.mutex);
+    auto [it, inserted] = s.ids.try_emplace(name, static_cast<uint32_t>(s.ids.size() + 1));
+    if (!inserted || !enabled())
+        return it->second;
+
+    const std::size_t chunks = std::max<std::size_t>(1, (name.size() + kNameChunk - 1) / kNameChunk);
+    for (std::size_t chunk = 0; chunk < chunks; ++chunk) {
+        const std::size_t offset = chunk * kNameChunk;
+        Record rec{};
+        if (offset < name.size())
+            std::memcpy(&rec.timestampNs, name.data() + offset,
+                        std::min(kNameChunk, name.size() - offset));
+        rec.moduleId = it->second;
+        rec.type = static_cast<uint16_t>(Event::ModuleName);
+        rec.result = static_cast<uint16_t>(chunk);
+        rec.aux = static_cast<uint32_t>(name.size());
+        write(rec);
+    }
+    return it->second;
+}
+
+} // anonymous namespace
+
+namespace detail {
+
+uint32_t intern(const std::string& name)
+{
+    IdCache& cache = idCache();
+    const uint64_t session = g_session.load(std::memory_order_acquire);
+    if (cache.session != session) {
+        cache.ids.clear();
+        cache.session = session;
+    } else if (auto it = cache.ids.find(name); it != cache.ids.end()) {
+        return it->second;
+    }
+    const uint32_t id = internLocked(name);
+    cache.ids.emplace(name, id);
+    return id;
+}
+
+void append(Event event, uint32_t moduleId, uint64_t timestampNs, uint64_t durationNs,
+            uint16_t result, uint32_t aux) noexcept
+{
+    Record rec{};
+    rec.timestampNs = timestampNs;
+    rec.durationNs = durationNs;
+    rec.moduleId = moduleId;
+    rec.type = static_cast<uint16_t>(event);
+    rec.result = result;
+    rec.aux = aux;
+    write(rec);
+}
+
+} // namespace detail
+
+bool start(const std::string& path, std::size_t capacity)
+{
+    if (path.empty() || capacity == 0)
+        return false;
+#ifdef _WIN32
+    spdlog::warn("Event journal is not supported on this platform");
+    return false;
+#else
+    SessionState& s = state();
+    std::lock_guard lock(s.mutex);
+    if (enabled())
+        return false;
+
+    const std::size_t bytes = sizeof(FileHeader) + capacity * sizeof(Record);
+    const int fd = ::open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if (fd < 0) {
+        spdlog::warn("Cannot create event journal {}: {}", path, std::strerror(errno));
+        return false;
+    }
+    // Sparse: pages are only backed as records land in them.
+    if (::ftruncate(fd, static_cast<off_t>(bytes)) != 0) {
+        spdlog::warn("Cannot size event journal {}: {}", path, std::strerror(errno));
+        ::close(fd);
+        return false;
+    }
+    void* mapping = ::mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (mapping == MAP_FAILED) {
+        spdlog::warn("Cannot map event journal {}: {}", path, std::strerror(errno));
+        ::close(fd);
+        return false;
+    }
+
+    auto* header = static_cast<FileHeader*>(mapping);
+    std::memcpy(header->magic, kMagic, sizeof kMagic);
+    header->version = kVersion;
+    header->recordSize = sizeof(Record);
+    header->wallClockNs = static_cast<uint64_t>(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::system_clock::now().time_since_epoch()).count());
+    header->steadyNs = toNs(Clock::now());
+    header->capacity = capacity;
+    header->pid = static_cast<uint32_t>(::getpid());
+
+    s.fd = fd;
+    s.mapping = mapping;
+    s.mappedBytes = bytes;
+    s.ids.clear();
+    g_session.fetch_add(1, std::memory_order_release);
+    g_records.store(reinterpret_cast<Record*>(header + 1), std::memory_order_relaxed);
+    g_capacity.store(capacity, std::memory_order_relaxed);
+    g_committed.store(0, std::memory_order_relaxed);
+    g_dropped.store(0, std::memory_order_relaxed);
+    g_next.store(0, std::memory_order_release);
+    detail::g_enabled.store(true, std::memory_order_release);
+    spdlog::info("Event journal recording to {} ({} records)", path, capacity);
+    return true;
+#endif
+}
+
+void startFromEnvironment()
+{
+    const char* path = std::getenv("LOGOS_EVENT_JOURNAL");
+    if (!path || !*path || enabled())
+        return;
+    std::size_t capacity = kDefaultCapacity;
+    if (const char* records = std::getenv("LOGOS_EVENT_JOURNAL_RECORDS")) {
+        char* end = nullptr;
+        const unsigned long long n = std::strtoull(records, &end, 10);
+        if (end != records && *end == '\0' && n > 0)
+            capacity = static_cast<std::size_t>(n);
+        else
+            spdlog::warn("Ignoring LOGOS_EVENT_JOURNAL_RECORDS={}: not a positive integer", records);
+    }
+    start(path, capacity);
+}
+
+bool stop()
+{
+#ifdef _WIN32
+    return false;
+#else
+    SessionState& s = state();
+    std::lock_guard lock(s.mutex);
+    if (!enabled())
+        return false;
+    detail::g_enabled.store(false, std::memory_order_relaxed);
+
+    // Writers that reserved a slot before this point still get to fill it.
+    const uint64_t reserved = g_next.exchange(kClosed, std::memory_order_acq_rel);
+    const uint64_t written = std::min(reserved, g_capacity.load(std::memory_order_relaxed));
+    while (g_committed.load(std::memory_order_acquire) < written)
+        std::this_thread::yield();
+
+    auto* header = static_cast<FileHeader*>(s.mapping);
+    header->written = written;
+    header->dropped = g_dropped.load(std::memory_order_relaxed);
+    if (header->dropped > 0)
+        spdlog::warn("Event journal full: {} event(s) dropped", header->dropped);
+
+    g_records.store(nullptr, std::memory_order_relaxed);
+    g_capacity.store(0, std::memory_order_relaxed);
+    ::munmap(s.mapping, s.mappedBytes);
+    if (::ftruncate(s.fd, static_cast<off_t>(sizeof(FileHeader) + written * sizeof(Record))) != 0)
+        spdlog::warn("Cannot trim event journal: {}", std::strerror(errno));
+    ::close(s.fd);
+    s.fd = -1;
+    s.mapping = nullptr;
+    s.mappedBytes = 0;
+    return true;
+#endif
+}
+
+uint64_t dropped()
+{
+    return g_dropped.load(std::memory_order_relaxed);
+}
+
+std::optional<Journal> read(const std::string& path, std::string* error)
+{
+    std::ifstream in(path, std::ios::binary);
+    if (!in) {
+        journalError(error, "cannot open " + path);
+        return std::nullopt;
+    }
+
+    Journal journal{};
+    if (!in.read(reinterpret_cast<char*>(&journal.header), sizeof(FileHeader))) {
+        journalError(error, path + ": too short for a journal header");
+        return std::nullopt;
+    }
+    const FileHeader& header = journal.header;
+    if (std::memcmp(header.magic, kMagic, sizeof kMagic) != 0) {
+        journalError(error, path + ": not an event journal");
+        return std::nullopt;
+    }
+    if (header.version != kVersion || header.recordSize != sizeof(Record)) {
+        journalError(error, path + ": unsupported journal version " + std::to_string(header.version));
+        return std::nullopt;
+    }
+
+    // A live or crashed session has written == 0; read up to capacity.
+    const uint64_t limit = header.written ? header.written : header.capacity;
+    Record rec;
+    for (uint64_t i = 0; i < limit && in.read(reinterpret_cast<char*>(&rec), sizeof rec); ++i) {
+        if (rec.type == 0)
+            continue;
+        if (rec.type != static_cast<uint16_t>(Event::ModuleName)) {
+            journal.records.push_back(rec);
+            continue;
+        }
+        std::string& name = journal.names[rec.moduleId];
+        name.resize(rec.aux);
+        const std::size_t offset = std::size_t{rec.result} * kNameChunk;
+        if (offset < name.size())
+            std::memcpy(name.data() + offset, &rec.timestampNs,
+                        std::min(kNameChunk, name.size() - offset));
+    }
+
+    // Slots are reserved in completion order; present them by start time.
+    std::stable_sort(journal.records.begin(), journal.records.end(),
+                     [](const Record& a, const Record& b) { return a.timestampNs < b.timestampNs; });
+    return journal;
+}
+
+const char* eventName(uint16_t type)
+{
+    switch (static_cast<Event>(type)) {
+    case Event::ModuleName:      return "module_name";
+    case Event::Load:            return "load";
+    case Event::Unload:          return "unload";
+    case Event::TokenIssued:     return "token_issued";
+    case Event::TokenNotify:     return "token_notify";
+    case Event::RestrictionPush: return "restriction_push";
+    case Event::ProtocolGate:    return "protocol_gate";
+    }
+    return "unknown";
+}
+
+const char* resultName(uint16_t type, uint16_t result)
+{
+    if (type == static_cast<uint16_t>(Event::Load)) {
+        switch (result) {
+        case Loaded:          return "loaded";
+        case ProtocolRefused: return "protocol_refused";
+        case NoLoader:        return "no_loader";
+        case LaunchFailed:    return "launch_failed";
+        case TokenRejected:   return "token_rejected";
+        }
+        return "unknown";
+    }
+    if (type == static_cast<uint16_t>(Event::ProtocolGate)) {
+        switch (result) {
+        case GateAllow:       return "allow";
+        case GateAllowLegacy: return "allow_legacy";
+        case GateRefuse:      return "refuse";
+        }
+        return "unknown";
+    }
+    switch (result) {
+    case Ok:     return "ok";
+    case Failed: return "failed";
+    }
+    return "unknown";
+}
+
+namespace {
+
+int64_t wallClockNs(const FileHeader& header, uint64_t steadyNs)
+{
+    return static_cast<int64_t>(header.wallClockNs)
+         + (static_cast<int64_t>(steadyNs) - static_cast<int64_t>(header.steadyNs));
+}
+
+std::string moduleName(const Journal& journal, uint32_t id)
+{
+    if (id == 0)
+        return {};
+    auto it = journal.names.find(id);
+    return it != journal.names.end() ? it->second : "#" + std::to_string(id);
+}
+
+} // anonymous namespace
+
+std::string toJson(const Journal& journal)
+{
+    nlohmann::json events = nlohmann::json::array();
+    for (const auto& rec : journal.records) {
+        events.push_back({
+            {"time_ns", wallClockNs(journal.header, rec.timestampNs)},
+            {"event", eventName(rec.type)},
+            {"module", moduleName(journal, rec.moduleId)},
+            {"duration_ns", rec.durationNs},
+            {"result", resultName(rec.type, rec.result)},
+            {"aux", rec.aux},
+        });
+    }
+    nlohmann::json out = {
+        {"pid", journal.header.pid},
+        {"capacity", journal.header.capacity},
+        {"dropped", journal.header.dropped},
+        {"events", std::move(events)},
+    };
+    return out.dump(2);
+}
+
+std::string toCsv(const Journal& journal)
+{
+    std::string out = "time_ns,event,module,duration_ns,result,aux\n";
+    for (const auto& rec : journal.records) {
+        std::string module = moduleName(journal, rec.moduleId);
+        if (module.find_first_of(",\"\n") != std::string::npos) {
+            std::string quoted = "\"";
+            for (char c : module) {
+                if (c == '"')
+                    quoted += '"';
+                quoted += c;
+            }
+            module = quoted + "\"";
+        }
+        out += std::to_string(wallClockNs(journal.header, rec.timestampNs)) + ','
+             + eventName(rec.type) + ',' + module + ','
+             + std::to_string(rec.durationNs) + ','
+             + resultName(rec.type, rec.result) + ','
+             + std::to_string(rec.aux) + '\n';
+    }
+    return out;
+}
+
+} // namespace EventJournal
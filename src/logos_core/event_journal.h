@@ -0,0 +1,198 @@
+#ifndef EVENT_JOURNAL_H
+#define EVENT_JOURNAL_H
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// Append-only binary journal of lifecycle events (Qt-free), for auditing
+// loads, unloads and token traffic at volumes where text logging costs too
+// much.
+//
+// Off by default. Turned on by LOGOS_EVENT_JOURNAL=<path> at
+// logos_core_start() or by logos_core_start_event_journal(); the file is
+// finalised by logos_core_stop_event_journal() or logos_core_cleanup().
+//
+// The file is a FileHeader followed by fixed-size Records in a region mapped
+// up front, so appending is a slot reservation (one fetch_add) and a 32-byte
+// store — no lock, no syscall, no formatting. The region holds `capacity`
+// records; once full, further events are counted in FileHeader::dropped
+// rather than growing the file. stop() trims the file to the records written.
+//
+// Module names are interned to small ids: the first event for a name also
+// writes ModuleName records carrying its bytes, so the journal is
+// self-describing. Each thread caches the ids it has resolved, so only a
+// thread's first event for a module takes the session lock. Decode a journal with read() + toJson()/toCsv(), or with
+// the logos_event_journal tool.
+
+namespace EventJournal {
+
+using Clock = std::chrono::steady_clock;
+
+enum class Event : uint16_t {
+    ModuleName = 1,       // name bytes for moduleId (see Record)
+    Load = 2,             // whole load; result: LoadResult
+    Unload = 3,           // whole unload; result: Result
+    TokenIssued = 4,      // token handed to the module; duration: sendToken
+    TokenNotify = 5,      // informModuleToken RPC to capability_module
+    RestrictionPush = 6,  // registerRestriction RPC; aux: allowed callers
+    ProtocolGate = 7,     // result: GateResult; aux: module protocol major
+};
+
+enum Result : uint16_t { Ok = 0, Failed = 1 };
+
+enum LoadResult : uint16_t {
+    Loaded = 0,
+    ProtocolRefused = 1,
+    NoLoader = 2,
+    LaunchFailed = 3,
+    TokenRejected = 4,
+};
+
+enum GateResult : uint16_t { GateAllow = 0, GateAllowLegacy = 1, GateRefuse = 2 };
+
+constexpr char kMagic[8] = {'L', 'G', 'E', 'V', 'J', 'N', 'L', '1'};
+constexpr uint32_t kVersion = 1;
+constexpr std::size_t kDefaultCapacity = 1u << 20;   // 32 MiB of records
+
+// Native byte order; the journal is read on the machine that wrote it.
+struct FileHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t recordSize;
+    uint64_t wallClockNs;  // system_clock at start()...
+    uint64_t steadyNs;     // ...and steady_clock at the same instant
+    uint64_t capacity;     // records the file was sized for
+    uint64_t written;      // records in the file; set by stop()
+    uint64_t dropped;      // events lost to a full journal; set by stop()
+    uint32_t pid;
+    uint32_t reserved;
+};
+static_assert(sizeof(FileHeader) == 64, "FileHeader layout is part of the file format");
+
+// A ModuleName record stores 16 name bytes in timestampNs..durationNs,
+// the chunk index in `result` and the full name length in `aux`.
+struct Record {
+    uint64_t timestampNs;  // steady clock, event start
+    uint64_t durationNs;
+    uint32_t moduleId;     // 0 = none
+    uint16_t type;         // Event; 0 = slot never written
+    uint16_t result;
+    uint32_t aux;
+    uint32_t reserved;
+};
+static_assert(sizeof(Record) == 32, "Record layout is part of the file format");
+
+namespace detail {
+extern std::atomic<bool> g_enabled;
+uint32_t intern(const std::string& name);
+void append(Event event, uint32_t moduleId, uint64_t timestampNs, uint64_t durationNs,
+            uint16_t result, uint32_t aux) noexcept;
+}
+
+inline bool enabled() { return detail::g_enabled.load(std::memory_order_relaxed); }
+
+inline uint64_t toNs(Clock::time_point t)
+{
+    return static_cast<uint64_t>(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(t.time_since_epoch()).count());
+}
+
+// Create `path` sized for `capacity` records and start recording. Returns
+// false (and leaves the current session alone) when `path` is empty,
+// `capacity` is 0, a session is already running, or the file cannot be
+// created and mapped.
+bool start(const std::string& path, std::size_t capacity = kDefaultCapacity);
+
+// Start a session from LOGOS_EVENT_JOURNAL (and LOGOS_EVENT_JOURNAL_RECORDS
+// for the capacity) if it is set and none is running.
+void startFromEnvironment();
+
+// End the session: fill in the header counts, trim and close the file.
+// Returns false when no session was running.
+bool stop();
+
+// Events lost to a full journal in the current session.
+uint64_t dropped();
+
+// Session-stable id for a module name; 0 when the journal is off.
+inline uint32_t moduleId(const std::string& name)
+{
+    return enabled() ? detail::intern(name) : 0;
+}
+
+// Record an instantaneous event now.
+inline void record(Event event, const std::string& module, uint16_t result = Ok, uint32_t aux = 0)
+{
+    if (enabled())
+        detail::append(event, detail::intern(module), toNs(Clock::now()), 0, result, aux);
+}
+
+// RAII event timed from construction to destruction. Free when the journal
+// is off.
+class Scope {
+public:
+    Scope(Event event, const std::string& module)
+        : m_active(enabled())
+        , m_event(event)
+    {
+        if (m_active) {
+            m_moduleId = detail::intern(module);
+            m_begin = Clock::now();
+        }
+    }
+    ~Scope()
+    {
+        if (m_active) {
+            const auto end = Clock::now();
+            detail::append(m_event, m_moduleId, toNs(m_begin), toNs(end) - toNs(m_begin),
+                           m_result, m_aux);
+        }
+    }
+
+    void setResult(uint16_t result) { m_result = result; }
+    void setAux(uint32_t aux) { m_aux = aux; }
+
+    Scope(const Scope&) = delete;
+    Scope& operator=(const Scope&) = delete;
+
+private:
+    bool m_active;
+    Event m_event;
+    uint32_t m_moduleId = 0;
+    uint16_t m_result = Ok;
+    uint32_t m_aux = 0;
+    Clock::time_point m_begin;
+};
+
+// ── Decoding ───────────────────────────────────────────────────────────────
+
+struct Journal {
+    FileHeader header;
+    std::vector<Record> records;   // events only, in timestamp order
+    std::unordered_map<uint32_t, std::string> names;
+};
+
+// Read a finished journal, or one still being written (records not yet
+// published are skipped). Returns nullopt with `error` set when the file is
+// not a journal this build understands.
+std::optional<Journal> read(const std::string& path, std::string* error = nullptr);
+
+// Names for Record::type and Record::result; "unknown" for values this build
+// does not know.
+const char* eventName(uint16_t type);
+const char* resultName(uint16_t type, uint16_t result);
+
+// One JSON object / CSV row per event. Times are wall-clock nanoseconds
+// since the Unix epoch, derived from the header's clock pair.
+std::string toJson(const Journal& journal);
+std::string toCsv(const Journal& journal);
+
+} // namespace EventJournal
+
+#endif // EVENT_JOURNAL_H
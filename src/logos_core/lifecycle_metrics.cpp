@@ -0,0 +1,296 @@
+#include "lifecycle_metrics.h"
+
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+
+namespace LifecycleMetrics {
+
+namespace {
+
+struct PhaseRow {
+    std::array<LatencyHistogram, kPhaseCount> phases;
+    std::array<std::atomic<uint64_t>, kCounterCount> counters{};
+
+    LatencyHistogram& operator[](std::size_t p) { return phases[p]; }
+    const LatencyHistogram& operator[](std::size_t p) const { return phases[p]; }
+};
+
+PhaseRow& aggregateRow()
+{
+    static PhaseRow row;
+    return row;
+}
+
+struct ModuleTable {
+    std::mutex mutex;
+    // Heap-allocated rows: PhaseRow holds atomics and cannot move on rehash.
+    std::unordered_map<std::string, std::unique_ptr<PhaseRow>> rows;
+};
+
+// Call with the table mutex held.
+PhaseRow& rowLocked(ModuleTable& table, const std::string& module)
+{
+    auto& row = table.rows[module];
+    if (!row)
+        row = std::make_unique<PhaseRow>();
+    return *row;
+}
+
+ModuleTable& moduleTable()
+{
+    static ModuleTable table;
+    return table;
+}
+
+void atomicMin(std::atomic<uint64_t>& target, uint64_t v)
+{
+    uint64_t cur = target.load(std::memory_order_relaxed);
+    while (v < cur && !target.compare_exchange_weak(cur, v, std::memory_order_relaxed)) {}
+}
+
+void atomicMax(std::atomic<uint64_t>& target, uint64_t v)
+{
+    uint64_t cur = target.load(std::memory_order_relaxed);
+    while (v > cur && !target.compare_exchange_weak(cur, v, std::memory_order_relaxed)) {}
+}
+
+std::size_t bucketIndex(uint64_t us)
+{
+    // Smallest i with us <= 2^i.
+    std::size_t i = 0;
+    while (i + 1 < kBucketCount && (uint64_t{1} << i) < us)
+        ++i;
+    return i;
+}
+
+nlohmann::json countersToJson(const PhaseRow& row)
+{
+    nlohmann::json out = nlohmann::json::object();
+    for (std::size_t c = 0; c < kCounterCount; ++c)
+        out[counterName(static_cast<Counter>(c))] = row.counters[c].load(std::memory_order_relaxed);
+    return out;
+}
+
+nlohmann::json rowToJson(const PhaseRow& row)
+{
+    nlohmann::json out = nlohmann::json::object();
+    for (std::size_t p = 0; p < kPhaseCount; ++p) {
+        if (row[p].count() == 0)
+            continue;
+        out[phaseName(static_cast<Phase>(p))] = row[p].toJson();
+    }
+    return out;
+}
+
+ModuleSnapshot rowSnapshot(const PhaseRow& row)
+{
+    ModuleSnapshot out;
+    for (std::size_t p = 0; p < kPhaseCount; ++p)
+        out.phases[p] = row[p].snapshot();
+    for (std::size_t c = 0; c < kCounterCount; ++c)
+        out.counters[c] = row.counters[c].load(std::memory_order_relaxed);
+    return out;
+}
+
+} // namespace
+
+const char* phaseName(Phase phase)
+{
+    switch (phase) {
+    case Phase::MetadataExtraction: return "load.metadata_extraction";
+    case Phase::ProtocolGate:       return "load.protocol_gate";
+    case Phase::LoaderSelection:    return "load.loader_selection";
+    case Phase::ContainerLaunch:    return "load.container_launch";
+    case Phase::CapabilityBarrier:  return "load.capability_barrier";
+    case Phase::SendToken:          return "load.send_token";
+    case Phase::TokenSave:          return "load.token_save";
+    case Phase::CapabilityNotify:   return "load.capability_notify";
+    case Phase::RestrictionRefresh: return "load.restriction_refresh";
+    case Phase::LoadTotal:          return "load.total";
+    case Phase::Terminate:          return "unload.terminate";
+    case Phase::UnloadTotal:        return "unload.total";
+    case Phase::Count:              break;
+    }
+    return "unknown";
+}
+
+const char* counterName(Counter counter)
+{
+    switch (counter) {
+    case Counter::Loads:        return "loads";
+    case Counter::LoadFailures: return "load_failures";
+    case Counter::Unloads:      return "unloads";
+    case Counter::Restarts:     return "restarts";
+    case Counter::Upgrades:     return "upgrades";
+    case Counter::Count:        break;
+    }
+    return "unknown";
+}
+
+uint64_t LatencyHistogram::bucketUpperUs(std::size_t i)
+{
+    if (i + 1 >= kBucketCount)
+        return UINT64_MAX;
+    return uint64_t{1} << i;
+}
+
+void LatencyHistogram::record(std::chrono::nanoseconds elapsed)
+{
+    const auto ns = elapsed.count() < 0 ? 0 : static_cast<uint64_t>(elapsed.count());
+    // Round up so a sub-microsecond phase lands in the first bucket rather
+    // than reading as zero.
+    const uint64_t us = (ns + 999) / 1000;
+    m_buckets[bucketIndex(us)].fetch_add(1, std::memory_order_relaxed);
+    m_sumUs.fetch_add(us, std::memory_order_relaxed);
+    atomicMin(m_minUs, us);
+    atomicMax(m_maxUs, us);
+    // Last, so a reader that sees the count also sees the bucket it covers.
+    m_count.fetch_add(1, std::memory_order_release);
+}
+
+void LatencyHistogram::reset()
+{
+    for (auto& b : m_buckets)
+        b.store(0, std::memory_order_relaxed);
+    m_sumUs.store(0, std::memory_order_relaxed);
+    m_minUs.store(UINT64_MAX, std::memory_order_relaxed);
+    m_maxUs.store(0, std::memory_order_relaxed);
+    m_count.store(0, std::memory_order_release);
+}
+
+uint64_t LatencyHistogram::quantileUs(double q) const
+{
+    const uint64_t total = m_count.load(std::memory_order_acquire);
+    if (total == 0)
+        return 0;
+    if (q < 0.0) q = 0.0;
+    if (q > 1.0) q = 1.0;
+    uint64_t rank = static_cast<uint64_t>(q * static_cast<double>(total) + 0.5);
+    if (rank == 0) rank = 1;
+
+    uint64_t seen = 0;
+    for (std::size_t i = 0; i < kBucketCount; ++i) {
+        seen += m_buckets[i].load(std::memory_order_relaxed);
+        if (seen >= rank) {
+            // Never report past the largest sample actually observed.
+            const uint64_t upper = bucketUpperUs(i);
+            const uint64_t maxUs = m_maxUs.load(std::memory_order_relaxed);
+            return upper < maxUs ? upper : maxUs;
+        }
+    }
+    return m_maxUs.load(std::memory_order_relaxed);
+}
+
+nlohmann::json LatencyHistogram::toJson() const
+{
+    const uint64_t n = m_count.load(std::memory_order_acquire);
+    nlohmann::json buckets = nlohmann::json::array();
+    for (const auto& b : m_buckets)
+        buckets.push_back(b.load(std::memory_order_relaxed));
+    return {
+        {"count", n},
+        {"sum_us", m_sumUs.load(std::memory_order_relaxed)},
+        {"min_us", n ? m_minUs.load(std::memory_order_relaxed) : 0},
+        {"max_us", m_maxUs.load(std::memory_order_relaxed)},
+        {"p50_us", quantileUs(0.50)},
+        {"p90_us", quantileUs(0.90)},
+        {"p99_us", quantileUs(0.99)},
+        {"buckets", std::move(buckets)},
+    };
+}
+
+HistogramSnapshot LatencyHistogram::snapshot() const
+{
+    HistogramSnapshot out;
+    out.count = m_count.load(std::memory_order_acquire);
+    out.sumUs = m_sumUs.load(std::memory_order_relaxed);
+    for (std::size_t i = 0; i < kBucketCount; ++i)
+        out.buckets[i] = m_buckets[i].load(std::memory_order_relaxed);
+    return out;
+}
+
+void record(const std::string& module, Phase phase, std::chrono::nanoseconds elapsed)
+{
+    const auto p = static_cast<std::size_t>(phase);
+    if (p >= kPhaseCount)
+        return;
+    aggregateRow()[p].record(elapsed);
+    if (module.empty())
+        return;
+    // Recorded under the table lock so reset() cannot free the row mid-write;
+    // loads are rare enough that this never contends in practice.
+    auto& table = moduleTable();
+    std::lock_guard lock(table.mutex);
+    rowLocked(table, module)[p].record(elapsed);
+}
+
+void count(const std::string& module, Counter counter)
+{
+    const auto c = static_cast<std::size_t>(counter);
+    if (c >= kCounterCount)
+        return;
+    auto& aggregate = aggregateRow();
+    aggregate.counters[c].fetch_add(1, std::memory_order_relaxed);
+
+    auto& table = moduleTable();
+    std::lock_guard lock(table.mutex);
+    auto& row = rowLocked(table, module);
+    const uint64_t before = row.counters[c].fetch_add(1, std::memory_order_relaxed);
+    if (counter == Counter::Loads && before > 0) {
+        const auto r = static_cast<std::size_t>(Counter::Restarts);
+        row.counters[r].fetch_add(1, std::memory_order_relaxed);
+        aggregate.counters[r].fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+Snapshot snapshot()
+{
+    Snapshot out;
+    out.aggregate = rowSnapshot(aggregateRow());
+    auto& table = moduleTable();
+    std::lock_guard lock(table.mutex);
+    for (const auto& [name, row] : table.rows)
+        out.modules.emplace(name, rowSnapshot(*row));
+    return out;
+}
+
+nlohmann::json toJson()
+{
+    nlohmann::json bounds = nlohmann::json::array();
+    for (std::size_t i = 0; i + 1 < kBucketCount; ++i)
+        bounds.push_back(LatencyHistogram::bucketUpperUs(i));
+    bounds.push_back(nullptr);  // overflow
+
+    nlohmann::json modulesJson = nlohmann::json::object();
+    {
+        auto& table = moduleTable();
+        std::lock_guard lock(table.mutex);
+        for (const auto& [name, row] : table.rows) {
+            auto j = rowToJson(*row);
+            j["counters"] = countersToJson(*row);
+            modulesJson[name] = std::move(j);
+        }
+    }
+
+    return {
+        {"bucket_upper_us", std::move(bounds)},
+        {"counters", countersToJson(aggregateRow())},
+        {"aggregate", rowToJson(aggregateRow())},
+        {"modules", std::move(modulesJson)},
+    };
+}
+
+void reset()
+{
+    auto& aggregate = aggregateRow();
+    for (auto& h : aggregate.phases)
+        h.reset();
+    for (auto& c : aggregate.counters)
+        c.store(0, std::memory_order_relaxed);
+    auto& table = moduleTable();
+    std::lock_guard lock(table.mutex);
+    table.rows.clear();
+}
+
+} // namespace LifecycleMetrics
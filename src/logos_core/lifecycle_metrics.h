@@ -0,0 +1,168 @@
+#ifndef LIFECYCLE_METRICS_H
+#define LIFECYCLE_METRICS_H
+
+#include "lifecycle_trace.h"
+#include <nlohmann/json.hpp>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <string>
+
+// Fixed-bucket latency histograms for the module lifecycle (Qt-free).
+//
+// ModuleManager times each phase of loadModuleInternal and
+// unloadModuleInternalLocked and records it here twice: once into the
+// aggregate histogram for the phase and once into the module's own. Recording
+// is a handful of relaxed atomic increments; the per-module row is found (or
+// created) and written under one short mutex.
+//
+// Exposed as JSON through logos_core_get_lifecycle_metrics().
+
+namespace LifecycleMetrics {
+
+enum class Phase : std::size_t {
+    // load
+    MetadataExtraction,   // ModuleLib::LogosModule::extractMetadata + parse
+    ProtocolGate,         // evaluateProtocolGate
+    LoaderSelection,      // ModuleLoaderRegistry::select
+    ContainerLaunch,      // ModuleLoader::load (spawn)
+    CapabilityBarrier,    // wait for capability_module to know the token
+    SendToken,            // ModuleLoader::sendToken
+    TokenSave,            // TokenManager::saveToken
+    CapabilityNotify,     // informModuleToken RPC (notifier thread)
+    RestrictionRefresh,   // derive + queue restriction updates
+    LoadTotal,            // whole successful loadModuleInternal
+    // unload
+    Terminate,            // ModuleLoader::terminate
+    UnloadTotal,          // whole successful unloadModuleInternalLocked
+    Count
+};
+
+constexpr std::size_t kPhaseCount = static_cast<std::size_t>(Phase::Count);
+
+// Stable dotted name used as the JSON key, e.g. "load.container_launch".
+const char* phaseName(Phase phase);
+
+// Outcome counters, kept next to the histograms so one reset covers both.
+enum class Counter : std::size_t {
+    Loads,          // successful loads
+    LoadFailures,   // load attempts on a known module that returned false
+    Unloads,        // successful unloads
+    Restarts,       // successful loads of a module that had loaded before
+    Upgrades,       // successful in-place upgrades (ModuleManager::upgradeModule)
+    Count
+};
+
+constexpr std::size_t kCounterCount = static_cast<std::size_t>(Counter::Count);
+
+// Stable name used as the JSON key, e.g. "load_failures".
+const char* counterName(Counter counter);
+
+// Power-of-two microsecond buckets: bucket i counts samples <= 2^i us, for
+// i in [0, kBucketCount - 2]; the last bucket is the overflow (> 2^(n-2) us,
+// about 33 s).
+constexpr std::size_t kBucketCount = 27;
+
+// Plain copy of one histogram, for renderers that need the raw buckets.
+struct HistogramSnapshot {
+    uint64_t count = 0;
+    uint64_t sumUs = 0;
+    std::array<uint64_t, kBucketCount> buckets{};
+};
+
+class LatencyHistogram {
+public:
+    void record(std::chrono::nanoseconds elapsed);
+    void reset();
+
+    uint64_t count() const { return m_count.load(std::memory_order_relaxed); }
+
+    // Upper bound (us) of the bucket holding quantile `q` in [0, 1]; 0 when
+    // empty. An estimate by construction — exact to within one bucket.
+    uint64_t quantileUs(double q) const;
+
+    nlohmann::json toJson() const;
+    HistogramSnapshot snapshot() const;
+
+    // Inclusive upper bound of bucket `i` in microseconds (UINT64_MAX for the
+    // overflow bucket).
+    static uint64_t bucketUpperUs(std::size_t i);
+
+private:
+    std::array<std::atomic<uint64_t>, kBucketCount> m_buckets{};
+    std::atomic<uint64_t> m_count{0};
+    std::atomic<uint64_t> m_sumUs{0};
+    std::atomic<uint64_t> m_minUs{UINT64_MAX};
+    std::atomic<uint64_t> m_maxUs{0};
+};
+
+void record(const std::string& module, Phase phase, std::chrono::nanoseconds elapsed);
+
+// Bump `counter` for `module` and in the aggregate. Counting a Loads for a
+// module that already has one also bumps Restarts.
+void count(const std::string& module, Counter counter);
+
+struct ModuleSnapshot {
+    std::array<HistogramSnapshot, kPhaseCount> phases{};
+    std::array<uint64_t, kCounterCount> counters{};
+};
+
+struct Snapshot {
+    ModuleSnapshot aggregate;
+    std::map<std::string, ModuleSnapshot> modules;
+};
+
+Snapshot snapshot();
+
+// {"bucket_upper_us": [...], "counters": {counter: n},
+//  "aggregate": {phase: histogram}, "modules": {name: {phase: histogram,
+//  "counters": {...}}}}. Phases with no samples are omitted. Histogram
+// shape: count, sum_us, min_us, max_us, p50_us, p90_us, p99_us and the raw
+// per-bucket counts.
+nlohmann::json toJson();
+
+void reset();
+
+// Records the time from construction to destruction (or to the first stop())
+// against `module`/`phase`. cancel() drops the sample — used for a phase
+// whose outcome should not count, e.g. the total of a failed load. Either way
+// the span goes to LifecycleTrace when tracing is on, since the time was spent.
+class ScopedTimer {
+public:
+    ScopedTimer(std::string module, Phase phase)
+        : m_module(std::move(module))
+        , m_phase(phase)
+        , m_start(std::chrono::steady_clock::now())
+    {}
+    ~ScopedTimer() { stop(); }
+
+    ScopedTimer(const ScopedTimer&) = delete;
+    ScopedTimer& operator=(const ScopedTimer&) = delete;
+
+    void stop() { finish(true); }
+    void cancel() { finish(false); }
+
+private:
+    void finish(bool recordSample)
+    {
+        if (m_done) return;
+        m_done = true;
+        const auto end = std::chrono::steady_clock::now();
+        if (recordSample)
+            record(m_module, m_phase, end - m_start);
+        if (LifecycleTrace::enabled())
+            LifecycleTrace::complete(phaseName(m_phase), "lifecycle", m_module, m_start, end);
+    }
+
+    std::string m_module;
+    Phase m_phase;
+    std::chrono::steady_clock::time_point m_start;
+    bool m_done = false;
+};
+
+} // namespace LifecycleMetrics
+
+#endif // LIFECYCLE_METRICS_H
@@ -0,0 +1,211 @@
+#include "lifecycle_trace.h"
+
+#include <nlohmann/json.hpp>
+#include <spdlog/spdlog.h>
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#ifdef _WIN32
+#include <process.h>
+#else
+#include <unistd.h>
+#endif
+
+namespace LifecycleTrace {
+
+namespace detail {
+std::atomic<bool> g_enabled{false};
+}
+
+namespace {
+
+// A boot records a few spans per module; this only bounds a session someone
+// forgot to stop.
+constexpr std::size_t kMaxEventsPerThread = 1u << 18;
+
+struct Event {
+    const char* name;
+    const char* category;
+    std::string detail;
+    int64_t tsUs;
+    int64_t durUs;
+};
+
+struct ThreadBuffer {
+    std::mutex mutex;           // uncontended except while stop() collects
+    uint32_t tid = 0;
+    std::string threadName;
+    uint64_t session = 0;       // session the events belong to
+    std::vector<Event> events;
+    uint64_t dropped = 0;
+};
+
+struct SessionState {
+    std::mutex mutex;
+    std::string path;
+    uint64_t id = 0;
+    uint32_t nextTid = 1;
+    // Every thread that ever recorded. Kept after the thread exits so its
+    // spans still make it into the file; pruned on stop().
+    std::vector<std::shared_ptr<ThreadBuffer>> buffers;
+};
+
+SessionState& state()
+{
+    static SessionState s;
+    return s;
+}
+
+std::atomic<uint64_t>& currentSession()
+{
+    static std::atomic<uint64_t> id{0};
+    return id;
+}
+
+ThreadBuffer& threadBuffer()
+{
+    thread_local std::shared_ptr<ThreadBuffer> buffer;
+    if (!buffer) {
+        buffer = std::make_shared<ThreadBuffer>();
+        auto& s = state();
+        std::lock_guard lock(s.mutex);
+        buffer->tid = s.nextTid++;
+        s.buffers.push_back(buffer);
+    }
+    return *buffer;
+}
+
+int64_t toUs(Clock::time_point t)
+{
+    return std::chrono::duration_cast<std::chrono::microseconds>(
+        t.time_since_epoch()).count();
+}
+
+} // namespace
+
+bool start(const std::string& path)
+{
+    if (path.empty())
+        return false;
+    auto& s = state();
+    std::lock_guard lock(s.mutex);
+    if (detail::g_enabled.load(std::memory_order_relaxed))
+        return false;
+    s.path = path;
+    s.id += 1;
+    currentSession().store(s.id, std::memory_order_relaxed);
+    detail::g_enabled.store(true, std::memory_order_release);
+    spdlog::info("Lifecycle tracing enabled, writing to {}", path);
+    return true;
+}
+
+void startFromEnvironment()
+{
+    const char* path = std::getenv("LOGOS_TRACE_FILE");
+    if (path && *path && !enabled())
+        start(path);
+}
+
+void complete(const char* name, const char* category, const std::string& detail,
+              Clock::time_point begin, Clock::time_point end)
+{
+    if (!enabled())
+        return;
+    const uint64_t session = currentSession().load(std::memory_order_relaxed);
+    ThreadBuffer& buf = threadBuffer();
+    std::lock_guard lock(buf.mutex);
+    if (buf.session != session) {
+        buf.events.clear();
+        buf.dropped = 0;
+        buf.session = session;
+    }
+    if (buf.events.size() >= kMaxEventsPerThread) {
+        ++buf.dropped;
+        return;
+    }
+    const int64_t ts = toUs(begin);
+    buf.events.push_back(Event{name, category, detail, ts, toUs(end) - ts});
+}
+
+void setThreadName(const std::string& name)
+{
+    ThreadBuffer& buf = threadBuffer();
+    std::lock_guard lock(buf.mutex);
+    buf.threadName = name;
+}
+
+bool stop()
+{
+    auto& s = state();
+    std::lock_guard lock(s.mutex);
+    if (!detail::g_enabled.exchange(false, std::memory_order_acq_rel))
+        return false;
+
+#ifdef _WIN32
+    const auto pid = static_cast<int64_t>(::_getpid());
+#else
+    const auto pid = static_cast<int64_t>(::getpid());
+#endif
+    nlohmann::json events = nlohmann::json::array();
+    uint64_t dropped = 0;
+
+    for (const auto& buffer : s.buffers) {
+        std::lock_guard bufLock(buffer->mutex);
+        if (!buffer->threadName.empty()) {
+            events.push_back({
+                {"name", "thread_name"}, {"ph", "M"}, {"pid", pid},
+                {"tid", buffer->tid}, {"args", {{"name", buffer->threadName}}},
+            });
+        }
+        if (buffer->session != s.id)
+            continue;
+        for (const Event& e : buffer->events) {
+            nlohmann::json ev = {
+                {"name", e.name}, {"cat", e.category}, {"ph", "X"},
+                {"ts", e.tsUs}, {"dur", e.durUs}, {"pid", pid}, {"tid", buffer->tid},
+            };
+            if (!e.detail.empty())
+                ev["args"] = {{"module", e.detail}};
+            events.push_back(std::move(ev));
+        }
+        dropped += buffer->dropped;
+        buffer->events.clear();
+        buffer->events.shrink_to_fit();
+        buffer->dropped = 0;
+    }
+
+    // Buffers only the registry still references belong to exited threads;
+    // their spans were just written.
+    s.buffers.erase(
+        std::remove_if(s.buffers.begin(), s.buffers.end(),
+                       [](const std::shared_ptr<ThreadBuffer>& b) { return b.use_count() == 1; }),
+        s.buffers.end());
+
+    if (dropped)
+        spdlog::warn("Lifecycle trace dropped {} span(s) over the per-thread cap", dropped);
+
+    nlohmann::json doc = {
+        {"traceEvents", std::move(events)},
+        {"displayTimeUnit", "ms"},
+    };
+
+    std::ofstream out(s.path, std::ios::out | std::ios::trunc);
+    if (!out) {
+        spdlog::error("Cannot write lifecycle trace to {}", s.path);
+        return false;
+    }
+    out << doc.dump();
+    if (!out) {
+        spdlog::error("Failed writing lifecycle trace to {}", s.path);
+        return false;
+    }
+    spdlog::info("Lifecycle trace written to {}", s.path);
+    return true;
+}
+
+} // namespace LifecycleTrace
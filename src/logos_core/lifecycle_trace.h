@@ -0,0 +1,85 @@
+#ifndef LIFECYCLE_TRACE_H
+#define LIFECYCLE_TRACE_H
+
+#include <atomic>
+#include <chrono>
+#include <string>
+
+// Opt-in Chrome trace-event recorder for the boot and module lifecycle
+// timeline (Qt-free). Open the written file in Perfetto or chrome://tracing.
+//
+// Off by default. Turned on by LOGOS_TRACE_FILE=<path> at logos_core_start()
+// or by logos_core_start_trace(path); the file is written by
+// logos_core_stop_trace() or logos_core_cleanup().
+//
+// Spans are "complete" events (ph "X") recorded from any thread into a
+// per-thread buffer, so recording never contends across threads; stop()
+// merges the buffers. While disabled a span costs one relaxed atomic load.
+//
+// Instrumented: discovery, per-module metadata extraction, dependency
+// resolver runs, and every LifecycleMetrics phase of load/unload (each
+// LifecycleMetrics::ScopedTimer doubles as a span).
+
+namespace LifecycleTrace {
+
+using Clock = std::chrono::steady_clock;
+
+namespace detail {
+extern std::atomic<bool> g_enabled;
+}
+
+inline bool enabled() { return detail::g_enabled.load(std::memory_order_relaxed); }
+
+// Begin a session writing to `path`, discarding anything recorded by an
+// earlier session. Returns false (and leaves the current session alone) when
+// `path` is empty or a session is already running.
+bool start(const std::string& path);
+
+// Start a session from LOGOS_TRACE_FILE if it is set and none is running.
+void startFromEnvironment();
+
+// End the session and write {"traceEvents": [...]} to its path. Returns false
+// when no session was running or the file could not be written.
+bool stop();
+
+// Record one span. `name` and `category` must be string literals (stored by
+// pointer); `detail` (a module name or path) becomes args.module.
+void complete(const char* name, const char* category, const std::string& detail,
+              Clock::time_point begin, Clock::time_point end);
+
+// Label the calling thread in the viewer (emitted as thread_name metadata).
+void setThreadName(const std::string& name);
+
+// RAII span from construction to destruction. Free when tracing is off.
+class Span {
+public:
+    Span(const char* name, const char* category, std::string detail = {})
+        : m_active(enabled())
+        , m_name(name)
+        , m_category(category)
+    {
+        if (m_active) {
+            m_detail = std::move(detail);
+            m_begin = Clock::now();
+        }
+    }
+    ~Span()
+    {
+        if (m_active)
+            complete(m_name, m_category, m_detail, m_begin, Clock::now());
+    }
+
+    Span(const Span&) = delete;
+    Span& operator=(const Span&) = delete;
+
+private:
+    bool m_active;
+    const char* m_name;
+    const char* m_category;
+    std::string m_detail;
+    Clock::time_point m_begin;
+};
+
+} // namespace LifecycleTrace
+
+#endif // LIFECYCLE_TRACE_H
@@ -0,0 +1,122 @@
+#include "load_scheduler.h"
+
+#include <spdlog/spdlog.h>
+#include <algorithm>
+#include <unordered_set>
+
+namespace LogosCore {
+
+const char* loadPriorityName(LoadPriority priority)
+{
+    switch (priority) {
+    case LoadPriority::Interactive: return "interactive";
+    case LoadPriority::Normal:      return "normal";
+    case LoadPriority::Background:  return "background";
+    }
+    return "unknown";
+}
+
+LoadScheduler::LoadScheduler(std::chrono::milliseconds agingStep)
+    : m_agingStep(agingStep)
+{
+}
+
+LoadScheduler::Admission::Admission(Admission&& other) noexcept
+    : m_scheduler(other.m_scheduler)
+    , m_waited(other.m_waited)
+    , m_promoted(other.m_promoted)
+{
+    other.m_scheduler = nullptr;
+}
+
+LoadScheduler::Admission::~Admission()
+{
+    if (m_scheduler)
+        m_scheduler->release();
+}
+
+LoadScheduler::Admission LoadScheduler::admit(LoadPriority priority, std::vector<std::string> modules)
+{
+    std::unique_lock lock(m_mutex);
+    if (!m_busy && m_waiters.empty()) {
+        m_busy = true;
+        return Admission(this, std::chrono::steady_clock::duration::zero(), false);
+    }
+
+    if (priority == LoadPriority::Interactive) {
+        const std::unordered_set<std::string> closure(modules.begin(), modules.end());
+        for (Waiter* waiter : m_waiters) {
+            if (waiter->priority == LoadPriority::Interactive)
+                continue;
+            for (const auto& name : waiter->modules) {
+                if (closure.count(name)) {
+                    spdlog::debug("Load scheduler: {} request for {} promoted to interactive",
+                                  loadPriorityName(waiter->priority), name);
+                    waiter->priority = LoadPriority::Interactive;
+                    waiter->promoted = true;
+                    break;
+                }
+            }
+        }
+    }
+
+    Waiter self;
+    self.seq = m_nextSeq++;
+    self.priority = priority;
+    self.enqueued = std::chrono::steady_clock::now();
+    self.modules = std::move(modules);
+    m_waiters.push_back(&self);
+    m_granted.wait(lock, [&self] { return self.granted; });
+    return Admission(this, std::chrono::steady_clock::now() - self.enqueued, self.promoted);
+}
+
+void LoadScheduler::release()
+{
+    std::lock_guard lock(m_mutex);
+    m_busy = false;
+    grantNextLocked();
+}
+
+void LoadScheduler::grantNextLocked()
+{
+    if (m_waiters.empty())
+        return;
+    const auto now = std::chrono::steady_clock::now();
+    auto best = m_waiters.begin();
+    int bestClass = effectiveClassLocked(**best, now);
+    for (auto it = std::next(m_waiters.begin()); it != m_waiters.end(); ++it) {
+        const int cls = effectiveClassLocked(**it, now);
+        if (cls < bestClass || (cls == bestClass && (*it)->seq < (*best)->seq)) {
+            best = it;
+            bestClass = cls;
+        }
+    }
+    (*best)->granted = true;
+    m_waiters.erase(best);
+    m_busy = true;
+    m_granted.notify_all();
+}
+
+int LoadScheduler::effectiveClassLocked(const Waiter& waiter, std::chrono::steady_clock::time_point now) const
+{
+    int cls = static_cast<int>(waiter.priority);
+    if (m_agingStep.count() > 0) {
+        const auto steps = (now - waiter.enqueued) / m_agingStep;
+        cls -= static_cast<int>(std::min<decltype(steps)>(steps, cls));
+    }
+    return cls;
+}
+
+std::size_t LoadScheduler::queued() const
+{
+    std::lock_guard lock(m_mutex);
+    return m_waiters.size();
+}
+
+void LoadScheduler::setAgingStep(std::chrono::milliseconds step)
+{
+    std::lock_guard lock(m_mutex);
+    m_agingStep = step;
+}
+
+} // namespace LogosCore
@@ -0,0 +1,96 @@
+#ifndef LOAD_SCHEDULER_H
+#define LOAD_SCHEDULER_H
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace LogosCore {
+
+// Admission order for load requests (Qt-free). Loads run one at a time; when
+// the current one finishes, the next to run is the queued request with the
+// best effective class, oldest first among equals, rather than whichever
+// thread happens to win the mutex.
+//
+// A request's effective class improves by one for every `agingStep` it has
+// waited, so background work cannot be starved by a steady stream of
+// interactive requests. When an interactive request arrives, any queued
+// request for a module in its dependency closure is promoted to interactive
+// too: the interactive load needs that module anyway.
+
+enum class LoadPriority : int {
+    Interactive = 0,   // a user is waiting on it
+    Normal = 1,
+    Background = 2,    // preloads, boot profile sets not required for ready
+};
+
+const char* loadPriorityName(LoadPriority priority);
+
+class LoadScheduler {
+public:
+    explicit LoadScheduler(std::chrono::milliseconds agingStep = std::chrono::milliseconds(250));
+
+    LoadScheduler(const LoadScheduler&) = delete;
+    LoadScheduler& operator=(const LoadScheduler&) = delete;
+
+    // Held while the admitted request runs; the next one is admitted when it
+    // is destroyed.
+    class Admission {
+    public:
+        Admission(Admission&& other) noexcept;
+        Admission& operator=(Admission&&) = delete;
+        ~Admission();
+
+        // How long the request waited to be admitted.
+        std::chrono::steady_clock::duration waited() const { return m_waited; }
+        // Whether an interactive request promoted it while it was queued.
+        bool promoted() const { return m_promoted; }
+
+    private:
+        friend class LoadScheduler;
+        Admission(LoadScheduler* scheduler, std::chrono::steady_clock::duration waited, bool promoted)
+            : m_scheduler(scheduler), m_waited(waited), m_promoted(promoted) {}
+
+        LoadScheduler* m_scheduler;
+        std::chrono::steady_clock::duration m_waited;
+        bool m_promoted;
+    };
+
+    // Block until this request may run. `modules` are the modules it will
+    // load (the target, plus its dependency closure when it loads that too);
+    // they decide what an interactive request promotes.
+    Admission admit(LoadPriority priority, std::vector<std::string> modules);
+
+    // Requests waiting for admission, not counting the running one.
+    std::size_t queued() const;
+
+    void setAgingStep(std::chrono::milliseconds step);
+
+private:
+    struct Waiter {
+        std::uint64_t seq = 0;
+        LoadPriority priority = LoadPriority::Normal;
+        std::chrono::steady_clock::time_point enqueued;
+        std::vector<std::string> modules;
+        bool promoted = false;
+        bool granted = false;
+    };
+
+    void release();
+    void grantNextLocked();
+    int effectiveClassLocked(const Waiter& waiter, std::chrono::steady_clock::time_point now) const;
+
+    mutable std::mutex m_mutex;
+    std::condition_variable m_granted;
+    std::chrono::milliseconds m_agingStep;
+    bool m_busy = false;
+    std::uint64_t m_nextSeq = 0;
+    std::vector<Waiter*> m_waiters;   // owned by the threads blocked in admit()
+};
+
+} // namespace LogosCore
+
+#endif // LOAD_SCHEDULER_H
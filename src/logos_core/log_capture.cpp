@@ -0,0 +1,399 @@
+#include "log_capture.h"
+#include "logging/logos_log.h"
+
+#include <spdlog/sinks/rotating_file_sink.h>
+#include <spdlog/spdlog.h>
+#include <algorithm>
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#ifdef __linux__
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#endif
+
+namespace LogosCore {
+
+namespace {
+
+constexpr std::size_t kReadChunk = 64 * 1024;
+
+// Larger FIFO buffer so a chatty module is less likely to block on us.
+constexpr int kFifoBytes = 256 * 1024;
+
+// sh -c <script> logos-capture <out> <err> <host> <args...>: the paths travel
+// as arguments, so nothing needs quoting; exec keeps the host on the same pid.
+constexpr const char* kWrapScript = "o=$1; e=$2; shift 2; exec \"$@\" >\"$o\" 2>\"$e\"";
+
+std::optional<double> parseRate(const nlohmann::json& v)
+{
+    if (!v.is_number() || v.get<double>() < 0)
+        return std::nullopt;
+    return v.get<double>();
+}
+
+std::optional<std::size_t> parseSize(const nlohmann::json& v)
+{
+    if (!v.is_number_integer() || v.get<int64_t>() <= 0)
+        return std::nullopt;
+    return static_cast<std::size_t>(v.get<int64_t>());
+}
+
+} // namespace
+
+std::optional<LogCaptureOptions> LogCaptureOptions::fromJson(const nlohmann::json& j)
+{
+    LogCaptureOptions o;
+    if (j.is_null())
+        return o;
+    if (!j.is_object())
+        return std::nullopt;
+
+    bool ok = true;
+    auto field = [&](const char* key, auto parse, auto& target) {
+        auto it = j.find(key);
+        if (it == j.end())
+            return;
+        if (auto v = parse(*it))
+            target = *v;
+        else {
+            spdlog::warn("log capture: malformed option {}: {}", key, it->dump());
+            ok = false;
+        }
+    };
+    field("file_dir", [](const nlohmann::json& v) {
+        return v.is_string() ? std::optional<std::string>(v.get<std::string>()) : std::nullopt;
+    }, o.fileDir);
+    field("max_file_bytes", parseSize, o.maxFileBytes);
+    field("max_files", parseSize, o.maxFiles);
+    field("lines_per_second", parseRate, o.linesPerSecond);
+    field("burst", parseRate, o.burst);
+    field("max_line_bytes", parseSize, o.maxLineBytes);
+    if (!ok)
+        return std::nullopt;
+    return o;
+}
+
+LogCapture::LogCapture(LogCaptureOptions options, LineFn onLine)
+    : m_options(std::move(options))
+    , m_onLine(std::move(onLine))
+{}
+
+LogCapture::~LogCapture()
+{
+    stop();
+}
+
+bool LogCapture::supported()
+{
+#ifdef __linux__
+    return true;
+#else
+    return false;
+#endif
+}
+
+bool LogCapture::start()
+{
+#ifdef __linux__
+    std::lock_guard lock(m_mutex);
+    if (m_running.load())
+        return false;
+
+    const char* runtime = std::getenv("XDG_RUNTIME_DIR");
+    std::string tmpl = std::string(runtime && *runtime ? runtime : "/tmp") + "/logos-capture-XXXXXX";
+    if (!::mkdtemp(tmpl.data())) {
+        spdlog::warn("log capture: cannot create FIFO directory {}: {}", tmpl, std::strerror(errno));
+        return false;
+    }
+    m_fifoDir = tmpl;
+
+    if (!m_options.fileDir.empty()) {
+        std::error_code ec;
+        std::filesystem::create_directories(m_options.fileDir, ec);
+    }
+
+    m_epollFd = ::epoll_create1(EPOLL_CLOEXEC);
+    m_wakeFd = ::eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+    if (m_epollFd < 0 || m_wakeFd < 0) {
+        spdlog::warn("log capture: epoll setup failed: {}", std::strerror(errno));
+        if (m_epollFd >= 0) ::close(m_epollFd);
+        if (m_wakeFd >= 0) ::close(m_wakeFd);
+        m_epollFd = m_wakeFd = -1;
+        ::rmdir(m_fifoDir.c_str());
+        return false;
+    }
+    epoll_event ev{};
+    ev.events = EPOLLIN;
+    ev.data.u64 = 0;   // ids start at 1
+    ::epoll_ctl(m_epollFd, EPOLL_CTL_ADD, m_wakeFd, &ev);
+
+    m_readBuf.resize(kReadChunk);
+    m_running.store(true);
+    m_thread = std::thread(&LogCapture::run, this);
+    return true;
+#else
+    return false;
+#endif
+}
+
+void LogCapture::stop()
+{
+#ifdef __linux__
+    if (!m_running.exchange(false))
+        return;
+    const uint64_t one = 1;
+    (void)::write(m_wakeFd, &one, sizeof(one));
+    m_thread.join();
+
+    std::lock_guard lock(m_mutex);
+    while (!m_entries.empty())
+        closeLocked(m_entries.begin()->first);
+    ::close(m_epollFd);
+    ::close(m_wakeFd);
+    m_epollFd = m_wakeFd = -1;
+    ::rmdir(m_fifoDir.c_str());
+#endif
+}
+
+std::optional<LogCapture::Redirect> LogCapture::open(const std::string& module)
+{
+#ifdef __linux__
+    std::lock_guard lock(m_mutex);
+    if (!m_running.load())
+        return std::nullopt;
+    if (m_entries.count(module))
+        closeLocked(module);
+
+    auto entry = std::make_unique<Entry>();
+    entry->id = m_nextId++;
+    entry->name = module;
+    entry->tokens = m_options.burst;
+    entry->refilled = std::chrono::steady_clock::now();
+
+    const char* suffix[2] = {".out", ".err"};
+    for (int s = 0; s < 2; ++s) {
+        Pipe& pipe = entry->pipes[s];
+        pipe.path = m_fifoDir + "/" + module + suffix[s];
+        ::unlink(pipe.path.c_str());
+        // Read-write: the FIFO always has a writer (us), so the module's open
+        // never blocks and our reads never see EOF or the module EPIPE.
+        if (::mkfifo(pipe.path.c_str(), 0600) != 0
+            || (pipe.fd = ::open(pipe.path.c_str(), O_RDWR | O_NONBLOCK | O_CLOEXEC)) < 0) {
+            spdlog::warn("log capture: cannot create {}: {}", pipe.path, std::strerror(errno));
+            for (Pipe& p : entry->pipes) {
+                if (p.fd >= 0) ::close(p.fd);
+                if (!p.path.empty()) ::unlink(p.path.c_str());
+            }
+            return std::nullopt;
+        }
+        ::fcntl(pipe.fd, F_SETPIPE_SZ, kFifoBytes);   // best effort
+        epoll_event ev{};
+        ev.events = EPOLLIN;
+        ev.data.u64 = (entry->id << 1) | static_cast<uint64_t>(s);
+        ::epoll_ctl(m_epollFd, EPOLL_CTL_ADD, pipe.fd, &ev);
+    }
+
+    entry->channel = &logos::logger(("module." + module).c_str());
+    if (!m_options.fileDir.empty()) {
+        try {
+            auto file = std::make_shared<spdlog::sinks::rotating_file_sink_mt>(
+                m_options.fileDir + "/" + module + ".log", m_options.maxFileBytes, m_options.maxFiles);
+            file->set_pattern("[%Y-%m-%d %H:%M:%S.%e] [%n] %v");
+            entry->file = std::move(file);
+        } catch (const spdlog::spdlog_ex& e) {
+            spdlog::warn("log capture: no log file for {}: {}", module, e.what());
+        }
+    }
+
+    Redirect redirect{entry->pipes[0].path, entry->pipes[1].path, entry->id};
+    m_byId[entry->id] = entry.get();
+    m_entries[module] = std::move(entry);
+    return redirect;
+#else
+    (void)module;
+    return std::nullopt;
+#endif
+}
+
+void LogCapture::close(const std::string& module, uint64_t id)
+{
+    std::lock_guard lock(m_mutex);
+    closeLocked(module, id);
+}
+
+void LogCapture::closeAll()
+{
+    std::lock_guard lock(m_mutex);
+    while (!m_entries.empty())
+        closeLocked(m_entries.begin()->first);
+}
+
+void LogCapture::closeLocked(const std::string& module, uint64_t id)
+{
+#ifdef __linux__
+    auto it = m_entries.find(module);
+    if (it == m_entries.end() || (id != 0 && it->second->id != id))
+        return;
+    Entry& entry = *it->second;
+    for (int s = 0; s < 2; ++s) {
+        Pipe& pipe = entry.pipes[s];
+        ::epoll_ctl(m_epollFd, EPOLL_CTL_DEL, pipe.fd, nullptr);
+        readPipeLocked(entry, s);
+        if (!pipe.partial.empty()) {
+            std::string rest;
+            rest.swap(pipe.partial);
+            emitLocked(entry, s, rest);
+        }
+        ::close(pipe.fd);
+        ::unlink(pipe.path.c_str());
+    }
+    reportSuppressedLocked(entry);
+    if (entry.file)
+        entry.file->flush();
+    m_byId.erase(entry.id);
+    m_entries.erase(it);
+#else
+    (void)module;
+    (void)id;
+#endif
+}
+
+std::pair<std::string, std::vector<std::string>>
+LogCapture::wrapCommand(const Redirect& redirect, const std::string& host, const std::vector<std::string>& args)
+{
+    std::vector<std::string> wrapped;
+    wrapped.reserve(args.size() + 5);
+    wrapped.push_back("-c");
+    wrapped.push_back(kWrapScript);
+    wrapped.push_back("logos-capture");
+    wrapped.push_back(redirect.stdoutPath);
+    wrapped.push_back(redirect.stderrPath);
+    wrapped.push_back(host);
+    wrapped.insert(wrapped.end(), args.begin(), args.end());
+    return {"/bin/sh", std::move(wrapped)};
+}
+
+std::optional<LogCapture::Counters> LogCapture::counters(const std::string& module) const
+{
+    std::lock_guard lock(m_mutex);
+    auto it = m_entries.find(module);
+    if (it == m_entries.end())
+        return std::nullopt;
+    return it->second->counters;
+}
+
+// ── Reader ──────────────────────────────────────────────────────────────────
+
+void LogCapture::run()
+{
+#ifdef __linux__
+    epoll_event events[32];
+    while (m_running.load()) {
+        const int n = ::epoll_wait(m_epollFd, events, 32, -1);
+        if (n < 0) {
+            if (errno == EINTR)
+                continue;
+            spdlog::warn("log capture: epoll_wait failed: {}", std::strerror(errno));
+            return;
+        }
+        std::lock_guard lock(m_mutex);
+        for (int i = 0; i < n; ++i) {
+            const uint64_t key = events[i].data.u64;
+            if (key == 0)
+                continue;   // wake-up from stop()
+            auto it = m_byId.find(key >> 1);
+            if (it != m_byId.end())   // closed since epoll_wait returned
+                readPipeLocked(*it->second, static_cast<int>(key & 1));
+        }
+    }
+#endif
+}
+
+void LogCapture::readPipeLocked(Entry& entry, int stream)
+{
+    Pipe& pipe = entry.pipes[stream];
+    for (;;) {
+        const ssize_t got = ::read(pipe.fd, m_readBuf.data(), m_readBuf.size());
+        if (got < 0 && errno == EINTR)
+            continue;
+        if (got <= 0)
+            return;   // EAGAIN: drained
+        entry.counters.bytes += static_cast<uint64_t>(got);
+
+        std::string_view chunk(m_readBuf.data(), static_cast<std::size_t>(got));
+        while (!chunk.empty()) {
+            const auto nl = chunk.find('\n');
+            if (nl == std::string_view::npos) {
+                pipe.partial.append(chunk);
+                while (pipe.partial.size() > m_options.maxLineBytes) {
+                    emitLocked(entry, stream, std::string_view(pipe.partial).substr(0, m_options.maxLineBytes));
+                    pipe.partial.erase(0, m_options.maxLineBytes);
+                }
+                break;
+            }
+            std::string_view line = chunk.substr(0, nl);
+            chunk.remove_prefix(nl + 1);
+            std::string whole;
+            if (!pipe.partial.empty()) {
+                pipe.partial.append(line);
+                whole.swap(pipe.partial);
+                line = whole;
+            }
+            while (line.size() > m_options.maxLineBytes) {
+                emitLocked(entry, stream, line.substr(0, m_options.maxLineBytes));
+                line.remove_prefix(m_options.maxLineBytes);
+            }
+            emitLocked(entry, stream, line);
+        }
+    }
+}
+
+void LogCapture::emitLocked(Entry& entry, int stream, std::string_view line)
+{
+    if (!line.empty() && line.back() == '\r')
+        line.remove_suffix(1);
+    ++entry.counters.lines;
+
+    if (entry.file)
+        entry.file->log(spdlog::details::log_msg(stream ? "stderr" : "stdout", spdlog::level::info,
+                                                 spdlog::string_view_t(line.data(), line.size())));
+
+    if (m_options.linesPerSecond > 0) {
+        const auto now = std::chrono::steady_clock::now();
+        const double elapsed = std::chrono::duration<double>(now - entry.refilled).count();
+        entry.refilled = now;
+        entry.tokens = std::min(std::max(m_options.burst, 1.0),
+                                entry.tokens + elapsed * m_options.linesPerSecond);
+        if (entry.tokens < 1.0) {
+            ++entry.counters.suppressed;
+            ++entry.pendingSuppressed;
+            return;
+        }
+        entry.tokens -= 1.0;
+        reportSuppressedLocked(entry);
+    }
+
+    const Stream s = stream ? Stream::Stderr : Stream::Stdout;
+    if (m_onLine)
+        m_onLine(entry.name, s, line);
+    else
+        entry.channel->info("{}", line);
+}
+
+void LogCapture::reportSuppressedLocked(Entry& entry)
+{
+    if (entry.pendingSuppressed == 0)
+        return;
+    entry.channel->warn("{} output line(s) suppressed by the rate limit ({}/s)",
+                        entry.pendingSuppressed, m_options.linesPerSecond);
+    entry.pendingSuppressed = 0;
+}
+
+} // namespace LogosCore
@@ -0,0 +1,143 @@
+#ifndef LOG_CAPTURE_H
+#define LOG_CAPTURE_H
+
+#include <nlohmann/json.hpp>
+#include <spdlog/logger.h>
+#include <spdlog/sinks/sink.h>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace LogosCore {
+
+struct LogCaptureOptions {
+    // Also write every line, unthrottled, to <fileDir>/<module>.log, rotated
+    // at maxFileBytes keeping maxFiles old files. Empty: no files.
+    std::string fileDir;
+    std::size_t maxFileBytes = 10 * 1024 * 1024;
+    std::size_t maxFiles = 3;
+
+    // Token bucket per module for lines routed to the logger; lines over the
+    // rate are counted and reported, not logged. 0: unlimited.
+    double linesPerSecond = 200;
+    double burst = 400;
+
+    // Longer lines are split.
+    std::size_t maxLineBytes = 4096;
+
+    // { "file_dir", "max_file_bytes", "max_files", "lines_per_second",
+    //   "burst", "max_line_bytes" } — all optional. nullopt on a bad type.
+    static std::optional<LogCaptureOptions> fromJson(const nlohmann::json& j);
+};
+
+// Collects module processes' stdout/stderr and routes them, line by line,
+// into the logging channel "module.<name>" (so LOGOS_LOG_LEVEL can tune a
+// single module, e.g. "info,module.chat=warn").
+//
+// The container owns the spawn, so output is redirected by the launch
+// command instead: open() makes a FIFO per stream, and wrapCommand() runs the
+// host binary under /bin/sh, which redirects into them and execs the host
+// (same pid). One epoll thread reads every FIFO. The core keeps each FIFO
+// open read-write so a module never sees EPIPE, and reads what is left when
+// the module is closed.
+//
+// Linux only (epoll); start() returns false elsewhere. Thread-safe.
+class LogCapture {
+public:
+    enum class Stream { Stdout, Stderr };
+    // Where routed lines go; defaults to the module's logger channel at info.
+    using LineFn = std::function<void(const std::string& module, Stream stream, std::string_view line)>;
+
+    explicit LogCapture(LogCaptureOptions options = {}, LineFn onLine = {});
+    ~LogCapture();
+
+    LogCapture(const LogCapture&) = delete;
+    LogCapture& operator=(const LogCapture&) = delete;
+
+    // Create the FIFO directory and start the reader thread.
+    bool start();
+    // Close every module and stop the reader.
+    void stop();
+
+    struct Redirect {
+        std::string stdoutPath;
+        std::string stderrPath;
+        uint64_t id = 0;   // this capture of the module, for close()
+    };
+    // Start capturing `module` (closing any previous capture of that name).
+    std::optional<Redirect> open(const std::string& module);
+    // Read what is left, flush a trailing partial line, report suppressed
+    // lines and forget the module. With a non-zero `id`, only if that capture
+    // is still the current one (a late exit callback must not close the
+    // capture of a restarted module).
+    void close(const std::string& module, uint64_t id = 0);
+    void closeAll();
+
+    // `host args...` rewritten to redirect stdout/stderr into `redirect`.
+    static std::pair<std::string, std::vector<std::string>>
+    wrapCommand(const Redirect& redirect, const std::string& host, const std::vector<std::string>& args);
+
+    struct Counters {
+        uint64_t lines = 0;        // complete lines read, both streams
+        uint64_t bytes = 0;
+        uint64_t suppressed = 0;   // dropped by the rate limiter
+    };
+    std::optional<Counters> counters(const std::string& module) const;
+
+    const LogCaptureOptions& options() const { return m_options; }
+    static bool supported();
+
+private:
+    struct Pipe {
+        int fd = -1;
+        std::string path;
+        std::string partial;
+    };
+    struct Entry {
+        uint64_t id = 0;
+        std::string name;
+        Pipe pipes[2];
+        double tokens = 0;
+        std::chrono::steady_clock::time_point refilled;
+        uint64_t pendingSuppressed = 0;
+        Counters counters;
+        spdlog::logger* channel = nullptr;   // registry-owned, lives for the process
+        std::shared_ptr<spdlog::sinks::sink> file;
+    };
+
+    void run();
+    void readPipeLocked(Entry& entry, int stream);
+    void emitLocked(Entry& entry, int stream, std::string_view line);
+    void reportSuppressedLocked(Entry& entry);
+    void closeLocked(const std::string& module, uint64_t id = 0);
+
+    LogCaptureOptions m_options;
+    LineFn m_onLine;
+
+    mutable std::mutex m_mutex;   // held by the reader while it handles an event
+    std::unordered_map<std::string, std::unique_ptr<Entry>> m_entries;
+    std::unordered_map<uint64_t, Entry*> m_byId;
+    uint64_t m_nextId = 1;
+
+    std::string m_fifoDir;
+    int m_epollFd = -1;
+    int m_wakeFd = -1;
+    std::atomic<bool> m_running{false};
+    std::thread m_thread;
+    std::vector<char> m_readBuf;   // guarded by m_mutex
+};
+
+} // namespace LogosCore
+
+#endif // LOG_CAPTURE_H
@@ -1,6 +1,8 @@
 #include "logos_core.h"
 #include "logging/logos_log.h"
 #include "module_manager.h"
+#include "lifecycle_trace.h"
+#include "event_journal.h"
 #include <logos_instance.h>
 #include <process_stats/process_stats.h>
 #include "token_manager.h"
@@ -22,13 +24,44 @@ void logos_core_add_modules_dir(const char* modules_dir) {
 
 void logos_core_start() {
     logos::initLogging();
+    // Before discovery, so the trace covers the whole boot.
+    LifecycleTrace::startFromEnvironment();
+    EventJournal::startFromEnvironment();
+    LifecycleTrace::Span span("logos_core_start", "boot");
     LogosInstance::id();
     ModuleManager::discoverInstalledModules();
     ModuleManager::initializeCapabilityModule();
+    if (const char* profile = std::getenv("LOGOS_BOOT_PROFILE"); profile && *profile)
+        ModuleManager::startBootProfileFromFile(profile);
 }
 
 void logos_core_cleanup() {
+    ModuleManager::stopBootProfile();
+    ModuleManager::stopMetricsExporter();
+    ModuleManager::stopStatsSampler();
     ModuleManager::clear();
+    ModuleManager::disableLogCapture();
+    LifecycleTrace::stop();
+    EventJournal::stop();
+    // Async logging: shutdown lines are on stderr before the host carries on.
+    logos::flushLogging();
+}
+
+void logos_core_set_shutdown_timeout(int timeout_ms) {
+    ModuleManager::setShutdownTimeout(std::chrono::milliseconds(timeout_ms));
+}
+
+int logos_core_start_boot_profile(const char* profile_json) {
+    if (!profile_json) { logos::logger("core").critical("logos_core_start_boot_profile: profile_json must not be null"); std::abort(); }
+    return ModuleManager::startBootProfile(profile_json) ? 1 : 0;
+}
+
+int logos_core_wait_boot_ready(int timeout_ms) {
+    return ModuleManager::waitBootReady(std::chrono::milliseconds(timeout_ms));
+}
+
+char* logos_core_get_boot_status() {
+    return ModuleManager::getBootStatusCStr();
 }
 
 char** logos_core_get_loaded_modules() {
@@ -50,6 +83,19 @@ int logos_core_load_module(const char* module_name, bool with_dependencies) {
     return ModuleManager::loadModule(module_name) ? 1 : 0;
 }
 
+int logos_core_load_module_with_priority(const char* module_name, bool with_dependencies, int priority) {
+    if (!module_name) { logos::logger("core").critical("logos_core_load_module_with_priority: module_name must not be null"); std::abort(); }
+    if (priority < static_cast<int>(LogosCore::LoadPriority::Interactive)
+        || priority > static_cast<int>(LogosCore::LoadPriority::Background)) {
+        logos::logger("core").warn("logos_core_load_module_with_priority: invalid priority {}", priority);
+        return 0;
+    }
+    const auto p = static_cast<LogosCore::LoadPriority>(priority);
+    if (with_dependencies)
+        return ModuleManager::loadModuleWithDependencies(module_name, p) ? 1 : 0;
+    return ModuleManager::loadModule(module_name, p) ? 1 : 0;
+}
+
 int logos_core_unload_module(const char* module_name, bool with_dependents) {
     if (!module_name) { logos::logger("core").critical("logos_core_unload_module: module_name must not be null"); std::abort(); }
     if (with_dependents)
@@ -57,6 +103,11 @@ int logos_core_unload_module(const char* module_name, bool with_dependents) {
     return ModuleManager::unloadModule(module_name) ? 1 : 0;
 }
 
+int logos_core_upgrade_module(const char* module_name, const char* plugin_path) {
+    if (!module_name) { logos::logger("core").critical("logos_core_upgrade_module: module_name must not be null"); std::abort(); }
+    return ModuleManager::upgradeModule(module_name, plugin_path ? plugin_path : "") ? 1 : 0;
+}
+
 char** logos_core_get_module_dependencies(const char* module_name, bool recursive) {
     if (!module_name) { logos::logger("core").critical("logos_core_get_module_dependencies: module_name must not be null"); std::abort(); }
     return ModuleManager::getDependenciesCStr(module_name, recursive);
@@ -88,7 +139,75 @@ char* logos_core_get_token(const char* key) {
 }
 
 char* logos_core_get_module_stats() {
-    return ProcessStats::getModuleStats(ModuleManager::getModuleProcessIds());
+    return ModuleManager::getModuleStatsCStr();
+}
+
+int logos_core_enable_cgroups(const char* root, const char* policy_json) {
+    return ModuleManager::enableCgroups(root ? root : "", policy_json ? policy_json : "") ? 1 : 0;
+}
+
+int logos_core_set_cpu_placement(const char* policy_json) {
+    return ModuleManager::setCpuPlacement(policy_json ? policy_json : "") ? 1 : 0;
+}
+
+int logos_core_enable_log_capture(const char* options_json) {
+    return ModuleManager::enableLogCapture(options_json ? options_json : "") ? 1 : 0;
+}
+
+int logos_core_start_stats_sampler(int interval_ms, int history_size) {
+    const auto interval = std::chrono::milliseconds(interval_ms > 0 ? interval_ms : 1000);
+    if (history_size <= 0) {
+        logos::logger("core").warn("logos_core_start_stats_sampler: invalid history_size {}", history_size);
+        return 0;
+    }
+    return ModuleManager::startStatsSampler(interval, static_cast<std::size_t>(history_size)) ? 1 : 0;
+}
+
+void logos_core_stop_stats_sampler() {
+    ModuleManager::stopStatsSampler();
+}
+
+char* logos_core_get_module_stats_history(const char* module_name, int window_ms) {
+    if (!module_name) { logos::logger("core").critical("logos_core_get_module_stats_history: module_name must not be null"); std::abort(); }
+    return ModuleManager::getModuleStatsHistoryCStr(
+        module_name, std::chrono::milliseconds(window_ms > 0 ? window_ms : 0));
+}
+
+char* logos_core_get_lifecycle_metrics() {
+    return ModuleManager::getLifecycleMetricsCStr();
+}
+
+char* logos_core_get_boot_report(const char* module_name) {
+    return ModuleManager::getBootReportCStr(module_name);
+}
+
+int logos_core_start_trace(const char* path) {
+    if (!path) { logos::logger("core").critical("logos_core_start_trace: path must not be null"); std::abort(); }
+    return LifecycleTrace::start(std::string(path)) ? 1 : 0;
+}
+
+int logos_core_stop_trace() {
+    return LifecycleTrace::stop() ? 1 : 0;
+}
+
+int logos_core_start_event_journal(const char* path, int max_records) {
+    if (!path) { logos::logger("core").critical("logos_core_start_event_journal: path must not be null"); std::abort(); }
+    const std::size_t capacity = max_records > 0 ? static_cast<std::size_t>(max_records)
+                                                 : EventJournal::kDefaultCapacity;
+    return EventJournal::start(std::string(path), capacity) ? 1 : 0;
+}
+
+int logos_core_stop_event_journal() {
+    return EventJournal::stop() ? 1 : 0;
+}
+
+int logos_core_start_metrics_exporter(const char* endpoint) {
+    if (!endpoint) { logos::logger("core").critical("logos_core_start_metrics_exporter: endpoint must not be null"); std::abort(); }
+    return ModuleManager::startMetricsExporter(std::string(endpoint)) ? 1 : 0;
+}
+
+void logos_core_stop_metrics_exporter() {
+    ModuleManager::stopMetricsExporter();
 }
 
 void logos_core_set_persistence_base_path(const char* path) {
@@ -107,6 +226,37 @@ void logos_core_set_module_transports(const char* module_name,
         transport_set_json ? std::string(transport_set_json) : std::string{});
 }
 
+int logos_core_set_module_replicas(const char* module_name, int count, const char* policy) {
+    if (!module_name) { logos::logger("core").critical("logos_core_set_module_replicas: module_name must not be null"); std::abort(); }
+    auto parsed = policy ? LogosCore::parseReplicaPolicy(policy)
+                         : std::optional<LogosCore::ReplicaPolicy>(LogosCore::ReplicaPolicy::RoundRobin);
+    if (!parsed) {
+        logos::logger("core").warn("logos_core_set_module_replicas: unknown policy {}", policy);
+        return 0;
+    }
+    return ModuleManager::setModuleReplicas(module_name, count, *parsed) ? 1 : 0;
+}
+
+char* logos_core_acquire_module_replica(const char* module_name) {
+    if (!module_name) { logos::logger("core").critical("logos_core_acquire_module_replica: module_name must not be null"); std::abort(); }
+    auto instance = ModuleManager::acquireModuleReplica(module_name);
+    if (!instance)
+        return nullptr;
+    char* result = new char[instance->size() + 1];
+    strcpy(result, instance->c_str());
+    return result;
+}
+
+void logos_core_release_module_replica(const char* module_name, const char* instance) {
+    if (!module_name || !instance) { logos::logger("core").critical("logos_core_release_module_replica: arguments must not be null"); std::abort(); }
+    ModuleManager::releaseModuleReplica(module_name, instance);
+}
+
+char* logos_core_get_module_replicas(const char* module_name) {
+    if (!module_name) { logos::logger("core").critical("logos_core_get_module_replicas: module_name must not be null"); std::abort(); }
+    return ModuleManager::getModuleReplicasCStr(module_name);
+}
+
 void logos_core_set_access_policy(const char* policy_json) {
     // NULL/"" clears the policy (see header) — unlike the module-name
     // setters above, this does not abort on NULL.
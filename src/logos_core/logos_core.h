@@ -47,6 +47,36 @@ LOGOS_CORE_EXPORT void logos_core_start();
 // Clean up resources
 LOGOS_CORE_EXPORT void logos_core_cleanup();
 
+// Bound how long logos_core_cleanup() (and a cascading unload) waits for module processes to exit.
+// Modules are stopped dependents-first in waves, each wave signalled at once;
+// whatever is still running when timeout_ms (shared by all waves; default
+// 3000, < 0 means 0) runs out is killed.
+LOGOS_CORE_EXPORT void logos_core_set_shutdown_timeout(int timeout_ms);
+
+// Load a declarative boot profile in the background: a JSON list of module
+// sets, {"sets": [{"name", "priority", "required", "modules": [...]}]} (or
+// just the array). Required sets load first, then the rest; higher priority
+// first within each group. Each module is loaded after its dependencies, one
+// load call at a time, so the host's own load calls are not held up behind
+// the whole profile. The "ready" milestone is reached once every module of
+// the required sets is loaded; see logos_core_wait_boot_ready(). Setting
+// LOGOS_BOOT_PROFILE=<file> runs a profile at the end of logos_core_start().
+// Returns 1 if started, 0 if the JSON is malformed or a profile is still
+// running. logos_core_cleanup() stops a running profile.
+LOGOS_CORE_EXPORT int logos_core_start_boot_profile(const char* profile_json);
+
+// Wait up to timeout_ms (< 0: no limit) for the boot profile's ready
+// milestone. Returns 1 once every required module is loaded, -1 if one of
+// them failed, was skipped or is unknown (ready can no longer be reached),
+// 0 on timeout or if no profile was started.
+LOGOS_CORE_EXPORT int logos_core_wait_boot_ready(int timeout_ms);
+
+// Progress of the boot profile as JSON: {state ("loading", "ready", "done"
+// or "failed"), ready_ms, finished_ms, sets: [{name, priority, required,
+// modules: [{name, status}]}]}. Returns NULL if no profile was started.
+// The returned string must be freed by the caller
+LOGOS_CORE_EXPORT char* logos_core_get_boot_status();
+
 // Get the list of loaded modules
 // Returns a null-terminated array of module names that must be freed by the caller
 LOGOS_CORE_EXPORT char** logos_core_get_loaded_modules();
@@ -69,6 +99,17 @@ LOGOS_CORE_EXPORT char** logos_core_get_known_modules();
 // Aborts the process if `module_name` is NULL.
 LOGOS_CORE_EXPORT int logos_core_load_module(const char* module_name, bool with_dependencies);
 
+// Same, at an explicit priority: 0 interactive, 1 normal (what
+// logos_core_load_module uses), 2 background. Loads run one at a time; when
+// several are queued the best priority goes next, oldest first, and a
+// waiting request moves up one class for every 250 ms it has waited. An
+// interactive request also moves queued requests for its dependencies up to
+// interactive. Returns 0 for an out-of-range priority, otherwise as
+// logos_core_load_module. Aborts the process if `module_name` is NULL.
+LOGOS_CORE_EXPORT int logos_core_load_module_with_priority(const char* module_name,
+                                                           bool with_dependencies,
+                                                           int priority);
+
 // Unload a specific module by name.
 // When with_dependents is true, also unloads every loaded module that
 // (transitively) depends on it. Dependents come down first (leaves-first)
@@ -76,6 +117,18 @@ LOGOS_CORE_EXPORT int logos_core_load_module(const char* module_name, bool with_
 // Returns 1 if successful, 0 if failed
 LOGOS_CORE_EXPORT int logos_core_unload_module(const char* module_name, bool with_dependents);
 
+// Replace a loaded module's process with a new build without unloading its
+// dependents. The new build (`plugin_path`, or NULL for the registered path
+// rebuilt in place) is started next to the running one and must pass the
+// protocol gate; its dependencies must already be loaded. Once it holds a
+// fresh token of its own (the old process's stays valid), the module's
+// registry entry, token and capability registrations switch to it, and only
+// then is the old process stopped, without holding up other loads.
+// Returns 1 on success, 0 if the module is not loaded or any step fails, in
+// which case the running version is left as it was. Aborts the process if
+// `module_name` is NULL.
+LOGOS_CORE_EXPORT int logos_core_upgrade_module(const char* module_name, const char* plugin_path);
+
 // Return the modules that `module_name` depends on (forward edges).
 // If `recursive` is true, returns the full transitive dependency closure
 // reached by a breadth-first walk; the target itself is not included.
@@ -117,6 +170,111 @@ LOGOS_CORE_EXPORT char* logos_core_get_token(const char* key);
 // The returned string must be freed by the caller
 LOGOS_CORE_EXPORT char* logos_core_get_module_stats();
 
+// Put each module process into its own cgroup v2 leaf under `root` (NULL or
+// empty: this process's own cgroup, which the core then leaves for a
+// "logos-core" leaf), with CPU weight/max, memory.max/high and pids.max from
+// the module metadata's "resources" object, overlaid by the optional host
+// policy JSON {"default": {...}, "modules": {"<name>": {...}}}. Module stats
+// then report the leaf's cpu.stat / memory.current.
+// Returns 1 if enabled, 0 if cgroups are unavailable or not delegated to this
+// process (modules keep launching in the host's cgroup) or the policy is malformed.
+LOGOS_CORE_EXPORT int logos_core_enable_cgroups(const char* root, const char* policy_json);
+
+// Pin each module process to CPUs right after launch. `policy_json` maps
+// modules to placements — {"default": {...}, "modules": {"<name>": {...}}}
+// with {"cpus": "0-3"}, {"numa_node": 1}, {"isolated": true}, {"auto": true}
+// or {"none": true} — and a module's "placement" metadata is used when the
+// policy has no entry for it. Modules without an explicit placement are spread
+// across NUMA nodes (no pinning on single-node hosts). NULL: balancer only.
+// Module stats then include "cpu_affinity" (and "numa_node").
+// Returns 1 on success, 0 on a malformed policy or where affinity is unsupported.
+LOGOS_CORE_EXPORT int logos_core_set_cpu_placement(const char* policy_json);
+
+// Capture the stdout/stderr of each module process launched from now on and
+// log it line by line on the "module.<name>" channel (tunable through
+// LOGOS_LOG_LEVEL like any other). `options_json` (NULL: defaults) may set
+// "lines_per_second" and "burst" (per-module rate limit, default 200/s with
+// bursts of 400; 0 disables it), "max_line_bytes" (default 4096), and
+// "file_dir" to also keep every line in <file_dir>/<module>.log, rotated at
+// "max_file_bytes" (default 10 MiB) keeping "max_files" (default 3).
+// Returns 1 on success, 0 on malformed options or where capture is unsupported.
+LOGOS_CORE_EXPORT int logos_core_enable_log_capture(const char* options_json);
+
+// Start a background thread that samples every module process's CPU and
+// memory each interval_ms (<= 0: 1000) into a per-module history of
+// history_size samples (at most 86400; larger values are capped). While it
+// runs, logos_core_get_module_stats() returns the latest samples instead of
+// reading /proc on the caller's thread. Returns 1 on success, 0 if already
+// running or history_size is not positive.
+LOGOS_CORE_EXPORT int logos_core_start_stats_sampler(int interval_ms, int history_size);
+
+// Stop the sampler and drop its history. logos_core_cleanup() does this implicitly.
+LOGOS_CORE_EXPORT void logos_core_stop_stats_sampler();
+
+// Get the sampled history of one module: the latest sample plus min/max/avg
+// CPU% and memory over the last window_ms, as JSON
+// {name, pid, interval_ms, latest, window}. Never reads /proc.
+// Returns NULL if the sampler is not running or has no samples for the module.
+// The returned string must be freed by the caller
+LOGOS_CORE_EXPORT char* logos_core_get_module_stats_history(const char* module_name, int window_ms);
+
+// Get latency histograms for each phase of module load/unload (metadata
+// extraction, protocol gate, loader selection, container launch, capability
+// barrier, token send/save, capability notify, restriction refresh, totals),
+// aggregate and per module. Fixed power-of-two microsecond buckets plus
+// count/sum/min/max and p50/p90/p99 estimates.
+// Returns a JSON string, never NULL. The returned string must be freed by the caller
+LOGOS_CORE_EXPORT char* logos_core_get_lifecycle_metrics();
+
+// Critical-path report of a boot, computed from each module's mean
+// successful load time (the lifecycle metrics above) and the dependency
+// graph: the earliest-start schedule with unlimited parallel loads, the
+// theoretical minimum boot time, one longest dependency chain, and the
+// modules on it ("gating", slowest first) — the only ones whose load time
+// bounds boot. Covers `module_name` and its dependency closure, or, when
+// `module_name` is NULL, every module that has loaded plus its dependencies.
+// Returns a JSON string, or NULL if `module_name` is not a known module.
+// The returned string must be freed by the caller
+LOGOS_CORE_EXPORT char* logos_core_get_boot_report(const char* module_name);
+
+// Start recording a Chrome trace-event timeline (open it in Perfetto or
+// chrome://tracing) of discovery, metadata extraction, dependency resolution
+// and every module load/unload phase, across all threads. Equivalent to
+// setting LOGOS_TRACE_FILE=<path> before logos_core_start().
+// Returns 1 on success, 0 if a trace is already running or path is empty.
+LOGOS_CORE_EXPORT int logos_core_start_trace(const char* path);
+
+// Stop the running trace and write it to the path given at start.
+// logos_core_cleanup() does this implicitly.
+// Returns 1 if the file was written, 0 if no trace was running or the write failed.
+LOGOS_CORE_EXPORT int logos_core_stop_trace();
+
+// Start appending a binary journal of lifecycle events (loads, unloads,
+// protocol-gate decisions, token hand-offs and restriction pushes) to `path`,
+// a memory-mapped file sized for `max_records` fixed-size records (<= 0 means
+// 1048576). Decode it with the logos_event_journal tool. Equivalent to setting
+// LOGOS_EVENT_JOURNAL=<path> before logos_core_start().
+// Returns 1 on success, 0 if a journal is already running, path is empty or
+// the file cannot be created.
+LOGOS_CORE_EXPORT int logos_core_start_event_journal(const char* path, int max_records);
+
+// Stop the running journal and trim its file to the records written.
+// logos_core_cleanup() does this implicitly.
+// Returns 1 if a journal was running, 0 otherwise.
+LOGOS_CORE_EXPORT int logos_core_stop_event_journal();
+
+// Serve core metrics in OpenMetrics text format (load/failure/unload/restart
+// counters, lifecycle latency histograms, known/loaded module counts and
+// per-module CPU/memory) for Prometheus-style scrapers, over HTTP on a local
+// endpoint: "unix:/path.sock" (or just "/path.sock") for a Unix socket, or
+// "[127.0.0.1:]port" for loopback TCP. Samples are refreshed every 5 s on a
+// background thread and scrapes are served from that cache.
+// Returns 1 on success, 0 if already running or the endpoint cannot be bound.
+LOGOS_CORE_EXPORT int logos_core_start_metrics_exporter(const char* endpoint);
+
+// Stop the metrics exporter, if running. logos_core_cleanup() does this implicitly.
+LOGOS_CORE_EXPORT void logos_core_stop_metrics_exporter();
+
 // Set the base directory for module instance persistence.
 // Each module gets a subdirectory: {path}/{module_name}/{instance_id}/
 // Must be called before logos_core_start().
@@ -138,6 +296,34 @@ LOGOS_CORE_EXPORT void logos_core_set_persistence_base_path(const char* path);
 LOGOS_CORE_EXPORT void logos_core_set_module_transports(const char* module_name,
                                                          const char* transport_set_json);
 
+// Run `count` instances of a CPU-bound, stateless module instead of one.
+// The primary keeps the module's name; replica i (1..count-1) runs as
+// "<module_name>_r<i>" with its own instance persistence path and token.
+// `policy` picks how calls are spread: "round_robin" (NULL) or
+// "least_loaded" (fewest calls in flight). Takes effect the next time the
+// module loads; count 1 turns it off. Returns 0 for a count outside 1..64 or
+// an unknown policy, 1 otherwise. Aborts the process if `module_name` is
+// NULL.
+LOGOS_CORE_EXPORT int logos_core_set_module_replicas(const char* module_name, int count,
+                                                      const char* policy);
+
+// Pick the instance of a loaded module to send the next call to, and count
+// the call as in flight until logos_core_release_module_replica(). Returns
+// the module's container key when it runs a single instance (its own name
+// unless logos_core_upgrade_module() moved it), NULL when it is not loaded. Aborts the process if `module_name` is NULL.
+// The returned string must be freed by the caller
+LOGOS_CORE_EXPORT char* logos_core_acquire_module_replica(const char* module_name);
+
+// The call on `instance` (from logos_core_acquire_module_replica) is done.
+// Aborts the process if either argument is NULL.
+LOGOS_CORE_EXPORT void logos_core_release_module_replica(const char* module_name,
+                                                          const char* instance);
+
+// A loaded module's instances as JSON: {module, policy, replicas: [{instance,
+// pid, in_flight, dispatched}]}. Returns NULL if the module is not loaded.
+// The returned string must be freed by the caller
+LOGOS_CORE_EXPORT char* logos_core_get_module_replicas(const char* module_name);
+
 // Install the inter-module access policy: which callers may invoke which
 // targets. `policy_json` shape:
 //
@@ -0,0 +1,353 @@
+#include "metrics_exporter.h"
+
+#include <spdlog/spdlog.h>
+
+#if defined(__linux__) || defined(__APPLE__)
+#define LOGOS_METRICS_EXPORTER_SOCKETS 1
+#include <arpa/inet.h>
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+#endif
+
+namespace LogosCore {
+
+#ifdef LOGOS_METRICS_EXPORTER_SOCKETS
+
+namespace {
+
+constexpr const char* kContentType = "application/openmetrics-text; version=1.0.0; charset=utf-8";
+constexpr std::size_t kMaxRequestBytes = 8192;
+
+void closeFd(int& fd)
+{
+    if (fd >= 0) {
+        ::close(fd);
+        fd = -1;
+    }
+}
+
+#ifdef __APPLE__
+// No SOCK_CLOEXEC / pipe2 / accept4 on macOS: set the flag right after.
+int cloexec(int fd)
+{
+    if (fd >= 0)
+        ::fcntl(fd, F_SETFD, FD_CLOEXEC);
+    return fd;
+}
+
+int openSocket(int domain)
+{
+    return cloexec(::socket(domain, SOCK_STREAM, 0));
+}
+
+bool openPipe(int fds[2])
+{
+    if (::pipe(fds) != 0)
+        return false;
+    cloexec(fds[0]);
+    cloexec(fds[1]);
+    return true;
+}
+
+// No MSG_NOSIGNAL either; a closed peer is kept from raising SIGPIPE per
+// socket instead.
+int acceptClient(int listenFd)
+{
+    const int fd = cloexec(::accept(listenFd, nullptr, nullptr));
+    if (fd >= 0) {
+        const int one = 1;
+        ::setsockopt(fd, SOL_SOCKET, SO_NOSIGPIPE, &one, sizeof(one));
+    }
+    return fd;
+}
+
+constexpr int kSendFlags = 0;
+#else
+int openSocket(int domain)
+{
+    return ::socket(domain, SOCK_STREAM | SOCK_CLOEXEC, 0);
+}
+
+bool openPipe(int fds[2])
+{
+    return ::pipe2(fds, O_CLOEXEC) == 0;
+}
+
+int acceptClient(int listenFd)
+{
+    return ::accept4(listenFd, nullptr, nullptr, SOCK_CLOEXEC);
+}
+
+constexpr int kSendFlags = MSG_NOSIGNAL;
+#endif
+
+bool sendAll(int fd, const char* data, std::size_t len)
+{
+    while (len > 0) {
+        const ssize_t n = ::send(fd, data, len, kSendFlags);
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            return false;
+        }
+        data += n;
+        len -= static_cast<std::size_t>(n);
+    }
+    return true;
+}
+
+// Parse "[127.0.0.1:|localhost:]port". Any other host is refused: the exporter
+// carries per-module process details and must not be reachable off-box.
+bool parseLoopbackPort(const std::string& endpoint, int& port)
+{
+    std::string portPart = endpoint;
+    if (auto colon = endpoint.rfind(':'); colon != std::string::npos) {
+        const std::string host = endpoint.substr(0, colon);
+        if (host != "127.0.0.1" && host != "localhost")
+            return false;
+        portPart = endpoint.substr(colon + 1);
+    }
+    if (portPart.empty() || portPart.size() > 5)
+        return false;
+    for (char c : portPart)
+        if (c < '0' || c > '9') return false;
+    port = std::stoi(portPart);
+    return port <= 65535;
+}
+
+} // namespace
+
+#endif // LOGOS_METRICS_EXPORTER_SOCKETS
+
+MetricsExporter::MetricsExporter(RenderFn render, std::chrono::milliseconds refresh)
+    : m_render(std::move(render))
+    , m_refresh(refresh)
+    , m_cached(std::make_shared<const std::string>())
+{}
+
+MetricsExporter::~MetricsExporter()
+{
+    stop();
+}
+
+bool MetricsExporter::running() const
+{
+    return m_thread.joinable();
+}
+
+int MetricsExporter::boundPort() const
+{
+    return m_port;
+}
+
+std::string MetricsExporter::cachedText() const
+{
+    std::lock_guard lock(m_mutex);
+    return *m_cached;
+}
+
+bool MetricsExporter::start(const std::string& endpoint)
+{
+    if (running()) {
+        spdlog::warn("Metrics exporter already running");
+        return false;
+    }
+#ifndef LOGOS_METRICS_EXPORTER_SOCKETS
+    spdlog::warn("Metrics exporter is not supported on this platform ({})", endpoint);
+    return false;
+#else
+
+    std::string unixPath;
+    if (endpoint.rfind("unix:", 0) == 0)
+        unixPath = endpoint.substr(5);
+    else if (!endpoint.empty() && endpoint.front() == '/')
+        unixPath = endpoint;
+
+    if (!unixPath.empty()) {
+        sockaddr_un addr{};
+        if (unixPath.size() >= sizeof(addr.sun_path)) {
+            spdlog::error("Metrics exporter socket path too long: {}", unixPath);
+            return false;
+        }
+        addr.sun_family = AF_UNIX;
+        std::memcpy(addr.sun_path, unixPath.c_str(), unixPath.size() + 1);
+
+        // Replace a stale socket left by a previous run, but never another
+        // kind of file.
+        struct stat st{};
+        if (::lstat(unixPath.c_str(), &st) == 0 && S_ISSOCK(st.st_mode))
+            ::unlink(unixPath.c_str());
+
+        m_listenFd = openSocket(AF_UNIX);
+        if (m_listenFd < 0
+            || ::bind(m_listenFd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0) {
+            spdlog::error("Metrics exporter cannot bind {}: {}", unixPath, std::strerror(errno));
+            closeFd(m_listenFd);
+            return false;
+        }
+        m_unixPath = unixPath;
+        m_port = 0;
+    } else {
+        int port = 0;
+        if (!parseLoopbackPort(endpoint, port)) {
+            spdlog::error("Metrics exporter endpoint must be a Unix socket path or a "
+                          "loopback [127.0.0.1:]port, got: {}", endpoint);
+            return false;
+        }
+        sockaddr_in addr{};
+        addr.sin_family = AF_INET;
+        addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        addr.sin_port = htons(static_cast<uint16_t>(port));
+
+        m_listenFd = openSocket(AF_INET);
+        const int one = 1;
+        if (m_listenFd >= 0)
+            ::setsockopt(m_listenFd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+        if (m_listenFd < 0
+            || ::bind(m_listenFd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0) {
+            spdlog::error("Metrics exporter cannot bind 127.0.0.1:{}: {}", port, std::strerror(errno));
+            closeFd(m_listenFd);
+            return false;
+        }
+        socklen_t len = sizeof(addr);
+        ::getsockname(m_listenFd, reinterpret_cast<sockaddr*>(&addr), &len);
+        m_port = ntohs(addr.sin_port);
+    }
+
+    if (::listen(m_listenFd, 16) != 0 || !openPipe(m_wakeFds)) {
+        spdlog::error("Metrics exporter cannot listen: {}", std::strerror(errno));
+        closeFd(m_listenFd);
+        closeFd(m_wakeFds[0]);
+        closeFd(m_wakeFds[1]);
+        if (!m_unixPath.empty()) {
+            ::unlink(m_unixPath.c_str());
+            m_unixPath.clear();
+        }
+        return false;
+    }
+
+    // First render before accepting, so no scrape ever sees an empty cache.
+    refresh();
+    m_thread = std::thread([this]() { run(); });
+    spdlog::info("Metrics exporter serving on {}",
+                 m_unixPath.empty() ? "127.0.0.1:" + std::to_string(m_port) : m_unixPath);
+    return true;
+#endif
+}
+
+void MetricsExporter::stop()
+{
+    if (!running())
+        return;
+#ifdef LOGOS_METRICS_EXPORTER_SOCKETS
+    const char byte = 0;
+    (void)!::write(m_wakeFds[1], &byte, 1);
+    m_thread.join();
+
+    closeFd(m_listenFd);
+    closeFd(m_wakeFds[0]);
+    closeFd(m_wakeFds[1]);
+    if (!m_unixPath.empty()) {
+        ::unlink(m_unixPath.c_str());
+        m_unixPath.clear();
+    }
+    m_port = 0;
+#endif
+}
+
+void MetricsExporter::refresh()
+{
+    std::string text;
+    try {
+        text = m_render();
+    } catch (const std::exception& e) {
+        // Keep serving the previous sample rather than nothing.
+        spdlog::warn("Metrics exporter render failed: {}", e.what());
+        return;
+    }
+    auto fresh = std::make_shared<const std::string>(std::move(text));
+    std::lock_guard lock(m_mutex);
+    m_cached = std::move(fresh);
+}
+
+void MetricsExporter::run()
+{
+#ifdef LOGOS_METRICS_EXPORTER_SOCKETS
+    using Clock = std::chrono::steady_clock;
+    auto nextRefresh = Clock::now() + m_refresh;
+
+    for (;;) {
+        const auto wait = std::chrono::duration_cast<std::chrono::milliseconds>(
+            nextRefresh - Clock::now());
+        pollfd fds[2] = {{m_listenFd, POLLIN, 0}, {m_wakeFds[0], POLLIN, 0}};
+        const int rc = ::poll(fds, 2, wait.count() > 0 ? static_cast<int>(wait.count()) : 0);
+
+        if (rc > 0 && (fds[1].revents & POLLIN))
+            return;
+        if (rc > 0 && (fds[0].revents & POLLIN))
+            serveOne();
+        if (Clock::now() >= nextRefresh) {
+            refresh();
+            nextRefresh = Clock::now() + m_refresh;
+        }
+    }
+#endif
+}
+
+void MetricsExporter::serveOne()
+{
+#ifdef LOGOS_METRICS_EXPORTER_SOCKETS
+    int fd = acceptClient(m_listenFd);
+    if (fd < 0)
+        return;
+
+    // A stalled client may delay the next scrape, never the load path.
+    timeval tv{1, 0};
+    ::setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof(tv));
+    ::setsockopt(fd, SOL_SOCKET, SO_SNDTIMEO, &tv, sizeof(tv));
+
+    std::string request;
+    char buf[1024];
+    while (request.size() < kMaxRequestBytes && request.find("\r\n\r\n") == std::string::npos) {
+        const ssize_t n = ::recv(fd, buf, sizeof(buf), 0);
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) break;
+        request.append(buf, static_cast<std::size_t>(n));
+    }
+
+    std::string status = "200 OK";
+    std::shared_ptr<const std::string> body;
+    const auto lineEnd = request.find("\r\n");
+    const std::string line = request.substr(0, lineEnd);
+    if (line.rfind("GET ", 0) != 0) {
+        status = "405 Method Not Allowed";
+    } else {
+        const auto pathEnd = line.find(' ', 4);
+        const std::string path = line.substr(4, pathEnd == std::string::npos ? std::string::npos : pathEnd - 4);
+        if (path == "/" || path == "/metrics" || path.rfind("/metrics?", 0) == 0) {
+            std::lock_guard lock(m_mutex);
+            body = m_cached;
+        } else {
+            status = "404 Not Found";
+        }
+    }
+
+    const std::size_t bodyLen = body ? body->size() : 0;
+    std::string header = "HTTP/1.0 " + status + "\r\n";
+    if (body)
+        header += std::string("Content-Type: ") + kContentType + "\r\n";
+    header += "Content-Length: " + std::to_string(bodyLen) + "\r\nConnection: close\r\n\r\n";
+
+    if (sendAll(fd, header.data(), header.size()) && body)
+        sendAll(fd, body->data(), body->size());
+    ::close(fd);
+#endif
+}
+
+} // namespace LogosCore
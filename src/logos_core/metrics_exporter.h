@@ -0,0 +1,73 @@
+#ifndef METRICS_EXPORTER_H
+#define METRICS_EXPORTER_H
+
+#include <chrono>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+
+namespace LogosCore {
+
+// Minimal HTTP/1.0 endpoint serving a cached text exposition (Qt-free,
+// POSIX sockets; Linux and macOS — elsewhere start() refuses). Used for the OpenMetrics exporter; the text itself comes
+// from a caller-supplied render function.
+//
+// One background thread owns the listening socket. It re-renders the cache
+// every `refresh` interval and answers each scrape from the cache, so a
+// scrape never runs the render function — and never touches core state —
+// on the request path. GET / and GET /metrics return the text; anything else
+// is 404.
+//
+// Endpoints are local-only:
+//   "unix:/path/to.sock" or "/path/to.sock"   Unix domain socket
+//   "9464", "127.0.0.1:9464", "localhost:9464" loopback TCP (port 0 = any)
+class MetricsExporter {
+public:
+    using RenderFn = std::function<std::string()>;
+
+    explicit MetricsExporter(RenderFn render,
+                             std::chrono::milliseconds refresh = std::chrono::seconds(5));
+    ~MetricsExporter();
+
+    MetricsExporter(const MetricsExporter&) = delete;
+    MetricsExporter& operator=(const MetricsExporter&) = delete;
+
+    // Bind `endpoint`, render once, and start serving. False (with a log line)
+    // on a malformed or non-local endpoint, a bind failure, if already
+    // running, or on a platform other than Linux / macOS.
+    bool start(const std::string& endpoint);
+
+    // Stop serving and close the socket (removing a Unix socket file).
+    void stop();
+
+    bool running() const;
+
+    // TCP port actually bound (useful with port 0); 0 for Unix sockets.
+    int boundPort() const;
+
+    // The text the next scrape would get.
+    std::string cachedText() const;
+
+private:
+    void run();
+    void refresh();
+    void serveOne();
+
+    RenderFn m_render;
+    std::chrono::milliseconds m_refresh;
+
+    mutable std::mutex m_mutex;  // guards m_cached
+    std::shared_ptr<const std::string> m_cached;
+
+    int m_listenFd = -1;
+    int m_wakeFds[2] = {-1, -1};
+    int m_port = 0;
+    std::string m_unixPath;
+    std::thread m_thread;
+};
+
+} // namespace LogosCore
+
+#endif // METRICS_EXPORTER_H
@@ -0,0 +1,68 @@
+#ifndef MODULE_BITSET_H
+#define MODULE_BITSET_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace LogosCore {
+
+// Growable bitset indexed by ModuleRegistry's dense module ids. Header-only,
+// std-only. Used for the registry's dependents x loaded matrix, where a
+// target's loaded dependents are one word-wise AND away instead of a walk of
+// the dependents list with a registry lookup per entry.
+class ModuleBitset {
+public:
+    void set(std::size_t i)
+    {
+        const std::size_t w = i / 64;
+        if (w >= m_words.size())
+            m_words.resize(w + 1, 0);
+        m_words[w] |= (uint64_t{1} << (i % 64));
+    }
+
+    void reset(std::size_t i)
+    {
+        const std::size_t w = i / 64;
+        if (w < m_words.size())
+            m_words[w] &= ~(uint64_t{1} << (i % 64));
+    }
+
+    bool test(std::size_t i) const
+    {
+        const std::size_t w = i / 64;
+        return w < m_words.size() && (m_words[w] >> (i % 64)) & 1u;
+    }
+
+    void clear() { m_words.clear(); }
+
+    bool none() const
+    {
+        for (uint64_t w : m_words)
+            if (w) return false;
+        return true;
+    }
+
+    // Calls fn(index) for every bit set in (*this & other), in index order.
+    template <typename Fn>
+    void forEachAnd(const ModuleBitset& other, Fn&& fn) const
+    {
+        const std::size_t n = m_words.size() < other.m_words.size()
+                                  ? m_words.size() : other.m_words.size();
+        for (std::size_t w = 0; w < n; ++w) {
+            uint64_t bits = m_words[w] & other.m_words[w];
+            while (bits) {
+                const unsigned b = static_cast<unsigned>(__builtin_ctzll(bits));
+                fn(w * 64 + b);
+                bits &= bits - 1;
+            }
+        }
+    }
+
+private:
+    std::vector<uint64_t> m_words;
+};
+
+} // namespace LogosCore
+
+#endif // MODULE_BITSET_H
@@ -30,6 +30,9 @@ public:
     virtual std::string id() const = 0;
 
     // Return true if this loader knows how to load the described module.
+    // ModuleLoaderRegistry memoizes the answer per (desc.format,
+    // desc.loaderConfig), so it should depend on nothing else; a loader whose
+    // answer changes over time calls ModuleLoaderRegistry::invalidateSelections().
     virtual bool canHandle(const ModuleDescriptor& desc) const = 0;
 
     // Load the module. On success, populate `out` and return true.
@@ -1,21 +1,54 @@
 #include "module_loader_registry.h"
 
+#include <atomic>
+
 namespace LogosCore {
 
+namespace {
+
+// Distinct (format, loaderConfig) pairs are few in practice; this only bounds
+// a host that generates configs per module.
+constexpr std::size_t kMaxMemoizedSelections = 256;
+
+} // anonymous namespace
+
+std::shared_ptr<const ModuleLoaderRegistry::State> ModuleLoaderRegistry::snapshot() const
+{
+    return std::atomic_load(&m_state);
+}
+
+void ModuleLoaderRegistry::replaceLoaders(std::vector<std::shared_ptr<ModuleLoader>> loaders)
+{
+    auto next = std::make_shared<State>();
+    next->generation = snapshot()->generation + 1;
+    next->loaders = std::move(loaders);
+    std::atomic_store(&m_state, std::shared_ptr<const State>(std::move(next)));
+}
+
 void ModuleLoaderRegistry::registerLoader(std::shared_ptr<ModuleLoader> loader)
 {
     std::lock_guard lock(m_mutex);
-    m_loaders.push_back(std::move(loader));
+    auto loaders = snapshot()->loaders;
+    loaders.push_back(std::move(loader));
+    replaceLoaders(std::move(loaders));
 }
 
-std::shared_ptr<ModuleLoader> ModuleLoaderRegistry::select(const ModuleDescriptor& desc) const
+std::string ModuleLoaderRegistry::selectionKey(const ModuleDescriptor& desc)
 {
-    std::lock_guard lock(m_mutex);
+    std::string key = desc.format;
+    key += '\0';
+    if (!desc.loaderConfig.empty())
+        key += desc.loaderConfig.dump();
+    return key;
+}
 
+std::shared_ptr<ModuleLoader> ModuleLoaderRegistry::selectFrom(const State& state,
+                                                               const ModuleDescriptor& desc)
+{
     // Explicit id override: caller pinned a specific loader id.
     if (desc.loaderConfig.contains("id")) {
         std::string requestedId = desc.loaderConfig.at("id").get<std::string>();
-        for (const auto& loader : m_loaders) {
+        for (const auto& loader : state.loaders) {
             if (loader->id() == requestedId)
                 return loader;
         }
@@ -24,24 +57,49 @@ std::shared_ptr<ModuleLoader> ModuleLoaderRegistry::select(const ModuleDescripto
     }
 
     // Format/capability-based: first loader that accepts this descriptor.
-    for (const auto& loader : m_loaders) {
+    for (const auto& loader : state.loaders) {
         if (loader->canHandle(desc))
             return loader;
     }
     return nullptr;
 }
 
-void ModuleLoaderRegistry::terminateAll()
+std::shared_ptr<ModuleLoader> ModuleLoaderRegistry::select(const ModuleDescriptor& desc) const
+{
+    auto state = snapshot();
+    std::string key = selectionKey(desc);
+    if (auto it = state->selections.find(key); it != state->selections.end())
+        return it->second;
+
+    auto selected = selectFrom(*state, desc);
+
+    // Memoize, unless the loaders changed while we were choosing.
+    std::lock_guard lock(m_mutex);
+    auto current = snapshot();
+    if (current->generation == state->generation
+        && current->selections.size() < kMaxMemoizedSelections) {
+        auto next = std::make_shared<State>(*current);
+        next->selections.emplace(std::move(key), selected);
+        std::atomic_store(&m_state, std::shared_ptr<const State>(std::move(next)));
+    }
+    return selected;
+}
+
+void ModuleLoaderRegistry::invalidateSelections()
 {
     std::lock_guard lock(m_mutex);
-    for (const auto& loader : m_loaders)
+    replaceLoaders(snapshot()->loaders);
+}
+
+void ModuleLoaderRegistry::terminateAll()
+{
+    for (const auto& loader : snapshot()->loaders)
         loader->terminateAll();
 }
 
 bool ModuleLoaderRegistry::terminate(const std::string& name)
 {
-    std::lock_guard lock(m_mutex);
-    for (const auto& loader : m_loaders) {
+    for (const auto& loader : snapshot()->loaders) {
         if (loader->hasModule(name)) {
             loader->terminate(name);
             return true;
@@ -52,19 +110,23 @@ bool ModuleLoaderRegistry::terminate(const std::string& name)
 
 std::unordered_map<std::string, int64_t> ModuleLoaderRegistry::getAllPids() const
 {
-    std::lock_guard lock(m_mutex);
     std::unordered_map<std::string, int64_t> result;
-    for (const auto& loader : m_loaders) {
+    for (const auto& loader : snapshot()->loaders) {
         auto pids = loader->getAllPids();
         result.insert(pids.begin(), pids.end());
     }
     return result;
 }
 
+std::vector<std::shared_ptr<ModuleLoader>> ModuleLoaderRegistry::all() const
+{
+    return snapshot()->loaders;
+}
+
 void ModuleLoaderRegistry::clearForTests()
 {
     std::lock_guard lock(m_mutex);
-    m_loaders.clear();
+    replaceLoaders({});
 }
 
 } // namespace LogosCore
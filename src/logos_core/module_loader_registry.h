@@ -2,15 +2,19 @@
 #define MODULE_LOADER_REGISTRY_H
 
 #include "module_loader.h"
+#include <cstdint>
 #include <memory>
 #include <mutex>
+#include <string>
 #include <unordered_map>
 #include <vector>
 
 namespace LogosCore {
 
 // Holds all registered ModuleLoader instances and selects one for a given descriptor.
-// Thread-safe (all operations protected by an internal mutex).
+// Thread-safe. The loader list and the selection cache form one immutable
+// snapshot, swapped whole under an internal mutex by writers; readers only
+// load the current snapshot and never take the mutex.
 class ModuleLoaderRegistry {
 public:
     // Register a loader. Loaders are consulted in registration order when
@@ -23,8 +27,16 @@ public:
     //      Returns nullptr if the id is unknown (does not fall through to canHandle).
     //   2. Otherwise, return the first registered loader whose canHandle(desc) is true.
     //   3. Returns nullptr if no loader matches.
+    // The result is memoized per (desc.format, desc.loaderConfig) — the
+    // pinned id plus any container hints — so repeat selections are one hash
+    // lookup and call no canHandle(). registerLoader() and clearForTests()
+    // drop the memo; see ModuleLoader::canHandle for the contract this relies on.
     std::shared_ptr<ModuleLoader> select(const ModuleDescriptor& desc) const;
 
+    // Drop memoized selections, for a loader whose canHandle() answers change
+    // after registration.
+    void invalidateSelections();
+
     // Fan-out terminateAll() to every registered loader.
     void terminateAll();
 
@@ -38,13 +50,28 @@ public:
     // name collision (should not happen in practice).
     std::unordered_map<std::string, int64_t> getAllPids() const;
 
+    // Snapshot of the registered loaders, in registration order.
+    std::vector<std::shared_ptr<ModuleLoader>> all() const;
+
     // Testing hook: remove all loaders so a test can install a FakeModuleLoader
     // without triggering any real Qt subprocess side effects.
     void clearForTests();
 
 private:
-    mutable std::mutex m_mutex;
-    std::vector<std::shared_ptr<ModuleLoader>> m_loaders;
+    struct State {
+        uint64_t generation = 0;   // bumped whenever the memo must be dropped
+        std::vector<std::shared_ptr<ModuleLoader>> loaders;
+        // selectionKey() -> select() result; nullptr memoizes "no loader".
+        std::unordered_map<std::string, std::shared_ptr<ModuleLoader>> selections;
+    };
+
+    static std::string selectionKey(const ModuleDescriptor& desc);
+    static std::shared_ptr<ModuleLoader> selectFrom(const State& state, const ModuleDescriptor& desc);
+    std::shared_ptr<const State> snapshot() const;
+    void replaceLoaders(std::vector<std::shared_ptr<ModuleLoader>> loaders);   // m_mutex held
+
+    mutable std::mutex m_mutex;   // serialises writers, including memo inserts
+    mutable std::shared_ptr<const State> m_state = std::make_shared<const State>();   // atomic_load/atomic_store only
 };
 
 } // namespace LogosCore
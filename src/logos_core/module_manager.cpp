@@ -4,19 +4,36 @@
 #include "dependency_resolver.h"
 #include "module_loader_registry.h"
 #include "composite_module_loader.h"
+#include "capability_notifier.h"
+#include "lifecycle_metrics.h"
+#include "event_journal.h"
+#include "metrics_exporter.h"
+#include "openmetrics.h"
+#include "stats_sampler.h"
+#include "cgroup_manager.h"
+#include "cpu_placement.h"
+#include "log_capture.h"
+#include "token_service.h"
+#include "teardown.h"
+#include "boot_schedule.h"
+#include "boot_profile.h"
+#include "replica_set.h"
+#include <process_stats/process_stats.h>
 #include <logos_container/container_factory.h>
 #include <logos_module_loader/format_loader_factory.h>
 #include <spdlog/spdlog.h>
 #include <nlohmann/json.hpp>
 #include <algorithm>
+#include <atomic>
+#include <condition_variable>
 #include <mutex>
 #include <cassert>
 #include <cstring>
+#include <fstream>
+#include <functional>
 #include <optional>
+#include <shared_mutex>
 #include <unordered_set>
-#include <boost/uuid/uuid.hpp>
-#include <boost/uuid/uuid_generators.hpp>
-#include <boost/uuid/uuid_io.hpp>
 #include "logos_api.h"
 #include "logos_api_client.h"
 #include "logos_module.h"
@@ -37,6 +54,42 @@ namespace {
         return mutex;
     }
 
+    // Orders load requests before they take loadMutex(): the one admitted
+    // is the only load waiting on it, so priority rather than lock
+    // contention picks who goes next. Unloads and clear() take loadMutex()
+    // directly.
+    LogosCore::LoadScheduler& loadScheduler() {
+        static LogosCore::LoadScheduler scheduler;
+        return scheduler;
+    }
+
+    // Modules a load request will touch: the target, plus its dependency
+    // closure when that gets loaded too or the request is interactive (so it
+    // can promote queued work for those dependencies).
+    std::vector<std::string> loadRequestModules(const std::string& name, bool closure) {
+        if (!closure)
+            return {name};
+        auto resolved = DependencyResolver::resolve(
+            {name},
+            [](const std::string& n) { return registryInstance().isKnown(n); },
+            [](const std::string& n) { return registryInstance().moduleDependencies(n); });
+        if (resolved.order.empty())
+            return {name};
+        return resolved.order;
+    }
+
+    LogosCore::LoadScheduler::Admission admitLoad(const std::string& name, bool withDependencies,
+                                                  LogosCore::LoadPriority priority) {
+        const bool closure = withDependencies || priority == LogosCore::LoadPriority::Interactive;
+        auto admission = loadScheduler().admit(priority, loadRequestModules(name, closure));
+        const auto waitedMs = std::chrono::duration<double, std::milli>(admission.waited()).count();
+        if (waitedMs >= 1)
+            spdlog::debug("Load of {} ({}{}) waited {:.1f} ms in the load queue", name,
+                          LogosCore::loadPriorityName(priority),
+                          admission.promoted() ? ", promoted" : "", waitedMs);
+        return admission;
+    }
+
     // Per-module transport set, keyed by module name. Set by the
     // daemon before the corresponding module loads (capability_module
     // before logos_core_start; user modules before loadModule). Empty
@@ -46,12 +99,177 @@ namespace {
         return m;
     }
 
+    // Per-module replica count and dispatch policy, set before the module
+    // loads. Guarded by loadMutex(), like moduleTransportsMap().
+    struct ReplicaConfig {
+        int count = 1;
+        LogosCore::ReplicaPolicy policy = LogosCore::ReplicaPolicy::RoundRobin;
+    };
+
+    std::unordered_map<std::string, ReplicaConfig>& replicaConfigs() {
+        static std::unordered_map<std::string, ReplicaConfig> m;
+        return m;
+    }
+
+    // Running instances of each loaded module with more than one, keyed by
+    // module name. Own mutex: callers pick an instance for every call and
+    // must not wait behind a load.
+    std::mutex& replicaMutex() {
+        static std::mutex mutex;
+        return mutex;
+    }
+
+    std::unordered_map<std::string, std::shared_ptr<LogosCore::ReplicaSet>>& replicaSets() {
+        static std::unordered_map<std::string, std::shared_ptr<LogosCore::ReplicaSet>> m;
+        return m;
+    }
+
+    std::shared_ptr<LogosCore::ReplicaSet> replicaSetFor(const std::string& name) {
+        std::lock_guard lock(replicaMutex());
+        auto it = replicaSets().find(name);
+        return it == replicaSets().end() ? nullptr : it->second;
+    }
+
+    // Container key of each module whose process was replaced by
+    // upgradeModule() and now runs under another name; absent means the
+    // module's own name. Own mutex: read from termination callbacks and the
+    // stats sampler.
+    std::mutex& instanceKeyMutex() {
+        static std::mutex mutex;
+        return mutex;
+    }
+
+    std::unordered_map<std::string, std::string>& instanceKeys() {
+        static std::unordered_map<std::string, std::string> m;
+        return m;
+    }
+
+    std::string instanceKeyOf(const std::string& name) {
+        std::lock_guard lock(instanceKeyMutex());
+        auto it = instanceKeys().find(name);
+        return it == instanceKeys().end() ? name : it->second;
+    }
+
+    void forgetInstanceKey(const std::string& name) {
+        std::lock_guard lock(instanceKeyMutex());
+        instanceKeys().erase(name);
+    }
+
+    // Container keys also running a module during an upgrade: the new side
+    // until the swap, then the old side until it is retired. Neither's exit
+    // unloads the module. Guarded by instanceKeyMutex(); sideKeysChanged()
+    // is signalled when one goes away.
+    std::unordered_map<std::string, std::vector<std::string>>& sideKeys() {
+        static std::unordered_map<std::string, std::vector<std::string>> m;
+        return m;
+    }
+
+    std::condition_variable& sideKeysChanged() {
+        static std::condition_variable cv;
+        return cv;
+    }
+
+    // Assumes instanceKeyMutex().
+    bool isSideKeyLocked(const std::string& key) {
+        for (const auto& [module, keys] : sideKeys()) {
+            if (std::find(keys.begin(), keys.end(), key) != keys.end())
+                return true;
+        }
+        return false;
+    }
+
+    void addSideKey(const std::string& name, const std::string& key) {
+        std::lock_guard lock(instanceKeyMutex());
+        sideKeys()[name].push_back(key);
+    }
+
+    void dropSideKey(const std::string& name, const std::string& key) {
+        {
+            std::lock_guard lock(instanceKeyMutex());
+            auto it = sideKeys().find(name);
+            if (it != sideKeys().end()) {
+                it->second.erase(std::remove(it->second.begin(), it->second.end(), key),
+                                 it->second.end());
+                if (it->second.empty())
+                    sideKeys().erase(it);
+            }
+        }
+        sideKeysChanged().notify_all();
+    }
+
+    std::vector<std::string> sideKeysOf(const std::string& name) {
+        std::lock_guard lock(instanceKeyMutex());
+        auto it = sideKeys().find(name);
+        return it == sideKeys().end() ? std::vector<std::string>() : it->second;
+    }
+
+    // Block until no upgrade is still retiring a process under `key`, so a
+    // fresh launch under it does not collide with the old entry.
+    void awaitSideKeyFree(const std::string& key) {
+        std::unique_lock lock(instanceKeyMutex());
+        sideKeysChanged().wait(lock, [&key] { return !isSideKeyLocked(key); });
+    }
+
+    // Termination callback for a module's process, keyed by container key.
+    // The module is unloaded only if that process is still the one serving
+    // it, not either side of an upgrade in progress.
+    void onModuleProcessExited(const std::string& key) {
+        std::string name = key;
+        {
+            std::lock_guard lock(instanceKeyMutex());
+            if (isSideKeyLocked(key))
+                return;
+            for (const auto& [module, instance] : instanceKeys()) {
+                if (instance == key) {
+                    name = module;
+                    break;
+                }
+            }
+            auto current = instanceKeys().find(name);
+            if ((current == instanceKeys().end() ? name : current->second) != key)
+                return;
+        }
+        registryInstance().markUnloaded(name);
+    }
+
+    // The extra instances running for `name`, without the primary (which
+    // runs under instanceKeyOf(name)).
+    std::vector<std::string> extraReplicasOf(const std::string& name) {
+        std::vector<std::string> out;
+        if (auto set = replicaSetFor(name)) {
+            const std::string primary = instanceKeyOf(name);
+            for (auto& instance : set->instances()) {
+                if (instance != primary)
+                    out.push_back(std::move(instance));
+            }
+        }
+        return out;
+    }
+
+    // Every other name `name` authenticates and is called under: its
+    // container key after an upgrade, the other side of an upgrade in
+    // progress, and its extra replicas. Access restrictions list these
+    // alongside the module.
+    std::vector<std::string> aliasesOf(const std::string& name) {
+        std::vector<std::string> out;
+        if (std::string key = instanceKeyOf(name); key != name)
+            out.push_back(std::move(key));
+        for (auto& key : sideKeysOf(name)) {
+            if (key != name && std::find(out.begin(), out.end(), key) == out.end())
+                out.push_back(std::move(key));
+        }
+        for (auto& instance : extraReplicasOf(name))
+            out.push_back(std::move(instance));
+        return out;
+    }
+
     std::string& persistenceBasePath() {
         static std::string path;
         return path;
     }
 
-    // Both guarded by loadMutex(). parsedEnforcePolicy is set only in enforce mode.
+    // All guarded by loadMutex(). parsedEnforcePolicy and its compiled lookup
+    // form are set (together) only in enforce mode.
     std::string& accessPolicyJson() {
         static std::string s;
         return s;
@@ -62,14 +280,89 @@ namespace {
         return p;
     }
 
+    std::optional<LogosCore::CompiledAccessPolicy>& compiledEnforcePolicy() {
+        static std::optional<LogosCore::CompiledAccessPolicy> p;
+        return p;
+    }
+
+    // The allowlist most recently queued for each target. A refresh whose
+    // derived list is unchanged is not re-sent. Reset whenever
+    // capability_module's view may have diverged: policy change, capability
+    // module (re)load or unload, teardown. A push that fails drops its entry
+    // again (from the notifier's worker), hence its own mutex.
+    std::mutex& lastPushedMutex() {
+        static std::mutex m;
+        return m;
+    }
+
+    std::unordered_map<std::string, std::vector<std::string>>& lastPushedRestrictions() {
+        static std::unordered_map<std::string, std::vector<std::string>> m;
+        return m;
+    }
+
+    void forgetPushedRestrictions() {
+        std::lock_guard lock(lastPushedMutex());
+        lastPushedRestrictions().clear();
+    }
+
+    // `callers` never reached capability_module for `target`: forget it so
+    // the next refresh sends it again — unless a newer list was queued since.
+    void forgetPushedRestriction(const std::string& target, const std::vector<std::string>& callers) {
+        std::lock_guard lock(lastPushedMutex());
+        auto it = lastPushedRestrictions().find(target);
+        if (it != lastPushedRestrictions().end() && it->second == callers)
+            lastPushedRestrictions().erase(it);
+    }
+
     // Always allowed past the dependency check, so they're never locked out.
     const std::vector<std::string> kTrustedCallers = {"core", "core_service"};
 
     // Never restricted as targets, even if an explicit policy names them.
     // TODO: re-eval this; probably is required to restrict core/core_service
-    const std::vector<std::string> kExemptTargets =
+    const std::unordered_set<std::string> kExemptTargets =
         {"capability_module", "core", "core_service"};
 
+    // Upper bound on tokens minted ahead at discovery; beyond it the pool
+    // refills in batches as loads draw from it.
+    constexpr std::size_t kMaxPrefilledTokens = 256;
+
+    // Upper bound on instances per module, so a typo cannot fork hundreds of
+    // processes.
+    constexpr int kMaxModuleReplicas = 64;
+
+    // Alternate container keys tried for the new side of an upgrade.
+    constexpr int kMaxUpgradeKeyProbes = 16;
+
+    // Upper bound on samples kept per module by the stats sampler: a day at
+    // the default 1 s interval. Each module's ring is sized from it.
+    constexpr std::size_t kMaxStatsHistory = 86400;
+
+    // Memory all modules' rings may take together (~300k samples): with many
+    // modules each ring holds fewer than `historySize` samples.
+    constexpr std::size_t kStatsMemoryBudget = 32u << 20;
+
+    // One deadline for a whole bulk teardown (terminateAll()/clear() or a
+    // cascade unload), across every wave.
+    std::atomic<int64_t>& shutdownTimeoutMs() {
+        static std::atomic<int64_t> ms{3000};
+        return ms;
+    }
+
+    // Mints module auth tokens and caches capability_module's own.
+    LogosCore::TokenService& tokenService() {
+        static LogosCore::TokenService service;
+        return service;
+    }
+
+    // The token that authenticates core -> capability_module calls. Falls
+    // back to TokenManager for a capability_module core did not load itself.
+    std::string capabilityModuleToken() {
+        std::string token = tokenService().capabilityToken();
+        if (token.empty())
+            token = TokenManager::instance().getToken(std::string("capability_module"));
+        return token;
+    }
+
     // Built-in default loader, composed from the container + format-loader the
     // build linked in. The concrete implementations are chosen at link time via
     // the contract factory seams (LogosCore::makeContainer / makeFormatLoader);
@@ -87,6 +380,30 @@ namespace {
         return reg;
     }
 
+    // Every loader's pids keyed by module name rather than container key.
+    // Both sides of an upgrade in progress are left out until they serve
+    // the module.
+    std::unordered_map<std::string, int64_t> modulePids() {
+        auto pids = loaderRegistry().getAllPids();
+        std::lock_guard lock(instanceKeyMutex());
+        if (instanceKeys().empty() && sideKeys().empty())
+            return pids;
+        std::unordered_map<std::string, int64_t> out;
+        for (const auto& [key, pid] : pids) {
+            std::string name = key;
+            for (const auto& [module, instance] : instanceKeys()) {
+                if (instance == key) {
+                    name = module;
+                    break;
+                }
+            }
+            if ((name == key && instanceKeys().count(key)) || isSideKeyLocked(key))
+                continue;
+            out[name] = pid;
+        }
+        return out;
+    }
+
     char** toNullTerminatedArray(const std::vector<std::string>& list) {
         int count = static_cast<int>(list.size());
         if (count == 0) {
@@ -104,19 +421,30 @@ namespace {
         return result;
     }
 
+    // Ordered async pipeline for every core -> capability_module call (see
+    // capability_notifier.h). Keeps that IPC off the loadMutex() critical path.
+    LogosCore::CapabilityNotifier& capabilityNotifier() {
+        static LogosCore::CapabilityNotifier notifier;
+        return notifier;
+    }
+
     // Dial capability_module from a long-lived "core" LogosAPI. Prefer the
     // operator's first configured transport; fall back to the global
     // default (LocalSocket). Needed because the single-arg getClient()
     // always uses the global default, which hangs against a tcp-only
     // capability_module that never bound a LocalSocket.
-    LogosAPIClient* capabilityModuleClient() {
+    //
+    // Only ever called on the notifier's worker thread, so the LogosAPI is
+    // created and used from one thread. `transportSetJson` is capability_module's
+    // entry in moduleTransportsMap(), snapshotted under loadMutex() at enqueue
+    // time — the worker never reads the map itself.
+    LogosAPIClient* capabilityModuleClient(const std::string& transportSetJson) {
         static LogosAPI* s_coreApi = nullptr;
         if (!s_coreApi)
             s_coreApi = new LogosAPI(std::string("core"));
 
-        if (auto it = moduleTransportsMap().find("capability_module");
-            it != moduleTransportsMap().end() && !it->second.empty()) {
-            const auto ts = logos::transportSetFromJsonString(it->second);
+        if (!transportSetJson.empty()) {
+            const auto ts = logos::transportSetFromJsonString(transportSetJson);
             if (!ts.empty()) {
                 return s_coreApi->getClient(
                     QStringLiteral("capability_module"), ts.front());
@@ -125,24 +453,75 @@ namespace {
         return s_coreApi->getClient(std::string("capability_module"));
     }
 
-    // Token authenticates the call. Best-effort; assumes capability_module loaded.
-    void registerRestrictionRpc(const std::string& target,
+    // Queue a capability_module call behind every earlier one (behind earlier
+    // urgent ones only, if `urgent`); `module` is the barrier key (see
+    // CapabilityNotifier::waitFor). Call with loadMutex() held.
+    LogosCore::CapabilityNotifier::Ticket enqueueCapabilityCall(
+            const std::string& module, std::function<void(LogosAPIClient*)> call,
+            bool urgent = false) {
+        std::string transports;
+        if (auto it = moduleTransportsMap().find("capability_module");
+            it != moduleTransportsMap().end())
+            transports = it->second;
+        LogosCore::CapabilityNotifier::Task task =
+            [transports = std::move(transports), call = std::move(call)]() {
+                call(capabilityModuleClient(transports));
+            };
+        return urgent ? capabilityNotifier().enqueueUrgent(module, std::move(task))
+                      : capabilityNotifier().enqueue(module, std::move(task));
+    }
+
+    // Token authenticates the call. Best-effort; assumes capability_module
+    // loaded. Runs on the notifier's worker thread.
+    bool registerRestrictionRpc(LogosAPIClient* client,
+                                const std::string& target,
                                 const std::vector<std::string>& callers) {
+        EventJournal::Scope journal(EventJournal::Event::RestrictionPush, target);
+        journal.setAux(static_cast<uint32_t>(callers.size()));
         nlohmann::json args = nlohmann::json::array();
-        args.push_back(TokenManager::instance().getToken(std::string("capability_module")));
+        args.push_back(capabilityModuleToken());
         args.push_back(target);
         args.push_back(callers);
 
-        nlohmann::json result = capabilityModuleClient()->invokeRemoteMethod(
+        nlohmann::json result = client->invokeRemoteMethod(
             std::string("capability_module"),
             std::string("registerRestriction"),
             args);
 
-        if (!result.is_boolean() || !result.get<bool>())
+        if (!result.is_boolean() || !result.get<bool>()) {
+            journal.setResult(EventJournal::Failed);
             spdlog::warn("Failed to register access restriction for target: {}", target);
-        else
-            spdlog::info("Registered access restriction for target: {} ({} allowed callers)",
-                         target, callers.size());
+            return false;
+        }
+        spdlog::info("Registered access restriction for target: {} ({} allowed callers)",
+                     target, callers.size());
+        return true;
+    }
+
+    void enqueueRestriction(const std::string& target, std::vector<std::string> callers) {
+        {
+            std::lock_guard lock(lastPushedMutex());
+            auto [it, inserted] = lastPushedRestrictions().try_emplace(target, callers);
+            if (!inserted) {
+                if (it->second == callers)
+                    return;  // capability_module already has (or is about to get) this list
+                it->second = callers;
+            }
+        }
+        const auto ticket = enqueueCapabilityCall(target,
+            [target, callers](LogosAPIClient* client) {
+                bool delivered = false;
+                try {
+                    delivered = registerRestrictionRpc(client, target, callers);
+                } catch (...) {
+                    forgetPushedRestriction(target, callers);
+                    throw;
+                }
+                if (!delivered)
+                    forgetPushedRestriction(target, callers);
+            });
+        if (ticket == 0)   // notifier shutting down: never queued
+            forgetPushedRestriction(target, callers);
     }
 
     // Explicit-policy restrictions, including targets not yet loaded (the
@@ -155,50 +534,68 @@ namespace {
             return;
 
         for (const auto& restriction : policy->restrictions) {
-            if (std::find(kExemptTargets.begin(), kExemptTargets.end(),
-                          restriction.target) != kExemptTargets.end())
+            if (kExemptTargets.count(restriction.target))
                 continue;
-            registerRestrictionRpc(restriction.target, restriction.allowedCallers);
+            enqueueRestriction(restriction.target, restriction.allowedCallers);
         }
     }
 
     // A module may only call modules it declared as a dependency, so `target`'s
     // allowed callers are its loaded dependents plus the trusted set. Empty when
     // exempt or no enforce policy (fail-open); explicit policy overrides verbatim.
+    //
+    // Every step is a hash lookup or a bitset AND: the explicit entry comes
+    // from the policy compiled in setAccessPolicy, and the loaded dependents
+    // from ModuleRegistry's dependents x loaded matrix in one locked read.
     std::vector<std::string> computeDerivedAllowedCallersLocked(const std::string& target) {
-        if (std::find(kExemptTargets.begin(), kExemptTargets.end(), target)
-                != kExemptTargets.end())
+        if (kExemptTargets.count(target))
             return {};
 
-        const auto& policy = parsedEnforcePolicy();
+        const auto& policy = compiledEnforcePolicy();
         if (!policy)
             return {};
 
-        for (const auto& r : policy->restrictions)
-            if (r.target == target)
-                return r.allowedCallers;
-
-        // Deduped; no dependents => trusted only (deny-by-default for peers).
-        std::vector<std::string> callers;
-        std::unordered_set<std::string> seen;
-        auto add = [&](const std::string& c) {
-            if (seen.insert(c).second)
-                callers.push_back(c);
+        // A replicated or upgraded caller calls out from every one of its
+        // instances.
+        auto withReplicas = [](std::vector<std::string> callers) {
+            const std::size_t named = callers.size();
+            for (std::size_t i = 0; i < named; ++i) {
+                for (auto& instance : aliasesOf(callers[i]))
+                    callers.push_back(std::move(instance));
+            }
+            return callers;
         };
-        for (const auto& d : registryInstance().moduleDependents(target, /*recursive=*/false))
-            if (registryInstance().isLoaded(d))
-                add(d);
-        for (const auto& t : kTrustedCallers)
-            add(t);
-        return callers;
+
+        if (const auto* explicitCallers = policy->explicitFor(target))
+            return withReplicas(*explicitCallers);
+
+        // Dependents are unique by construction; only a trusted name that is
+        // also a loaded dependent needs deduping. No dependents => trusted only
+        // (deny-by-default for peers).
+        std::vector<std::string> callers = registryInstance().loadedDependents(target);
+        const std::size_t dependentCount = callers.size();
+        for (const auto& t : kTrustedCallers) {
+            if (std::find(callers.begin(), callers.begin() + dependentCount, t)
+                    == callers.begin() + dependentCount)
+                callers.push_back(t);
+        }
+        return withReplicas(std::move(callers));
     }
 
+    // The caller list is derived now, under loadMutex(); only the RPC is
+    // deferred. A later push for the same target is queued behind this one,
+    // so capability_module always ends up with the newest list.
     void pushDerivedRestrictionForTarget(const std::string& target) {
         if (!registryInstance().isLoaded("capability_module"))
             return;
         auto callers = computeDerivedAllowedCallersLocked(target);
-        if (!callers.empty())
-            registerRestrictionRpc(target, callers);
+        if (callers.empty())
+            return;
+        // Replicas and upgrade sides of `target` are called directly, so each
+        // gets the same list.
+        for (const auto& instance : aliasesOf(target))
+            enqueueRestriction(instance, callers);
+        enqueueRestriction(target, std::move(callers));
     }
 
     // On load/unload of `name`, re-push the targets whose caller set changed:
@@ -211,46 +608,391 @@ namespace {
         pushDerivedRestrictionForTarget(name);
     }
 
-    void notifyCapabilityModule(const std::string& name, const std::string& token) {
+    // Urgent, so a load waiting on it (see tokenBarrier) is not held behind
+    // restriction pushes queued by earlier loads. Returns the ticket to wait
+    // on; 0 when capability_module is not loaded.
+    LogosCore::CapabilityNotifier::Ticket notifyCapabilityModule(const std::string& name,
+                                                                 const std::string& token) {
         if (!registryInstance().isLoaded("capability_module"))
-            return;
+            return 0;
+
+        return enqueueCapabilityCall(name, [name, token](LogosAPIClient* client) {
+            LifecycleMetrics::ScopedTimer timer(name, LifecycleMetrics::Phase::CapabilityNotify);
+            EventJournal::Scope journal(EventJournal::Event::TokenNotify, name);
+            if (!client->informModuleToken(capabilityModuleToken(), name, token)) {
+                journal.setResult(EventJournal::Failed);
+                spdlog::warn("Failed to register token with capability module for: {}", name);
+            }
+        }, /*urgent=*/true);
+    }
 
-        TokenManager& tokenManager = TokenManager::instance();
-        std::string capabilityModuleToken = tokenManager.getToken(std::string("capability_module"));
+    // Wait until capability_module can authenticate `name`'s first outbound
+    // call: its own token notification (`ticket`), plus any restriction push
+    // still queued for the targets it may call — its declared dependencies.
+    // Restriction traffic for unrelated targets is not waited on.
+    void tokenBarrier(LogosCore::CapabilityNotifier::Ticket ticket,
+                      const std::vector<std::string>& dependencies) {
+        capabilityNotifier().wait(ticket);
+        for (const auto& dep : dependencies)
+            capabilityNotifier().waitFor(dep);
+    }
 
-        LogosAPIClient* client = capabilityModuleClient();
+    // Optional OpenMetrics endpoint; see startMetricsExporter.
+    std::mutex& metricsExporterMutex() {
+        static std::mutex mutex;
+        return mutex;
+    }
 
-        if (!client->informModuleToken(capabilityModuleToken, name, token)) {
-            spdlog::warn("Failed to register token with capability module for: {}", name);
-        }
+    std::unique_ptr<LogosCore::MetricsExporter>& metricsExporter() {
+        static std::unique_ptr<LogosCore::MetricsExporter> exporter;
+        return exporter;
     }
 
-    bool loadModuleInternal(const char* moduleName) {
-        std::string name(moduleName);
+    // Optional background ProcessStats sampler; see startStatsSampler.
+    // Guards creation/destruction; the sampler's own queries are lock-free.
+    std::shared_mutex& statsSamplerMutex() {
+        static std::shared_mutex mutex;
+        return mutex;
+    }
 
-        if (!registryInstance().isKnown(name)) {
-            spdlog::warn("Cannot load unknown module: {}", name);
+    std::unique_ptr<LogosCore::StatsSampler>& statsSampler() {
+        static std::unique_ptr<LogosCore::StatsSampler> sampler;
+        return sampler;
+    }
+
+    // The current (or last) boot profile run; see startBootProfile. The
+    // mutex guards replacing it; callers copy the pointer and use the
+    // runner (which locks its own state) outside it.
+    std::mutex& bootProfileMutex() {
+        static std::mutex mutex;
+        return mutex;
+    }
+
+    std::shared_ptr<LogosCore::BootProfileRunner>& bootProfileSlot() {
+        static std::shared_ptr<LogosCore::BootProfileRunner> runner;
+        return runner;
+    }
+
+    std::shared_ptr<LogosCore::BootProfileRunner> currentBootProfile() {
+        std::lock_guard lock(bootProfileMutex());
+        return bootProfileSlot();
+    }
+
+    // Per-module cgroup placement; null unless enableCgroups succeeded.
+    // atomic_load/atomic_store only.
+    std::shared_ptr<LogosCore::CgroupManager>& cgroupsSlot() {
+        static std::shared_ptr<LogosCore::CgroupManager> cgroups;
+        return cgroups;
+    }
+
+    std::shared_ptr<LogosCore::CgroupManager> currentCgroups() {
+        return std::atomic_load(&cgroupsSlot());
+    }
+
+    // CPU pinning policy; null unless setCpuPlacement succeeded.
+    // atomic_load/atomic_store only.
+    std::shared_ptr<LogosCore::CpuPlacement>& placementSlot() {
+        static std::shared_ptr<LogosCore::CpuPlacement> placement;
+        return placement;
+    }
+
+    // Hands `placement` (possibly null) to every registered composite loader.
+    void installPlacement(const std::shared_ptr<LogosCore::CpuPlacement>& placement) {
+        for (const auto& loader : loaderRegistry().all())
+            if (auto composite = std::dynamic_pointer_cast<LogosCore::CompositeModuleLoader>(loader))
+                composite->setPlacement(placement);
+    }
+
+    // Module stdout/stderr capture; null unless enableLogCapture succeeded.
+    // atomic_load/atomic_store only.
+    std::shared_ptr<LogosCore::LogCapture>& logCaptureSlot() {
+        static std::shared_ptr<LogosCore::LogCapture> capture;
+        return capture;
+    }
+
+    void installLogCapture(const std::shared_ptr<LogosCore::LogCapture>& capture) {
+        for (const auto& loader : loaderRegistry().all())
+            if (auto composite = std::dynamic_pointer_cast<LogosCore::CompositeModuleLoader>(loader))
+                composite->setLogCapture(capture);
+    }
+
+    // One read of a module's cgroup leaf. Modules without a leaf, or whose
+    // leaf has no memory controller, are read from /proc instead.
+    struct CgroupReading {
+        std::string leaf;
+        LogosCore::CgroupStats stats;
+        double cpuPercent = 0.0;
+    };
+
+    // CPU% of cgroup-accounted modules, from usage_usec deltas between two
+    // reads of the same leaf (ProcessStats keeps the baseline for the rest).
+    struct CgroupCpuBaseline {
+        double cpuSeconds = 0.0;
+        std::chrono::steady_clock::time_point at;
+    };
+
+    std::mutex& cgroupCpuMutex() {
+        static std::mutex mutex;
+        return mutex;
+    }
+
+    std::unordered_map<std::string, CgroupCpuBaseline>& cgroupCpuBaselines() {
+        static std::unordered_map<std::string, CgroupCpuBaseline> baselines;
+        return baselines;
+    }
+
+    double cgroupCpuPercent(const std::string& leaf, double cpuSeconds) {
+        const auto now = std::chrono::steady_clock::now();
+        std::lock_guard lock(cgroupCpuMutex());
+        auto [it, fresh] = cgroupCpuBaselines().try_emplace(leaf, CgroupCpuBaseline{cpuSeconds, now});
+        if (fresh)
+            return 0.0;
+        const double wall = std::chrono::duration<double>(now - it->second.at).count();
+        const double used = cpuSeconds - it->second.cpuSeconds;   // < 0: leaf recreated
+        it->second = {cpuSeconds, now};
+        return wall > 0.0 && used > 0.0 ? used / wall * 100.0 : 0.0;
+    }
+
+    // Leaves are keyed by container key, which an upgrade moves off the
+    // module's name.
+    std::optional<CgroupReading> readModuleCgroup(const std::string& name) {
+        auto cgroups = currentCgroups();
+        if (!cgroups)
+            return std::nullopt;
+        const std::string key = instanceKeyOf(name);
+        auto leaf = cgroups->leafOf(key);
+        auto s = leaf ? cgroups->stats(key) : std::nullopt;
+        if (!s || s->memoryBytes == 0)
+            return std::nullopt;
+        CgroupReading r{std::move(*leaf), *s};
+        r.cpuPercent = cgroupCpuPercent(r.leaf, s->cpuSeconds);
+        return r;
+    }
+
+    // A module process's counters. For a module in its own cgroup, CPU time
+    // and memory come from the leaf's cpu.stat / memory.current, which cover
+    // every process it spawned.
+    bool readModuleProcess(int64_t pid, uint32_t detail, LogosCore::ProcessReading& out) {
+        if (!LogosCore::readProcess(pid, out, detail))
             return false;
+        if (auto cgroups = currentCgroups()) {
+            if (auto s = cgroups->statsForPid(pid)) {
+                out.cpuSeconds = s->cpuSeconds;
+                if (s->memoryBytes > 0)
+                    out.rssBytes = s->memoryBytes;
+            }
         }
+        return true;
+    }
 
-        // "Already loaded" is a successful no-op, not a failure.
-        // Callers (basecamp's PluginLoader::loadCoreDependencies,
-        // logoscore-cli, etc.) use loadModule as "ensure loaded";
-        // returning false here aborted UI-plugin loads whose core
-        // dependency had been pre-loaded at startup (e.g. clicking
-        // the package-manager launcher after basecamp pre-loaded
-        // `package_manager`).
-        if (registryInstance().isLoaded(name)) {
-            spdlog::debug("Module already loaded (no-op): {}", name);
-            return true;
+    // Per-module CPU/memory: the sampler's latest point when it runs (no
+    // /proc work here), otherwise one read per module — of its cgroup leaf
+    // if it has one, else ProcessStats. The ProcessDetail groups come only
+    // from the sampler.
+    std::vector<LogosCore::MetricsSample::ModuleProcess> currentModuleProcesses() {
+        std::vector<LogosCore::MetricsSample::ModuleProcess> out;
+        {
+            std::shared_lock lock(statsSamplerMutex());
+            if (const auto& sampler = statsSampler()) {
+                for (const auto& name : sampler->modules()) {
+                    const auto latest = sampler->latest(name);
+                    if (!latest)
+                        continue;
+                    LogosCore::MetricsSample::ModuleProcess p;
+                    p.name = name;
+                    p.pid = sampler->pidOf(name).value_or(0);
+                    p.cpuPercent = latest->cpuPercent;
+                    p.cpuSeconds = latest->cpuSeconds;
+                    p.memoryBytes = latest->rssBytes;
+                    p.detail = latest->detail;
+                    out.push_back(std::move(p));
+                }
+                return out;
+            }
+        }
+        for (const auto& [name, pid] : modulePids()) {
+            LogosCore::MetricsSample::ModuleProcess p;
+            p.name = name;
+            p.pid = pid;
+            if (auto cg = readModuleCgroup(name)) {
+                p.cpuPercent = cg->cpuPercent;
+                p.cpuSeconds = cg->stats.cpuSeconds;
+                p.memoryBytes = cg->stats.memoryBytes;
+            } else {
+                const auto stats = ProcessStats::getProcessStats(pid);
+                p.cpuPercent = stats.cpuPercent;
+                p.cpuSeconds = stats.cpuTimeSeconds;
+                p.memoryBytes = static_cast<uint64_t>(stats.memoryMB * 1024.0 * 1024.0);
+            }
+            out.push_back(std::move(p));
         }
+        std::sort(out.begin(), out.end(),
+                  [](const auto& a, const auto& b) { return a.name < b.name; });
+        return out;
+    }
 
-        std::string modPath = registryInstance().modulePath(name);
+    // Adds the ProcessDetail fields that were readable to one entry of the
+    // module stats JSON array.
+    void addProcessDetail(nlohmann::json& entry, const LogosCore::ProcessDetail& d) {
+        using LogosCore::ProcessDetail;
+        constexpr double kMB = 1024.0 * 1024.0;
+        if (d.has(ProcessDetail::MemoryDetail)) {
+            entry["pss_mb"] = static_cast<double>(d.pssBytes) / kMB;
+            entry["uss_mb"] = static_cast<double>(d.ussBytes) / kMB;
+        }
+        if (d.has(ProcessDetail::Threads))
+            entry["threads"] = d.threads;
+        if (d.has(ProcessDetail::OpenFds))
+            entry["open_fds"] = d.openFds;
+        if (d.has(ProcessDetail::ContextSwitches)) {
+            entry["voluntary_ctx_switches"] = d.voluntaryCtxSwitches;
+            entry["involuntary_ctx_switches"] = d.involuntaryCtxSwitches;
+        }
+        if (d.has(ProcessDetail::Io)) {
+            entry["io_read_bytes"] = d.ioReadBytes;
+            entry["io_write_bytes"] = d.ioWriteBytes;
+        }
+    }
 
-        // Build a descriptor for the loader to inspect.
+    // Adds a module's cgroup accounting to its entry and makes it the
+    // entry's CPU time and memory.
+    void addCgroupStats(nlohmann::json& entry, const std::string& leaf, const LogosCore::CgroupStats& stats) {
+        constexpr double kMB = 1024.0 * 1024.0;
+        entry["cpu_time_seconds"] = stats.cpuSeconds;
+        if (stats.memoryBytes > 0)
+            entry["memory_mb"] = static_cast<double>(stats.memoryBytes) / kMB;
+        entry["cgroup"] = {
+            {"path", leaf},
+            {"cpu_seconds", stats.cpuSeconds},
+            {"cpu_user_seconds", stats.userSeconds},
+            {"cpu_system_seconds", stats.systemSeconds},
+            {"cpu_throttled_seconds", static_cast<double>(stats.throttledUs) / 1e6},
+            {"memory_mb", static_cast<double>(stats.memoryBytes) / kMB},
+            {"pids", stats.pids},
+        };
+    }
+
+    // Same, for a module that has a leaf (under its container key).
+    void addCgroupStats(nlohmann::json& entry, const std::string& name) {
+        auto cgroups = currentCgroups();
+        if (!cgroups)
+            return;
+        const std::string key = instanceKeyOf(name);
+        auto leaf = cgroups->leafOf(key);
+        if (auto s = leaf ? cgroups->stats(key) : std::nullopt)
+            addCgroupStats(entry, *leaf, *s);
+    }
+
+    void addPlacement(nlohmann::json& entry, const std::string& name) {
+        auto placement = std::atomic_load(&placementSlot());
+        if (!placement)
+            return;
+        if (auto a = placement->assignmentOf(instanceKeyOf(name))) {
+            entry["cpu_affinity"] = LogosCore::formatCpuList(a->cpus);
+            if (a->node >= 0)
+                entry["numa_node"] = a->node;
+        }
+    }
+
+    // Runs on the exporter thread. Reads only state with its own locking
+    // (registry shared lock, loader registry, metric atomics) — never
+    // loadMutex(), so a refresh cannot stall behind a load.
+    LogosCore::MetricsSample collectMetricsSample() {
+        LogosCore::MetricsSample sample;
+        sample.knownModules = registryInstance().knownModuleNames().size();
+        sample.loadedModules = registryInstance().loadedModuleNames().size();
+        sample.lifecycle = LifecycleMetrics::snapshot();
+        sample.processes = currentModuleProcesses();
+        return sample;
+    }
+
+    // Take `name`'s replica set out of dispatch and stop its extra
+    // instances. A no-op for a module running a single instance.
+    void terminateReplicasLocked(const std::string& name,
+                                 const std::shared_ptr<LogosCore::ModuleLoader>& loader) {
+        std::shared_ptr<LogosCore::ReplicaSet> set;
+        {
+            std::lock_guard lock(replicaMutex());
+            auto it = replicaSets().find(name);
+            if (it == replicaSets().end())
+                return;
+            set = std::move(it->second);
+            replicaSets().erase(it);
+        }
+        const std::string primary = instanceKeyOf(name);
+        for (const auto& instance : set->instances()) {
+            if (instance == primary)
+                continue;
+            if (loader)
+                loader->terminate(instance);
+            else
+                loaderRegistry().terminate(instance);
+        }
+    }
+
+    // Start the extra instances configured for `name` once its primary is
+    // up, through the same loader. Each replica is launched under
+    // replicaInstanceName() with its own persistence path and token; the
+    // descriptor's loaderConfig carries "replica_of" / "replica_index" so
+    // the format loader can run the module's plugin under that name. A
+    // replica that fails to start is left out and the module keeps the
+    // instances that did.
+    void launchReplicasLocked(const std::string& name,
+                              const LogosCore::ModuleDescriptor& primary,
+                              const std::shared_ptr<LogosCore::ModuleLoader>& loader) {
+        // Leftovers of an earlier load whose primary exited on its own.
+        terminateReplicasLocked(name, loader);
+
+        auto config = replicaConfigs().find(name);
+        if (config == replicaConfigs().end() || config->second.count <= 1)
+            return;
+
+        auto set = std::make_shared<LogosCore::ReplicaSet>(config->second.policy);
+        set->add(instanceKeyOf(name));
+        for (int index = 1; index < config->second.count; ++index) {
+            const std::string instance = LogosCore::replicaInstanceName(name, index);
+            LogosCore::ModuleDescriptor desc = primary;
+            desc.name = instance;
+            desc.loaderConfig["replica_of"] = name;
+            desc.loaderConfig["replica_index"] = index;
+            if (!persistenceBasePath().empty()) {
+                desc.instancePersistencePath = ModuleLib::InstancePersistence::resolveInstance(
+                    persistenceBasePath(), instance).persistencePath;
+            }
+
+            const std::string authToken = tokenService().issue();
+            const auto ticket = notifyCapabilityModule(instance, authToken);
+            // A replica that exits leaves dispatch; the primary stays loaded.
+            auto onTerminated = [name](const std::string& n) {
+                if (auto live = replicaSetFor(name))
+                    live->remove(n);
+            };
+            LogosCore::LoadedModuleHandle handle;
+            if (!loader->load(desc, onTerminated, handle)) {
+                spdlog::warn("Failed to start replica {} of module {}", instance, name);
+                continue;
+            }
+            tokenBarrier(ticket, desc.dependencies);
+            if (!loader->sendToken(instance, authToken)) {
+                spdlog::warn("Replica {} of module {} rejected its token", instance, name);
+                loader->terminate(instance);
+                continue;
+            }
+            TokenManager::instance().saveToken(instance, authToken);
+            set->add(instance);
+        }
+        spdlog::info("Module {} running {} of {} instance(s), {} dispatch", name, set->size(),
+                     config->second.count, LogosCore::replicaPolicyName(set->policy()));
+        std::lock_guard lock(replicaMutex());
+        replicaSets()[name] = std::move(set);
+    }
+
+    // Build a descriptor for the loader to inspect: `name` launched from
+    // `path`. Call with loadMutex() held (reads the transport map).
+    LogosCore::ModuleDescriptor describeModuleLocked(const std::string& name, const std::string& path) {
         LogosCore::ModuleDescriptor desc;
         desc.name        = name;
-        desc.path        = modPath;
+        desc.path        = path;
         desc.format      = "qt-plugin";
         desc.dependencies = registryInstance().moduleDependencies(name);
         desc.modulesDirs  = registryInstance().modulesDirs();
@@ -269,14 +1011,18 @@ namespace {
             it != moduleTransportsMap().end()) {
             desc.transportSetJson = it->second;
         }
+        return desc;
+    }
 
-        // ── Protocol-version load gate ─────────────────────────────────
-        // Read the module's embedded metadata without loading it and apply
-        // the one compatibility rule: equal logos-protocol MAJOR loads,
-        // different MAJOR is refused, a missing stamp (pre-protocol module)
-        // loads permissively with a warning.
+    // ── Protocol-version load gate ─────────────────────────────────────
+    // Read the module's embedded metadata (desc.path) without loading it and
+    // apply the one compatibility rule: equal logos-protocol MAJOR loads,
+    // different MAJOR is refused, a missing stamp (pre-protocol module) loads
+    // permissively with a warning. Fills desc.rawMetadata for the loader.
+    bool passProtocolGate(const std::string& name, LogosCore::ModuleDescriptor& desc) {
         std::string moduleProtocolVersion;
-        if (auto meta = ModuleLib::LogosModule::extractMetadata(modPath)) {
+        LifecycleMetrics::ScopedTimer metadataTimer(name, LifecycleMetrics::Phase::MetadataExtraction);
+        if (auto meta = ModuleLib::LogosModule::extractMetadata(desc.path)) {
             // While we have it, hand the full metadata to the loader.
             desc.rawMetadata = nlohmann::json::parse(
                 meta->rawMetadataJson, nullptr, /*allow_exceptions=*/false);
@@ -286,8 +1032,13 @@ namespace {
                 it != desc.rawMetadata.end() && it->is_string())
                 moduleProtocolVersion = it->get<std::string>();
         }
+        metadataTimer.stop();
+
+        LifecycleMetrics::ScopedTimer gateTimer(name, LifecycleMetrics::Phase::ProtocolGate);
         const auto gate = LogosCore::evaluateProtocolGate(
             moduleProtocolVersion, LOGOS_PROTOCOL_VERSION_MAJOR);
+        gateTimer.stop();
+        const auto journalMajor = static_cast<uint32_t>(std::max(gate.moduleMajor, 0));
         switch (gate.decision) {
         case LogosCore::ProtocolGateDecision::Refuse:
             spdlog::error(
@@ -296,49 +1047,137 @@ namespace {
                 "protocol majors",
                 name, moduleProtocolVersion, gate.moduleMajor,
                 LOGOS_PROTOCOL_VERSION_MAJOR, LOGOS_PROTOCOL_VERSION_STRING);
+            EventJournal::record(EventJournal::Event::ProtocolGate, name,
+                                 EventJournal::GateRefuse, journalMajor);
             return false;
         case LogosCore::ProtocolGateDecision::AllowLegacy:
             spdlog::warn(
                 "Module {} carries no usable logos_protocol_version "
                 "(pre-protocol build) — loading permissively",
                 name);
+            EventJournal::record(EventJournal::Event::ProtocolGate, name,
+                                 EventJournal::GateAllowLegacy, journalMajor);
             break;
         case LogosCore::ProtocolGateDecision::Allow:
             spdlog::debug("Module {} protocol version {} compatible with host {}",
                           name, moduleProtocolVersion,
                           LOGOS_PROTOCOL_VERSION_STRING);
+            EventJournal::record(EventJournal::Event::ProtocolGate, name,
+                                 EventJournal::GateAllow, journalMajor);
             break;
         }
+        return true;
+    }
+
+    bool loadModuleInternal(const char* moduleName) {
+        std::string name(moduleName);
+
+        if (!registryInstance().isKnown(name)) {
+            spdlog::warn("Cannot load unknown module: {}", name);
+            return false;
+        }
+
+        // "Already loaded" is a successful no-op, not a failure.
+        // Callers (basecamp's PluginLoader::loadCoreDependencies,
+        // logoscore-cli, etc.) use loadModule as "ensure loaded";
+        // returning false here aborted UI-plugin loads whose core
+        // dependency had been pre-loaded at startup (e.g. clicking
+        // the package-manager launcher after basecamp pre-loaded
+        // `package_manager`).
+        if (registryInstance().isLoaded(name)) {
+            spdlog::debug("Module already loaded (no-op): {}", name);
+            return true;
+        }
 
+        // Phase timings (lifecycle_metrics.h). The total only counts loads
+        // that complete; each phase counts whenever it ran.
+        LifecycleMetrics::ScopedTimer totalTimer(name, LifecycleMetrics::Phase::LoadTotal);
+        EventJournal::Scope journal(EventJournal::Event::Load, name);
+        auto failed = [&](EventJournal::LoadResult result) {
+            totalTimer.cancel();
+            LifecycleMetrics::count(name, LifecycleMetrics::Counter::LoadFailures);
+            journal.setResult(result);
+            return false;
+        };
+
+        LogosCore::ModuleDescriptor desc = describeModuleLocked(name, registryInstance().modulePath(name));
+
+        if (!passProtocolGate(name, desc))
+            return failed(EventJournal::ProtocolRefused);
+
+        LifecycleMetrics::ScopedTimer selectTimer(name, LifecycleMetrics::Phase::LoaderSelection);
         auto loader = loaderRegistry().select(desc);
+        selectTimer.stop();
         if (!loader) {
             spdlog::warn("No loader available to load module: {}", name);
-            return false;
+            return failed(EventJournal::NoLoader);
         }
 
-        auto onTerminated = [](const std::string& n) {
-            registryInstance().markUnloaded(n);
-        };
+        auto onTerminated = [](const std::string& n) { onModuleProcessExited(n); };
+        // A fresh launch runs under the module's own name again, once an
+        // upgrade retiring an old process under it is done.
+        forgetInstanceKey(name);
+        awaitSideKeyFree(name);
 
-        LogosCore::LoadedModuleHandle handle;
-        if (!loader->load(desc, onTerminated, handle))
-            return false;
+        std::string authToken = tokenService().issue();
 
-        std::string authToken = boost::uuids::to_string(boost::uuids::random_generator()());
+        // Tell capability_module about the token before launching, so that
+        // IPC runs on the notifier thread while the container spawns the
+        // child. If the launch then fails, capability_module is left holding
+        // a token nobody was ever given — harmless.
+        const auto ticket = notifyCapabilityModule(name, authToken);
 
-        if (!loader->sendToken(name, authToken)) {
+        LogosCore::LoadedModuleHandle handle;
+        LifecycleMetrics::ScopedTimer launchTimer(name, LifecycleMetrics::Phase::ContainerLaunch);
+        const bool launched = loader->load(desc, onTerminated, handle);
+        launchTimer.stop();
+        if (!launched)
+            return failed(EventJournal::LaunchFailed);
+
+        // The module can't call out until it holds its token, so
+        // capability_module must know that token first. Only this module's own
+        // notification and its dependencies' restrictions are waited on, not
+        // the whole queue.
+        LifecycleMetrics::ScopedTimer barrierTimer(name, LifecycleMetrics::Phase::CapabilityBarrier);
+        tokenBarrier(ticket, desc.dependencies);
+        barrierTimer.stop();
+
+        LifecycleMetrics::ScopedTimer sendTimer(name, LifecycleMetrics::Phase::SendToken);
+        bool tokenSent = false;
+        {
+            EventJournal::Scope tokenJournal(EventJournal::Event::TokenIssued, name);
+            tokenSent = loader->sendToken(name, authToken);
+            if (!tokenSent)
+                tokenJournal.setResult(EventJournal::Failed);
+        }
+        sendTimer.stop();
+        if (!tokenSent) {
             loader->terminate(name);
-            return false;
+            return failed(EventJournal::TokenRejected);
         }
 
         registryInstance().markLoaded(name, loader, std::move(handle));
 
+        LifecycleMetrics::ScopedTimer saveTimer(name, LifecycleMetrics::Phase::TokenSave);
         TokenManager::instance().saveToken(name, authToken);
+        saveTimer.stop();
+
+        // A fresh capability_module knows no restrictions yet; forget what the
+        // previous instance was sent so nothing is diffed away.
+        if (name == "capability_module") {
+            forgetPushedRestrictions();
+            tokenService().setCapabilityToken(authToken);
+        }
 
-        notifyCapabilityModule(name, authToken);
+        launchReplicasLocked(name, desc, loader);
 
+        // Queued, not awaited: the next load can start spawning right away.
+        LifecycleMetrics::ScopedTimer refreshTimer(name, LifecycleMetrics::Phase::RestrictionRefresh);
         refreshDerivedRestrictionsForDependenciesOf(name);
+        refreshTimer.stop();
 
+        totalTimer.stop();
+        LifecycleMetrics::count(name, LifecycleMetrics::Counter::Loads);
         spdlog::info("Module loaded: {}", name);
 
         return true;
@@ -347,38 +1186,272 @@ namespace {
     // Unload helper that assumes loadMutex() is already held by the caller.
     // unloadModuleWithDependents() needs a single lock span so a late-arriving
     // load can't interleave between tearing down the dependents and the target.
-    bool unloadModuleInternalLocked(const std::string& name) {
-        if (!registryInstance().isLoaded(name)) {
+    //
+    // `stoppedInWave`: the caller already stopped the process (stopWaveLocked),
+    // so its exit callback may have marked it unloaded and its loader may have
+    // dropped the entry. Clean up regardless — loader entry, replicas, instance
+    // key, restrictions, metrics — instead of refusing.
+    bool unloadModuleInternalLocked(const std::string& name, bool stoppedInWave = false) {
+        if (!stoppedInWave && !registryInstance().isLoaded(name)) {
             spdlog::warn("Cannot unload module (not loaded): {}", name);
             return false;
         }
 
+        LifecycleMetrics::ScopedTimer totalTimer(name, LifecycleMetrics::Phase::UnloadTotal);
+        EventJournal::Scope journal(EventJournal::Event::Unload, name);
+
         auto loader = registryInstance().loaderFor(name);
+        const std::string key = instanceKeyOf(name);
         if (loader) {
-            if (!loader->hasModule(name)) {
+            if (!stoppedInWave && !loader->hasModule(key)) {
                 spdlog::warn("No module entry found for module: {}", name);
+                totalTimer.cancel();
+                journal.setResult(EventJournal::Failed);
                 return false;
             }
-            loader->terminate(name);
+            LifecycleMetrics::ScopedTimer terminateTimer(name, LifecycleMetrics::Phase::Terminate);
+            terminateReplicasLocked(name, loader);
+            loader->terminate(key);
         } else {
             // Fallback: module was loaded via markLoaded(name) directly (test
             // scenarios or external setup), so no loader was recorded. Ask the
             // registered loaders to terminate it by name — no specific container
             // is named here.
-            if (!loaderRegistry().terminate(name)) {
+            LifecycleMetrics::ScopedTimer terminateTimer(name, LifecycleMetrics::Phase::Terminate);
+            if (!loaderRegistry().terminate(key) && !stoppedInWave) {
                 spdlog::warn("No live module entry found for module: {}", name);
+                terminateTimer.cancel();
+                totalTimer.cancel();
+                journal.setResult(EventJournal::Failed);
                 return false;
             }
         }
 
         registryInstance().markUnloaded(name);
+        forgetInstanceKey(name);
+
+        if (name == "capability_module") {
+            forgetPushedRestrictions();
+            tokenService().clearCapabilityToken();
+        }
 
         // markUnloaded keeps the dependency edges, so this still resolves them.
         refreshDerivedRestrictionsForDependenciesOf(name);
 
+        totalTimer.stop();
+        LifecycleMetrics::count(name, LifecycleMetrics::Counter::Unloads);
         spdlog::info("Module unloaded: {}", name);
         return true;
     }
+
+    std::chrono::steady_clock::time_point teardownDeadline() {
+        return std::chrono::steady_clock::now()
+            + std::chrono::milliseconds(shutdownTimeoutMs().load(std::memory_order_relaxed));
+    }
+
+    // Signal every process in one teardown wave at once and wait for them
+    // (SIGKILL at `deadline`); the caller then lets each loader drop its entry.
+    void stopWaveLocked(const std::vector<std::string>& wave,
+                        std::chrono::steady_clock::time_point deadline) {
+        std::vector<int64_t> pids;
+        for (const auto& n : wave) {
+            auto loader = registryInstance().loaderFor(n);
+            const std::string key = instanceKeyOf(n);
+            if (!loader || !loader->hasModule(key))
+                continue;
+            if (auto pid = loader->pid(key))
+                pids.push_back(*pid);
+            for (const auto& instance : extraReplicasOf(n)) {
+                if (auto pid = loader->pid(instance))
+                    pids.push_back(*pid);
+            }
+        }
+        LogosCore::stopProcesses(pids, deadline);
+    }
+
+    // Whether `key` would clash as a container key for an upgrade of `name`:
+    // another module's name, a live entry in `loader`, another module's
+    // instance key, or a replica.
+    bool containerKeyTaken(const std::string& name, const std::string& key,
+                           const std::shared_ptr<LogosCore::ModuleLoader>& loader) {
+        if (key != name && registryInstance().isKnown(key))
+            return true;
+        if (loader->hasModule(key))
+            return true;
+        {
+            std::lock_guard lock(instanceKeyMutex());
+            if (isSideKeyLocked(key))
+                return true;
+            for (const auto& [module, instance] : instanceKeys()) {
+                if (instance == key)
+                    return true;
+            }
+        }
+        std::lock_guard lock(replicaMutex());
+        for (const auto& [module, set] : replicaSets()) {
+            const auto instances = set->instances();
+            if (module != key
+                && std::find(instances.begin(), instances.end(), key) != instances.end())
+                return true;
+        }
+        return false;
+    }
+
+    // The container key the new side of an upgrade runs under: back to the
+    // module's own name when it currently runs elsewhere, else the first free
+    // of "<name>_next", "<name>_next2", ... Empty if none is free.
+    std::string upgradeKeyFor(const std::string& name, const std::string& oldKey,
+                              const std::shared_ptr<LogosCore::ModuleLoader>& loader) {
+        if (oldKey != name)
+            return containerKeyTaken(name, name, loader) ? std::string() : name;
+        for (int i = 1; i <= kMaxUpgradeKeyProbes; ++i) {
+            std::string key = name + "_next" + (i > 1 ? std::to_string(i) : std::string());
+            if (!containerKeyTaken(name, key, loader))
+                return key;
+        }
+        return {};
+    }
+
+    // The old side of an upgrade, stopped once loadMutex() is released.
+    struct RetiringProcess {
+        std::shared_ptr<LogosCore::ModuleLoader> loader;
+        std::string module;
+        std::string key;
+    };
+
+    // Blue-green replacement of a loaded module's process; see
+    // ModuleManager::upgradeModule(). Assumes loadMutex(). On success the
+    // old process is still running and `retiring` names it.
+    bool upgradeModuleLocked(const std::string& name, const std::string& pluginPath,
+                             RetiringProcess& retiring) {
+        if (!registryInstance().isLoaded(name)) {
+            spdlog::warn("Cannot upgrade module (not loaded): {}", name);
+            return false;
+        }
+        // Its token also authenticates core's own calls; restart it instead.
+        if (name == "capability_module") {
+            spdlog::warn("capability_module cannot be upgraded in place");
+            return false;
+        }
+        auto loader = registryInstance().loaderFor(name);
+        const std::string oldKey = instanceKeyOf(name);
+        if (!loader || !loader->hasModule(oldKey)) {
+            spdlog::warn("Cannot upgrade module {}: no live loader entry", name);
+            return false;
+        }
+
+        const std::string path = pluginPath.empty() ? registryInstance().modulePath(name) : pluginPath;
+        LogosCore::ModuleDescriptor desc = describeModuleLocked(name, path);
+        if (!passProtocolGate(name, desc)) {
+            spdlog::warn("Upgrade of {} refused; the running version stays", name);
+            return false;
+        }
+
+        // The new build's own dependency list when its metadata carries one.
+        // Nothing is loaded on its behalf: dependencies must already be up.
+        if (auto it = desc.rawMetadata.find("dependencies");
+            it != desc.rawMetadata.end() && it->is_array()) {
+            desc.dependencies.clear();
+            for (const auto& dep : *it) {
+                if (dep.is_string())
+                    desc.dependencies.push_back(dep.get<std::string>());
+            }
+        }
+        for (const auto& dep : desc.dependencies) {
+            if (!registryInstance().isLoaded(dep)) {
+                spdlog::warn("Cannot upgrade module {}: dependency {} is not loaded", name, dep);
+                return false;
+            }
+        }
+
+        // The new process runs alongside the old one under a second container
+        // key and keeps it: once swapped in, core addresses it and hands it to
+        // callers through instanceKeyOf(). "upgrade_of" tells the format
+        // loader which module it is, like "replica_of" for a replica.
+        const std::string newKey = upgradeKeyFor(name, oldKey, loader);
+        if (newKey.empty()) {
+            spdlog::warn("Cannot upgrade module {}: no free container key for the new version", name);
+            return false;
+        }
+        LogosCore::ModuleDescriptor green = desc;
+        green.name = newKey;
+        green.loaderConfig["upgrade_of"] = name;
+        LogosCore::LoadedModuleHandle handle;
+        auto onTerminated = [](const std::string& n) { onModuleProcessExited(n); };
+        addSideKey(name, newKey);
+        if (!loader->load(green, onTerminated, handle)) {
+            dropSideKey(name, newKey);
+            spdlog::warn("Upgrade of {}: the new version failed to start; the running version stays", name);
+            return false;
+        }
+
+        // Launched first, so a failed start never disturbs the running
+        // version. The new process authenticates under its container key,
+        // next to the old one's: capability_module learns its token, and the
+        // restrictions it is subject to list it, before it holds the token.
+        const std::string authToken = tokenService().issue();
+        const auto ticket = notifyCapabilityModule(newKey, authToken);
+        for (const auto& dep : desc.dependencies)
+            pushDerivedRestrictionForTarget(dep);
+        pushDerivedRestrictionForTarget(name);
+        tokenBarrier(ticket, desc.dependencies);
+        if (!loader->sendToken(newKey, authToken)) {
+            spdlog::warn("Upgrade of {}: the new version rejected its token; the running version stays", name);
+            loader->terminate(newKey);
+            dropSideKey(name, newKey);
+            for (const auto& dep : desc.dependencies)
+                pushDerivedRestrictionForTarget(dep);
+            pushDerivedRestrictionForTarget(name);
+            return false;
+        }
+
+        // Swap: the registry entry, container key and token now all name the
+        // new process, and callers are handed its key. The old process keeps
+        // its own token and restrictions until it is retired.
+        const auto oldDependencies = registryInstance().moduleDependencies(name);
+        if (path != registryInstance().modulePath(name) || desc.dependencies != oldDependencies)
+            registryInstance().registerModule(name, path, desc.dependencies);
+        // The old replica set still lists the old process as its primary; stop
+        // its extras before the key moves. They restart from the new build.
+        terminateReplicasLocked(name, loader);
+        {
+            std::lock_guard keyLock(instanceKeyMutex());
+            if (newKey == name)
+                instanceKeys().erase(name);
+            else
+                instanceKeys()[name] = newKey;
+            auto& side = sideKeys()[name];
+            side.erase(std::remove(side.begin(), side.end(), newKey), side.end());
+            side.push_back(oldKey);
+        }
+        registryInstance().markLoaded(name, loader, std::move(handle));
+        TokenManager::instance().saveToken(name, authToken);
+
+        launchReplicasLocked(name, desc, loader);
+        for (const auto& dep : oldDependencies)
+            pushDerivedRestrictionForTarget(dep);
+        refreshDerivedRestrictionsForDependenciesOf(name);
+
+        retiring = {loader, name, oldKey};
+        LifecycleMetrics::count(name, LifecycleMetrics::Counter::Upgrades);
+        spdlog::info("Module upgraded: {} ({})", name, path);
+        return true;
+    }
+
+    // SIGTERM, then SIGKILL at the shutdown deadline. Runs without
+    // loadMutex(), so loads and unloads are not held up for as long as the
+    // old process takes to exit; its exit does not unload the module. Then
+    // the restrictions listing its key are re-pushed without it.
+    void retireUpgradedProcess(const RetiringProcess& old) {
+        if (auto pid = old.loader->pid(old.key))
+            LogosCore::stopProcesses({*pid}, teardownDeadline());
+        old.loader->terminate(old.key);
+        dropSideKey(old.module, old.key);
+
+        std::lock_guard lock(loadMutex());
+        if (registryInstance().isLoaded(old.module))
+            refreshDerivedRestrictionsForDependenciesOf(old.module);
+    }
 }
 
 namespace ModuleManager {
@@ -391,6 +1464,10 @@ namespace ModuleManager {
         return loaderRegistry();
     }
 
+    LogosCore::TokenService& tokens() {
+        return tokenService();
+    }
+
     void setModulesDir(const char* modules_dir) {
         assert(modules_dir != nullptr);
         registryInstance().setModulesDir(std::string(modules_dir));
@@ -420,6 +1497,66 @@ namespace ModuleManager {
             moduleTransportsMap()[moduleName] = transportSetJson;
     }
 
+    bool setModuleReplicas(const std::string& moduleName, int count,
+                           LogosCore::ReplicaPolicy policy) {
+        if (count < 1 || count > kMaxModuleReplicas) {
+            spdlog::warn("Replica count for {} must be 1..{}, got {}", moduleName,
+                         kMaxModuleReplicas, count);
+            return false;
+        }
+        std::lock_guard<std::mutex> g(loadMutex());
+        if (count == 1)
+            replicaConfigs().erase(moduleName);
+        else
+            replicaConfigs()[moduleName] = {count, policy};
+        return true;
+    }
+
+    std::optional<std::string> acquireModuleReplica(const std::string& moduleName) {
+        if (!registryInstance().isLoaded(moduleName))
+            return std::nullopt;
+        if (auto set = replicaSetFor(moduleName)) {
+            if (auto instance = set->acquire())
+                return instance;
+        }
+        return instanceKeyOf(moduleName);
+    }
+
+    void releaseModuleReplica(const std::string& moduleName, const std::string& instance) {
+        if (auto set = replicaSetFor(moduleName))
+            set->release(instance);
+    }
+
+    std::string getModuleReplicasJson(const std::string& moduleName) {
+        if (!registryInstance().isLoaded(moduleName))
+            return {};
+        auto loader = registryInstance().loaderFor(moduleName);
+        auto set = replicaSetFor(moduleName);
+        nlohmann::json replicas = set ? set->toJson() : nlohmann::json::array({
+            {{"instance", instanceKeyOf(moduleName)}, {"in_flight", 0}, {"dispatched", 0}}});
+        for (auto& replica : replicas) {
+            std::optional<int64_t> pid;
+            if (loader)
+                pid = loader->pid(replica["instance"].get<std::string>());
+            replica["pid"] = pid ? nlohmann::json(*pid) : nlohmann::json(nullptr);
+        }
+        const auto policy = set ? set->policy() : LogosCore::ReplicaPolicy::RoundRobin;
+        return nlohmann::json{
+            {"module", moduleName},
+            {"policy", LogosCore::replicaPolicyName(policy)},
+            {"replicas", replicas},
+        }.dump();
+    }
+
+    char* getModuleReplicasCStr(const char* moduleName) {
+        const std::string json = getModuleReplicasJson(moduleName);
+        if (json.empty())
+            return nullptr;
+        char* result = new char[json.size() + 1];
+        strcpy(result, json.c_str());
+        return result;
+    }
+
     // THE deny-by-default switch. `mode: "enforce"` is the whole flag: it is
     // what turns the derived restrictions on (computeDerivedAllowedCallersLocked
     // returns {} without it, so core registers nothing and capability_module
@@ -437,6 +1574,8 @@ namespace ModuleManager {
         accessPolicyJson() = policyJson;
         // Cache the parse only in enforce mode; malformed/non-enforce stays empty.
         parsedEnforcePolicy().reset();
+        compiledEnforcePolicy().reset();
+        forgetPushedRestrictions();
 
         if (policyJson.empty()) {
             spdlog::info("Inter-module access enforcement is OFF (no access policy set): "
@@ -462,11 +1601,15 @@ namespace ModuleManager {
                      "a module may only call the modules it declares as dependencies; "
                      "{} explicit restriction(s) override the derived allow-list",
                      parsed->restrictions.size());
+        compiledEnforcePolicy() = LogosCore::compileAccessPolicy(*parsed);
         parsedEnforcePolicy() = std::move(parsed);
     }
 
     void discoverInstalledModules() {
         registryInstance().discoverInstalledModules();
+        // Mint a token per known module now rather than one per load.
+        tokenService().prefill(std::min<std::size_t>(
+            registryInstance().knownModuleNames().size(), kMaxPrefilledTokens));
     }
 
     std::string processModule(const std::string& modulePath) {
@@ -487,12 +1630,14 @@ namespace ModuleManager {
         return result;
     }
 
-    bool loadModule(const char* moduleName) {
+    bool loadModule(const char* moduleName, LogosCore::LoadPriority priority) {
+        auto admission = admitLoad(moduleName, false, priority);
         std::lock_guard lock(loadMutex());
         return loadModuleInternal(moduleName);
     }
 
-    bool loadModuleWithDependencies(const char* moduleName) {
+    bool loadModuleWithDependencies(const char* moduleName, LogosCore::LoadPriority priority) {
+        auto admission = admitLoad(moduleName, true, priority);
         std::lock_guard lock(loadMutex());
 
         std::string name(moduleName);
@@ -536,6 +1681,22 @@ namespace ModuleManager {
         return allSucceeded;
     }
 
+    std::size_t queuedLoadRequests() {
+        return loadScheduler().queued();
+    }
+
+    bool upgradeModule(const std::string& moduleName, const std::string& pluginPath) {
+        RetiringProcess retiring;
+        {
+            auto admission = admitLoad(moduleName, false, LogosCore::LoadPriority::Normal);
+            std::lock_guard lock(loadMutex());
+            if (!upgradeModuleLocked(moduleName, pluginPath, retiring))
+                return false;
+        }
+        retireUpgradedProcess(retiring);
+        return true;
+    }
+
     bool initializeCapabilityModule() {
         std::lock_guard lock(loadMutex());
 
@@ -549,10 +1710,13 @@ namespace ModuleManager {
 
         // Register restrictions before any other module can call out: explicit
         // entries, then derived for anything already loaded (usually nothing —
-        // only the exempt capability_module is up here).
+        // only the exempt capability_module is up here). Token notifications
+        // overtake queued restrictions, so wait for these here, once, rather
+        // than on every later load's token barrier.
         pushAccessRestrictionsToCapabilityModule();
         for (const auto& loaded : registryInstance().loadedModuleNames())
             pushDerivedRestrictionForTarget(loaded);
+        capabilityNotifier().drain();
 
         return true;
     }
@@ -592,50 +1756,97 @@ namespace ModuleManager {
                 teardownSet.push_back(d);
         }
 
-        // Order leaves-first: resolve load-order for the teardown set, then
-        // reverse. Dependents come down before the modules they depend on.
-        // Teardown is best-effort — we use .order and ignore resolution errors
-        // (missing deps / cycles) because we need to tear down what we can.
-        std::vector<std::string> loadOrder = DependencyResolver::resolve(
+        // Tear down in leaves-first waves: nothing in a wave has a dependent
+        // left running, so a wave's processes are stopped together and no
+        // dependent outlives its dependency. Best-effort: cycles come down as
+        // one last wave rather than failing the cascade.
+        const auto deadline = teardownDeadline();
+        const auto waves = LogosCore::teardownWaves(
             teardownSet,
-            [](const std::string& n) { return registryInstance().isKnown(n); },
-            [](const std::string& n) { return registryInstance().moduleDependencies(n); }
-        ).order;
-        std::vector<std::string> teardownOrder;
-        std::unordered_set<std::string> teardownOrderMembers;
-        for (auto it = loadOrder.rbegin(); it != loadOrder.rend(); ++it) {
-            if (teardownSetMembers.count(*it) && teardownOrderMembers.insert(*it).second)
-                teardownOrder.push_back(*it);
-        }
-
-        // Safety net: any members not seen by the resolver (shouldn't happen,
-        // but don't silently skip them) go to the end.
-        for (const std::string& n : teardownSet) {
-            if (teardownOrderMembers.insert(n).second)
-                teardownOrder.push_back(n);
-        }
+            [](const std::string& n) { return registryInstance().moduleDependencies(n); });
 
         bool allSucceeded = true;
-        for (const std::string& n : teardownOrder) {
-            if (!registryInstance().isLoaded(n)) continue;
-            if (!unloadModuleInternalLocked(n)) {
-                spdlog::warn("Failed to unload module during cascade: {}", n);
-                allSucceeded = false;
+        for (const auto& wave : waves) {
+            // Snapshot before signalling: a member whose process exits during
+            // the wave is marked unloaded by its exit callback, but still
+            // needs its loader entry, replicas and restrictions cleaned up.
+            std::vector<std::string> live;
+            for (const std::string& n : wave) {
+                if (registryInstance().isLoaded(n))
+                    live.push_back(n);
+            }
+            stopWaveLocked(live, deadline);
+            for (const std::string& n : live) {
+                if (!unloadModuleInternalLocked(n, /*stoppedInWave=*/true)) {
+                    spdlog::warn("Failed to unload module during cascade: {}", n);
+                    allSucceeded = false;
+                }
             }
         }
 
         return allSucceeded;
     }
 
+    // Bring every loaded module down in leaves-first waves (teardown.h).
+    // Each wave's processes are signalled at once; all waves share one
+    // deadline, after which stragglers are SIGKILLed. The loaders then drop
+    // their entries, finding the processes already gone. Assumes loadMutex().
+    void terminateAllLocked() {
+        const auto deadline = teardownDeadline();
+        const auto waves = LogosCore::teardownWaves(
+            registryInstance().loadedModuleNames(),
+            [](const std::string& n) { return registryInstance().moduleDependencies(n); });
+        for (const auto& wave : waves) {
+            stopWaveLocked(wave, deadline);
+            for (const auto& n : wave) {
+                auto loader = registryInstance().loaderFor(n);
+                const std::string key = instanceKeyOf(n);
+                terminateReplicasLocked(n, loader);
+                if (loader)
+                    loader->terminate(key);
+                else
+                    loaderRegistry().terminate(key);
+            }
+        }
+        // Anything a loader still holds that the registry never saw loaded.
+        loaderRegistry().terminateAll();
+        {
+            std::lock_guard replicaLock(replicaMutex());
+            replicaSets().clear();
+        }
+        {
+            std::lock_guard keyLock(instanceKeyMutex());
+            instanceKeys().clear();
+            sideKeys().clear();
+        }
+        sideKeysChanged().notify_all();
+    }
+
     void terminateAll() {
         std::lock_guard lock(loadMutex());
-        loaderRegistry().terminateAll();
+        // Anything still queued would target a capability_module that is
+        // about to go down.
+        capabilityNotifier().cancelPending();
+        terminateAllLocked();
         registryInstance().clearLoaded();
+        forgetPushedRestrictions();
+        tokenService().clearCapabilityToken();
+    }
+
+    void setShutdownTimeout(std::chrono::milliseconds timeout) {
+        shutdownTimeoutMs().store(std::max<int64_t>(timeout.count(), 0), std::memory_order_relaxed);
     }
 
     void clear() {
+        // Before taking loadMutex(): the profile's thread loads through it.
+        stopBootProfile();
+        {
+            std::lock_guard profileLock(bootProfileMutex());
+            bootProfileSlot().reset();
+        }
         std::lock_guard lock(loadMutex());
-        loaderRegistry().terminateAll();
+        capabilityNotifier().cancelPending();
+        terminateAllLocked();
         registryInstance().clear();
         // Per-module transport overrides are part of the manager's
         // mutable state — without clearing them here, a daemon
@@ -643,8 +1854,13 @@ namespace ModuleManager {
         // clear() between scenarios) would inherit the previous
         // run's transport map and bind unexpected ports.
         moduleTransportsMap().clear();
+        replicaConfigs().clear();
         accessPolicyJson().clear();  // same rationale — don't leak across restarts
         parsedEnforcePolicy().reset();
+        compiledEnforcePolicy().reset();
+        forgetPushedRestrictions();
+        tokenService().clearCapabilityToken();
+        LifecycleMetrics::reset();
     }
 
     char** getLoadedModulesCStr() {
@@ -664,7 +1880,7 @@ namespace ModuleManager {
     }
 
     std::unordered_map<std::string, int64_t> getModuleProcessIds() {
-        return loaderRegistry().getAllPids();
+        return modulePids();
     }
 
     std::vector<std::string> resolveDependencies(const std::vector<std::string>& requestedModules) {
@@ -711,8 +1927,422 @@ namespace ModuleManager {
         return result;
     }
 
+    std::string getLifecycleMetricsJson() {
+        return LifecycleMetrics::toJson().dump();
+    }
+
+    char* getLifecycleMetricsCStr() {
+        std::string json = getLifecycleMetricsJson();
+        char* result = new char[json.size() + 1];
+        strcpy(result, json.c_str());
+        return result;
+    }
+
+    std::string getBootReportJson(const std::string& module) {
+        auto& registry = registryInstance();
+        const auto metrics = LifecycleMetrics::snapshot();
+        std::vector<std::string> names;
+        if (!module.empty()) {
+            if (!registry.isKnown(module))
+                return {};
+            names = registry.moduleDependencies(module, true);
+            names.push_back(module);
+        } else {
+            // Everything that has loaded at least once, plus whatever it
+            // depends on, in registry order.
+            std::unordered_set<std::string> wanted;
+            for (const auto& [name, m] : metrics.modules) {
+                if (m.phases[static_cast<std::size_t>(LifecycleMetrics::Phase::LoadTotal)].count == 0
+                    || !registry.isKnown(name))
+                    continue;
+                wanted.insert(name);
+                for (auto& dep : registry.moduleDependencies(name, true))
+                    wanted.insert(std::move(dep));
+            }
+            for (auto& name : registry.knownModuleNames()) {
+                if (wanted.count(name))
+                    names.push_back(std::move(name));
+            }
+        }
+
+        std::vector<LogosCore::BootTask> tasks;
+        tasks.reserve(names.size());
+        for (const auto& name : names) {
+            LogosCore::BootTask task;
+            task.name = name;
+            task.dependencies = registry.moduleDependencies(name);
+            task.measured = false;
+            if (auto it = metrics.modules.find(name); it != metrics.modules.end()) {
+                const auto& total =
+                    it->second.phases[static_cast<std::size_t>(LifecycleMetrics::Phase::LoadTotal)];
+                if (total.count > 0) {
+                    task.durationMs = static_cast<double>(total.sumUs) / total.count / 1000.0;
+                    task.measured = true;
+                }
+            }
+            tasks.push_back(std::move(task));
+        }
+
+        nlohmann::json report = LogosCore::bootPlanToJson(LogosCore::planBoot(tasks));
+        report["module"] = module.empty() ? nlohmann::json(nullptr) : nlohmann::json(module);
+        report["modules"] = tasks.size();
+        return report.dump();
+    }
+
+    char* getBootReportCStr(const char* module) {
+        std::string json = getBootReportJson(module ? std::string(module) : std::string());
+        if (json.empty())
+            return nullptr;
+        char* result = new char[json.size() + 1];
+        strcpy(result, json.c_str());
+        return result;
+    }
+
+    std::string getOpenMetricsText() {
+        return LogosCore::renderOpenMetrics(collectMetricsSample());
+    }
+
+    bool startMetricsExporter(const std::string& endpoint, std::chrono::milliseconds refresh) {
+        std::lock_guard lock(metricsExporterMutex());
+        auto& exporter = metricsExporter();
+        if (exporter && exporter->running()) {
+            spdlog::warn("Metrics exporter already running");
+            return false;
+        }
+        exporter = std::make_unique<LogosCore::MetricsExporter>(&getOpenMetricsText, refresh);
+        if (!exporter->start(endpoint)) {
+            exporter.reset();
+            return false;
+        }
+        return true;
+    }
+
+    void stopMetricsExporter() {
+        std::lock_guard lock(metricsExporterMutex());
+        metricsExporter().reset();
+    }
+
+    bool enableCgroups(const std::string& root, const std::string& policyJson) {
+        auto cgroups = std::make_shared<LogosCore::CgroupManager>(root);
+        if (!policyJson.empty()) {
+            auto policy = nlohmann::json::parse(policyJson, nullptr, false);
+            if (!policy.is_object()) {
+                spdlog::warn("cgroups: resource policy is not a JSON object; not enabling");
+                return false;
+            }
+            cgroups->setPolicy(policy);
+        }
+        if (!cgroups->init())
+            return false;
+
+        std::atomic_store(&cgroupsSlot(), cgroups);
+        for (const auto& loader : loaderRegistry().all())
+            if (auto composite = std::dynamic_pointer_cast<LogosCore::CompositeModuleLoader>(loader))
+                composite->setCgroups(cgroups);
+        return true;
+    }
+
+    void disableCgroups() {
+        auto cgroups = std::atomic_exchange(&cgroupsSlot(), std::shared_ptr<LogosCore::CgroupManager>());
+        if (!cgroups)
+            return;
+        for (const auto& loader : loaderRegistry().all())
+            if (auto composite = std::dynamic_pointer_cast<LogosCore::CompositeModuleLoader>(loader))
+                composite->setCgroups(nullptr);
+        cgroups->releaseAll();
+    }
+
+    std::shared_ptr<LogosCore::CgroupManager> cgroups() {
+        return currentCgroups();
+    }
+
+    bool setCpuPlacement(const std::string& policyJson) {
+        if (!LogosCore::CpuPlacement::supported()) {
+            spdlog::warn("CPU placement is not supported on this platform");
+            return false;
+        }
+        nlohmann::json policy = nlohmann::json::object();
+        if (!policyJson.empty()) {
+            policy = nlohmann::json::parse(policyJson, nullptr, false);
+            if (!policy.is_object()) {
+                spdlog::warn("CPU placement policy is not a JSON object; keeping the previous one");
+                return false;
+            }
+        }
+        auto placement = std::make_shared<LogosCore::CpuPlacement>();
+        placement->setPolicy(policy);
+        const auto& topology = placement->topology();
+        spdlog::info("CPU placement enabled: {} online CPUs, {} NUMA node(s), isolated [{}]",
+                     topology.online.size(), topology.nodes.size(),
+                     LogosCore::formatCpuList(topology.isolated));
+        std::atomic_store(&placementSlot(), placement);
+        installPlacement(placement);
+        return true;
+    }
+
+    void clearCpuPlacement() {
+        std::atomic_store(&placementSlot(), std::shared_ptr<LogosCore::CpuPlacement>());
+        installPlacement(nullptr);
+    }
+
+    std::shared_ptr<LogosCore::CpuPlacement> cpuPlacement() {
+        return std::atomic_load(&placementSlot());
+    }
+
+    bool enableLogCapture(const std::string& optionsJson) {
+        if (!LogosCore::LogCapture::supported()) {
+            spdlog::warn("Module log capture is not supported on this platform");
+            return false;
+        }
+        nlohmann::json json;
+        if (!optionsJson.empty()) {
+            json = nlohmann::json::parse(optionsJson, nullptr, false);
+            if (json.is_discarded()) {
+                spdlog::warn("Log capture options are not valid JSON");
+                return false;
+            }
+        }
+        auto options = LogosCore::LogCaptureOptions::fromJson(json);
+        if (!options)
+            return false;
+        auto capture = std::make_shared<LogosCore::LogCapture>(std::move(*options));
+        if (!capture->start())
+            return false;
+        spdlog::info("Capturing module output{}",
+                     capture->options().fileDir.empty() ? "" : " (files in " + capture->options().fileDir + ")");
+        // A previous capture lives on in the exit callbacks of the modules it
+        // captured, and stops once the last of them is gone.
+        std::atomic_store(&logCaptureSlot(), capture);
+        installLogCapture(capture);
+        return true;
+    }
+
+    void disableLogCapture() {
+        std::atomic_store(&logCaptureSlot(), std::shared_ptr<LogosCore::LogCapture>());
+        installLogCapture(nullptr);
+    }
+
+    std::shared_ptr<LogosCore::LogCapture> logCapture() {
+        return std::atomic_load(&logCaptureSlot());
+    }
+
+    bool startBootProfile(const std::string& profileJson) {
+        std::string error;
+        auto profile = LogosCore::parseBootProfile(profileJson, &error);
+        if (!profile) {
+            spdlog::warn("Boot profile rejected: {}", error);
+            return false;
+        }
+        std::lock_guard lock(bootProfileMutex());
+        auto& runner = bootProfileSlot();
+        if (runner && !runner->finished()) {
+            spdlog::warn("Boot profile already running");
+            return false;
+        }
+        LogosCore::BootProfileRunner::Hooks hooks;
+        hooks.isKnown = [](const std::string& n) { return registryInstance().isKnown(n); };
+        hooks.dependenciesOf = [](const std::string& n) { return registryInstance().moduleDependencies(n); };
+        hooks.isLoaded = [](const std::string& n) { return registryInstance().isLoaded(n); };
+        hooks.load = [](const std::string& n, bool required) {
+            return loadModule(n.c_str(), required ? LogosCore::LoadPriority::Normal
+                                                  : LogosCore::LoadPriority::Background);
+        };
+        runner = std::make_shared<LogosCore::BootProfileRunner>(std::move(*profile), std::move(hooks));
+        runner->start();
+        spdlog::info("Boot profile started");
+        return true;
+    }
+
+    bool startBootProfileFromFile(const std::string& path) {
+        std::ifstream in(path);
+        if (!in) {
+            spdlog::warn("Cannot read boot profile {}", path);
+            return false;
+        }
+        std::string json((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+        return startBootProfile(json);
+    }
+
+    void stopBootProfile() {
+        if (auto runner = currentBootProfile())
+            runner->stop();
+    }
+
+    int waitBootReady(std::chrono::milliseconds timeout) {
+        auto runner = currentBootProfile();
+        if (!runner)
+            return 0;
+        switch (runner->waitReady(timeout)) {
+        case LogosCore::BootProfileRunner::Ready::Reached:     return 1;
+        case LogosCore::BootProfileRunner::Ready::Unreachable: return -1;
+        case LogosCore::BootProfileRunner::Ready::Pending:     return 0;
+        }
+        return 0;
+    }
+
+    std::string getBootStatusJson() {
+        auto runner = currentBootProfile();
+        return runner ? runner->status().dump() : std::string();
+    }
+
+    char* getBootStatusCStr() {
+        std::string json = getBootStatusJson();
+        if (json.empty())
+            return nullptr;
+        char* result = new char[json.size() + 1];
+        strcpy(result, json.c_str());
+        return result;
+    }
+
+    bool startStatsSampler(std::chrono::milliseconds interval, std::size_t historySize) {
+        std::unique_lock lock(statsSamplerMutex());
+        auto& sampler = statsSampler();
+        if (sampler) {
+            spdlog::warn("Stats sampler already running");
+            return false;
+        }
+        if (historySize == 0) {
+            spdlog::warn("Stats sampler history size must be at least 1");
+            return false;
+        }
+        if (historySize > kMaxStatsHistory) {
+            spdlog::warn("Stats sampler history size {} capped at {}", historySize, kMaxStatsHistory);
+            historySize = kMaxStatsHistory;
+        }
+        sampler = std::make_unique<LogosCore::StatsSampler>(
+            []() { return modulePids(); }, interval, historySize,
+            &readModuleProcess, kStatsMemoryBudget);
+        sampler->start();
+        spdlog::info("Stats sampler started ({} ms interval, up to {} samples per module, {} MiB total)",
+                     sampler->interval().count(), historySize, kStatsMemoryBudget >> 20);
+        return true;
+    }
+
+    void stopStatsSampler() {
+        std::unique_lock lock(statsSamplerMutex());
+        statsSampler().reset();
+    }
+
+    bool isStatsSamplerRunning() {
+        std::shared_lock lock(statsSamplerMutex());
+        return statsSampler() != nullptr;
+    }
+
+    std::optional<LogosCore::StatsSample> latestModuleStats(const std::string& name) {
+        std::shared_lock lock(statsSamplerMutex());
+        if (!statsSampler())
+            return std::nullopt;
+        return statsSampler()->latest(name);
+    }
+
+    LogosCore::StatsWindow moduleStatsWindow(const std::string& name, std::chrono::milliseconds span) {
+        std::shared_lock lock(statsSamplerMutex());
+        if (!statsSampler())
+            return {};
+        return statsSampler()->window(name, span);
+    }
+
+    char* getModuleStatsCStr() {
+        nlohmann::json arr = nlohmann::json::array();
+        if (!isStatsSamplerRunning()) {
+            // Modules in their own cgroup are read from the leaf alone; for
+            // the rest ProcessStats keeps the CPU% baseline and the detail
+            // is one extra ProcReader pass per pid.
+            auto pids = getModuleProcessIds();
+            std::vector<nlohmann::json> fromCgroups;
+            for (auto it = pids.begin(); it != pids.end();) {
+                auto cg = readModuleCgroup(it->first);
+                if (!cg) {
+                    ++it;
+                    continue;
+                }
+                nlohmann::json entry = {{"name", it->first}, {"cpu_percent", cg->cpuPercent}};
+                addCgroupStats(entry, cg->leaf, cg->stats);
+                addPlacement(entry, it->first);
+                fromCgroups.push_back(std::move(entry));
+                it = pids.erase(it);
+            }
+            char* base = ProcessStats::getModuleStats(pids);
+            arr = nlohmann::json::parse(base, nullptr, false);
+            if (!arr.is_array())
+                return base;
+            delete[] base;
+            for (auto& entry : arr) {
+                auto it = pids.find(entry.value("name", std::string()));
+                LogosCore::ProcessReading reading;
+                if (it != pids.end() && LogosCore::readProcess(it->second, reading))
+                    addProcessDetail(entry, reading.detail);
+                addPlacement(entry, entry.value("name", std::string()));
+            }
+            for (auto& entry : fromCgroups)
+                arr.push_back(std::move(entry));
+        } else {
+            // Same shape, from the sampler's latest points.
+            for (const auto& p : currentModuleProcesses()) {
+                nlohmann::json entry = {
+                    {"name", p.name},
+                    {"cpu_percent", p.cpuPercent},
+                    {"cpu_time_seconds", p.cpuSeconds},
+                    {"memory_mb", static_cast<double>(p.memoryBytes) / (1024.0 * 1024.0)},
+                };
+                addProcessDetail(entry, p.detail);
+                addCgroupStats(entry, p.name);
+                addPlacement(entry, p.name);
+                arr.push_back(std::move(entry));
+            }
+        }
+        std::string json = arr.dump();
+        char* result = new char[json.size() + 1];
+        strcpy(result, json.c_str());
+        return result;
+    }
+
+    char* getModuleStatsHistoryCStr(const char* name, std::chrono::milliseconds span) {
+        std::shared_lock lock(statsSamplerMutex());
+        const auto& sampler = statsSampler();
+        if (!sampler)
+            return nullptr;
+        const auto latest = sampler->latest(name);
+        if (!latest)
+            return nullptr;
+        const auto w = sampler->window(name, span);
+
+        constexpr double kMB = 1024.0 * 1024.0;
+        nlohmann::json j = {
+            {"name", name},
+            {"pid", sampler->pidOf(name).value_or(0)},
+            {"interval_ms", sampler->interval().count()},
+            {"latest", {
+                {"age_ms", std::chrono::duration_cast<std::chrono::milliseconds>(
+                               std::chrono::steady_clock::now().time_since_epoch()).count()
+                           - latest->timestampMs},
+                {"cpu_percent", latest->cpuPercent},
+                {"cpu_time_seconds", latest->cpuSeconds},
+                {"memory_mb", static_cast<double>(latest->rssBytes) / kMB},
+            }},
+            {"window", {
+                {"ms", span.count()},
+                {"count", w.count},
+                {"span_ms", w.toMs - w.fromMs},
+                {"cpu_percent", {{"min", w.cpuPercentMin}, {"max", w.cpuPercentMax}, {"avg", w.cpuPercentAvg}}},
+                {"memory_mb", {{"min", static_cast<double>(w.rssBytesMin) / kMB},
+                               {"max", static_cast<double>(w.rssBytesMax) / kMB},
+                               {"avg", w.rssBytesAvg / kMB}}},
+            }},
+        };
+        addProcessDetail(j["latest"], latest->detail);
+        std::string json = j.dump();
+        char* result = new char[json.size() + 1];
+        strcpy(result, json.c_str());
+        return result;
+    }
+
     std::vector<std::string> computeDerivedAllowedCallers(const std::string& target) {
         std::lock_guard lock(loadMutex());
         return computeDerivedAllowedCallersLocked(target);
     }
+
+    void flushCapabilityNotifications() {
+        capabilityNotifier().drain();
+    }
 }
@@ -2,6 +2,15 @@
 #define MODULE_MANAGER_H
 
 #include "module_loader_registry.h"
+#include "stats_sampler.h"
+#include "cgroup_manager.h"
+#include "cpu_placement.h"
+#include "log_capture.h"
+#include "token_service.h"
+#include "load_scheduler.h"
+#include "replica_set.h"
+#include <chrono>
+#include <optional>
 #include <string>
 #include <vector>
 #include <unordered_map>
@@ -20,6 +29,10 @@ namespace ModuleManager {
     // (see module_manager.cpp). Also used by tests to install a FakeModuleLoader.
     LogosCore::ModuleLoaderRegistry& loaders();
 
+    // Token minting for module loads (see token_service.h). Exposed for
+    // tests and diagnostics.
+    LogosCore::TokenService& tokens();
+
     void setModulesDir(const char* modules_dir);
     void addModulesDir(const char* modules_dir);
     void setPersistenceBasePath(const char* path);
@@ -40,6 +53,25 @@ namespace ModuleManager {
     void setModuleTransports(const std::string& moduleName,
                              const std::string& transportSetJson);
 
+    // Run `count` instances of the module instead of one (see
+    // replica_set.h): the primary under its own name plus count - 1
+    // replicas, each with its own persistence path, spread across by
+    // `policy`. Takes effect the next time the module loads; 1 turns it
+    // off. False for a count outside 1..64.
+    bool setModuleReplicas(const std::string& moduleName, int count,
+                           LogosCore::ReplicaPolicy policy = LogosCore::ReplicaPolicy::RoundRobin);
+    // Instance to send the next call for the module to, counted as in flight
+    // until releaseModuleReplica(). The module's container key when it runs
+    // a single instance: its own name, or the key an upgrade moved it to.
+    // nullopt when it is not loaded.
+    std::optional<std::string> acquireModuleReplica(const std::string& moduleName);
+    void releaseModuleReplica(const std::string& moduleName, const std::string& instance);
+    // {"module", "policy", "replicas": [{instance, pid, in_flight,
+    // dispatched}]}; empty when the module is not loaded.
+    std::string getModuleReplicasJson(const std::string& moduleName);
+    // char* variant. Caller owns the returned string. Null when not loaded.
+    char* getModuleReplicasCStr(const char* moduleName);
+
     // Store the inter-module access policy (the raw JSON document set via
     // logos_core_set_access_policy). Core parses it and registers the
     // concrete per-target restrictions with capability_module once that
@@ -51,23 +83,52 @@ namespace ModuleManager {
     // A pure read with no RPC — exposed so tests can observe the derivation.
     std::vector<std::string> computeDerivedAllowedCallers(const std::string& target);
 
+    // Token and restriction notifications to capability_module are delivered
+    // asynchronously, in order, off the load path. Block until every one
+    // queued so far has been delivered.
+    void flushCapabilityNotifications();
+
     void discoverInstalledModules();
 
     std::string processModule(const std::string& modulePath);
     char* processModuleCStr(const char* modulePath);
-    bool loadModule(const char* moduleName);
-    bool loadModuleWithDependencies(const char* moduleName);
+    // Loads run one at a time; `priority` decides which queued request goes
+    // next (see load_scheduler.h). An interactive request also promotes
+    // queued requests for modules in its dependency closure.
+    bool loadModule(const char* moduleName,
+                    LogosCore::LoadPriority priority = LogosCore::LoadPriority::Normal);
+    bool loadModuleWithDependencies(const char* moduleName,
+                                    LogosCore::LoadPriority priority = LogosCore::LoadPriority::Normal);
+    // Load requests waiting behind the running one.
+    std::size_t queuedLoadRequests();
+    // Blue-green upgrade of a loaded module: start the build at `pluginPath`
+    // (empty: the registered path, rebuilt in place) next to the running
+    // process, pass it through the protocol gate, hand capability_module and
+    // the new process a fresh token (the old one's stays valid), swap the
+    // registry entry over to it, and only then stop the old process, after
+    // releasing the load lock. Dependents are never unloaded. False,
+    // with the old process untouched, if the module is not loaded, the new
+    // build is refused or one of its dependencies is not loaded, no container
+    // key is free for it, or it fails to start or to take its token. The new
+    // process keeps its container key; acquireModuleReplica() hands it out.
+    bool upgradeModule(const std::string& moduleName, const std::string& pluginPath = {});
     bool initializeCapabilityModule();
     bool unloadModule(const char* moduleName);
 
     // Cascading unload: unload the named module together with every currently
-    // loaded module that (transitively) depends on it. The order is
-    // leaves-first (dependents before dependencies) so no process is left
-    // briefly pointing at a dead parent.
+    // loaded module that (transitively) depends on it. It comes down in
+    // leaves-first waves (dependents before dependencies) so no process is
+    // left briefly pointing at a dead parent; modules in one wave are stopped
+    // together, against the setShutdownTimeout deadline.
     // Returns true only if every step succeeded.
     bool unloadModuleWithDependents(const char* moduleName);
 
+    // Stop every loaded module, dependents before their dependencies. Each
+    // leaves-first wave is signalled at once and the whole shutdown shares
+    // one deadline (setShutdownTimeout, default 3 s), after which modules
+    // still running are SIGKILLed. clear() shuts down the same way.
     void terminateAll();
+    void setShutdownTimeout(std::chrono::milliseconds timeout);
     void clear();
 
     char** getLoadedModulesCStr();
@@ -103,6 +164,114 @@ namespace ModuleManager {
     std::string getModulesInfoJson();
     // char* variant. Caller owns the returned string. Never null.
     char* getModulesInfoCStr();
+
+    // JSON (string) with per-phase latency histograms of module loads and
+    // unloads, aggregate and per module. See lifecycle_metrics.h for the
+    // phases and the shape. Reset by clear().
+    std::string getLifecycleMetricsJson();
+    // char* variant. Caller owns the returned string. Never null.
+    char* getLifecycleMetricsCStr();
+
+    // JSON (string) critical-path report of a boot (see boot_schedule.h):
+    // the earliest-start parallel schedule, theoretical minimum boot time and
+    // gating modules for `module` and its dependency closure or, when
+    // `module` is empty, for every module that has loaded plus everything it
+    // depends on. Each module weighs its mean successful load time from the
+    // lifecycle metrics; never-loaded ones count as 0 and are listed as
+    // unmeasured. Empty when `module` is not known.
+    std::string getBootReportJson(const std::string& module);
+    // char* variant. Caller owns the returned string. Null when the module
+    // is not known.
+    char* getBootReportCStr(const char* module);
+
+    // OpenMetrics text exposition of the lifecycle counters and histograms,
+    // known/loaded module counts and per-module CPU/memory (see openmetrics.h).
+    // Rendered fresh on every call.
+    std::string getOpenMetricsText();
+
+    // Serve getOpenMetricsText() on a local endpoint (see metrics_exporter.h
+    // for the accepted forms), re-rendered every `refresh` on the exporter's
+    // own thread; scrapes are answered from that cache. False if already
+    // running or the endpoint cannot be bound.
+    bool startMetricsExporter(const std::string& endpoint,
+                              std::chrono::milliseconds refresh = std::chrono::seconds(5));
+    void stopMetricsExporter();
+
+    // Put every module process launched through a CompositeModuleLoader
+    // from now on into its own cgroup v2 leaf under `root` (empty: this
+    // process's own cgroup), with limits from module metadata overlaid by
+    // `policyJson` (see cgroup_manager.h). Module stats then take CPU time
+    // and memory from the leaf. False — and modules keep running in the
+    // host's cgroup — when the hierarchy is not delegated to us.
+    bool enableCgroups(const std::string& root, const std::string& policyJson);
+    // Stop placing modules and remove the leaves that are empty.
+    void disableCgroups();
+    std::shared_ptr<LogosCore::CgroupManager> cgroups();
+
+    // Pin module processes launched through a CompositeModuleLoader from now
+    // on to CPUs per `policyJson` (empty: balance across NUMA nodes only; see
+    // cpu_placement.h). Replaces any previous policy; modules already running
+    // keep their affinity. False on a malformed policy or off Linux.
+    bool setCpuPlacement(const std::string& policyJson);
+    void clearCpuPlacement();
+    std::shared_ptr<LogosCore::CpuPlacement> cpuPlacement();
+
+    // Capture stdout/stderr of module processes launched through a
+    // CompositeModuleLoader from now on into "module.<name>" log channels,
+    // rate-limited, optionally also into rotating per-module files (see
+    // log_capture.h for `optionsJson`). Replaces any previous capture for
+    // new launches. False on bad options or off Linux.
+    bool enableLogCapture(const std::string& optionsJson);
+    // Stop capturing new launches; running modules stay captured until they exit.
+    void disableLogCapture();
+    std::shared_ptr<LogosCore::LogCapture> logCapture();
+
+    // Background ProcessStats sampling (see stats_sampler.h): a dedicated
+    // thread reads every module process each `interval` into a per-module
+    // ring of `historySize` samples. While it runs, getModuleStatsCStr() and
+    // the metrics exporter read its latest points instead of /proc. False if
+    // already running or `historySize` is 0; sizes above 86400 are capped,
+    // and all rings together stay within 32 MiB, so with many modules each
+    // holds fewer samples.
+    bool startStatsSampler(std::chrono::milliseconds interval = std::chrono::seconds(1),
+                           std::size_t historySize = 300);
+    void stopStatsSampler();
+    bool isStatsSamplerRunning();
+
+    // Declarative boot profile (see boot_profile.h): load the profile's
+    // module sets in priority order on a background thread, one module per
+    // load call. False if the JSON is malformed or a profile is still
+    // running; a finished one is replaced. clear() stops and drops it.
+    bool startBootProfile(const std::string& profileJson);
+    // Same, reading the profile from a file.
+    bool startBootProfileFromFile(const std::string& path);
+    // Cancel the modules not yet started and wait for the one in progress.
+    void stopBootProfile();
+    // 1 once every module of the required sets is loaded, -1 if that can no
+    // longer happen, 0 on timeout or when no profile was started. Negative
+    // `timeout` waits without limit.
+    int waitBootReady(std::chrono::milliseconds timeout);
+    // Progress JSON (BootProfileRunner::status()); empty when no profile was
+    // started.
+    std::string getBootStatusJson();
+    // char* variant. Caller owns the returned string. Null when no profile
+    // was started.
+    char* getBootStatusCStr();
+
+    // Latest sample / window summary for `name`; empty when the sampler is
+    // not running or has no history for it. Never touch /proc.
+    std::optional<LogosCore::StatsSample> latestModuleStats(const std::string& name);
+    LogosCore::StatsWindow moduleStatsWindow(const std::string& name,
+                                             std::chrono::milliseconds span);
+
+    // JSON array of {name, cpu_percent, cpu_time_seconds, memory_mb} per
+    // module process — from the sampler when running, else a direct
+    // ProcessStats read. Caller owns the returned string.
+    char* getModuleStatsCStr();
+    // JSON {name, pid, interval_ms, latest, window} for one module, or null
+    // when the sampler is not running or has no history for it. Caller owns
+    // the returned string.
+    char* getModuleStatsHistoryCStr(const char* name, std::chrono::milliseconds span);
 }
 
 #endif // MODULE_MANAGER_H
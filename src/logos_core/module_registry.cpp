@@ -1,4 +1,5 @@
 #include "module_registry.h"
+#include "lifecycle_trace.h"
 #include <spdlog/spdlog.h>
 #include <cassert>
 #include <ctime>
@@ -57,6 +58,7 @@ std::vector<std::string> ModuleRegistry::modulesDirs() const {
 }
 
 void ModuleRegistry::discoverInstalledModules() {
+    LifecycleTrace::Span span("discovery", "registry");
     std::unique_lock lock(m_mutex);
 
     PackageManagerLib& pm = packageManagerInstance();
@@ -104,7 +106,7 @@ void ModuleRegistry::discoverInstalledModules() {
             toRemove.push_back(name);
     }
     for (const std::string& name : toRemove) {
-        m_modules.erase(name);
+        eraseLocked(name);
     }
 
     // Graph has its final shape (upserts + prunes applied). Re-derive
@@ -125,6 +127,7 @@ std::string ModuleRegistry::processModule(const std::string& modulePath) {
 
 std::string ModuleRegistry::processModuleInternal(const std::string& modulePath,
                                                   const std::string& trustedName) {
+    LifecycleTrace::Span span("metadata_extraction", "registry", modulePath);
     // The plugin's *self-asserted* identity, read verbatim from its embedded
     // metadata. This is attacker-controlled for any plugin we didn't build,
     // so it must never be trusted as the module's identity on its own.
@@ -164,7 +167,7 @@ std::string ModuleRegistry::processModuleInternal(const std::string& modulePath,
 
     // Update module info in place so re-discovery preserves the loaded flag
     // (and any other state that lives on ModuleInfo).
-    ModuleInfo& info = m_modules[name];
+    ModuleInfo& info = entryLocked(name);
     info.path = modulePath;
     info.metadataJson = ModuleLib::LogosModule::getRawMetadataJson(modulePath);
     info.dependencies.clear();
@@ -290,11 +293,42 @@ std::vector<std::string> ModuleRegistry::moduleDependentsLocked(const std::strin
     return out;
 }
 
+ModuleInfo& ModuleRegistry::entryLocked(const std::string& name) {
+    auto [it, inserted] = m_modules.try_emplace(name);
+    if (inserted) {
+        uint32_t id;
+        if (!m_freeIds.empty()) {
+            id = m_freeIds.back();
+            m_freeIds.pop_back();
+            m_idNames[id] = name;
+        } else {
+            id = static_cast<uint32_t>(m_idNames.size());
+            m_idNames.push_back(name);
+        }
+        it->second.id = id;
+    }
+    return it->second;
+}
+
+void ModuleRegistry::eraseLocked(const std::string& name) {
+    auto it = m_modules.find(name);
+    if (it == m_modules.end())
+        return;
+    const uint32_t id = it->second.id;
+    m_loadedBits.reset(id);
+    m_idNames[id].clear();
+    m_freeIds.push_back(id);
+    m_modules.erase(it);
+}
+
 void ModuleRegistry::recomputeDependentsLocked() {
     // Wipe the reverse edges in place — we don't want to reallocate each
     // ModuleInfo, so clear() keeps any existing vector capacity.
     for (auto& [k, v] : m_modules)
         v.dependents.clear();
+    m_dependentBits.resize(m_idNames.size());
+    for (auto& row : m_dependentBits)
+        row.clear();
 
     // Invert every forward edge. An entry whose dependency points at an
     // unknown module is silently skipped — we can't register a reverse
@@ -307,10 +341,23 @@ void ModuleRegistry::recomputeDependentsLocked() {
             auto& deps = depIt->second.dependents;
             if (std::find(deps.begin(), deps.end(), depender) == deps.end())
                 deps.push_back(depender);
+            m_dependentBits[depIt->second.id].set(info.id);
         }
     }
 }
 
+std::vector<std::string> ModuleRegistry::loadedDependents(const std::string& name) const {
+    std::shared_lock lock(m_mutex);
+    auto it = m_modules.find(name);
+    if (it == m_modules.end() || it->second.id >= m_dependentBits.size())
+        return {};
+    std::vector<std::string> out;
+    m_dependentBits[it->second.id].forEachAnd(m_loadedBits, [&](std::size_t id) {
+        out.push_back(m_idNames[id]);
+    });
+    return out;
+}
+
 std::vector<std::string> ModuleRegistry::knownModuleNames() const {
     std::shared_lock lock(m_mutex);
     std::vector<std::string> keys;
@@ -323,7 +370,7 @@ std::vector<std::string> ModuleRegistry::knownModuleNames() const {
 void ModuleRegistry::registerModule(const std::string& name, const std::string& path,
                                     const std::vector<std::string>& dependencies) {
     std::unique_lock lock(m_mutex);
-    ModuleInfo& info = m_modules[name];
+    ModuleInfo& info = entryLocked(name);
     info.path = path;
     // Always assign dependencies (even when empty) and recompute reverse
     // edges. Two reasons we can't gate this on `dependencies.empty()`:
@@ -336,9 +383,19 @@ void ModuleRegistry::registerModule(const std::string& name, const std::string&
     recomputeDependentsLocked();
 }
 
+void ModuleRegistry::registerModules(const std::vector<ModuleRegistration>& modules) {
+    std::unique_lock lock(m_mutex);
+    for (const auto& m : modules) {
+        ModuleInfo& info = entryLocked(m.name);
+        info.path = m.path;
+        info.dependencies = m.dependencies;
+    }
+    recomputeDependentsLocked();
+}
+
 void ModuleRegistry::registerDependencies(const std::string& name, const std::vector<std::string>& dependencies) {
     std::unique_lock lock(m_mutex);
-    m_modules[name].dependencies = dependencies;
+    entryLocked(name).dependencies = dependencies;
     // Same reasoning as registerModule: this is a direct graph mutator used
     // by tests. Keep the dependents-consistent-with-dependencies invariant
     // holding across every path that edits forward edges.
@@ -360,18 +417,20 @@ static int64_t nowUnixSeconds() {
 
 void ModuleRegistry::markLoaded(const std::string& name) {
     std::unique_lock lock(m_mutex);
-    auto& info = m_modules[name];
+    auto& info = entryLocked(name);
     info.loaded = true;
     info.loadedAt = nowUnixSeconds();
+    m_loadedBits.set(info.id);
 }
 
 void ModuleRegistry::markLoaded(const std::string& name,
                                  std::shared_ptr<LogosCore::ModuleLoader> loader,
                                  LogosCore::LoadedModuleHandle handle) {
     std::unique_lock lock(m_mutex);
-    auto& info = m_modules[name];
+    auto& info = entryLocked(name);
     info.loaded = true;
     info.loadedAt = nowUnixSeconds();
+    m_loadedBits.set(info.id);
     info.loader = std::move(loader);
     info.handle = std::move(handle);
 }
@@ -390,6 +449,7 @@ void ModuleRegistry::markUnloaded(const std::string& name) {
     if (it != m_modules.end()) {
         it->second.loaded = false;
         it->second.loadedAt = 0;
+        m_loadedBits.reset(it->second.id);
     }
 }
 
@@ -407,10 +467,15 @@ void ModuleRegistry::clearLoaded() {
     std::unique_lock lock(m_mutex);
     for (auto& [k, v] : m_modules)
         v.loaded = false;
+    m_loadedBits.clear();
 }
 
 void ModuleRegistry::clear() {
     std::unique_lock lock(m_mutex);
     m_modulesDirs.clear();
     m_modules.clear();
+    m_idNames.clear();
+    m_freeIds.clear();
+    m_dependentBits.clear();
+    m_loadedBits.clear();
 }
@@ -2,6 +2,8 @@
 #define MODULE_REGISTRY_H
 
 #include "module_loader.h"
+#include "module_bitset.h"
+#include <cstdint>
 #include <memory>
 #include <string>
 #include <vector>
@@ -34,6 +36,10 @@ struct ModuleInfo {
     // directly. Use ModuleRegistry::moduleDependents() for transitive walks.
     std::vector<std::string> dependents;
     bool loaded = false;
+    // Dense index into the registry's bitset matrix (see
+    // ModuleRegistry::loadedDependents). Assigned when the entry is created,
+    // recycled after it is erased; never meaningful outside the registry.
+    uint32_t id = 0;
     // Unix timestamp (seconds) of the most recent load, set by markLoaded and
     // cleared to 0 by markUnloaded. 0 ⟺ not currently loaded. Callers derive a
     // module's uptime from it (now - loadedAt), valid only while loaded.
@@ -43,6 +49,13 @@ struct ModuleInfo {
     LogosCore::LoadedModuleHandle handle;
 };
 
+// One entry for ModuleRegistry::registerModules().
+struct ModuleRegistration {
+    std::string name;
+    std::string path;
+    std::vector<std::string> dependencies;
+};
+
 class ModuleRegistry {
 public:
     void setModulesDir(const std::string& dir);
@@ -76,6 +89,18 @@ public:
     void registerModule(const std::string& name, const std::string& path,
                         const std::vector<std::string>& dependencies = {});
     void registerDependencies(const std::string& name, const std::vector<std::string>& dependencies);
+    // registerModule() for many modules under one lock, with a single rebuild
+    // of the reverse edges at the end instead of one per module — registering
+    // N modules one at a time costs O(N * graph). Same semantics otherwise.
+    void registerModules(const std::vector<ModuleRegistration>& modules);
+
+    // Direct dependents of `name` that are currently loaded. Answered from a
+    // dependents x loaded bitset matrix under one shared lock — a word-wise
+    // AND rather than an isLoaded() lookup (and lock) per dependent. The
+    // dependents rows are rebuilt with the reverse edges; the loaded row is
+    // flipped in place by markLoaded / markUnloaded. Unknown names yield an
+    // empty list. Order is by internal id, not declaration order.
+    std::vector<std::string> loadedDependents(const std::string& name) const;
 
     bool isLoaded(const std::string& name) const;
     void markLoaded(const std::string& name);
@@ -116,6 +141,12 @@ private:
     // exclusively. Cost is O(N * avg_deps) — negligible for the module
     // counts we see and simpler than keeping incremental diffs.
     void recomputeDependentsLocked();
+
+    // Find-or-create the entry for `name`, assigning it a matrix id on
+    // creation. Every insertion into m_modules goes through here.
+    ModuleInfo& entryLocked(const std::string& name);
+    // Erase `name` and release its id (clearing its loaded bit).
+    void eraseLocked(const std::string& name);
     std::vector<std::string> moduleDependenciesLocked(const std::string& name,
                                                       bool recursive) const;
     std::vector<std::string> moduleDependentsLocked(const std::string& name,
@@ -124,6 +155,15 @@ private:
     mutable std::shared_mutex m_mutex;
     std::vector<std::string> m_modulesDirs;
     std::unordered_map<std::string, ModuleInfo> m_modules;
+
+    // id -> name, "" for a released id. Released ids are reused first so the
+    // bitsets stay as narrow as the live module count.
+    std::vector<std::string> m_idNames;
+    std::vector<uint32_t> m_freeIds;
+    // Row per target id: bit j set iff module j declares the target as a
+    // direct dependency. Rebuilt by recomputeDependentsLocked.
+    std::vector<LogosCore::ModuleBitset> m_dependentBits;
+    LogosCore::ModuleBitset m_loadedBits;
 };
 
 #endif // MODULE_REGISTRY_H
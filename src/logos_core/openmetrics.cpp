@@ -0,0 +1,184 @@
+#include "openmetrics.h"
+
+#include <cstdio>
+
+namespace LogosCore {
+
+namespace {
+
+// Label values are module names and phase names; module names are already
+// restricted by isValidModuleName, but escape per the spec regardless.
+std::string escapeLabel(const std::string& value)
+{
+    std::string out;
+    out.reserve(value.size());
+    for (char c : value) {
+        switch (c) {
+        case '\\': out += "\\\\"; break;
+        case '"':  out += "\\\""; break;
+        case '\n': out += "\\n"; break;
+        default:   out += c; break;
+        }
+    }
+    return out;
+}
+
+std::string formatDouble(double v)
+{
+    char buf[32];
+    std::snprintf(buf, sizeof(buf), "%.9g", v);
+    return buf;
+}
+
+std::string secondsFromUs(uint64_t us)
+{
+    return formatDouble(static_cast<double>(us) / 1e6);
+}
+
+void family(std::string& out, const char* name, const char* type, const char* help,
+            const char* unit = nullptr)
+{
+    out += "# TYPE logos_core_"; out += name; out += ' '; out += type; out += '\n';
+    if (unit) {
+        out += "# UNIT logos_core_"; out += name; out += ' '; out += unit; out += '\n';
+    }
+    out += "# HELP logos_core_"; out += name; out += ' '; out += help; out += '\n';
+}
+
+void sample(std::string& out, const char* name, const char* suffix,
+            const std::string& labels, const std::string& value)
+{
+    out += "logos_core_"; out += name; out += suffix;
+    if (!labels.empty()) {
+        out += '{'; out += labels; out += '}';
+    }
+    out += ' '; out += value; out += '\n';
+}
+
+std::string label(const char* key, const std::string& value)
+{
+    return std::string(key) + "=\"" + escapeLabel(value) + "\"";
+}
+
+void counterFamily(std::string& out, const char* name, const char* help,
+                   const MetricsSample& s, LifecycleMetrics::Counter counter)
+{
+    family(out, name, "counter", help);
+    const auto c = static_cast<std::size_t>(counter);
+    for (const auto& [module, snap] : s.lifecycle.modules)
+        sample(out, name, "_total", label("module", module), std::to_string(snap.counters[c]));
+}
+
+} // namespace
+
+std::string renderOpenMetrics(const MetricsSample& s)
+{
+    using LifecycleMetrics::kBucketCount;
+    using LifecycleMetrics::kPhaseCount;
+    using LifecycleMetrics::LatencyHistogram;
+    using LifecycleMetrics::Phase;
+
+    std::string out;
+    out.reserve(4096 + s.lifecycle.modules.size() * 1024);
+
+    family(out, "modules_known", "gauge", "Modules known to the registry.");
+    sample(out, "modules_known", "", {}, std::to_string(s.knownModules));
+    family(out, "modules_loaded", "gauge", "Modules currently loaded.");
+    sample(out, "modules_loaded", "", {}, std::to_string(s.loadedModules));
+
+    counterFamily(out, "module_loads", "Successful module loads.", s,
+                  LifecycleMetrics::Counter::Loads);
+    counterFamily(out, "module_load_failures", "Failed load attempts of known modules.", s,
+                  LifecycleMetrics::Counter::LoadFailures);
+    counterFamily(out, "module_unloads", "Successful module unloads.", s,
+                  LifecycleMetrics::Counter::Unloads);
+    counterFamily(out, "module_restarts", "Loads of a module that had loaded before.", s,
+                  LifecycleMetrics::Counter::Restarts);
+    counterFamily(out, "module_upgrades", "In-place upgrades of a running module.", s,
+                  LifecycleMetrics::Counter::Upgrades);
+
+    family(out, "lifecycle_phase_seconds", "histogram",
+           "Latency of each module load/unload phase, all modules.", "seconds");
+    for (std::size_t p = 0; p < kPhaseCount; ++p) {
+        const auto& h = s.lifecycle.aggregate.phases[p];
+        if (h.count == 0)
+            continue;
+        const std::string phase = label("phase", LifecycleMetrics::phaseName(static_cast<Phase>(p)));
+        uint64_t cumulative = 0;
+        for (std::size_t i = 0; i < kBucketCount; ++i) {
+            cumulative += h.buckets[i];
+            const std::string le = i + 1 < kBucketCount
+                ? secondsFromUs(LatencyHistogram::bucketUpperUs(i)) : "+Inf";
+            sample(out, "lifecycle_phase_seconds", "_bucket",
+                   phase + ",le=\"" + le + "\"", std::to_string(cumulative));
+        }
+        sample(out, "lifecycle_phase_seconds", "_count", phase, std::to_string(h.count));
+        sample(out, "lifecycle_phase_seconds", "_sum", phase, secondsFromUs(h.sumUs));
+    }
+
+    family(out, "module_lifecycle_phase_seconds", "summary",
+           "Latency of each module load/unload phase, per module.", "seconds");
+    for (const auto& [module, snap] : s.lifecycle.modules) {
+        for (std::size_t p = 0; p < kPhaseCount; ++p) {
+            const auto& h = snap.phases[p];
+            if (h.count == 0)
+                continue;
+            const std::string labels = label("module", module) + "," +
+                label("phase", LifecycleMetrics::phaseName(static_cast<Phase>(p)));
+            sample(out, "module_lifecycle_phase_seconds", "_count", labels, std::to_string(h.count));
+            sample(out, "module_lifecycle_phase_seconds", "_sum", labels, secondsFromUs(h.sumUs));
+        }
+    }
+
+    family(out, "module_cpu_percent", "gauge", "Module process CPU usage, percent of one core.");
+    for (const auto& p : s.processes)
+        sample(out, "module_cpu_percent", "", label("module", p.name), formatDouble(p.cpuPercent));
+    family(out, "module_cpu_seconds", "counter", "Module process CPU time.", "seconds");
+    for (const auto& p : s.processes)
+        sample(out, "module_cpu_seconds", "_total", label("module", p.name), formatDouble(p.cpuSeconds));
+    family(out, "module_memory_bytes", "gauge", "Module process resident memory.", "bytes");
+    for (const auto& p : s.processes)
+        sample(out, "module_memory_bytes", "", label("module", p.name), std::to_string(p.memoryBytes));
+
+    family(out, "module_pss_bytes", "gauge", "Module process proportional set size.", "bytes");
+    for (const auto& p : s.processes)
+        if (p.detail.has(ProcessDetail::MemoryDetail))
+            sample(out, "module_pss_bytes", "", label("module", p.name), std::to_string(p.detail.pssBytes));
+    family(out, "module_uss_bytes", "gauge", "Module process unique (private) memory.", "bytes");
+    for (const auto& p : s.processes)
+        if (p.detail.has(ProcessDetail::MemoryDetail))
+            sample(out, "module_uss_bytes", "", label("module", p.name), std::to_string(p.detail.ussBytes));
+    family(out, "module_threads", "gauge", "Module process thread count.");
+    for (const auto& p : s.processes)
+        if (p.detail.has(ProcessDetail::Threads))
+            sample(out, "module_threads", "", label("module", p.name), std::to_string(p.detail.threads));
+    family(out, "module_open_fds", "gauge", "Module process open file descriptors.");
+    for (const auto& p : s.processes)
+        if (p.detail.has(ProcessDetail::OpenFds))
+            sample(out, "module_open_fds", "", label("module", p.name), std::to_string(p.detail.openFds));
+    family(out, "module_context_switches", "counter", "Module process context switches.");
+    for (const auto& p : s.processes) {
+        if (!p.detail.has(ProcessDetail::ContextSwitches))
+            continue;
+        const std::string module = label("module", p.name);
+        sample(out, "module_context_switches", "_total", module + "," + label("kind", "voluntary"),
+               std::to_string(p.detail.voluntaryCtxSwitches));
+        sample(out, "module_context_switches", "_total", module + "," + label("kind", "involuntary"),
+               std::to_string(p.detail.involuntaryCtxSwitches));
+    }
+    family(out, "module_io_bytes", "counter", "Module process storage I/O.", "bytes");
+    for (const auto& p : s.processes) {
+        if (!p.detail.has(ProcessDetail::Io))
+            continue;
+        const std::string module = label("module", p.name);
+        sample(out, "module_io_bytes", "_total", module + "," + label("direction", "read"),
+               std::to_string(p.detail.ioReadBytes));
+        sample(out, "module_io_bytes", "_total", module + "," + label("direction", "write"),
+               std::to_string(p.detail.ioWriteBytes));
+    }
+
+    out += "# EOF\n";
+    return out;
+}
+
+} // namespace LogosCore
@@ -0,0 +1,54 @@
+#ifndef OPENMETRICS_H
+#define OPENMETRICS_H
+
+#include "lifecycle_metrics.h"
+#include "proc_reader.h"
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace LogosCore {
+
+// Everything the OpenMetrics exposition renders, gathered in one pass so the
+// text is a pure function of it (and testable without a live core).
+struct MetricsSample {
+    struct ModuleProcess {
+        std::string name;
+        int64_t pid = 0;
+        double cpuPercent = 0.0;
+        double cpuSeconds = 0.0;
+        uint64_t memoryBytes = 0;
+        ProcessDetail detail;
+    };
+
+    std::size_t knownModules = 0;
+    std::size_t loadedModules = 0;
+    LifecycleMetrics::Snapshot lifecycle;
+    std::vector<ModuleProcess> processes;
+};
+
+// Render `sample` in the OpenMetrics 1.0 text format, terminated by "# EOF".
+//
+// Families (all prefixed logos_core_):
+//   modules_known, modules_loaded                       gauge
+//   module_loads, module_load_failures,
+//   module_unloads, module_restarts     {module}        counter
+//   lifecycle_phase_seconds             {phase}         histogram (aggregate)
+//   module_lifecycle_phase_seconds      {module,phase}  summary (count/sum)
+//   module_cpu_percent                  {module}        gauge
+//   module_cpu_seconds                  {module}        counter
+//   module_memory_bytes                 {module}        gauge
+//   module_pss_bytes, module_uss_bytes  {module}        gauge
+//   module_threads, module_open_fds     {module}        gauge
+//   module_context_switches             {module,kind}   counter
+//   module_io_bytes                     {module,direction} counter
+//
+// The last four rows only carry modules whose ProcessDetail has the field.
+//
+// Per-module latency is a summary rather than a histogram to keep the
+// exposition size linear in modules x phases instead of x buckets too.
+std::string renderOpenMetrics(const MetricsSample& sample);
+
+} // namespace LogosCore
+
+#endif // OPENMETRICS_H
@@ -0,0 +1,189 @@
+#include "proc_reader.h"
+
+#ifdef __linux__
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#else
+#include <process_stats/process_stats.h>
+#endif
+
+namespace LogosCore {
+
+#ifdef __linux__
+
+namespace {
+
+// Value of a "Key:   <n> [kB]" line. `key` includes the leading newline and
+// trailing colon, so "Pss:" does not match "SwapPss:" and
+// "voluntary_ctxt_switches:" does not match its "non" twin.
+bool lineValue(const char* buf, const char* key, uint64_t& value)
+{
+    const char* p = std::strstr(buf, key);
+    if (!p)
+        return false;
+    p += std::strlen(key);
+    while (*p == ' ' || *p == '\t') ++p;
+    value = std::strtoull(p, nullptr, 10);
+    return true;
+}
+
+} // namespace
+
+bool ProcReader::readAt(int dirFd, const char* name)
+{
+    m_len = 0;
+    const int fd = ::openat(dirFd, name, O_RDONLY | O_CLOEXEC);
+    if (fd < 0)
+        return false;
+    // /proc files report a size of 0, so read until EOF rather than stat'ing.
+    while (m_len + 1 < kBufferSize) {
+        const ssize_t n = ::read(fd, m_buf + m_len, kBufferSize - 1 - m_len);
+        if (n <= 0) break;
+        m_len += static_cast<std::size_t>(n);
+    }
+    ::close(fd);
+    m_buf[m_len] = '\0';
+    return m_len > 0;
+}
+
+bool ProcReader::countFds(int dirFd, uint32_t& count)
+{
+    const int fd = ::openat(dirFd, "fd", O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+    if (fd < 0)
+        return false;
+    // getdents64 straight into our own buffer: no DIR* allocation, no per-entry
+    // readdir call.
+    struct Dirent64 {
+        uint64_t d_ino;
+        int64_t d_off;
+        unsigned short d_reclen;
+        unsigned char d_type;
+        char d_name[1];
+    };
+    count = 0;
+    for (;;) {
+        const long n = ::syscall(SYS_getdents64, fd, m_dents, kBufferSize);
+        if (n <= 0) {
+            ::close(fd);
+            return n == 0;
+        }
+        for (long off = 0; off < n;) {
+            const auto* d = reinterpret_cast<const Dirent64*>(m_dents + off);
+            if (d->d_name[0] != '.')
+                ++count;
+            off += d->d_reclen;
+        }
+    }
+}
+
+bool ProcReader::read(int64_t pid, ProcessReading& out, uint32_t detail)
+{
+    if (pid <= 0)
+        return false;
+
+    static const long ticks = ::sysconf(_SC_CLK_TCK);
+    static const long pageSize = ::sysconf(_SC_PAGESIZE);
+
+    char path[32];
+    std::snprintf(path, sizeof(path), "/proc/%lld", static_cast<long long>(pid));
+    const int dirFd = ::open(path, O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+    if (dirFd < 0)
+        return false;
+
+    ProcessReading r;
+    bool ok = false;
+    do {
+        if (!readAt(dirFd, "stat"))
+            break;
+        // comm (field 2) may contain spaces and parens; fields resume after
+        // the last ')', with field 3 (state) first.
+        const char* p = std::strrchr(m_buf, ')');
+        if (!p)
+            break;
+        ++p;
+        unsigned long long utime = 0, stime = 0, threads = 0;
+        int field = 3;
+        for (; field <= 20 && *p; ++field) {
+            while (*p == ' ') ++p;
+            if (field == 14) utime = std::strtoull(p, nullptr, 10);
+            else if (field == 15) stime = std::strtoull(p, nullptr, 10);
+            else if (field == 20) threads = std::strtoull(p, nullptr, 10);
+            while (*p && *p != ' ') ++p;
+        }
+        r.cpuSeconds = ticks > 0 ? static_cast<double>(utime + stime) / static_cast<double>(ticks) : 0.0;
+        if (field > 20 && (detail & ProcessDetail::Threads)) {
+            r.detail.threads = static_cast<uint32_t>(threads);
+            r.detail.fields |= ProcessDetail::Threads;
+        }
+
+        if (!readAt(dirFd, "statm"))
+            break;
+        unsigned long long sizePages = 0, residentPages = 0;
+        if (std::sscanf(m_buf, "%llu %llu", &sizePages, &residentPages) != 2)
+            break;
+        r.rssBytes = static_cast<uint64_t>(residentPages) * static_cast<uint64_t>(pageSize);
+        ok = true;
+
+        if ((detail & ProcessDetail::ContextSwitches)
+            && readAt(dirFd, "status")
+            && lineValue(m_buf, "\nvoluntary_ctxt_switches:", r.detail.voluntaryCtxSwitches)
+            && lineValue(m_buf, "\nnonvoluntary_ctxt_switches:", r.detail.involuntaryCtxSwitches))
+            r.detail.fields |= ProcessDetail::ContextSwitches;
+
+        if ((detail & ProcessDetail::OpenFds) && countFds(dirFd, r.detail.openFds))
+            r.detail.fields |= ProcessDetail::OpenFds;
+
+        uint64_t pssKb = 0, cleanKb = 0, dirtyKb = 0;
+        if ((detail & ProcessDetail::MemoryDetail)
+            && readAt(dirFd, "smaps_rollup")
+            && lineValue(m_buf, "\nPss:", pssKb)
+            && lineValue(m_buf, "\nPrivate_Clean:", cleanKb)
+            && lineValue(m_buf, "\nPrivate_Dirty:", dirtyKb)) {
+            r.detail.pssBytes = pssKb * 1024;
+            r.detail.ussBytes = (cleanKb + dirtyKb) * 1024;
+            r.detail.fields |= ProcessDetail::MemoryDetail;
+        }
+
+        // read_bytes/write_bytes are never io's first line (rchar is), so
+        // the newline-anchored match holds.
+        if ((detail & ProcessDetail::Io)
+            && readAt(dirFd, "io")
+            && lineValue(m_buf, "\nread_bytes:", r.detail.ioReadBytes)
+            && lineValue(m_buf, "\nwrite_bytes:", r.detail.ioWriteBytes))
+            r.detail.fields |= ProcessDetail::Io;
+    } while (false);
+
+    ::close(dirFd);
+    if (ok)
+        out = r;
+    return ok;
+}
+
+#else
+
+bool ProcReader::read(int64_t pid, ProcessReading& out, uint32_t)
+{
+    if (pid <= 0)
+        return false;
+    const auto stats = ProcessStats::getProcessStats(pid);
+    if (stats.memoryMB <= 0.0 && stats.cpuTimeSeconds <= 0.0)
+        return false;
+    out = ProcessReading{};
+    out.cpuSeconds = stats.cpuTimeSeconds;
+    out.rssBytes = static_cast<uint64_t>(stats.memoryMB * 1024.0 * 1024.0);
+    return true;
+}
+
+#endif
+
+bool readProcess(int64_t pid, ProcessReading& out, uint32_t detail)
+{
+    thread_local ProcReader reader;
+    return reader.read(pid, out, detail);
+}
+
+} // namespace LogosCore
@@ -0,0 +1,82 @@
+#ifndef PROC_READER_H
+#define PROC_READER_H
+
+#include <cstddef>
+#include <cstdint>
+
+namespace LogosCore {
+
+// Capacity-planning counters beyond CPU time and RSS. Linux only; each group
+// is read from its own /proc file and may be individually unavailable (e.g.
+// smaps_rollup predates 4.14, io needs ptrace access), so `fields` says which
+// ones are filled in.
+struct ProcessDetail {
+    enum Field : uint32_t {
+        Threads         = 1u << 0,   // stat
+        ContextSwitches = 1u << 1,   // status
+        OpenFds         = 1u << 2,   // fd/
+        MemoryDetail    = 1u << 3,   // smaps_rollup
+        Io              = 1u << 4,   // io
+        All             = Threads | ContextSwitches | OpenFds | MemoryDetail | Io,
+    };
+
+    uint32_t fields = 0;
+    bool has(Field f) const { return (fields & f) != 0; }
+
+    uint32_t threads = 0;
+    uint64_t voluntaryCtxSwitches = 0;
+    uint64_t involuntaryCtxSwitches = 0;
+    uint32_t openFds = 0;
+    uint64_t pssBytes = 0;
+    uint64_t ussBytes = 0;       // Private_Clean + Private_Dirty
+    uint64_t ioReadBytes = 0;    // read_bytes: storage-layer reads
+    uint64_t ioWriteBytes = 0;   // write_bytes
+};
+
+// Raw, cumulative resource counters for one process at one instant. Rates
+// (CPU %) are the caller's business: derive them from two readings, so no
+// hidden per-pid history is shared between callers.
+struct ProcessReading {
+    double cpuSeconds = 0.0;   // utime + stime
+    uint64_t rssBytes = 0;
+    ProcessDetail detail;
+};
+
+// Reads /proc/<pid> with one openat() per file, relative to a directory fd
+// for the pid, into buffers owned by the reader and reused across calls — so
+// a sampling pass over many modules does no allocation and no path lookups
+// beyond the pid directory. Not thread-safe; use one per thread.
+//
+// Files are skipped unless a requested detail group needs them. smaps_rollup
+// dominates the cost (the kernel walks every mapping), so periodic callers
+// should ask for MemoryDetail less often than the rest.
+class ProcReader {
+public:
+    ProcReader() = default;
+    ProcReader(const ProcReader&) = delete;
+    ProcReader& operator=(const ProcReader&) = delete;
+
+    // False if the process is gone or its stat/statm are unreadable. The
+    // `detail` groups (ProcessDetail::Field mask) are best-effort; those
+    // actually read are flagged in out.detail.fields.
+    bool read(int64_t pid, ProcessReading& out, uint32_t detail = ProcessDetail::All);
+
+private:
+    static constexpr std::size_t kBufferSize = 4096;
+
+    bool readAt(int dirFd, const char* name);   // into m_buf, NUL-terminated
+    bool countFds(int dirFd, uint32_t& count);
+
+    char m_buf[kBufferSize];
+    std::size_t m_len = 0;
+    alignas(8) char m_dents[kBufferSize];
+};
+
+// Read `pid`'s counters through a thread-local ProcReader. Off Linux the
+// reader falls back to ProcessStats::getProcessStats and leaves the detail
+// empty. False if the process is gone or unreadable.
+bool readProcess(int64_t pid, ProcessReading& out, uint32_t detail = ProcessDetail::All);
+
+} // namespace LogosCore
+
+#endif // PROC_READER_H
@@ -0,0 +1,123 @@
+#include "replica_set.h"
+
+#include <algorithm>
+
+namespace LogosCore {
+
+const char* replicaPolicyName(ReplicaPolicy policy)
+{
+    switch (policy) {
+    case ReplicaPolicy::RoundRobin:  return "round_robin";
+    case ReplicaPolicy::LeastLoaded: return "least_loaded";
+    }
+    return "unknown";
+}
+
+std::optional<ReplicaPolicy> parseReplicaPolicy(const std::string& name)
+{
+    if (name == "round_robin")
+        return ReplicaPolicy::RoundRobin;
+    if (name == "least_loaded")
+        return ReplicaPolicy::LeastLoaded;
+    return std::nullopt;
+}
+
+std::string replicaInstanceName(const std::string& module, int index)
+{
+    if (index <= 0)
+        return module;
+    return module + "_r" + std::to_string(index);
+}
+
+ReplicaSet::ReplicaSet(ReplicaPolicy policy)
+    : m_policy(policy)
+{
+}
+
+void ReplicaSet::add(const std::string& instance)
+{
+    std::lock_guard lock(m_mutex);
+    auto it = std::find_if(m_entries.begin(), m_entries.end(),
+                           [&](const Entry& e) { return e.instance == instance; });
+    if (it == m_entries.end())
+        m_entries.push_back({instance});
+}
+
+bool ReplicaSet::remove(const std::string& instance)
+{
+    std::lock_guard lock(m_mutex);
+    auto it = std::find_if(m_entries.begin(), m_entries.end(),
+                           [&](const Entry& e) { return e.instance == instance; });
+    if (it == m_entries.end())
+        return false;
+    const auto index = static_cast<std::size_t>(it - m_entries.begin());
+    m_entries.erase(it);
+    if (m_cursor > index)
+        --m_cursor;
+    if (m_cursor >= m_entries.size())
+        m_cursor = 0;
+    return true;
+}
+
+std::vector<std::string> ReplicaSet::instances() const
+{
+    std::lock_guard lock(m_mutex);
+    std::vector<std::string> out;
+    out.reserve(m_entries.size());
+    for (const auto& e : m_entries)
+        out.push_back(e.instance);
+    return out;
+}
+
+std::size_t ReplicaSet::size() const
+{
+    std::lock_guard lock(m_mutex);
+    return m_entries.size();
+}
+
+std::optional<std::string> ReplicaSet::acquire()
+{
+    std::lock_guard lock(m_mutex);
+    const std::size_t n = m_entries.size();
+    if (n == 0)
+        return std::nullopt;
+
+    std::size_t pick = m_cursor % n;
+    if (m_policy == ReplicaPolicy::LeastLoaded) {
+        // First minimum scanning from the cursor, so equally loaded
+        // instances still take turns.
+        for (std::size_t i = 1; i < n; ++i) {
+            const std::size_t j = (m_cursor + i) % n;
+            if (m_entries[j].inFlight < m_entries[pick].inFlight)
+                pick = j;
+        }
+    }
+    m_cursor = (pick + 1) % n;
+    Entry& chosen = m_entries[pick];
+    ++chosen.inFlight;
+    ++chosen.dispatched;
+    return chosen.instance;
+}
+
+void ReplicaSet::release(const std::string& instance)
+{
+    std::lock_guard lock(m_mutex);
+    for (auto& e : m_entries) {
+        if (e.instance == instance) {
+            if (e.inFlight > 0)
+                --e.inFlight;
+            return;
+        }
+    }
+}
+
+nlohmann::json ReplicaSet::toJson() const
+{
+    std::lock_guard lock(m_mutex);
+    nlohmann::json out = nlohmann::json::array();
+    for (const auto& e : m_entries)
+        out.push_back({{"instance", e.instance}, {"in_flight", e.inFlight}, {"dispatched", e.dispatched}});
+    return out;
+}
+
+} // namespace LogosCore
@@ -0,0 +1,75 @@
+#ifndef REPLICA_SET_H
+#define REPLICA_SET_H
+
+#include <nlohmann/json.hpp>
+
+#include <cstdint>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace LogosCore {
+
+// Call dispatch across the running instances of one replicated module
+// (Qt-free). A module configured with N replicas runs as N processes: the
+// primary under the module's own name, and N-1 replicas under
+// replicaInstanceName(). Each caller asks for an instance before a call and
+// hands it back afterwards; the set spreads calls by its policy.
+
+enum class ReplicaPolicy {
+    RoundRobin,    // each acquire takes the next instance in turn
+    LeastLoaded,   // fewest calls in flight; ties go round-robin
+};
+
+const char* replicaPolicyName(ReplicaPolicy policy);
+// "round_robin" or "least_loaded"; nullopt for anything else.
+std::optional<ReplicaPolicy> parseReplicaPolicy(const std::string& name);
+
+// Name replica `index` runs under: the module name for 0, "<module>_r<index>"
+// otherwise. Stays within the module-name alphabet, so it is also a valid
+// persistence directory and registry key.
+std::string replicaInstanceName(const std::string& module, int index);
+
+class ReplicaSet {
+public:
+    explicit ReplicaSet(ReplicaPolicy policy);
+
+    ReplicaSet(const ReplicaSet&) = delete;
+    ReplicaSet& operator=(const ReplicaSet&) = delete;
+
+    ReplicaPolicy policy() const { return m_policy; }
+
+    void add(const std::string& instance);
+    // False if `instance` was not in the set. Calls in flight on it are
+    // dropped with it.
+    bool remove(const std::string& instance);
+    std::vector<std::string> instances() const;
+    std::size_t size() const;
+
+    // The instance to send the next call to, counted as in flight until
+    // release(). nullopt when the set is empty.
+    std::optional<std::string> acquire();
+    // The call on `instance` is done. Unknown instances, and instances with
+    // nothing in flight, are ignored.
+    void release(const std::string& instance);
+
+    // [{"instance", "in_flight", "dispatched"}] in instance order.
+    nlohmann::json toJson() const;
+
+private:
+    struct Entry {
+        std::string instance;
+        std::uint64_t inFlight = 0;
+        std::uint64_t dispatched = 0;
+    };
+
+    const ReplicaPolicy m_policy;
+    mutable std::mutex m_mutex;
+    std::vector<Entry> m_entries;
+    std::size_t m_cursor = 0;   // where the next round-robin scan starts
+};
+
+} // namespace LogosCore
+
+#endif // REPLICA_SET_H
@@ -0,0 +1,351 @@
+#include "stats_sampler.h"
+
+#include <spdlog/spdlog.h>
+#include <algorithm>
+#include <cstring>
+#include <limits>
+
+namespace LogosCore {
+
+namespace {
+
+uint64_t toBits(double v)
+{
+    uint64_t bits;
+    std::memcpy(&bits, &v, sizeof(bits));
+    return bits;
+}
+
+double fromBits(uint64_t bits)
+{
+    double v;
+    std::memcpy(&v, &bits, sizeof(v));
+    return v;
+}
+
+int64_t nowMs()
+{
+    return std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+} // namespace
+
+// ── StatsRing ───────────────────────────────────────────────────────────────
+
+StatsRing::StatsRing(std::size_t capacity)
+    : m_slots(capacity ? capacity : 1)
+{}
+
+std::size_t StatsRing::slotBytes()
+{
+    return sizeof(Slot);
+}
+
+void StatsRing::push(const StatsSample& s)
+{
+    const uint64_t index = m_written.load(std::memory_order_relaxed);
+    Slot& slot = m_slots[index % m_slots.size()];
+
+    const uint64_t seq = slot.seq.load(std::memory_order_relaxed);
+    slot.seq.store(seq + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    slot.timestampMs.store(s.timestampMs, std::memory_order_relaxed);
+    slot.cpuPercentBits.store(toBits(s.cpuPercent), std::memory_order_relaxed);
+    slot.cpuSecondsBits.store(toBits(s.cpuSeconds), std::memory_order_relaxed);
+    slot.rssBytes.store(s.rssBytes, std::memory_order_relaxed);
+    slot.fields.store(s.detail.fields, std::memory_order_relaxed);
+    slot.threads.store(s.detail.threads, std::memory_order_relaxed);
+    slot.openFds.store(s.detail.openFds, std::memory_order_relaxed);
+    slot.voluntaryCtxSwitches.store(s.detail.voluntaryCtxSwitches, std::memory_order_relaxed);
+    slot.involuntaryCtxSwitches.store(s.detail.involuntaryCtxSwitches, std::memory_order_relaxed);
+    slot.pssBytes.store(s.detail.pssBytes, std::memory_order_relaxed);
+    slot.ussBytes.store(s.detail.ussBytes, std::memory_order_relaxed);
+    slot.ioReadBytes.store(s.detail.ioReadBytes, std::memory_order_relaxed);
+    slot.ioWriteBytes.store(s.detail.ioWriteBytes, std::memory_order_relaxed);
+
+    slot.seq.store(seq + 2, std::memory_order_release);
+    m_written.store(index + 1, std::memory_order_release);
+}
+
+bool StatsRing::readSlot(uint64_t index, StatsSample& out) const
+{
+    const Slot& slot = m_slots[index % m_slots.size()];
+    // The n-th write into a slot leaves seq == 2n, so this is the sequence the
+    // slot carries while it still holds sample `index`.
+    const uint64_t expected = 2 * (index / m_slots.size() + 1);
+
+    const uint64_t before = slot.seq.load(std::memory_order_acquire);
+    if (before != expected)
+        return false;   // mid-write, or already overwritten by a newer lap
+    out.timestampMs = slot.timestampMs.load(std::memory_order_relaxed);
+    out.cpuPercent = fromBits(slot.cpuPercentBits.load(std::memory_order_relaxed));
+    out.cpuSeconds = fromBits(slot.cpuSecondsBits.load(std::memory_order_relaxed));
+    out.rssBytes = slot.rssBytes.load(std::memory_order_relaxed);
+    out.detail.fields = slot.fields.load(std::memory_order_relaxed);
+    out.detail.threads = slot.threads.load(std::memory_order_relaxed);
+    out.detail.openFds = slot.openFds.load(std::memory_order_relaxed);
+    out.detail.voluntaryCtxSwitches = slot.voluntaryCtxSwitches.load(std::memory_order_relaxed);
+    out.detail.involuntaryCtxSwitches = slot.involuntaryCtxSwitches.load(std::memory_order_relaxed);
+    out.detail.pssBytes = slot.pssBytes.load(std::memory_order_relaxed);
+    out.detail.ussBytes = slot.ussBytes.load(std::memory_order_relaxed);
+    out.detail.ioReadBytes = slot.ioReadBytes.load(std::memory_order_relaxed);
+    out.detail.ioWriteBytes = slot.ioWriteBytes.load(std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_acquire);
+    return slot.seq.load(std::memory_order_relaxed) == before;
+}
+
+std::optional<StatsSample> StatsRing::latest() const
+{
+    // The writer can lap the newest slot only after a full interval; a couple
+    // of retries is plenty.
+    for (int attempt = 0; attempt < 4; ++attempt) {
+        const uint64_t written = m_written.load(std::memory_order_acquire);
+        if (written == 0)
+            return std::nullopt;
+        StatsSample s;
+        if (readSlot(written - 1, s))
+            return s;
+    }
+    return std::nullopt;
+}
+
+std::vector<StatsSample> StatsRing::since(int64_t sinceMs) const
+{
+    std::vector<StatsSample> out;
+    const uint64_t written = m_written.load(std::memory_order_acquire);
+    const uint64_t oldest = written > m_slots.size() ? written - m_slots.size() : 0;
+    for (uint64_t i = written; i > oldest; --i) {
+        StatsSample s;
+        if (!readSlot(i - 1, s))
+            break;   // the writer has lapped us; everything older is gone too
+        if (s.timestampMs < sinceMs)
+            break;
+        out.push_back(s);
+    }
+    return out;
+}
+
+// ── StatsSampler ────────────────────────────────────────────────────────────
+
+StatsSampler::StatsSampler(PidsFn pids, std::chrono::milliseconds interval,
+                           std::size_t capacity, ReadFn read, std::size_t memoryBudget)
+    : m_pids(std::move(pids))
+    , m_read(read ? std::move(read) : ReadFn([](int64_t pid, uint32_t detail, ProcessReading& out) {
+          return readProcess(pid, out, detail);
+      }))
+    , m_interval(interval.count() > 0 ? interval : std::chrono::milliseconds(1))
+    , m_capacity(capacity ? capacity : 1)
+    , m_memoryBudget(memoryBudget)
+{}
+
+StatsSampler::~StatsSampler()
+{
+    stop();
+}
+
+void StatsSampler::start()
+{
+    if (running())
+        return;
+    {
+        std::lock_guard lock(m_stopMutex);
+        m_stopping = false;
+    }
+    m_thread = std::thread([this]() { run(); });
+}
+
+void StatsSampler::stop()
+{
+    if (!running())
+        return;
+    {
+        std::lock_guard lock(m_stopMutex);
+        m_stopping = true;
+    }
+    m_stopCv.notify_all();
+    m_thread.join();
+}
+
+void StatsSampler::run()
+{
+    std::unique_lock lock(m_stopMutex);
+    while (!m_stopping) {
+        lock.unlock();
+        sampleOnce();
+        lock.lock();
+        m_stopCv.wait_for(lock, m_interval, [&]() { return m_stopping; });
+    }
+}
+
+void StatsSampler::sampleOnce()
+{
+    std::lock_guard pass(m_passMutex);
+
+    std::unordered_map<std::string, int64_t> pids;
+    try {
+        pids = m_pids();
+    } catch (const std::exception& e) {
+        spdlog::warn("Stats sampler could not list module pids: {}", e.what());
+        return;
+    }
+
+    // Reconcile the module set first (the only step that takes the map lock
+    // exclusively), then sample without holding it.
+    std::vector<std::shared_ptr<ModuleHistory>> targets;
+    targets.reserve(pids.size());
+    {
+        std::unique_lock lock(m_mapMutex);
+        for (auto it = m_histories.begin(); it != m_histories.end();) {
+            if (!pids.count(it->first))
+                it = m_histories.erase(it);
+            else
+                ++it;
+        }
+        const std::size_t capacity = capacityFor(pids.size());
+        for (const auto& [name, pid] : pids) {
+            auto& history = m_histories[name];
+            if (!history || history->pid != pid)
+                history = std::make_shared<ModuleHistory>(pid, capacity);
+            else if (history->ring.capacity() != capacity)
+                history = resized(*history, capacity);
+            targets.push_back(history);
+        }
+    }
+
+    for (const auto& history : targets) {
+        uint32_t want = ProcessDetail::All;
+        if (history->passes++ % kMemoryDetailEvery != 0)
+            want &= ~static_cast<uint32_t>(ProcessDetail::MemoryDetail);
+
+        ProcessReading reading;
+        if (!m_read(history->pid, want, reading))
+            continue;
+        if (reading.detail.has(ProcessDetail::MemoryDetail)) {
+            history->pssBytes = reading.detail.pssBytes;
+            history->ussBytes = reading.detail.ussBytes;
+            history->haveMemoryDetail = true;
+        } else if (history->haveMemoryDetail) {
+            reading.detail.pssBytes = history->pssBytes;
+            reading.detail.ussBytes = history->ussBytes;
+            reading.detail.fields |= ProcessDetail::MemoryDetail;
+        }
+        const int64_t t = nowMs();
+
+        StatsSample s;
+        s.timestampMs = t;
+        s.cpuSeconds = reading.cpuSeconds;
+        s.rssBytes = reading.rssBytes;
+        s.detail = reading.detail;
+        if (history->havePrev && t > history->prevMs) {
+            const double cpu = reading.cpuSeconds - history->prevCpuSeconds;
+            s.cpuPercent = std::max(0.0, cpu * 1000.0 / static_cast<double>(t - history->prevMs) * 100.0);
+        }
+        history->havePrev = true;
+        history->prevCpuSeconds = reading.cpuSeconds;
+        history->prevMs = t;
+        history->ring.push(s);
+    }
+}
+
+std::size_t StatsSampler::capacityFor(std::size_t modules) const
+{
+    if (m_memoryBudget == 0 || modules == 0)
+        return m_capacity;
+    const std::size_t share = m_memoryBudget / modules / StatsRing::slotBytes();
+    return std::max<std::size_t>(1, std::min(m_capacity, share));
+}
+
+// Only while reconciling, under m_passMutex: the old ring's writer is the
+// calling thread. Readers still holding the old history keep reading it.
+std::shared_ptr<StatsSampler::ModuleHistory>
+StatsSampler::resized(const ModuleHistory& history, std::size_t capacity)
+{
+    auto out = std::make_shared<ModuleHistory>(history.pid, capacity);
+    out->havePrev = history.havePrev;
+    out->prevCpuSeconds = history.prevCpuSeconds;
+    out->prevMs = history.prevMs;
+    out->passes = history.passes;
+    out->pssBytes = history.pssBytes;
+    out->ussBytes = history.ussBytes;
+    out->haveMemoryDetail = history.haveMemoryDetail;
+    auto samples = history.ring.since(std::numeric_limits<int64_t>::min());   // newest first
+    if (samples.size() > capacity)
+        samples.resize(capacity);
+    for (auto it = samples.rbegin(); it != samples.rend(); ++it)
+        out->ring.push(*it);
+    return out;
+}
+
+std::size_t StatsSampler::capacityOf(const std::string& module) const
+{
+    auto history = find(module);
+    return history ? history->ring.capacity() : 0;
+}
+
+std::shared_ptr<StatsSampler::ModuleHistory> StatsSampler::find(const std::string& module) const
+{
+    std::shared_lock lock(m_mapMutex);
+    auto it = m_histories.find(module);
+    return it == m_histories.end() ? nullptr : it->second;
+}
+
+std::optional<StatsSample> StatsSampler::latest(const std::string& module) const
+{
+    auto history = find(module);
+    if (!history)
+        return std::nullopt;
+    return history->ring.latest();
+}
+
+StatsWindow StatsSampler::window(const std::string& module, std::chrono::milliseconds span) const
+{
+    StatsWindow w;
+    auto history = find(module);
+    if (!history)
+        return w;
+
+    const auto samples = history->ring.since(nowMs() - span.count());
+    if (samples.empty())
+        return w;
+
+    w.count = samples.size();
+    w.toMs = samples.front().timestampMs;
+    w.fromMs = samples.back().timestampMs;
+    w.cpuPercentMin = std::numeric_limits<double>::max();
+    w.rssBytesMin = std::numeric_limits<uint64_t>::max();
+    double cpuSum = 0.0, rssSum = 0.0;
+    for (const auto& s : samples) {
+        w.cpuPercentMin = std::min(w.cpuPercentMin, s.cpuPercent);
+        w.cpuPercentMax = std::max(w.cpuPercentMax, s.cpuPercent);
+        w.rssBytesMin = std::min(w.rssBytesMin, s.rssBytes);
+        w.rssBytesMax = std::max(w.rssBytesMax, s.rssBytes);
+        cpuSum += s.cpuPercent;
+        rssSum += static_cast<double>(s.rssBytes);
+    }
+    w.cpuPercentAvg = cpuSum / static_cast<double>(w.count);
+    w.rssBytesAvg = rssSum / static_cast<double>(w.count);
+    return w;
+}
+
+std::optional<int64_t> StatsSampler::pidOf(const std::string& module) const
+{
+    auto history = find(module);
+    if (!history)
+        return std::nullopt;
+    return history->pid;
+}
+
+std::vector<std::string> StatsSampler::modules() const
+{
+    std::shared_lock lock(m_mapMutex);
+    std::vector<std::string> names;
+    names.reserve(m_histories.size());
+    for (const auto& [name, history] : m_histories)
+        names.push_back(name);
+    std::sort(names.begin(), names.end());
+    return names;
+}
+
+} // namespace LogosCore
@@ -0,0 +1,171 @@
+#ifndef STATS_SAMPLER_H
+#define STATS_SAMPLER_H
+
+#include "proc_reader.h"
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <shared_mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace LogosCore {
+
+// One point of a module's resource history.
+struct StatsSample {
+    int64_t timestampMs = 0;   // steady clock
+    double cpuPercent = 0.0;   // since the previous sample of this pid
+    double cpuSeconds = 0.0;
+    uint64_t rssBytes = 0;
+    ProcessDetail detail;      // as read; see ProcessDetail::fields
+};
+
+// Min/max/avg over the samples of a window. count == 0 when nothing fell
+// in the window (or the module is unknown to the sampler).
+struct StatsWindow {
+    std::size_t count = 0;
+    int64_t fromMs = 0;
+    int64_t toMs = 0;
+    double cpuPercentMin = 0.0, cpuPercentMax = 0.0, cpuPercentAvg = 0.0;
+    uint64_t rssBytesMin = 0, rssBytesMax = 0;
+    double rssBytesAvg = 0.0;
+};
+
+// Fixed-capacity history of one module's samples. Single writer (the sampler
+// thread), any number of concurrent readers, no locks: each slot is a
+// seqlock whose fields are atomics, and a reader that races the writer on a
+// slot retries or skips it.
+class StatsRing {
+public:
+    explicit StatsRing(std::size_t capacity);
+
+    void push(const StatsSample& s);          // writer only
+    std::optional<StatsSample> latest() const;
+    // Newest-first samples with timestampMs >= sinceMs.
+    std::vector<StatsSample> since(int64_t sinceMs) const;
+
+    std::size_t capacity() const { return m_slots.size(); }
+    // Memory one sample slot takes, for sizing rings against a budget.
+    static std::size_t slotBytes();
+
+private:
+    struct Slot {
+        std::atomic<uint64_t> seq{0};   // odd while being written
+        std::atomic<int64_t> timestampMs{0};
+        std::atomic<uint64_t> cpuPercentBits{0};
+        std::atomic<uint64_t> cpuSecondsBits{0};
+        std::atomic<uint64_t> rssBytes{0};
+        std::atomic<uint32_t> fields{0};
+        std::atomic<uint32_t> threads{0};
+        std::atomic<uint32_t> openFds{0};
+        std::atomic<uint64_t> voluntaryCtxSwitches{0};
+        std::atomic<uint64_t> involuntaryCtxSwitches{0};
+        std::atomic<uint64_t> pssBytes{0};
+        std::atomic<uint64_t> ussBytes{0};
+        std::atomic<uint64_t> ioReadBytes{0};
+        std::atomic<uint64_t> ioWriteBytes{0};
+    };
+
+    bool readSlot(uint64_t index, StatsSample& out) const;
+
+    std::vector<Slot> m_slots;
+    std::atomic<uint64_t> m_written{0};   // samples pushed so far
+};
+
+// Dedicated thread that samples every module process at a fixed interval into
+// a StatsRing per module, so callers read history instead of parsing /proc
+// themselves and no two callers share (and skew) one CPU% baseline.
+//
+// Modules come from `pids` on every tick. A module whose pid changed (a
+// restart) starts a fresh ring; one that disappears is dropped. PSS/USS
+// (smaps_rollup, by far the costliest read) is refreshed every
+// kMemoryDetailEvery passes and carried forward in between.
+//
+// Each ring holds `capacity` samples, or less under a `memoryBudget` (bytes,
+// 0 = none): the budget is split evenly across the modules being sampled,
+// and when their number changes the rings are resized, keeping their newest
+// samples, so all rings together never exceed it.
+class StatsSampler {
+public:
+    using PidsFn = std::function<std::unordered_map<std::string, int64_t>()>;
+    using ReadFn = std::function<bool(int64_t pid, uint32_t detail, ProcessReading& out)>;
+
+    static constexpr unsigned kMemoryDetailEvery = 10;
+
+    StatsSampler(PidsFn pids,
+                 std::chrono::milliseconds interval = std::chrono::seconds(1),
+                 std::size_t capacity = 300,
+                 ReadFn read = {},
+                 std::size_t memoryBudget = 0);
+    ~StatsSampler();
+
+    StatsSampler(const StatsSampler&) = delete;
+    StatsSampler& operator=(const StatsSampler&) = delete;
+
+    void start();
+    void stop();
+    bool running() const { return m_thread.joinable(); }
+
+    // One sampling pass on the calling thread. The thread calls this; exposed
+    // so tests can drive it deterministically. Passes are serialized.
+    void sampleOnce();
+
+    std::optional<StatsSample> latest(const std::string& module) const;
+    StatsWindow window(const std::string& module, std::chrono::milliseconds span) const;
+    std::optional<int64_t> pidOf(const std::string& module) const;
+    std::vector<std::string> modules() const;
+    // Samples a module's ring holds; 0 for a module not being sampled.
+    std::size_t capacityOf(const std::string& module) const;
+
+    std::chrono::milliseconds interval() const { return m_interval; }
+
+private:
+    struct ModuleHistory {
+        int64_t pid = 0;
+        StatsRing ring;
+        // Previous raw reading, for the CPU% delta. Sampler thread only.
+        bool havePrev = false;
+        double prevCpuSeconds = 0.0;
+        int64_t prevMs = 0;
+        unsigned passes = 0;
+        uint64_t pssBytes = 0, ussBytes = 0;   // last smaps_rollup read
+        bool haveMemoryDetail = false;
+
+        ModuleHistory(int64_t p, std::size_t capacity) : pid(p), ring(capacity) {}
+    };
+
+    std::shared_ptr<ModuleHistory> find(const std::string& module) const;
+    // Ring size for each of `modules` rings under the budget.
+    std::size_t capacityFor(std::size_t modules) const;
+    // `history` with its ring resized to `capacity`, newest samples kept.
+    static std::shared_ptr<ModuleHistory> resized(const ModuleHistory& history, std::size_t capacity);
+    void run();
+
+    std::mutex m_passMutex;   // one sampleOnce at a time: each ring has one writer
+    PidsFn m_pids;
+    ReadFn m_read;
+    std::chrono::milliseconds m_interval;
+    std::size_t m_capacity;
+    std::size_t m_memoryBudget;
+
+    // Guards the module -> history map only; ring reads and writes are
+    // lock-free. Writers take it exclusively just to add/remove modules.
+    mutable std::shared_mutex m_mapMutex;
+    std::unordered_map<std::string, std::shared_ptr<ModuleHistory>> m_histories;
+
+    std::mutex m_stopMutex;
+    std::condition_variable m_stopCv;
+    bool m_stopping = false;
+    std::thread m_thread;
+};
+
+} // namespace LogosCore
+
+#endif // STATS_SAMPLER_H
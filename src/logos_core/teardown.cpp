@@ -0,0 +1,137 @@
+#include "teardown.h"
+
+#include <spdlog/spdlog.h>
+#include <algorithm>
+#include <thread>
+#include <unordered_map>
+
+#ifndef _WIN32
+#include <cerrno>
+#include <csignal>
+#include <sys/wait.h>
+#endif
+
+namespace LogosCore {
+
+std::vector<std::vector<std::string>> teardownWaves(
+    const std::vector<std::string>& modules,
+    const std::function<std::vector<std::string>(const std::string&)>& dependenciesOf)
+{
+    std::unordered_map<std::string, std::size_t> index;
+    for (std::size_t i = 0; i < modules.size(); ++i)
+        index.emplace(modules[i], i);
+
+    // deps[i]: distinct in-set dependencies of modules[i];
+    // dependents[i]: how many in-set modules still depend on modules[i].
+    std::vector<std::vector<std::size_t>> deps(modules.size());
+    std::vector<std::size_t> dependents(modules.size(), 0);
+    for (std::size_t i = 0; i < modules.size(); ++i) {
+        if (index.at(modules[i]) != i)
+            continue;   // duplicate name; the first occurrence carries it
+        for (const auto& dep : dependenciesOf(modules[i])) {
+            auto it = index.find(dep);
+            if (it == index.end() || it->second == i)
+                continue;
+            if (std::find(deps[i].begin(), deps[i].end(), it->second) != deps[i].end())
+                continue;
+            deps[i].push_back(it->second);
+            ++dependents[it->second];
+        }
+    }
+
+    std::vector<std::vector<std::string>> waves;
+    std::vector<bool> done(modules.size(), false);
+    std::size_t remaining = index.size();
+    while (remaining > 0) {
+        std::vector<std::size_t> wave;
+        for (std::size_t i = 0; i < modules.size(); ++i) {
+            if (!done[i] && index.at(modules[i]) == i && dependents[i] == 0)
+                wave.push_back(i);
+        }
+        if (wave.empty()) {
+            // Only cycles are left; nothing orders them, so take them together.
+            for (std::size_t i = 0; i < modules.size(); ++i) {
+                if (!done[i] && index.at(modules[i]) == i)
+                    wave.push_back(i);
+            }
+        }
+        std::vector<std::string> names;
+        for (std::size_t i : wave) {
+            done[i] = true;
+            names.push_back(modules[i]);
+            for (std::size_t d : deps[i])
+                --dependents[d];
+        }
+        remaining -= wave.size();
+        waves.push_back(std::move(names));
+    }
+    return waves;
+}
+
+#ifndef _WIN32
+
+namespace {
+
+// How long SIGKILLed processes get to disappear before we stop waiting.
+constexpr auto kKillGrace = std::chrono::milliseconds(500);
+
+bool processExited(int64_t pid)
+{
+    // WNOWAIT: observe the exit without reaping, so the container that owns
+    // the child still collects its status.
+    siginfo_t info{};
+    if (::waitid(P_PID, static_cast<id_t>(pid), &info, WEXITED | WNOHANG | WNOWAIT) == 0)
+        return info.si_pid == static_cast<pid_t>(pid);
+    if (errno == ECHILD)   // not our child (or already reaped)
+        return ::kill(static_cast<pid_t>(pid), 0) != 0 && errno == ESRCH;
+    return false;
+}
+
+// Wait until every pid in `pending` has exited or `deadline` passes; the ones
+// still running are left in `pending`.
+void waitForExit(std::vector<int64_t>& pending, std::chrono::steady_clock::time_point deadline)
+{
+    auto interval = std::chrono::milliseconds(1);
+    while (true) {
+        pending.erase(std::remove_if(pending.begin(), pending.end(), processExited), pending.end());
+        const auto now = std::chrono::steady_clock::now();
+        if (pending.empty() || now >= deadline)
+            return;
+        std::this_thread::sleep_for(std::min<std::chrono::steady_clock::duration>(interval, deadline - now));
+        interval = std::min(interval * 2, std::chrono::milliseconds(20));
+    }
+}
+
+} // anonymous namespace
+
+std::vector<int64_t> stopProcesses(const std::vector<int64_t>& pids,
+                                   std::chrono::steady_clock::time_point deadline)
+{
+    std::vector<int64_t> pending;
+    for (int64_t pid : pids) {
+        if (pid > 0 && ::kill(static_cast<pid_t>(pid), SIGTERM) == 0)
+            pending.push_back(pid);
+    }
+    waitForExit(pending, deadline);
+    if (pending.empty())
+        return {};
+
+    for (int64_t pid : pending) {
+        spdlog::warn("Process {} ignored SIGTERM until the shutdown deadline; sending SIGKILL", pid);
+        ::kill(static_cast<pid_t>(pid), SIGKILL);
+    }
+    std::vector<int64_t> killed = pending;
+    waitForExit(pending, std::chrono::steady_clock::now() + kKillGrace);
+    return killed;
+}
+
+#else
+
+std::vector<int64_t> stopProcesses(const std::vector<int64_t>&, std::chrono::steady_clock::time_point)
+{
+    return {};
+}
+
+#endif
+
+} // namespace LogosCore
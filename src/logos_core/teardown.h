@@ -0,0 +1,40 @@
+#ifndef TEARDOWN_H
+#define TEARDOWN_H
+
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace LogosCore {
+
+// Planning and process-signalling helpers for tearing modules down in bulk
+// (Qt-free). ModuleManager uses them for shutdown and cascade unload.
+//
+// A bulk teardown runs in waves, leaves first: every module in a wave has no
+// dependent left running, so the wave's processes can all be stopped at once
+// without any dependent outliving its dependency. Each wave is stopped with
+// stopProcesses() against one deadline shared by the whole teardown, then
+// handed to its loader, whose terminate() finds the process already gone.
+
+// Split `modules` into leaves-first waves. `dependenciesOf` returns direct
+// dependencies; edges to modules outside the set are ignored. Modules on a
+// dependency cycle (which cannot be ordered) form one last wave. Within a
+// wave, modules keep their order in `modules`.
+std::vector<std::vector<std::string>> teardownWaves(
+    const std::vector<std::string>& modules,
+    const std::function<std::vector<std::string>(const std::string&)>& dependenciesOf);
+
+// SIGTERM every pid at once, wait for all of them to exit until `deadline`,
+// then SIGKILL the ones still running and wait briefly for those too. A pid
+// that has exited but not yet been reaped counts as exited; it is left for
+// its owner to reap. Non-positive pids are skipped. Returns the pids that
+// had to be killed. A no-op on Windows, where the loaders stop their own
+// processes.
+std::vector<int64_t> stopProcesses(const std::vector<int64_t>& pids,
+                                   std::chrono::steady_clock::time_point deadline);
+
+} // namespace LogosCore
+
+#endif // TEARDOWN_H
@@ -0,0 +1,68 @@
+#include "token_service.h"
+
+#include <boost/uuid/uuid.hpp>
+#include <boost/uuid/uuid_io.hpp>
+#include <algorithm>
+#include <atomic>
+
+namespace LogosCore {
+
+TokenService::TokenService(std::size_t batch)
+    : m_batch(std::max<std::size_t>(batch, 1))
+{}
+
+std::string TokenService::issue()
+{
+    std::lock_guard lock(m_mutex);
+    if (m_pool.empty())
+        refillLocked(m_batch);
+    std::string token = std::move(m_pool.back());
+    m_pool.pop_back();
+    return token;
+}
+
+void TokenService::prefill(std::size_t count)
+{
+    std::lock_guard lock(m_mutex);
+    if (m_pool.size() < count)
+        refillLocked(count - m_pool.size());
+}
+
+std::size_t TokenService::pooled() const
+{
+    std::lock_guard lock(m_mutex);
+    return m_pool.size();
+}
+
+void TokenService::discardPool()
+{
+    std::lock_guard lock(m_mutex);
+    m_pool.clear();
+    m_pool.shrink_to_fit();
+}
+
+void TokenService::refillLocked(std::size_t count)
+{
+    m_pool.reserve(m_pool.size() + count);
+    for (std::size_t i = 0; i < count; ++i)
+        m_pool.push_back(boost::uuids::to_string(m_generator()));
+}
+
+std::string TokenService::capabilityToken() const
+{
+    auto token = std::atomic_load(&m_capabilityToken);
+    return token ? *token : std::string();
+}
+
+void TokenService::setCapabilityToken(std::string token)
+{
+    std::atomic_store(&m_capabilityToken,
+                      std::make_shared<const std::string>(std::move(token)));
+}
+
+void TokenService::clearCapabilityToken()
+{
+    std::atomic_store(&m_capabilityToken, std::shared_ptr<const std::string>());
+}
+
+} // namespace LogosCore
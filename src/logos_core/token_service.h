@@ -0,0 +1,63 @@
+#ifndef TOKEN_SERVICE_H
+#define TOKEN_SERVICE_H
+
+#include <boost/uuid/random_generator.hpp>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace LogosCore {
+
+// Mints the auth tokens ModuleManager hands to modules (Qt-free).
+//
+// Tokens are random (version 4) UUID strings, as before, but drawn from one
+// long-lived generator over the OS CSPRNG instead of a generator built — and
+// its entropy source opened — per load. They are produced in batches into a
+// pool, so issue() is normally a pop; prefill() lets startup mint a token for
+// every known module before the first load. A pooled token is handed out
+// once and never reused.
+//
+// Also caches capability_module's own token, which authenticates every
+// core -> capability_module call, so the notifier thread does not go back to
+// TokenManager for each one.
+class TokenService {
+public:
+    static constexpr std::size_t kDefaultBatch = 32;
+
+    explicit TokenService(std::size_t batch = kDefaultBatch);
+
+    TokenService(const TokenService&) = delete;
+    TokenService& operator=(const TokenService&) = delete;
+
+    // A fresh token, from the pool when it has one. Thread-safe.
+    std::string issue();
+
+    // Mint tokens until at least `count` are pooled.
+    void prefill(std::size_t count);
+
+    // Tokens currently pooled. Diagnostic / test use.
+    std::size_t pooled() const;
+
+    // Drop every pooled token (they are never handed out afterwards).
+    void discardPool();
+
+    // capability_module's current token; empty when it is not loaded.
+    std::string capabilityToken() const;
+    void setCapabilityToken(std::string token);
+    void clearCapabilityToken();
+
+private:
+    void refillLocked(std::size_t count);
+
+    const std::size_t m_batch;
+    mutable std::mutex m_mutex;
+    boost::uuids::random_generator m_generator;   // guarded by m_mutex
+    std::vector<std::string> m_pool;              // guarded by m_mutex; popped from the back
+    std::shared_ptr<const std::string> m_capabilityToken;   // atomic_load/atomic_store only
+};
+
+} // namespace LogosCore
+
+#endif // TOKEN_SERVICE_H
@@ -0,0 +1,41 @@
+// Decode a lifecycle event journal (see logos_core/event_journal.h).
+//
+//   logos_event_journal [--json | --csv] <journal>
+//
+// JSON (the default) is an object with the header counts and an "events"
+// array; CSV is one row per event with a header line.
+#include "event_journal.h"
+
+#include <cstring>
+#include <iostream>
+#include <string>
+
+int main(int argc, char** argv)
+{
+    bool csv = false;
+    bool usage = false;
+    const char* path = nullptr;
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--csv") == 0)
+            csv = true;
+        else if (std::strcmp(argv[i], "--json") == 0)
+            csv = false;
+        else if (!path && argv[i][0] != '-')
+            path = argv[i];
+        else
+            usage = true;
+    }
+    if (usage || !path) {
+        std::cerr << "usage: logos_event_journal [--json | --csv] <journal>\n";
+        return 2;
+    }
+
+    std::string error;
+    auto journal = EventJournal::read(path, &error);
+    if (!journal) {
+        std::cerr << error << '\n';
+        return 1;
+    }
+    std::cout << (csv ? EventJournal::toCsv(*journal) : EventJournal::toJson(*journal) + '\n');
+    return 0;
+}
@@ -0,0 +1,69 @@
+// Write a seeded synthetic module graph as installable stub packages (see
+// tools/synthetic_graph.h), for measuring discovery against a modules dir.
+//
+//   logos_synthetic_modules [--seed N] [--modules N] [--depth N]
+//                           [--min-fan-in N] [--max-fan-in N] [--max-fan-out N]
+//                           [--cycles N] [--prefix NAME] <out-dir>
+//
+// Prints a JSON summary of the graph written.
+#include "synthetic_graph.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <string>
+
+int main(int argc, char** argv)
+{
+    nlohmann::json options = nlohmann::json::object();
+    const char* outDir = nullptr;
+    bool usage = false;
+    const struct { const char* flag; const char* key; } numeric[] = {
+        {"--seed", "seed"}, {"--modules", "modules"}, {"--depth", "depth"},
+        {"--min-fan-in", "min_fan_in"}, {"--max-fan-in", "max_fan_in"},
+        {"--max-fan-out", "max_fan_out"}, {"--cycles", "cycles"},
+    };
+    for (int i = 1; i < argc && !usage; ++i) {
+        bool matched = false;
+        for (const auto& opt : numeric) {
+            if (std::strcmp(argv[i], opt.flag) == 0 && i + 1 < argc) {
+                options[opt.key] = std::strtol(argv[++i], nullptr, 10);
+                matched = true;
+            }
+        }
+        if (matched)
+            continue;
+        if (std::strcmp(argv[i], "--prefix") == 0 && i + 1 < argc)
+            options["prefix"] = argv[++i];
+        else if (!outDir && argv[i][0] != '-')
+            outDir = argv[i];
+        else
+            usage = true;
+    }
+    if (usage || !outDir) {
+        std::cerr << "usage: logos_synthetic_modules [--seed N] [--modules N] [--depth N]\n"
+                     "                               [--min-fan-in N] [--max-fan-in N] [--max-fan-out N]\n"
+                     "                               [--cycles N] [--prefix NAME] <out-dir>\n";
+        return 2;
+    }
+
+    const auto graph = SyntheticGraph::generate(SyntheticGraph::optionsFromJson(options));
+    std::string error;
+    if (!SyntheticGraph::writePackages(graph, outDir, &error)) {
+        std::cerr << error << '\n';
+        return 1;
+    }
+    int depth = 0;
+    for (int l : graph.layer)
+        depth = std::max(depth, l + 1);
+    nlohmann::json summary = {
+        {"dir", outDir},
+        {"modules", graph.names.size()},
+        {"edges", graph.edgeCount()},
+        {"depth", depth},
+        {"back_edges", graph.backEdges},
+    };
+    std::cout << summary.dump(2) << '\n';
+    return 0;
+}
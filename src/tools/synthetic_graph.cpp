@@ -0,0 +1,377 @@
+#include "synthetic_graph.h"
+#include "module_registry.h"
+
+#include <algorithm>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <random>
+#include <unordered_map>
+
+namespace fs = std::filesystem;
+
+namespace SyntheticGraph {
+
+namespace {
+
+std::string moduleName(const std::string& prefix, int index, int width)
+{
+    std::string digits = std::to_string(index);
+    if (static_cast<int>(digits.size()) < width)
+        digits.insert(0, width - digits.size(), '0');
+    return prefix + digits;
+}
+
+// --- CBOR -------------------------------------------------------------------
+
+void cborHead(std::string& out, uint8_t major, uint64_t value)
+{
+    const uint8_t m = static_cast<uint8_t>(major << 5);
+    auto bigEndian = [&](int bytes) {
+        for (int i = bytes - 1; i >= 0; --i)
+            out.push_back(static_cast<char>((value >> (8 * i)) & 0xff));
+    };
+    if (value < 24) {
+        out.push_back(static_cast<char>(m | value));
+    } else if (value <= 0xff) {
+        out.push_back(static_cast<char>(m | 24));
+        bigEndian(1);
+    } else if (value <= 0xffff) {
+        out.push_back(static_cast<char>(m | 25));
+        bigEndian(2);
+    } else if (value <= 0xffffffffu) {
+        out.push_back(static_cast<char>(m | 26));
+        bigEndian(4);
+    } else {
+        out.push_back(static_cast<char>(m | 27));
+        bigEndian(8);
+    }
+}
+
+void cborText(std::string& out, const std::string& s)
+{
+    cborHead(out, 3, s.size());
+    out += s;
+}
+
+void cborEncode(std::string& out, const nlohmann::json& v)
+{
+    switch (v.type()) {
+    case nlohmann::json::value_t::null:
+    case nlohmann::json::value_t::discarded:
+        out.push_back(static_cast<char>(0xf6));
+        break;
+    case nlohmann::json::value_t::boolean:
+        out.push_back(static_cast<char>(v.get<bool>() ? 0xf5 : 0xf4));
+        break;
+    case nlohmann::json::value_t::number_unsigned:
+        cborHead(out, 0, v.get<uint64_t>());
+        break;
+    case nlohmann::json::value_t::number_integer: {
+        const int64_t i = v.get<int64_t>();
+        if (i >= 0)
+            cborHead(out, 0, static_cast<uint64_t>(i));
+        else
+            cborHead(out, 1, static_cast<uint64_t>(-(i + 1)));
+        break;
+    }
+    case nlohmann::json::value_t::number_float: {
+        const double d = v.get<double>();
+        uint64_t bits;
+        std::memcpy(&bits, &d, sizeof(bits));
+        out.push_back(static_cast<char>(0xfb));
+        for (int i = 7; i >= 0; --i)
+            out.push_back(static_cast<char>((bits >> (8 * i)) & 0xff));
+        break;
+    }
+    case nlohmann::json::value_t::string:
+        cborText(out, v.get_ref<const std::string&>());
+        break;
+    case nlohmann::json::value_t::binary:
+        cborHead(out, 2, v.get_binary().size());
+        out.append(v.get_binary().begin(), v.get_binary().end());
+        break;
+    case nlohmann::json::value_t::array:
+        cborHead(out, 4, v.size());
+        for (const auto& item : v)
+            cborEncode(out, item);
+        break;
+    case nlohmann::json::value_t::object:
+        cborHead(out, 5, v.size());
+        for (auto it = v.begin(); it != v.end(); ++it) {
+            cborText(out, it.key());
+            cborEncode(out, it.value());
+        }
+        break;
+    }
+}
+
+// --- Stub ELF plugin ----------------------------------------------------------
+//
+// Just enough of an ELF64 shared object for a metadata reader that parses
+// section headers (as QPluginLoader does, without dlopen): the file header,
+// the .qtmetadata payload, a section-name string table and three section
+// headers (null, .qtmetadata, .shstrtab). No program headers, no code.
+
+#if defined(__x86_64__)
+constexpr uint16_t kElfMachine = 62;    // EM_X86_64
+#elif defined(__aarch64__)
+constexpr uint16_t kElfMachine = 183;   // EM_AARCH64
+#else
+constexpr uint16_t kElfMachine = 0;     // unsupported: no stub plugins
+#endif
+
+template <typename T>
+void put(std::string& out, std::size_t offset, T value)
+{
+    // Little-endian hosts only (see kElfMachine).
+    std::memcpy(&out[offset], &value, sizeof(T));
+}
+
+constexpr std::size_t kEhdrSize = 64;
+constexpr std::size_t kShdrSize = 64;
+
+void putSectionHeader(std::string& image, std::size_t at, uint32_t name, uint32_t type,
+                      uint64_t flags, uint64_t offset, uint64_t size, uint64_t align)
+{
+    put<uint32_t>(image, at + 0, name);
+    put<uint32_t>(image, at + 4, type);
+    put<uint64_t>(image, at + 8, flags);
+    put<uint64_t>(image, at + 16, 0);        // sh_addr
+    put<uint64_t>(image, at + 24, offset);
+    put<uint64_t>(image, at + 32, size);
+    put<uint32_t>(image, at + 40, 0);        // sh_link
+    put<uint32_t>(image, at + 44, 0);        // sh_info
+    put<uint64_t>(image, at + 48, align);
+    put<uint64_t>(image, at + 56, 0);        // sh_entsize
+}
+
+std::size_t alignUp(std::size_t n, std::size_t a)
+{
+    return (n + a - 1) / a * a;
+}
+
+} // anonymous namespace
+
+std::size_t Graph::edgeCount() const
+{
+    std::size_t n = 0;
+    for (const auto& deps : dependencies)
+        n += deps.size();
+    return n;
+}
+
+Graph generate(const Options& options)
+{
+    Graph g;
+    const int n = std::max(0, options.modules);
+    if (n == 0)
+        return g;
+    const int depth = std::clamp(options.depth, 1, n);
+    const int minFanIn = std::max(0, options.minFanIn);
+    const int maxFanIn = std::max(minFanIn, options.maxFanIn);
+    const int width = static_cast<int>(std::to_string(n - 1).size());
+    std::mt19937 rng(options.seed);
+
+    // Spread modules over the layers as evenly as possible; every layer gets
+    // at least one so the requested depth is reached.
+    std::vector<std::vector<int>> layers(depth);
+    for (int i = 0; i < n; ++i) {
+        const int layer = static_cast<int>(static_cast<int64_t>(i) * depth / n);
+        layers[layer].push_back(i);
+        g.names.push_back(moduleName(options.prefix, i, width));
+        g.layer.push_back(layer);
+    }
+    g.dependencies.resize(n);
+    std::vector<int> fanOut(n, 0);
+    auto hasRoom = [&](int m) { return options.maxFanOut <= 0 || fanOut[m] < options.maxFanOut; };
+
+    for (int l = 1; l < depth; ++l) {
+        const int lowerCount = layers[l].front();   // modules in layers < l are [0, lowerCount)
+        for (int m : layers[l]) {
+            std::vector<int> chosen;
+            auto choose = [&](int lo, int hi) {
+                // Up to 8 tries for a candidate with fan-out room not yet chosen.
+                std::uniform_int_distribution<int> pick(lo, hi);
+                for (int attempt = 0; attempt < 8; ++attempt) {
+                    const int d = pick(rng);
+                    if (hasRoom(d) && std::find(chosen.begin(), chosen.end(), d) == chosen.end()) {
+                        chosen.push_back(d);
+                        ++fanOut[d];
+                        return;
+                    }
+                }
+            };
+            choose(layers[l - 1].front(), layers[l - 1].back());
+            const int want = std::uniform_int_distribution<int>(minFanIn, maxFanIn)(rng);
+            for (int k = static_cast<int>(chosen.size()); k < want; ++k)
+                choose(0, lowerCount - 1);
+            for (int d : chosen)
+                g.dependencies[m].push_back(g.names[d]);
+        }
+    }
+
+    // Cycle injection: walk down from a module through its dependencies and
+    // make the module reached depend on the starting point.
+    std::unordered_map<std::string, int> index;
+    for (int i = 0; i < n; ++i)
+        index.emplace(g.names[i], i);
+    std::uniform_int_distribution<int> pickModule(0, n - 1);
+    for (int c = 0, attempts = 0; c < options.cycles && attempts < options.cycles * 16; ++attempts) {
+        const int start = pickModule(rng);
+        if (g.dependencies[start].empty())
+            continue;
+        int at = start;
+        const int steps = std::uniform_int_distribution<int>(1, depth)(rng);
+        for (int s = 0; s < steps && !g.dependencies[at].empty(); ++s) {
+            const auto& deps = g.dependencies[at];
+            at = index.at(deps[std::uniform_int_distribution<std::size_t>(0, deps.size() - 1)(rng)]);
+        }
+        auto& atDeps = g.dependencies[at];
+        if (std::find(atDeps.begin(), atDeps.end(), g.names[start]) != atDeps.end())
+            continue;
+        atDeps.push_back(g.names[start]);
+        g.backEdges.emplace_back(g.names[at], g.names[start]);
+        ++c;
+    }
+    return g;
+}
+
+Options optionsFromJson(const nlohmann::json& json)
+{
+    Options o;
+    o.seed = json.value("seed", o.seed);
+    o.modules = json.value("modules", o.modules);
+    o.depth = json.value("depth", o.depth);
+    o.minFanIn = json.value("min_fan_in", o.minFanIn);
+    o.maxFanIn = json.value("max_fan_in", o.maxFanIn);
+    o.maxFanOut = json.value("max_fan_out", o.maxFanOut);
+    o.cycles = json.value("cycles", o.cycles);
+    o.prefix = json.value("prefix", o.prefix);
+    return o;
+}
+
+void registerInto(ModuleRegistry& registry, const Graph& graph, const std::string& pathPrefix)
+{
+    std::vector<ModuleRegistration> batch;
+    batch.reserve(graph.names.size());
+    for (std::size_t i = 0; i < graph.names.size(); ++i)
+        batch.push_back({graph.names[i], pathPrefix + graph.names[i] + "_plugin.so", graph.dependencies[i]});
+    registry.registerModules(batch);
+}
+
+nlohmann::json moduleMetadata(const Graph& graph, std::size_t index)
+{
+    return {
+        {"name", graph.names[index]},
+        {"version", "1.0.0"},
+        {"description", "Synthetic module (layer " + std::to_string(graph.layer[index]) + ")"},
+        {"author", "logos synthetic graph"},
+        {"type", "core"},
+        {"category", "synthetic"},
+        {"main", graph.names[index] + "_plugin"},
+        {"dependencies", graph.dependencies[index]},
+        {"capabilities", nlohmann::json::array()},
+    };
+}
+
+std::string encodeCbor(const nlohmann::json& value)
+{
+    std::string out;
+    cborEncode(out, value);
+    return out;
+}
+
+std::string stubPluginImage(const nlohmann::json& metadata)
+{
+    if (kElfMachine == 0)
+        return {};
+
+    // Payload as moc lays it out: magic, a 4-byte header (metadata format 0,
+    // Qt 6.0, no architecture requirements), then a CBOR map of
+    // {2: IID, 3: class name, 4: metadata}.
+    std::string payload = "QTMETADATA !";
+    payload += std::string{'\0', '\x06', '\0', '\0'};
+    cborHead(payload, 5, 3);
+    cborHead(payload, 0, 2);
+    cborText(payload, "org.logos.SyntheticModule");
+    cborHead(payload, 0, 3);
+    cborText(payload, metadata.value("main", std::string("SyntheticModule")));
+    cborHead(payload, 0, 4);
+    cborEncode(payload, metadata);
+
+    const std::string shstrtab = std::string("\0.qtmetadata\0.shstrtab\0", 23);
+    const std::size_t payloadOffset = kEhdrSize;
+    const std::size_t strtabOffset = payloadOffset + payload.size();
+    const std::size_t shdrOffset = alignUp(strtabOffset + shstrtab.size(), 8);
+
+    std::string image(shdrOffset + 3 * kShdrSize, '\0');
+    const unsigned char ident[16] = {0x7f, 'E', 'L', 'F', 2 /*64-bit*/, 1 /*LE*/, 1 /*EV_CURRENT*/};
+    std::memcpy(&image[0], ident, sizeof(ident));
+    put<uint16_t>(image, 16, 3);                 // e_type: ET_DYN
+    put<uint16_t>(image, 18, kElfMachine);
+    put<uint32_t>(image, 20, 1);                 // e_version
+    put<uint64_t>(image, 24, 0);                 // e_entry
+    put<uint64_t>(image, 32, 0);                 // e_phoff
+    put<uint64_t>(image, 40, shdrOffset);        // e_shoff
+    put<uint32_t>(image, 48, 0);                 // e_flags
+    put<uint16_t>(image, 52, kEhdrSize);         // e_ehsize
+    put<uint16_t>(image, 54, 56);                // e_phentsize
+    put<uint16_t>(image, 56, 0);                 // e_phnum
+    put<uint16_t>(image, 58, kShdrSize);         // e_shentsize
+    put<uint16_t>(image, 60, 3);                 // e_shnum
+    put<uint16_t>(image, 62, 2);                 // e_shstrndx
+
+    image.replace(payloadOffset, payload.size(), payload);
+    image.replace(strtabOffset, shstrtab.size(), shstrtab);
+    putSectionHeader(image, shdrOffset + kShdrSize, 1, 1 /*SHT_PROGBITS*/, 2 /*SHF_ALLOC*/,
+                     payloadOffset, payload.size(), 1);
+    putSectionHeader(image, shdrOffset + 2 * kShdrSize, 13, 3 /*SHT_STRTAB*/, 0,
+                     strtabOffset, shstrtab.size(), 1);
+    return image;
+}
+
+bool writePackages(const Graph& graph, const std::string& dir, std::string* error)
+{
+    auto fail = [&](const std::string& message) {
+        if (error)
+            *error = message;
+        return false;
+    };
+    if (kElfMachine == 0)
+        return fail("stub plugins are only written for x86-64 and AArch64 ELF hosts");
+
+    std::error_code ec;
+    fs::create_directories(dir, ec);
+    if (ec)
+        return fail("cannot create " + dir + ": " + ec.message());
+
+    for (std::size_t i = 0; i < graph.names.size(); ++i) {
+        const std::string& name = graph.names[i];
+        const fs::path packageDir = fs::path(dir) / name;
+        fs::create_directories(packageDir, ec);
+        if (ec)
+            return fail("cannot create " + packageDir.string() + ": " + ec.message());
+
+        const nlohmann::json metadata = moduleMetadata(graph, i);
+        nlohmann::json manifest = {
+            {"name", name},
+            {"version", metadata["version"]},
+            {"type", "core"},
+            {"main", name + "_plugin.so"},
+            {"description", metadata["description"]},
+        };
+        if (!graph.dependencies[i].empty())
+            manifest["dependencies"] = graph.dependencies[i];
+
+        std::ofstream mf(packageDir / "manifest.json", std::ios::trunc);
+        mf << manifest.dump(2) << '\n';
+        std::ofstream bf(packageDir / (name + "_plugin.so"), std::ios::binary | std::ios::trunc);
+        bf << stubPluginImage(metadata);
+        if (!mf || !bf)
+            return fail("cannot write package " + packageDir.string());
+    }
+    return true;
+}
+
+} // namespace SyntheticGraph
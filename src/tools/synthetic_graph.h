@@ -0,0 +1,81 @@
+#ifndef SYNTHETIC_GRAPH_H
+#define SYNTHETIC_GRAPH_H
+
+#include <nlohmann/json.hpp>
+
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+class ModuleRegistry;
+
+// Seeded random module dependency graphs for scale tests and benchmarks
+// (Qt-free). A graph can be loaded straight into a ModuleRegistry, or written
+// out as installable stub packages so discovery can be measured end to end.
+//
+// Modules are arranged in `depth` layers. Every module above layer 0 depends
+// on at least one module in the layer directly below it, so the longest chain
+// is exactly `depth` modules; its remaining dependencies are drawn from any
+// lower layer, which yields wide fan-out near the bottom and diamonds
+// throughout. The same Options (seed included) always give the same graph.
+
+namespace SyntheticGraph {
+
+struct Options {
+    uint32_t seed = 1;
+    int modules = 100;
+    int depth = 8;          // layers; clamped to [1, modules]
+    int minFanIn = 1;       // dependencies per module above layer 0
+    int maxFanIn = 3;
+    int maxFanOut = 0;      // cap on direct dependents per module; 0 = none
+    int cycles = 0;         // back edges injected after the DAG is built
+    std::string prefix = "synth_";
+};
+
+struct Graph {
+    std::vector<std::string> names;
+    std::vector<std::vector<std::string>> dependencies;   // parallel to names
+    std::vector<int> layer;                               // parallel to names
+    // (from, to) edges added by cycle injection: `from` now depends on `to`,
+    // which already depended on `from`, directly or transitively.
+    std::vector<std::pair<std::string, std::string>> backEdges;
+
+    std::size_t edgeCount() const;
+};
+
+Graph generate(const Options& options);
+
+// Options from JSON: {"seed", "modules", "depth", "min_fan_in", "max_fan_in",
+// "max_fan_out", "cycles", "prefix"}, each optional. Throws
+// nlohmann::json::exception on a field of the wrong type.
+Options optionsFromJson(const nlohmann::json& json);
+
+// Register every module of `graph` (path "<pathPrefix><name>_plugin.so") in
+// one batch; see ModuleRegistry::registerModules().
+void registerInto(ModuleRegistry& registry, const Graph& graph,
+                  const std::string& pathPrefix = "/synthetic/");
+
+// The metadata.json a real module of this graph would embed.
+nlohmann::json moduleMetadata(const Graph& graph, std::size_t index);
+
+// Write one package directory per module under `dir`, in the layout the
+// package manager scans: <dir>/<name>/manifest.json naming the main file
+// <name>_plugin.so, plus that file. The file is a stub shared object — an
+// ELF image with no code, only a .qtmetadata section holding the module's
+// metadata the way moc embeds it (magic, header, CBOR) — so metadata
+// extraction reads it without loading anything. Stub plugins are written
+// for 64-bit little-endian ELF hosts (x86-64, AArch64) only. Returns false
+// and sets `error` on an unsupported host or an I/O failure.
+bool writePackages(const Graph& graph, const std::string& dir, std::string* error = nullptr);
+
+// The stub plugin image for `metadata`, or empty on an unsupported host.
+std::string stubPluginImage(const nlohmann::json& metadata);
+
+// CBOR encoding as Qt's plugin metadata uses it (definite-length items,
+// shortest integer forms). Round-trips through nlohmann::json::from_cbor.
+std::string encodeCbor(const nlohmann::json& value);
+
+} // namespace SyntheticGraph
+
+#endif // SYNTHETIC_GRAPH_H
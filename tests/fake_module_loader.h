@@ -0,0 +1,78 @@
+#ifndef FAKE_MODULE_LOADER_H
+#define FAKE_MODULE_LOADER_H
+
+// Test-only ModuleLoader that launches nothing: a load just marks the module
+// active, so tests can drive ModuleManager's lifecycle (metrics, trace,
+// journal, tokens, stats) without spawning processes. useOnlyLoader() /
+// restoreSubprocessLoader() are the SetUp/TearDown pair that swaps it in for
+// the default SubprocessManager and back, from a clean module state.
+
+#include "logos_core.h"
+#include "qt_test_adapter.h"
+#include "module_manager.h"
+#include "module_loader_registry.h"
+#include "module_loader.h"
+#include "subprocess_manager.h"
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+
+struct FakeModuleLoader : public LogosCore::ModuleLoader {
+    std::string id() const override { return "fake"; }
+    bool canHandle(const LogosCore::ModuleDescriptor&) const override { return true; }
+
+    bool load(const LogosCore::ModuleDescriptor& desc,
+              std::function<void(const std::string&)>,
+              LogosCore::LoadedModuleHandle& out) override {
+        if (failOn.count(desc.name)) return false;
+        out.name = desc.name;
+        out.pid = pid;
+        active.insert(desc.name);
+        return true;
+    }
+    bool sendToken(const std::string& name, const std::string& token) override {
+        if (rejectToken.count(name)) return false;
+        received[name] = token;
+        return true;
+    }
+    void terminate(const std::string& name) override {
+        active.erase(name);
+        received.erase(name);
+    }
+    void terminateAll() override {
+        active.clear();
+        received.clear();
+    }
+    bool hasModule(const std::string& name) const override { return active.count(name) > 0; }
+    // Every active module at `pid`, when one is set.
+    std::unordered_map<std::string, int64_t> getAllPids() const override {
+        std::unordered_map<std::string, int64_t> pids;
+        if (pid > 0)
+            for (const auto& name : active) pids[name] = pid;
+        return pids;
+    }
+
+    int64_t pid = -1;                                        // handed out for every load
+    std::unordered_set<std::string> failOn;                  // load() fails
+    std::unordered_set<std::string> rejectToken;             // sendToken() fails
+    std::unordered_set<std::string> active;
+    std::unordered_map<std::string, std::string> received;   // token sent, per module
+};
+
+// Drop every module and make `loader` the only registered loader.
+inline void useOnlyLoader(std::shared_ptr<LogosCore::ModuleLoader> loader) {
+    logos_core_terminate_all();
+    logos_core_clear();
+    SubprocessManager::clearAll();
+    ModuleManager::loaders().clearForTests();
+    ModuleManager::loaders().registerLoader(std::move(loader));
+}
+
+// Drop every module and go back to the default SubprocessManager loader.
+inline void restoreSubprocessLoader() {
+    useOnlyLoader(std::make_shared<SubprocessManager>());
+}
+
+#endif // FAKE_MODULE_LOADER_H
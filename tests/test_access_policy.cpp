@@ -169,3 +169,35 @@ TEST(AccessPolicyParse, VersionDefaultsToZeroWhenAbsent) {
     ASSERT_TRUE(policy.has_value());
     EXPECT_EQ(policy->version, 0);
 }
+
+// ── Compiled lookup form ─────────────────────────────────────────────────────
+
+TEST(AccessPolicyCompile, ExplicitForReturnsTargetAllowlist) {
+    auto policy = parseAccessPolicy(kProductionPolicy);
+    ASSERT_TRUE(policy.has_value());
+    auto compiled = LogosCore::compileAccessPolicy(*policy);
+
+    const auto* pm = compiled.explicitFor("package_manager");
+    ASSERT_NE(pm, nullptr);
+    EXPECT_EQ(*pm, std::vector<std::string>{"package_manager_ui"});
+    ASSERT_NE(compiled.explicitFor("package_downloader"), nullptr);
+}
+
+TEST(AccessPolicyCompile, UnnamedTargetHasNoExplicitEntry) {
+    auto policy = parseAccessPolicy(kProductionPolicy);
+    ASSERT_TRUE(policy.has_value());
+    auto compiled = LogosCore::compileAccessPolicy(*policy);
+    EXPECT_EQ(compiled.explicitFor("wallet"), nullptr);
+}
+
+TEST(AccessPolicyCompile, EmptyAllowlistIsStillAnExplicitEntry) {
+    // An explicit empty list overrides derivation and admits no peer; it
+    // must not be confused with "not named".
+    auto policy = parseAccessPolicy(
+        "{\"version\":1,\"mode\":\"enforce\",\"restrictions\":{\"locked\":{}}}");
+    ASSERT_TRUE(policy.has_value());
+    auto compiled = LogosCore::compileAccessPolicy(*policy);
+    const auto* locked = compiled.explicitFor("locked");
+    ASSERT_NE(locked, nullptr);
+    EXPECT_TRUE(locked->empty());
+}
@@ -0,0 +1,274 @@
+// =============================================================================
+// Tests for the asynchronous logging sink (logging/async_sink.h) and the
+// LOGOS_LOG_ASYNC environment switch (logging/logos_log.h).
+//
+// Each test wraps a recording sink in its own AsyncSink and logs through a
+// private logger, so the process-wide stderr sink is never touched.
+// =============================================================================
+#include <gtest/gtest.h>
+#include "logging/async_sink.h"
+#include "logging/logos_log.h"
+#include <spdlog/sinks/base_sink.h>
+#include <spdlog/spdlog.h>
+#include <condition_variable>
+#include <cstdlib>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+using logos::AsyncSink;
+using logos::OverflowPolicy;
+
+namespace {
+
+// Records payloads; while the gate is closed, writes block (a stalled pipe).
+class RecordingSink : public spdlog::sinks::base_sink<std::mutex> {
+public:
+    std::vector<std::string> lines() {
+        std::lock_guard lk(mutex_);
+        return m_lines;
+    }
+
+    void closeGate() {
+        std::lock_guard lk(m_gateMutex);
+        m_open = false;
+    }
+    void openGate() {
+        {
+            std::lock_guard lk(m_gateMutex);
+            m_open = true;
+        }
+        m_gateCv.notify_all();
+    }
+    // Wait until the flusher is stuck on the gate.
+    void waitBlocked() {
+        std::unique_lock lk(m_gateMutex);
+        m_gateCv.wait(lk, [&] { return m_blocked; });
+    }
+
+protected:
+    void sink_it_(const spdlog::details::log_msg& msg) override {
+        {
+            std::unique_lock lk(m_gateMutex);
+            if (!m_open) {
+                m_blocked = true;
+                m_gateCv.notify_all();
+                m_gateCv.wait(lk, [&] { return m_open; });
+                m_blocked = false;
+            }
+        }
+        m_lines.emplace_back(msg.payload.data(), msg.payload.size());
+    }
+    void flush_() override {}
+
+private:
+    std::vector<std::string> m_lines;
+    std::mutex m_gateMutex;
+    std::condition_variable m_gateCv;
+    bool m_open = true;
+    bool m_blocked = false;
+};
+
+struct AsyncFixture {
+    std::shared_ptr<RecordingSink> inner = std::make_shared<RecordingSink>();
+    std::shared_ptr<AsyncSink> sink = std::make_shared<AsyncSink>(inner);
+    spdlog::logger logger{"async-test", sink};
+};
+
+class EnvGuard {
+public:
+    EnvGuard(const char* name, const char* value) : m_name(name) {
+        if (const char* old = std::getenv(name))
+            m_old = old;
+        if (value)
+            ::setenv(name, value, 1);
+        else
+            ::unsetenv(name);
+    }
+    ~EnvGuard() {
+        if (m_old.empty())
+            ::unsetenv(m_name);
+        else
+            ::setenv(m_name, m_old.c_str(), 1);
+    }
+
+private:
+    const char* m_name;
+    std::string m_old;
+};
+
+} // anonymous namespace
+
+TEST(AsyncSink, PassesThroughUntilStarted) {
+    AsyncFixture f;
+    f.logger.info("sync");
+    EXPECT_EQ(f.inner->lines(), std::vector<std::string>{"sync"});
+    EXPECT_FALSE(f.sink->running());
+}
+
+TEST(AsyncSink, WritesEverythingInOrderOnFlush) {
+    AsyncFixture f;
+    ASSERT_TRUE(f.sink->start(64, OverflowPolicy::Block));
+    EXPECT_FALSE(f.sink->start(64, OverflowPolicy::Block));
+    for (int i = 0; i < 500; ++i)
+        f.logger.info("line {}", i);
+    f.logger.flush();
+
+    auto lines = f.inner->lines();
+    ASSERT_EQ(lines.size(), 500u);
+    for (int i = 0; i < 500; ++i)
+        EXPECT_EQ(lines[i], "line " + std::to_string(i));
+    EXPECT_EQ(f.sink->droppedMessages(), 0u);
+    f.sink->stop();
+}
+
+TEST(AsyncSink, KeepsPerThreadOrderUnderConcurrentProducers) {
+    AsyncFixture f;
+    ASSERT_TRUE(f.sink->start(16, OverflowPolicy::Block));
+    constexpr int kThreads = 4;
+    constexpr int kPerThread = 2000;
+    std::vector<std::thread> threads;
+    for (int t = 0; t < kThreads; ++t)
+        threads.emplace_back([&, t] {
+            for (int i = 0; i < kPerThread; ++i)
+                f.logger.info("{}:{}", t, i);
+        });
+    for (auto& th : threads)
+        th.join();
+    f.sink->stop();
+
+    auto lines = f.inner->lines();
+    ASSERT_EQ(lines.size(), static_cast<size_t>(kThreads * kPerThread));
+    std::vector<int> next(kThreads, 0);
+    for (const auto& line : lines) {
+        const auto colon = line.find(':');
+        const int t = std::stoi(line.substr(0, colon));
+        EXPECT_EQ(std::stoi(line.substr(colon + 1)), next[t]++);
+    }
+}
+
+TEST(AsyncSink, DiscardNewDropsWhenFull) {
+    AsyncFixture f;
+    ASSERT_TRUE(f.sink->start(4, OverflowPolicy::DiscardNew));
+    f.inner->closeGate();
+    f.logger.info("stuck");   // the flusher takes it and blocks on the gate
+    f.inner->waitBlocked();
+    for (int i = 0; i < 10; ++i)
+        f.logger.info("m{}", i);   // 4 fit, 6 are dropped
+    EXPECT_EQ(f.sink->droppedMessages(), 6u);
+
+    f.inner->openGate();
+    f.sink->stop();
+    auto lines = f.inner->lines();
+    ASSERT_EQ(lines.size(), 6u);   // stuck, m0..m3, drop report
+    EXPECT_EQ(lines[1], "m0");
+    EXPECT_EQ(lines[4], "m3");
+    EXPECT_EQ(lines[5], "6 log message(s) dropped: async queue full");
+}
+
+TEST(AsyncSink, OverrunOldestKeepsNewest) {
+    AsyncFixture f;
+    ASSERT_TRUE(f.sink->start(4, OverflowPolicy::OverrunOldest));
+    f.inner->closeGate();
+    f.logger.info("stuck");
+    f.inner->waitBlocked();
+    for (int i = 0; i < 10; ++i)
+        f.logger.info("m{}", i);
+    EXPECT_EQ(f.sink->droppedMessages(), 6u);
+
+    f.inner->openGate();
+    f.sink->stop();
+    auto lines = f.inner->lines();
+    ASSERT_EQ(lines.size(), 6u);
+    EXPECT_EQ(lines[1], "m6");
+    EXPECT_EQ(lines[4], "m9");
+}
+
+TEST(AsyncSink, BlockPolicyWaitsForRoom) {
+    AsyncFixture f;
+    ASSERT_TRUE(f.sink->start(2, OverflowPolicy::Block));
+    f.inner->closeGate();
+    f.logger.info("stuck");
+    f.inner->waitBlocked();
+
+    std::thread producer([&] {
+        for (int i = 0; i < 5; ++i)
+            f.logger.info("m{}", i);   // blocks after two
+    });
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    f.inner->openGate();
+    producer.join();
+    f.sink->stop();
+    EXPECT_EQ(f.inner->lines().size(), 6u);
+    EXPECT_EQ(f.sink->droppedMessages(), 0u);
+}
+
+TEST(AsyncSink, ErrorLinesAreWrittenBeforeLogReturns) {
+    AsyncFixture f;
+    ASSERT_TRUE(f.sink->start(64, OverflowPolicy::Block));
+    f.logger.info("before");
+    f.logger.error("fatal");
+    auto lines = f.inner->lines();
+    ASSERT_EQ(lines.size(), 2u);
+    EXPECT_EQ(lines[1], "fatal");
+    f.sink->stop();
+}
+
+TEST(AsyncSink, LoggerLevelStillFilters) {
+    AsyncFixture f;
+    ASSERT_TRUE(f.sink->start(64, OverflowPolicy::Block));
+    f.logger.set_level(spdlog::level::warn);
+    f.logger.info("hidden");
+    f.logger.warn("shown");
+    f.logger.flush();
+    EXPECT_EQ(f.inner->lines(), std::vector<std::string>{"shown"});
+    f.sink->stop();
+}
+
+TEST(AsyncSink, StopRevertsToPassThroughAndCanRestart) {
+    AsyncFixture f;
+    ASSERT_TRUE(f.sink->start(8, OverflowPolicy::Block));
+    f.logger.info("a");
+    f.sink->stop();
+    EXPECT_FALSE(f.sink->running());
+    f.logger.info("b");
+    EXPECT_EQ(f.inner->lines().size(), 2u);
+
+    ASSERT_TRUE(f.sink->start(8, OverflowPolicy::Block));
+    f.logger.info("c");
+    f.logger.flush();
+    EXPECT_EQ(f.inner->lines(), (std::vector<std::string>{"a", "b", "c"}));
+    f.sink->stop();
+}
+
+TEST(LoggingOptions, ReadsEnvironment) {
+    {
+        EnvGuard mode("LOGOS_LOG_ASYNC", nullptr);
+        EXPECT_FALSE(logos::loggingOptionsFromEnvironment().async);
+    }
+    {
+        EnvGuard mode("LOGOS_LOG_ASYNC", "drop");
+        EnvGuard size("LOGOS_LOG_QUEUE_SIZE", "1024");
+        auto options = logos::loggingOptionsFromEnvironment();
+        EXPECT_TRUE(options.async);
+        EXPECT_EQ(options.overflow, OverflowPolicy::DiscardNew);
+        EXPECT_EQ(options.queueSize, 1024u);
+    }
+    {
+        EnvGuard mode("LOGOS_LOG_ASYNC", "1");
+        EnvGuard size("LOGOS_LOG_QUEUE_SIZE", "junk");
+        auto options = logos::loggingOptionsFromEnvironment();
+        EXPECT_EQ(options.overflow, OverflowPolicy::Block);
+        EXPECT_EQ(options.queueSize, logos::LoggingOptions{}.queueSize);
+    }
+    {
+        EnvGuard mode("LOGOS_LOG_ASYNC", "overrun");
+        EXPECT_EQ(logos::loggingOptionsFromEnvironment().overflow, OverflowPolicy::OverrunOldest);
+    }
+    {
+        EnvGuard mode("LOGOS_LOG_ASYNC", "sometimes");
+        EXPECT_FALSE(logos::loggingOptionsFromEnvironment().async);
+    }
+}
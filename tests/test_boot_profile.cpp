@@ -0,0 +1,298 @@
+// =============================================================================
+// Tests for declarative boot profiles (boot_profile.h): parsing, load order
+// by required flag and priority with dependency closure, the ready milestone
+// while background sets are still loading, failure propagation, and the
+// logos_core_start_boot_profile / wait_boot_ready / get_boot_status C API.
+// =============================================================================
+#include <gtest/gtest.h>
+#include "logos_core.h"
+#include "qt_test_adapter.h"
+#include "module_manager.h"
+#include "module_loader_registry.h"
+#include "module_loader.h"
+#include "boot_profile.h"
+#include "subprocess_manager.h"
+#include <nlohmann/json.hpp>
+#include <chrono>
+#include <condition_variable>
+#include <map>
+#include <mutex>
+#include <set>
+#include <string>
+#include <vector>
+
+using namespace LogosCore;
+using namespace std::chrono_literals;
+
+namespace {
+
+// In-memory graph plus a load log; `gate` holds back one module's load
+// until released.
+struct BootHarness {
+    std::map<std::string, std::vector<std::string>> deps;
+    std::set<std::string> failOn;
+    std::string gate;
+
+    std::mutex mutex;
+    std::condition_variable cv;
+    bool entered = false;   // the gated load has started
+    bool released = false;
+    std::set<std::string> loaded;
+    std::vector<std::string> order;
+
+    BootProfileRunner::Hooks hooks() {
+        BootProfileRunner::Hooks h;
+        h.isKnown = [this](const std::string& n) { return deps.count(n) > 0; };
+        h.dependenciesOf = [this](const std::string& n) {
+            auto it = deps.find(n);
+            return it == deps.end() ? std::vector<std::string>{} : it->second;
+        };
+        h.isLoaded = [this](const std::string& n) {
+            std::lock_guard lock(mutex);
+            return loaded.count(n) > 0;
+        };
+        h.load = [this](const std::string& n, bool) {
+            std::unique_lock lock(mutex);
+            if (n == gate) {
+                entered = true;
+                cv.notify_all();
+                cv.wait(lock, [this] { return released; });
+            }
+            order.push_back(n);
+            if (failOn.count(n))
+                return false;
+            loaded.insert(n);
+            return true;
+        };
+        return h;
+    }
+
+    void waitEntered() {
+        std::unique_lock lock(mutex);
+        cv.wait(lock, [this] { return entered; });
+    }
+
+    void release() {
+        std::lock_guard lock(mutex);
+        released = true;
+        cv.notify_all();
+    }
+};
+
+BootProfile profileOf(const std::string& json) {
+    std::string error;
+    auto profile = parseBootProfile(json, &error);
+    EXPECT_TRUE(profile.has_value()) << error;
+    return profile.value_or(BootProfile{});
+}
+
+std::string statusOf(const nlohmann::json& status, const std::string& module) {
+    for (const auto& set : status["sets"])
+        for (const auto& m : set["modules"])
+            if (m["name"] == module)
+                return m["status"];
+    return "";
+}
+
+struct BootProfileLoader : public ModuleLoader {
+    std::string id() const override { return "boot-profile"; }
+    bool canHandle(const ModuleDescriptor&) const override { return true; }
+    bool load(const ModuleDescriptor& desc,
+              std::function<void(const std::string&)>,
+              LoadedModuleHandle& out) override {
+        std::lock_guard lock(mutex);
+        out.name = desc.name;
+        active.insert(desc.name);
+        return true;
+    }
+    bool sendToken(const std::string&, const std::string&) override { return true; }
+    void terminate(const std::string& name) override {
+        std::lock_guard lock(mutex);
+        active.erase(name);
+    }
+    void terminateAll() override {
+        std::lock_guard lock(mutex);
+        active.clear();
+    }
+    bool hasModule(const std::string& name) const override {
+        std::lock_guard lock(mutex);
+        return active.count(name) > 0;
+    }
+    mutable std::mutex mutex;
+    std::set<std::string> active;
+};
+
+} // anonymous namespace
+
+TEST(BootProfile, ParsesObjectAndBareArray) {
+    auto a = profileOf(R"({"sets": [{"name": "core", "priority": 5, "required": true, "modules": ["x", "y"]}]})");
+    ASSERT_EQ(a.sets.size(), 1u);
+    EXPECT_EQ(a.sets[0].name, "core");
+    EXPECT_EQ(a.sets[0].priority, 5);
+    EXPECT_TRUE(a.sets[0].required);
+    EXPECT_EQ(a.sets[0].modules, (std::vector<std::string>{"x", "y"}));
+
+    auto b = profileOf(R"([{"modules": ["z"]}])");
+    ASSERT_EQ(b.sets.size(), 1u);
+    EXPECT_EQ(b.sets[0].name, "set0");
+    EXPECT_EQ(b.sets[0].priority, 0);
+    EXPECT_FALSE(b.sets[0].required);
+}
+
+TEST(BootProfile, RejectsMalformedProfiles) {
+    for (const char* bad : {"not json", "{}", R"({"sets": 3})", R"([{"name": "n"}])",
+                            R"([{"modules": [1]}])", R"([{"modules": ["a"], "priority": "high"}])",
+                            R"([{"modules": ["a"], "required": 1}])"}) {
+        std::string error;
+        EXPECT_FALSE(parseBootProfile(bad, &error).has_value()) << bad;
+        EXPECT_FALSE(error.empty()) << bad;
+    }
+}
+
+TEST(BootProfile, RequiredFirstThenPriorityWithDependencies) {
+    BootHarness h;
+    h.deps = {{"base", {}}, {"ui", {"base"}}, {"net", {"base"}}, {"extra", {"net"}}, {"late", {}}};
+    BootProfileRunner runner(profileOf(R"([
+        {"name": "later", "priority": 1, "modules": ["late"]},
+        {"name": "soon", "priority": 9, "modules": ["extra"]},
+        {"name": "core", "priority": 0, "required": true, "modules": ["ui"]}
+    ])"), h.hooks());
+    runner.start();
+    ASSERT_TRUE(runner.waitFinished(5s));
+    EXPECT_EQ(h.order, (std::vector<std::string>{"base", "ui", "net", "extra", "late"}));
+    EXPECT_EQ(runner.ready(), BootProfileRunner::Ready::Reached);
+
+    const auto status = runner.status();
+    EXPECT_EQ(status["state"], "done");
+    EXPECT_TRUE(status["ready_ms"].is_number());
+    // Each module is listed under the set that brought it in.
+    EXPECT_EQ(status["sets"][2]["modules"].size(), 2u);   // core: base, ui
+    EXPECT_EQ(status["sets"][1]["modules"].size(), 2u);   // soon: net, extra
+}
+
+TEST(BootProfile, ReadyBeforeBackgroundSetsFinish) {
+    BootHarness h;
+    h.deps = {{"needed", {}}, {"slow_background", {}}};
+    h.gate = "slow_background";
+    BootProfileRunner runner(profileOf(R"([
+        {"required": true, "modules": ["needed"]},
+        {"modules": ["slow_background"]}
+    ])"), h.hooks());
+    runner.start();
+    EXPECT_EQ(runner.waitReady(5s), BootProfileRunner::Ready::Reached);
+    EXPECT_FALSE(runner.finished());
+    EXPECT_EQ(runner.status()["state"], "ready");
+    h.release();
+    ASSERT_TRUE(runner.waitFinished(5s));
+    EXPECT_EQ(runner.status()["state"], "done");
+}
+
+TEST(BootProfile, FailedRequiredModuleMakesReadyUnreachable) {
+    BootHarness h;
+    h.deps = {{"broken", {}}, {"needs_broken", {"broken"}}, {"other", {}}};
+    h.failOn = {"broken"};
+    BootProfileRunner runner(profileOf(R"([
+        {"required": true, "modules": ["needs_broken"]},
+        {"modules": ["other"]}
+    ])"), h.hooks());
+    runner.start();
+    EXPECT_EQ(runner.waitReady(5s), BootProfileRunner::Ready::Unreachable);
+    ASSERT_TRUE(runner.waitFinished(5s));
+    const auto status = runner.status();
+    EXPECT_EQ(status["state"], "failed");
+    EXPECT_EQ(statusOf(status, "broken"), "failed");
+    EXPECT_EQ(statusOf(status, "needs_broken"), "skipped");
+    EXPECT_EQ(statusOf(status, "other"), "loaded");   // background carries on
+}
+
+TEST(BootProfile, UnknownRequiredModuleIsUnresolved) {
+    BootHarness h;
+    h.deps = {{"fine", {}}};
+    BootProfileRunner runner(profileOf(R"([{"required": true, "modules": ["fine", "ghost"]}])"), h.hooks());
+    EXPECT_EQ(runner.ready(), BootProfileRunner::Ready::Unreachable);
+    runner.start();
+    ASSERT_TRUE(runner.waitFinished(5s));
+    EXPECT_EQ(statusOf(runner.status(), "ghost"), "unresolved");
+    EXPECT_EQ(statusOf(runner.status(), "fine"), "loaded");
+}
+
+TEST(BootProfile, StopCancelsRemainingSteps) {
+    BootHarness h;
+    h.deps = {{"first", {}}, {"second", {"first"}}};
+    h.gate = "first";
+    BootProfileRunner runner(profileOf(R"([{"modules": ["first", "second"]}])"), h.hooks());
+    runner.start();
+    h.waitEntered();
+    std::thread releaser([&] {
+        std::this_thread::sleep_for(50ms);
+        h.release();
+    });
+    runner.stop();
+    releaser.join();
+    EXPECT_TRUE(runner.finished());
+    EXPECT_EQ(statusOf(runner.status(), "first"), "loaded");
+    EXPECT_EQ(statusOf(runner.status(), "second"), "cancelled");
+}
+
+class BootProfileApiTest : public ::testing::Test {
+protected:
+    std::shared_ptr<BootProfileLoader> loader;
+
+    void SetUp() override {
+        logos_core_terminate_all();
+        logos_core_clear();
+        loader = std::make_shared<BootProfileLoader>();
+        ModuleManager::loaders().clearForTests();
+        ModuleManager::loaders().registerLoader(loader);
+    }
+
+    void TearDown() override {
+        logos_core_clear();
+        ModuleManager::loaders().clearForTests();
+        ModuleManager::loaders().registerLoader(std::make_shared<SubprocessManager>());
+    }
+
+    void registerModule(const std::string& name, const std::vector<std::string>& deps = {}) {
+        const std::string path = "/boot_profile/" + name + "_plugin.so";
+        logos_core_register_module(name.c_str(), path.c_str());
+        std::vector<const char*> ptrs;
+        for (const auto& d : deps)
+            ptrs.push_back(d.c_str());
+        logos_core_register_module_dependencies(name.c_str(), ptrs.empty() ? nullptr : ptrs.data(),
+                                                static_cast<int>(ptrs.size()));
+    }
+};
+
+TEST_F(BootProfileApiTest, LoadsProfileAndReportsReady) {
+    registerModule("bp_base");
+    registerModule("bp_app", {"bp_base"});
+    registerModule("bp_tools");
+
+    EXPECT_EQ(logos_core_start_boot_profile("{oops"), 0);
+    ASSERT_EQ(logos_core_start_boot_profile(R"({"sets": [
+        {"name": "app", "required": true, "modules": ["bp_app"]},
+        {"name": "tools", "priority": -1, "modules": ["bp_tools"]}
+    ]})"), 1);
+    EXPECT_EQ(logos_core_wait_boot_ready(5000), 1);
+    EXPECT_EQ(logos_core_is_module_loaded("bp_app"), 1);
+    EXPECT_EQ(logos_core_is_module_loaded("bp_base"), 1);
+
+    char* raw = logos_core_get_boot_status();
+    ASSERT_NE(raw, nullptr);
+    const auto status = nlohmann::json::parse(raw);
+    delete[] raw;
+    EXPECT_TRUE(status["state"] == "ready" || status["state"] == "done");
+    EXPECT_EQ(status["sets"][0]["name"], "app");
+}
+
+TEST_F(BootProfileApiTest, NoProfileMeansNoStatus) {
+    EXPECT_EQ(logos_core_get_boot_status(), nullptr);
+    EXPECT_EQ(logos_core_wait_boot_ready(0), 0);
+}
+
+TEST_F(BootProfileApiTest, UnknownRequiredModuleFailsReady) {
+    registerModule("bp_known");
+    ASSERT_EQ(logos_core_start_boot_profile(R"([{"required": true, "modules": ["bp_missing"]},
+                                                {"modules": ["bp_known"]}])"), 1);
+    EXPECT_EQ(logos_core_wait_boot_ready(5000), -1);
+}
@@ -0,0 +1,180 @@
+// =============================================================================
+// Tests for boot critical-path analysis (boot_schedule.h): earliest-start
+// schedule, slack and critical path on small graphs, cycles, and the report
+// logos_core_get_boot_report() builds from recorded load times.
+// =============================================================================
+#include <gtest/gtest.h>
+#include "logos_core.h"
+#include "qt_test_adapter.h"
+#include "module_manager.h"
+#include "lifecycle_metrics.h"
+#include "boot_schedule.h"
+#include <nlohmann/json.hpp>
+#include <chrono>
+#include <string>
+#include <vector>
+
+using namespace LogosCore;
+
+namespace {
+
+const BootSlot& slotOf(const BootPlan& plan, const std::string& name) {
+    for (const auto& slot : plan.schedule)
+        if (slot.name == name)
+            return slot;
+    static const BootSlot none;
+    ADD_FAILURE() << "no slot for " << name;
+    return none;
+}
+
+void registerBootModule(const std::string& name, const std::vector<std::string>& deps = {}) {
+    const std::string path = "/boot/" + name + "_plugin.so";
+    logos_core_register_module(name.c_str(), path.c_str());
+    std::vector<const char*> ptrs;
+    for (const auto& d : deps)
+        ptrs.push_back(d.c_str());
+    logos_core_register_module_dependencies(name.c_str(), ptrs.empty() ? nullptr : ptrs.data(),
+                                            static_cast<int>(ptrs.size()));
+}
+
+void recordLoad(const std::string& name, int ms) {
+    LifecycleMetrics::record(name, LifecycleMetrics::Phase::LoadTotal, std::chrono::milliseconds(ms));
+}
+
+nlohmann::json bootReport(const char* module) {
+    char* raw = logos_core_get_boot_report(module);
+    if (!raw)
+        return nullptr;
+    auto json = nlohmann::json::parse(raw);
+    delete[] raw;
+    return json;
+}
+
+class BootReportTest : public ::testing::Test {
+protected:
+    void SetUp() override { logos_core_clear(); }
+    void TearDown() override { logos_core_clear(); }
+};
+
+} // anonymous namespace
+
+TEST(BootSchedule, DiamondStartsEachModuleAfterItsLastDependency) {
+    //        top(5)
+    //       /      \
+    //   fast(1)   slow(10)
+    //       \      /
+    //        base(2)
+    const auto plan = planBoot({
+        {"base", {}, 2},
+        {"fast", {"base"}, 1},
+        {"slow", {"base"}, 10},
+        {"top", {"fast", "slow"}, 5},
+    });
+    EXPECT_DOUBLE_EQ(plan.minimumBootMs, 17);
+    EXPECT_DOUBLE_EQ(plan.serialBootMs, 18);
+    EXPECT_EQ(plan.maxParallelism, 2);
+    EXPECT_EQ(plan.criticalPath, (std::vector<std::string>{"base", "slow", "top"}));
+
+    EXPECT_DOUBLE_EQ(slotOf(plan, "top").startMs, 12);
+    EXPECT_DOUBLE_EQ(slotOf(plan, "fast").startMs, 2);
+    EXPECT_DOUBLE_EQ(slotOf(plan, "fast").slackMs, 9);
+    EXPECT_FALSE(slotOf(plan, "fast").critical);
+    EXPECT_TRUE(slotOf(plan, "slow").critical);
+    EXPECT_TRUE(slotOf(plan, "base").critical);
+    EXPECT_EQ(plan.schedule.front().name, "base");
+    EXPECT_EQ(plan.schedule.back().name, "top");
+}
+
+TEST(BootSchedule, IgnoresOutsideEdgesAndReportsCycles) {
+    const auto plan = planBoot({
+        {"a", {"not_in_set"}, 3},
+        {"b", {"c"}, 1},
+        {"c", {"b"}, 1},
+        {"d", {"c"}, 1},
+    });
+    ASSERT_EQ(plan.schedule.size(), 1u);
+    EXPECT_EQ(plan.schedule[0].name, "a");
+    EXPECT_DOUBLE_EQ(plan.minimumBootMs, 3);
+    EXPECT_EQ(plan.unschedulable, (std::vector<std::string>{"b", "c", "d"}));
+}
+
+TEST(BootSchedule, DependencyOfACycleKeepsItsSlack) {
+    // base feeds the b <-> c cycle and, off the cycle, a slow chain.
+    const auto plan = planBoot({
+        {"base", {}, 1},
+        {"b", {"base", "c"}, 1},
+        {"c", {"b"}, 1},
+        {"slow", {}, 10},
+        {"top", {"slow"}, 1},
+    });
+    EXPECT_EQ(plan.unschedulable, (std::vector<std::string>{"b", "c"}));
+    EXPECT_DOUBLE_EQ(plan.minimumBootMs, 11);
+    EXPECT_DOUBLE_EQ(slotOf(plan, "base").slackMs, 10);
+    EXPECT_FALSE(slotOf(plan, "base").critical);
+    const auto json = bootPlanToJson(plan);
+    ASSERT_EQ(json["gating"].size(), 2u);
+    EXPECT_EQ(json["gating"][0]["name"], "slow");
+    EXPECT_EQ(json["gating"][1]["name"], "top");
+}
+
+TEST(BootSchedule, JsonListsGatingModulesSlowestFirst) {
+    const auto json = bootPlanToJson(planBoot({
+        {"a", {}, 4},
+        {"b", {"a"}, 9},
+        {"side", {}, 1, false},
+    }));
+    ASSERT_EQ(json["gating"].size(), 2u);
+    EXPECT_EQ(json["gating"][0]["name"], "b");
+    EXPECT_EQ(json["gating"][1]["name"], "a");
+    EXPECT_EQ(json["unmeasured"], nlohmann::json::array({"side"}));
+    EXPECT_EQ(json["critical_path"], nlohmann::json::array({"a", "b"}));
+    EXPECT_DOUBLE_EQ(json["minimum_boot_ms"].get<double>(), 13);
+}
+
+TEST_F(BootReportTest, UsesMeanRecordedLoadTimes) {
+    registerBootModule("boot_base");
+    registerBootModule("boot_ui", {"boot_base"});
+    registerBootModule("boot_net", {"boot_base"});
+    registerBootModule("boot_app", {"boot_ui", "boot_net"});
+    registerBootModule("boot_idle");
+    recordLoad("boot_base", 4);
+    recordLoad("boot_ui", 2);
+    recordLoad("boot_net", 10);
+    recordLoad("boot_net", 30);   // mean 20
+    recordLoad("boot_app", 3);
+
+    const auto all = bootReport(nullptr);
+    ASSERT_TRUE(all.is_object());
+    EXPECT_TRUE(all["module"].is_null());
+    EXPECT_EQ(all["modules"], 4);   // boot_idle never loaded
+    EXPECT_NEAR(all["minimum_boot_ms"].get<double>(), 27, 1e-6);
+    EXPECT_NEAR(all["serial_boot_ms"].get<double>(), 29, 1e-6);
+    EXPECT_EQ(all["critical_path"],
+              nlohmann::json::array({"boot_base", "boot_net", "boot_app"}));
+    EXPECT_EQ(all["gating"][0]["name"], "boot_net");
+
+    const auto ui = bootReport("boot_ui");
+    ASSERT_TRUE(ui.is_object());
+    EXPECT_EQ(ui["module"], "boot_ui");
+    EXPECT_EQ(ui["critical_path"], nlohmann::json::array({"boot_base", "boot_ui"}));
+    EXPECT_NEAR(ui["minimum_boot_ms"].get<double>(), 6, 1e-6);
+}
+
+TEST_F(BootReportTest, UnmeasuredDependenciesCountAsZero) {
+    registerBootModule("boot_dep");
+    registerBootModule("boot_top", {"boot_dep"});
+    recordLoad("boot_top", 5);
+
+    const auto report = bootReport("boot_top");
+    ASSERT_TRUE(report.is_object());
+    EXPECT_EQ(report["unmeasured"], nlohmann::json::array({"boot_dep"}));
+    EXPECT_NEAR(report["minimum_boot_ms"].get<double>(), 5, 1e-6);
+}
+
+TEST_F(BootReportTest, UnknownModuleReturnsNull) {
+    EXPECT_EQ(logos_core_get_boot_report("boot_missing"), nullptr);
+    const auto empty = bootReport(nullptr);
+    ASSERT_TRUE(empty.is_object());
+    EXPECT_EQ(empty["modules"], 0);
+    EXPECT_TRUE(empty["schedule"].empty());
+}
@@ -0,0 +1,211 @@
+// =============================================================================
+// Tests for CapabilityNotifier, the ordered async pipeline that carries core's
+// token and restriction notifications to capability_module off the load path.
+//
+// Pins the properties ModuleManager relies on:
+//   - tasks run in enqueue order, on one worker thread; urgent tasks (token
+//     notifications) run ahead of queued non-urgent ones
+//   - wait(ticket) waits for one task, waitFor(module) for every task queued
+//     for that module; neither waits for unrelated work queued ahead
+//   - cancelPending drops queued work without stranding a barrier
+// Tasks here are plain lambdas; no capability_module, no Qt.
+// =============================================================================
+#include <gtest/gtest.h>
+#include "capability_notifier.h"
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+using LogosCore::CapabilityNotifier;
+
+namespace {
+
+// Blocks the worker inside a task until release() is called, so tests can
+// observe queue state deterministically.
+struct Gate {
+    std::mutex m;
+    std::condition_variable cv;
+    bool open = false;
+    bool entered = false;
+
+    void hold() {
+        std::unique_lock lock(m);
+        entered = true;
+        cv.notify_all();
+        cv.wait(lock, [&] { return open; });
+    }
+    void waitEntered() {
+        std::unique_lock lock(m);
+        cv.wait(lock, [&] { return entered; });
+    }
+    void release() {
+        std::lock_guard lock(m);
+        open = true;
+        cv.notify_all();
+    }
+};
+
+} // namespace
+
+TEST(CapabilityNotifier, RunsTasksInEnqueueOrder) {
+    CapabilityNotifier notifier;
+    std::mutex m;
+    std::vector<int> seen;
+
+    for (int i = 0; i < 50; ++i) {
+        notifier.enqueue(i % 2 ? "a" : "b", [&, i] {
+            std::lock_guard lock(m);
+            seen.push_back(i);
+        });
+    }
+    notifier.drain();
+
+    ASSERT_EQ(seen.size(), 50u);
+    for (int i = 0; i < 50; ++i)
+        EXPECT_EQ(seen[i], i);
+}
+
+TEST(CapabilityNotifier, RunsTasksOffTheCallingThread) {
+    CapabilityNotifier notifier;
+    std::thread::id ran;
+    notifier.enqueue("a", [&] { ran = std::this_thread::get_id(); });
+    notifier.drain();
+    EXPECT_NE(ran, std::this_thread::get_id());
+}
+
+TEST(CapabilityNotifier, EnqueueDoesNotWaitForTheTask) {
+    CapabilityNotifier notifier;
+    Gate gate;
+    notifier.enqueue("slow", [&] { gate.hold(); });
+    // Returned while the task is still blocked: the caller is off the IPC path.
+    gate.waitEntered();
+    EXPECT_EQ(notifier.pending(), 1u);
+    gate.release();
+    notifier.drain();
+    EXPECT_EQ(notifier.pending(), 0u);
+}
+
+TEST(CapabilityNotifier, WaitForUnknownModuleReturnsImmediately) {
+    CapabilityNotifier notifier;
+    notifier.waitFor("never_enqueued");
+    SUCCEED();
+}
+
+TEST(CapabilityNotifier, WaitForBlocksUntilModuleTaskRan) {
+    CapabilityNotifier notifier;
+    Gate gate;
+    std::atomic<bool> informed{false};
+
+    notifier.enqueue("mod", [&] {
+        gate.hold();
+        informed = true;
+    });
+
+    std::atomic<bool> barrierPassed{false};
+    std::thread waiter([&] {
+        notifier.waitFor("mod");
+        barrierPassed = true;
+    });
+
+    gate.waitEntered();
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    EXPECT_FALSE(barrierPassed.load());
+
+    gate.release();
+    waiter.join();
+    EXPECT_TRUE(informed.load());
+    EXPECT_TRUE(barrierPassed.load());
+}
+
+TEST(CapabilityNotifier, UrgentTasksOvertakeQueuedWork) {
+    CapabilityNotifier notifier;
+    Gate gate;
+    std::mutex m;
+    std::vector<std::string> seen;
+    auto record = [&](std::string label) {
+        return [&, label] {
+            std::lock_guard lock(m);
+            seen.push_back(label);
+        };
+    };
+
+    notifier.enqueue("busy", [&] { gate.hold(); });
+    gate.waitEntered();
+    notifier.enqueue("a", record("restriction_a"));
+    notifier.enqueue("b", record("restriction_b"));
+    notifier.enqueueUrgent("x", record("token_x"));
+    notifier.enqueueUrgent("y", record("token_y"));
+    gate.release();
+    notifier.drain();
+
+    EXPECT_EQ(seen, (std::vector<std::string>{"token_x", "token_y", "restriction_a", "restriction_b"}));
+}
+
+TEST(CapabilityNotifier, WaitOnTicketDoesNotWaitForEarlierWork) {
+    CapabilityNotifier notifier;
+    Gate busy;
+    Gate queued;
+    notifier.enqueue("busy", [&] { busy.hold(); });
+    busy.waitEntered();
+    notifier.enqueue("other_target", [&] { queued.hold(); });
+    const auto ticket = notifier.enqueueUrgent("mod", [] {});
+
+    busy.release();
+    // The restriction for other_target is still blocked; mod's token is not
+    // behind it.
+    notifier.wait(ticket);
+    queued.waitEntered();
+    queued.release();
+    notifier.drain();
+    notifier.wait(0);
+}
+
+TEST(CapabilityNotifier, WaitForIgnoresLaterWorkForOtherModules) {
+    CapabilityNotifier notifier;
+    Gate gate;
+    notifier.enqueue("mod", [] {});
+    notifier.waitFor("mod");
+
+    notifier.enqueue("other", [&] { gate.hold(); });
+    gate.waitEntered();
+    // Nothing new is outstanding for "mod", so this must not block on "other".
+    notifier.waitFor("mod");
+    gate.release();
+    notifier.drain();
+}
+
+TEST(CapabilityNotifier, CancelPendingDropsQueuedTasksAndReleasesBarriers) {
+    CapabilityNotifier notifier;
+    Gate gate;
+    std::atomic<int> ran{0};
+
+    notifier.enqueue("first", [&] { gate.hold(); ++ran; });
+    gate.waitEntered();
+    notifier.enqueue("dropped", [&] { ++ran; });
+    notifier.enqueue("dropped", [&] { ++ran; });
+
+    std::thread canceller([&] { notifier.cancelPending(); });
+    // cancelPending waits for the in-flight task; let it finish.
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    gate.release();
+    canceller.join();
+
+    EXPECT_EQ(ran.load(), 1);
+    EXPECT_EQ(notifier.pending(), 0u);
+    // The dropped module's barrier must not hang.
+    notifier.waitFor("dropped");
+}
+
+TEST(CapabilityNotifier, ThrowingTaskDoesNotStallThePipeline) {
+    CapabilityNotifier notifier;
+    std::atomic<bool> after{false};
+    notifier.enqueue("bad", [] { throw std::runtime_error("rpc failed"); });
+    notifier.enqueue("good", [&] { after = true; });
+    notifier.waitFor("good");
+    EXPECT_TRUE(after.load());
+}
@@ -0,0 +1,418 @@
+// =============================================================================
+// Tests for per-module cgroup v2 placement (cgroup_manager.h), its wiring
+// into CompositeModuleLoader, and module stats read from the leaves.
+//
+// A temporary directory stands in for the delegated cgroup2 root. Unlike the
+// real cgroupfs, the kernel does not populate a new leaf's control files, so
+// each test pre-creates the ones it expects to be written or read.
+// =============================================================================
+#include <gtest/gtest.h>
+#include "cgroup_manager.h"
+#include "composite_module_loader.h"
+#include "fake_module_loader.h"
+#include <logos_container/module_container.h>
+#include <logos_module_loader/module_format_loader.h>
+#include <nlohmann/json.hpp>
+#include <signal.h>
+#include <spawn.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <optional>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <unordered_map>
+
+extern char** environ;
+
+using namespace LogosCore;
+namespace fs = std::filesystem;
+
+// Stubs — outside the anonymous namespace for the same Clang make_shared
+// reason as test_composite_module_loader.cpp, hence the distinct names.
+struct CgroupTestContainer : public ModuleContainer {
+    std::string id() const override { return "cgroup-test-container"; }
+    bool canHandle(const ModuleDescriptor&) const override { return true; }
+    bool launch(const ModuleDescriptor& desc, const std::string&, const std::vector<std::string>&,
+                std::function<void(const std::string&)> onTerminated,
+                LoadedModuleHandle& out) override {
+        out.name = desc.name;
+        out.pid = 4242;
+        exitCallback = std::move(onTerminated);
+        return true;
+    }
+    bool sendToken(const std::string&, const std::string&) override { return true; }
+    void terminate(const std::string&) override {}
+    void terminateAll() override {}
+    bool hasModule(const std::string&) const override { return true; }
+
+    std::function<void(const std::string&)> exitCallback;
+};
+
+// Runs each module as a real `sleep` child, so there is a live pid to place
+// and to stop; terminate() reaps it.
+struct CgroupSleepContainer : public ModuleContainer {
+    std::string id() const override { return "cgroup-sleep-container"; }
+    bool canHandle(const ModuleDescriptor&) const override { return true; }
+    bool launch(const ModuleDescriptor& desc, const std::string&, const std::vector<std::string>&,
+                std::function<void(const std::string&)>, LoadedModuleHandle& out) override {
+        char* argv[] = {(char*)"sleep", (char*)"30", nullptr};
+        pid_t pid = 0;
+        if (::posix_spawnp(&pid, "sleep", nullptr, nullptr, argv, environ) != 0)
+            return false;
+        out.name = desc.name;
+        out.pid = pid;
+        pids[desc.name] = pid;
+        return true;
+    }
+    bool sendToken(const std::string&, const std::string&) override { return true; }
+    void terminate(const std::string& name) override {
+        auto it = pids.find(name);
+        if (it == pids.end())
+            return;
+        ::kill(it->second, SIGKILL);
+        ::waitpid(it->second, nullptr, 0);
+        pids.erase(it);
+    }
+    void terminateAll() override {
+        while (!pids.empty())
+            terminate(pids.begin()->first);
+    }
+    bool hasModule(const std::string& name) const override { return pids.count(name) > 0; }
+    std::optional<int64_t> pid(const std::string& name) const override {
+        auto it = pids.find(name);
+        return it == pids.end() ? std::nullopt : std::optional<int64_t>(it->second);
+    }
+    std::unordered_map<std::string, int64_t> getAllPids() const override {
+        return {pids.begin(), pids.end()};
+    }
+
+    std::unordered_map<std::string, pid_t> pids;
+};
+
+struct CgroupTestLoader : public ModuleFormatLoader {
+    std::string id() const override { return "cgroup-test-loader"; }
+    bool canHandle(const ModuleDescriptor&) const override { return true; }
+    std::string resolveHostBinary(const ModuleDescriptor&) const override { return "/bin/true"; }
+    std::vector<std::string> buildArguments(const ModuleDescriptor&) const override { return {}; }
+};
+
+namespace {
+
+void writeText(const fs::path& path, const std::string& text) {
+    std::ofstream(path) << text;
+}
+
+std::string readText(const fs::path& path) {
+    std::ifstream in(path);
+    std::stringstream ss;
+    ss << in.rdbuf();
+    return ss.str();
+}
+
+// A fake delegated root offering cpu, memory and pids, with a pre-populated
+// leaf for each name in `leaves`.
+class FakeCgroupRoot {
+public:
+    explicit FakeCgroupRoot(const std::vector<std::string>& leaves = {}) {
+        char tmpl[] = "/tmp/logos_cgroup_XXXXXX";
+        root = ::mkdtemp(tmpl);
+        writeText(root / "cgroup.controllers", "cpuset cpu io memory pids\n");
+        writeText(root / "cgroup.subtree_control", "");
+        writeText(root / "cgroup.procs", "");
+        for (const auto& name : leaves)
+            addLeaf(name);
+    }
+    ~FakeCgroupRoot() { fs::remove_all(root); }
+
+    fs::path addLeaf(const std::string& name) {
+        const fs::path leaf = root / ("module-" + name);
+        fs::create_directories(leaf);
+        for (const char* f : {"cgroup.procs", "cpu.weight", "cpu.max", "memory.max",
+                              "memory.high", "pids.max"})
+            writeText(leaf / f, "");
+        return leaf;
+    }
+
+    fs::path root;
+};
+
+ModuleDescriptor descriptor(const std::string& name, nlohmann::json resources = nullptr) {
+    ModuleDescriptor desc;
+    desc.name = name;
+    if (!resources.is_null())
+        desc.rawMetadata["resources"] = std::move(resources);
+    return desc;
+}
+
+} // anonymous namespace
+
+// =============================================================================
+// CgroupLimits
+// =============================================================================
+
+TEST(CgroupLimits, ParsesUnitsAndCpuForms) {
+    auto l = CgroupLimits::fromJson({
+        {"cpu_weight", 200},
+        {"cpu_max", 0.5},
+        {"memory_max", "512M"},
+        {"memory_high", 1048576},
+        {"pids_max", 64},
+    });
+    EXPECT_EQ(l.cpuWeight, 200u);
+    EXPECT_EQ(l.cpuMax, "50000 100000");
+    EXPECT_EQ(l.memoryMax, 512ull << 20);
+    EXPECT_EQ(l.memoryHigh, 1048576u);
+    EXPECT_EQ(l.pidsMax, 64u);
+
+    EXPECT_EQ(CgroupLimits::fromJson({{"cpu_max", "max"}}).cpuMax, "max");
+    EXPECT_EQ(CgroupLimits::fromJson({{"cpu_max", "20000 50000"}}).cpuMax, "20000 50000");
+}
+
+TEST(CgroupLimits, MalformedValuesAreIgnored) {
+    auto l = CgroupLimits::fromJson({
+        {"cpu_weight", 0},
+        {"cpu_max", "lots"},
+        {"memory_max", "12Q"},
+        {"pids_max", -1},
+    });
+    EXPECT_TRUE(l.empty());
+    EXPECT_TRUE(CgroupLimits::fromJson("not an object").empty());
+}
+
+TEST(CgroupLimits, PolicyOverlaysMetadata) {
+    CgroupManager cg("/nonexistent");
+    cg.setPolicy({
+        {"default", {{"pids_max", 32}, {"cpu_weight", 50}}},
+        {"modules", {{"greedy", {{"memory_max", "1G"}}}}},
+    });
+
+    // Metadata beats the default; the per-module policy beats metadata.
+    auto l = cg.limitsFor(descriptor("greedy", {{"cpu_weight", 500}, {"memory_max", "4G"}}));
+    EXPECT_EQ(l.pidsMax, 32u);
+    EXPECT_EQ(l.cpuWeight, 500u);
+    EXPECT_EQ(l.memoryMax, 1ull << 30);
+
+    EXPECT_EQ(cg.limitsFor(descriptor("other")).cpuWeight, 50u);
+}
+
+// =============================================================================
+// CgroupManager
+// =============================================================================
+
+TEST(CgroupManager, InitFailsWithoutDelegation) {
+    CgroupManager cg("/nonexistent/cgroup/root");
+    EXPECT_FALSE(cg.init());
+}
+
+TEST(CgroupManager, InitEnablesOfferedControllers) {
+    FakeCgroupRoot fake;
+    CgroupManager cg(fake.root.string());
+    ASSERT_TRUE(cg.init());
+    EXPECT_TRUE(cg.hasController("cpu"));
+    EXPECT_TRUE(cg.hasController("memory"));
+    EXPECT_TRUE(cg.hasController("pids"));
+    EXPECT_FALSE(cg.hasController("io"));   // offered, but not ours to enable
+}
+
+TEST(CgroupManager, InitSkipsControllersNotOffered) {
+    FakeCgroupRoot fake;
+    writeText(fake.root / "cgroup.controllers", "cpu\n");
+    CgroupManager cg(fake.root.string());
+    ASSERT_TRUE(cg.init());
+    EXPECT_TRUE(cg.hasController("cpu"));
+    EXPECT_FALSE(cg.hasController("memory"));
+}
+
+TEST(CgroupManager, InitMovesItselfOutOfTheRoot) {
+    FakeCgroupRoot fake;
+    writeText(fake.root / "cgroup.procs", "1\n" + std::to_string(::getpid()) + "\n");
+    fs::create_directories(fake.root / "logos-core");
+    writeText(fake.root / "logos-core" / "cgroup.procs", "");
+
+    CgroupManager cg(fake.root.string());
+    ASSERT_TRUE(cg.init());
+    EXPECT_EQ(readText(fake.root / "logos-core" / "cgroup.procs"), std::to_string(::getpid()));
+}
+
+TEST(CgroupManager, PlaceWritesLimitsAndMovesPid) {
+    FakeCgroupRoot fake({"foo"});
+    CgroupManager cg(fake.root.string());
+    ASSERT_TRUE(cg.init());
+
+    ASSERT_TRUE(cg.place(descriptor("foo", {{"cpu_weight", 300}, {"memory_max", "64M"}, {"pids_max", 16}}),
+                         1234));
+    const fs::path leaf = fake.root / "module-foo";
+    EXPECT_EQ(cg.leafOf("foo"), leaf.string());
+    EXPECT_EQ(readText(leaf / "cgroup.procs"), "1234");
+    EXPECT_EQ(readText(leaf / "cpu.weight"), "300");
+    EXPECT_EQ(readText(leaf / "memory.max"), std::to_string(64ull << 20));
+    EXPECT_EQ(readText(leaf / "pids.max"), "16");
+    EXPECT_EQ(readText(leaf / "cpu.max"), "");   // unset: kernel default kept
+}
+
+TEST(CgroupManager, PlaceFailsGracefullyWhenPidCannotMove) {
+    FakeCgroupRoot fake;
+    CgroupManager cg(fake.root.string());
+    ASSERT_TRUE(cg.init());
+    // No leaf files: the fake has no kernel to create cgroup.procs.
+    EXPECT_FALSE(cg.place(descriptor("foo"), 1234));
+    EXPECT_FALSE(cg.leafOf("foo").has_value());
+    EXPECT_FALSE(cg.place(descriptor("bar"), 0));
+}
+
+TEST(CgroupManager, ReadsStatsFromTheLeaf) {
+    FakeCgroupRoot fake;
+    const fs::path leaf = fake.addLeaf("foo");
+    writeText(leaf / "cpu.stat",
+              "usage_usec 2500000\nuser_usec 2000000\nsystem_usec 500000\n"
+              "nr_periods 0\nnr_throttled 0\nthrottled_usec 1500\n");
+    writeText(leaf / "memory.current", "8388608\n");
+    writeText(leaf / "pids.current", "5\n");
+
+    CgroupManager cg(fake.root.string());
+    ASSERT_TRUE(cg.init());
+    ASSERT_TRUE(cg.place(descriptor("foo"), 77));
+
+    auto s = cg.stats("foo");
+    ASSERT_TRUE(s.has_value());
+    EXPECT_DOUBLE_EQ(s->cpuSeconds, 2.5);
+    EXPECT_DOUBLE_EQ(s->userSeconds, 2.0);
+    EXPECT_DOUBLE_EQ(s->systemSeconds, 0.5);
+    EXPECT_EQ(s->throttledUs, 1500u);
+    EXPECT_EQ(s->memoryBytes, 8388608u);
+    EXPECT_EQ(s->pids, 5u);
+
+    ASSERT_TRUE(cg.statsForPid(77).has_value());
+    EXPECT_FALSE(cg.statsForPid(78).has_value());
+    EXPECT_FALSE(cg.stats("bar").has_value());
+}
+
+TEST(CgroupManager, ReleaseForgetsTheLeaf) {
+    FakeCgroupRoot fake({"foo"});
+    CgroupManager cg(fake.root.string());
+    ASSERT_TRUE(cg.init());
+    ASSERT_TRUE(cg.place(descriptor("foo"), 1234));
+    cg.release("foo");
+    EXPECT_FALSE(cg.leafOf("foo").has_value());
+    cg.release("foo");   // idempotent
+}
+
+// =============================================================================
+// CompositeModuleLoader placement
+// =============================================================================
+
+TEST(CgroupPlacement, CompositeLoaderPlacesAndReleases) {
+    FakeCgroupRoot fake({"foo"});
+    auto cg = std::make_shared<CgroupManager>(fake.root.string());
+    ASSERT_TRUE(cg->init());
+
+    auto* rawContainer = new CgroupTestContainer;
+    std::shared_ptr<ModuleContainer> container(rawContainer);
+    std::shared_ptr<ModuleFormatLoader> loader(new CgroupTestLoader);
+    CompositeModuleLoader composite(container, loader);
+    composite.setCgroups(cg);
+
+    bool notified = false;
+    LoadedModuleHandle out;
+    ASSERT_TRUE(composite.load(descriptor("foo"), [&](const std::string&) { notified = true; }, out));
+    EXPECT_EQ(readText(fake.root / "module-foo" / "cgroup.procs"), "4242");
+    EXPECT_TRUE(cg->leafOf("foo").has_value());
+
+    // The process exiting on its own releases the leaf and still reaches
+    // the original callback.
+    ASSERT_TRUE(rawContainer->exitCallback);
+    rawContainer->exitCallback("foo");
+    EXPECT_TRUE(notified);
+    EXPECT_FALSE(cg->leafOf("foo").has_value());
+}
+
+TEST(CgroupPlacement, WithoutCgroupsLaunchIsUnchanged) {
+    std::shared_ptr<ModuleContainer> container(new CgroupTestContainer);
+    std::shared_ptr<ModuleFormatLoader> loader(new CgroupTestLoader);
+    CompositeModuleLoader composite(container, loader);
+    EXPECT_EQ(composite.cgroups(), nullptr);
+
+    LoadedModuleHandle out;
+    EXPECT_TRUE(composite.load(descriptor("foo"), nullptr, out));
+    EXPECT_EQ(out.pid, 4242);
+}
+
+// =============================================================================
+// Module stats
+// =============================================================================
+
+TEST(CgroupModuleStats, ModuleWithALeafIsReadFromItAlone) {
+    FakeCgroupRoot fake({"cg_stats"});
+    const fs::path leaf = fake.root / "module-cg_stats";
+    writeText(leaf / "cpu.stat", "usage_usec 2000000\nuser_usec 1500000\nsystem_usec 500000\n");
+    writeText(leaf / "memory.current", "8388608\n");
+    writeText(leaf / "pids.current", "3\n");
+
+    useOnlyLoader(std::make_shared<CompositeModuleLoader>(std::make_shared<CgroupSleepContainer>(),
+                                                          std::make_shared<CgroupTestLoader>()));
+    ASSERT_TRUE(ModuleManager::enableCgroups(fake.root.string(), ""));
+    logos_core_register_module("cg_stats", "/cgroup/cg_stats_plugin.so");
+    ASSERT_EQ(logos_core_load_module("cg_stats", false), 1);
+
+    auto stats = [] {
+        char* raw = logos_core_get_module_stats();
+        auto j = nlohmann::json::parse(raw);
+        delete[] raw;
+        return j;
+    };
+    auto first = stats();
+    ASSERT_EQ(first.size(), 1u);
+    EXPECT_EQ(first[0]["name"], "cg_stats");
+    EXPECT_DOUBLE_EQ(first[0]["cpu_time_seconds"].get<double>(), 2.0);
+    EXPECT_DOUBLE_EQ(first[0]["memory_mb"].get<double>(), 8.0);
+    EXPECT_DOUBLE_EQ(first[0]["cpu_percent"].get<double>(), 0.0);   // no baseline yet
+    EXPECT_EQ(first[0]["cgroup"]["path"], leaf.string());
+    EXPECT_FALSE(first[0].contains("threads"));   // /proc was not read
+
+    // CPU% comes from the leaf's usage between two reads.
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    writeText(leaf / "cpu.stat", "usage_usec 2010000\nuser_usec 1510000\nsystem_usec 500000\n");
+    auto second = stats();
+    ASSERT_EQ(second.size(), 1u);
+    EXPECT_GT(second[0]["cpu_percent"].get<double>(), 0.0);
+    EXPECT_DOUBLE_EQ(second[0]["cpu_time_seconds"].get<double>(), 2.01);
+
+    ModuleManager::disableCgroups();
+    restoreSubprocessLoader();
+}
+
+TEST(CgroupModuleStats, UpgradedModuleIsReadFromItsNewLeaf) {
+    FakeCgroupRoot fake({"cg_up", "cg_up_next"});
+    writeText(fake.root / "module-cg_up" / "cpu.stat", "usage_usec 1000000\n");
+    writeText(fake.root / "module-cg_up" / "memory.current", "4194304\n");
+    const fs::path next = fake.root / "module-cg_up_next";
+    writeText(next / "cpu.stat", "usage_usec 3000000\n");
+    writeText(next / "memory.current", "16777216\n");
+
+    useOnlyLoader(std::make_shared<CompositeModuleLoader>(std::make_shared<CgroupSleepContainer>(),
+                                                          std::make_shared<CgroupTestLoader>()));
+    ASSERT_TRUE(ModuleManager::enableCgroups(fake.root.string(),
+                                             R"({"modules": {"cg_up": {"pids_max": 32}}})"));
+    logos_core_register_module("cg_up", "/cgroup/cg_up_plugin.so");
+    ASSERT_EQ(logos_core_load_module("cg_up", false), 1);
+    ASSERT_EQ(logos_core_upgrade_module("cg_up", nullptr), 1);
+
+    // The new process's leaf, under its container key, with the host
+    // policy's entry for the module.
+    EXPECT_EQ(readText(next / "pids.max"), "32");
+    char* raw = logos_core_get_module_stats();
+    auto stats = nlohmann::json::parse(raw);
+    delete[] raw;
+    ASSERT_EQ(stats.size(), 1u);
+    EXPECT_EQ(stats[0]["name"], "cg_up");
+    EXPECT_EQ(stats[0]["cgroup"]["path"], next.string());
+    EXPECT_DOUBLE_EQ(stats[0]["memory_mb"].get<double>(), 16.0);
+
+    ModuleManager::disableCgroups();
+    restoreSubprocessLoader();
+}
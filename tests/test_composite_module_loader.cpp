@@ -89,15 +89,27 @@ struct FakeLoader : public ModuleFormatLoader {
     bool canHandle(const ModuleDescriptor&) const override { return loaderCanHandle; }
 
     std::string resolveHostBinary(const ModuleDescriptor&) const override {
+        resolveCalls++;
         return hostBinary;
     }
 
     std::vector<std::string> buildArguments(const ModuleDescriptor& desc) const override {
-        return {"--name", desc.name, "--path", desc.path};
+        buildCalls++;
+        std::vector<std::string> args = {"--name", desc.name, "--path", desc.path};
+        if (!desc.instancePersistencePath.empty())
+            args.push_back("--instance-persistence-path=" + desc.instancePersistencePath);
+        if (nameLengthArg)
+            args.push_back(std::to_string(desc.name.size()));
+        if (auto it = desc.loaderConfig.find("replica_of"); it != desc.loaderConfig.end())
+            args.push_back("--replica-of=" + it->get<std::string>());
+        return args;
     }
 
     bool loaderCanHandle = true;
+    bool nameLengthArg = false;   // an argument derived from a field: not templatable
     std::string hostBinary = "/usr/bin/fake_host";
+    mutable int resolveCalls = 0;
+    mutable int buildCalls = 0;
 };
 
 class CompositeModuleLoaderTest : public ::testing::Test {
@@ -185,6 +197,162 @@ TEST_F(CompositeModuleLoaderTest, Load_FailsWhenContainerLaunchFails) {
     EXPECT_FALSE(composite->load(desc, nullptr, handle));
 }
 
+// ---------------------------------------------------------------------------
+// load: host binary and argument template are memoized
+// ---------------------------------------------------------------------------
+
+TEST_F(CompositeModuleLoaderTest, Load_ResolvesHostOncePerFormatAndVariant) {
+    for (const char* name : {"m1", "m2", "m3"}) {
+        ModuleDescriptor desc;
+        desc.name = name;
+        desc.format = "fake";
+        LoadedModuleHandle h;
+        ASSERT_TRUE(composite->load(desc, nullptr, h));
+    }
+    EXPECT_EQ(loader->resolveCalls, 1);
+
+    ModuleDescriptor portable;
+    portable.name = "m4";
+    portable.format = "fake";
+    portable.loaderConfig["variant"] = "portable";
+    LoadedModuleHandle h;
+    ASSERT_TRUE(composite->load(portable, nullptr, h));
+    EXPECT_EQ(loader->resolveCalls, 2);
+
+    composite->clearLaunchCache();
+    ModuleDescriptor again;
+    again.name = "m5";
+    again.format = "fake";
+    ASSERT_TRUE(composite->load(again, nullptr, h));
+    EXPECT_EQ(loader->resolveCalls, 3);
+}
+
+TEST_F(CompositeModuleLoaderTest, Load_UnresolvedOrFailedHostIsResolvedAgain) {
+    loader->hostBinary = "";
+    ModuleDescriptor desc;
+    desc.name = "late";
+    LoadedModuleHandle h;
+    EXPECT_FALSE(composite->load(desc, nullptr, h));
+    loader->hostBinary = "/usr/bin/fake_host";
+    EXPECT_TRUE(composite->load(desc, nullptr, h));
+    EXPECT_EQ(loader->resolveCalls, 2);
+
+    container->launchShouldSucceed = false;
+    EXPECT_FALSE(composite->load(desc, nullptr, h));
+    container->launchShouldSucceed = true;
+    EXPECT_TRUE(composite->load(desc, nullptr, h));
+    EXPECT_EQ(loader->resolveCalls, 3);
+}
+
+TEST_F(CompositeModuleLoaderTest, Load_FillsArgumentTemplatePerModule) {
+    ModuleDescriptor a;
+    a.name = "mod_a";
+    a.path = "/lib/mod_a.so";
+    a.instancePersistencePath = "/state/mod_a";
+    ModuleDescriptor b;
+    b.name = "mod_bb";
+    b.path = "/lib/mod_bb.so";
+    b.instancePersistencePath = "/state/mod_bb";
+    ModuleDescriptor d;
+    d.name = "mod_ddd";
+    d.path = "/lib/mod_ddd.so";
+    d.instancePersistencePath = "/state/mod_ddd";
+    ModuleDescriptor c;   // no persistence path: its own template
+    c.name = "mod_c";
+    c.path = "/lib/mod_c.so";
+
+    // The first load of a key builds once, the second also builds the
+    // template, and later ones are filled in from it.
+    LoadedModuleHandle h;
+    ASSERT_TRUE(composite->load(a, nullptr, h));
+    EXPECT_EQ(loader->buildCalls, 1);
+    ASSERT_TRUE(composite->load(b, nullptr, h));
+    EXPECT_EQ(loader->buildCalls, 3);
+    ASSERT_TRUE(composite->load(d, nullptr, h));
+    EXPECT_EQ(loader->buildCalls, 3);
+    ASSERT_TRUE(composite->load(c, nullptr, h));
+    EXPECT_EQ(loader->buildCalls, 4);
+
+    ASSERT_EQ(container->launchCalls.size(), 4u);
+    EXPECT_EQ(container->launchCalls[0].args, loader->buildArguments(a));
+    EXPECT_EQ(container->launchCalls[1].args, loader->buildArguments(b));
+    EXPECT_EQ(container->launchCalls[2].args,
+              (std::vector<std::string>{"--name", "mod_ddd", "--path", "/lib/mod_ddd.so",
+                                        "--instance-persistence-path=/state/mod_ddd"}));
+    EXPECT_EQ(container->launchCalls[3].args,
+              (std::vector<std::string>{"--name", "mod_c", "--path", "/lib/mod_c.so"}));
+}
+
+TEST_F(CompositeModuleLoaderTest, Load_KeepsTemplatesForRecentKeysPastTheCap) {
+    // Distinct metadata per module: every module is its own key, as on a
+    // host with many modules.
+    auto module = [](int i) {
+        ModuleDescriptor desc;
+        desc.name = "mod_" + std::to_string(i);
+        desc.path = "/lib/mod_" + std::to_string(i) + ".so";
+        desc.rawMetadata["version"] = i;
+        return desc;
+    };
+    LoadedModuleHandle h;
+    for (int i = 0; i < 300; ++i)
+        ASSERT_TRUE(composite->load(module(i), nullptr, h));
+    EXPECT_EQ(loader->buildCalls, 300);   // loaded once: no template built
+
+    // Past the cap a key seen again still gets its template, and keeps it.
+    ASSERT_TRUE(composite->load(module(299), nullptr, h));
+    EXPECT_EQ(loader->buildCalls, 302);
+    ASSERT_TRUE(composite->load(module(299), nullptr, h));
+    EXPECT_EQ(loader->buildCalls, 302);
+    EXPECT_EQ(container->launchCalls.back().args,
+              (std::vector<std::string>{"--name", "mod_299", "--path", "/lib/mod_299.so"}));
+
+    // The oldest key was forgotten: its next load counts as a first one.
+    ASSERT_TRUE(composite->load(module(0), nullptr, h));
+    EXPECT_EQ(loader->buildCalls, 303);
+}
+
+TEST_F(CompositeModuleLoaderTest, Load_LoaderConfigKeysAreNotServedFromAnotherTemplate) {
+    ModuleDescriptor primary;
+    primary.name = "mod_a";
+    primary.path = "/lib/mod_a.so";
+    ModuleDescriptor replica = primary;
+    replica.name = "mod_a#1";
+    replica.loaderConfig["replica_of"] = "mod_a";
+    ModuleDescriptor other = replica;
+    other.name = "mod_b#1";
+    other.loaderConfig["replica_of"] = "mod_b";
+
+    LoadedModuleHandle h;
+    ASSERT_TRUE(composite->load(primary, nullptr, h));
+    ASSERT_TRUE(composite->load(replica, nullptr, h));
+    ASSERT_TRUE(composite->load(other, nullptr, h));
+
+    ASSERT_EQ(container->launchCalls.size(), 3u);
+    EXPECT_EQ(container->launchCalls[0].args,
+              (std::vector<std::string>{"--name", "mod_a", "--path", "/lib/mod_a.so"}));
+    EXPECT_EQ(container->launchCalls[1].args,
+              (std::vector<std::string>{"--name", "mod_a#1", "--path", "/lib/mod_a.so",
+                                        "--replica-of=mod_a"}));
+    EXPECT_EQ(container->launchCalls[2].args,
+              (std::vector<std::string>{"--name", "mod_b#1", "--path", "/lib/mod_a.so",
+                                        "--replica-of=mod_b"}));
+}
+
+TEST_F(CompositeModuleLoaderTest, Load_UntemplatableArgumentsAreBuiltPerLoad) {
+    loader->nameLengthArg = true;
+    ModuleDescriptor a;
+    a.name = "ab";
+    ModuleDescriptor b;
+    b.name = "abcd";
+    LoadedModuleHandle h;
+    ASSERT_TRUE(composite->load(a, nullptr, h));
+    ASSERT_TRUE(composite->load(b, nullptr, h));
+
+    ASSERT_EQ(container->launchCalls.size(), 2u);
+    EXPECT_EQ(container->launchCalls[0].args.back(), "2");
+    EXPECT_EQ(container->launchCalls[1].args.back(), "4");
+}
+
 // ---------------------------------------------------------------------------
 // sendToken, terminate, terminateAll delegate to container
 // ---------------------------------------------------------------------------
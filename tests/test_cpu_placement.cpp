@@ -0,0 +1,281 @@
+// =============================================================================
+// Tests for CPU affinity / NUMA placement (cpu_placement.h) and its wiring
+// into CompositeModuleLoader.
+//
+// Topologies are synthetic and affinity is applied through a recording
+// ApplyFn, except for one test that re-applies this process's own mask.
+// =============================================================================
+#include <gtest/gtest.h>
+#include "cpu_placement.h"
+#include "composite_module_loader.h"
+#include <logos_container/module_container.h>
+#include <logos_module_loader/module_format_loader.h>
+#include <nlohmann/json.hpp>
+#include <unistd.h>
+#include <filesystem>
+#include <fstream>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+#ifdef __linux__
+#include <sched.h>
+#endif
+
+using namespace LogosCore;
+namespace fs = std::filesystem;
+
+// Stubs — outside the anonymous namespace for the same Clang make_shared
+// reason as test_composite_module_loader.cpp, hence the distinct names.
+struct PlacementTestContainer : public ModuleContainer {
+    std::string id() const override { return "placement-test-container"; }
+    bool canHandle(const ModuleDescriptor&) const override { return true; }
+    bool launch(const ModuleDescriptor& desc, const std::string&, const std::vector<std::string>&,
+                std::function<void(const std::string&)>, LoadedModuleHandle& out) override {
+        out.name = desc.name;
+        out.pid = nextPid++;
+        return true;
+    }
+    bool sendToken(const std::string&, const std::string&) override { return true; }
+    void terminate(const std::string&) override {}
+    void terminateAll() override {}
+    bool hasModule(const std::string&) const override { return true; }
+
+    int64_t nextPid = 100;
+};
+
+struct PlacementTestLoader : public ModuleFormatLoader {
+    std::string id() const override { return "placement-test-loader"; }
+    bool canHandle(const ModuleDescriptor&) const override { return true; }
+    std::string resolveHostBinary(const ModuleDescriptor&) const override { return "/bin/true"; }
+    std::vector<std::string> buildArguments(const ModuleDescriptor&) const override { return {}; }
+};
+
+namespace {
+
+// Two 4-CPU nodes; CPU 3 is isolated.
+CpuTopology twoNodes() {
+    CpuTopology t;
+    t.online = {0, 1, 2, 3, 4, 5, 6, 7};
+    t.isolated = {3};
+    t.nodes = {{0, {0, 1, 2, 3}}, {1, {4, 5, 6, 7}}};
+    return t;
+}
+
+CpuTopology oneNode() {
+    CpuTopology t;
+    t.online = {0, 1, 2, 3};
+    t.nodes = {{0, {0, 1, 2, 3}}};
+    return t;
+}
+
+struct Recorder {
+    std::map<int64_t, std::vector<int>> applied;
+    bool succeed = true;
+
+    CpuPlacement::ApplyFn fn() {
+        return [this](int64_t pid, const std::vector<int>& cpus) {
+            if (!succeed) return false;
+            applied[pid] = cpus;
+            return true;
+        };
+    }
+};
+
+ModuleDescriptor descriptor(const std::string& name, nlohmann::json placement = nullptr) {
+    ModuleDescriptor desc;
+    desc.name = name;
+    if (!placement.is_null())
+        desc.rawMetadata["placement"] = std::move(placement);
+    return desc;
+}
+
+} // anonymous namespace
+
+// =============================================================================
+// CPU lists and topology
+// =============================================================================
+
+TEST(CpuList, ParsesRangesAndSingles) {
+    EXPECT_EQ(parseCpuList("0-3,8,10-11"), (std::vector<int>{0, 1, 2, 3, 8, 10, 11}));
+    EXPECT_EQ(parseCpuList(" 5 , 1-2 ,1"), (std::vector<int>{1, 2, 5}));
+    EXPECT_EQ(parseCpuList(""), std::vector<int>{});
+    EXPECT_FALSE(parseCpuList("3-1").has_value());
+    EXPECT_FALSE(parseCpuList("a").has_value());
+    EXPECT_FALSE(parseCpuList("1-").has_value());
+}
+
+TEST(CpuList, FormatsCompactRanges) {
+    EXPECT_EQ(formatCpuList({0, 1, 2, 3, 8, 10, 11}), "0-3,8,10-11");
+    EXPECT_EQ(formatCpuList({}), "");
+    EXPECT_EQ(formatCpuList({4}), "4");
+}
+
+TEST(CpuTopology, DetectsNodesFromSysfs) {
+    char tmpl[] = "/tmp/logos_sysfs_XXXXXX";
+    const fs::path root = ::mkdtemp(tmpl);
+    fs::create_directories(root / "devices/system/cpu");
+    fs::create_directories(root / "devices/system/node/node0");
+    fs::create_directories(root / "devices/system/node/node1");
+    fs::create_directories(root / "devices/system/node/node2");   // memory-only
+    std::ofstream(root / "devices/system/cpu/online") << "0-7\n";
+    std::ofstream(root / "devices/system/cpu/isolated") << "6-7\n";
+    std::ofstream(root / "devices/system/node/node0/cpulist") << "0-3\n";
+    std::ofstream(root / "devices/system/node/node1/cpulist") << "4-7\n";
+    std::ofstream(root / "devices/system/node/node2/cpulist") << "\n";
+
+    auto t = CpuTopology::detect(root.string());
+    fs::remove_all(root);
+
+    EXPECT_EQ(t.online.size(), 8u);
+    EXPECT_EQ(t.isolated, (std::vector<int>{6, 7}));
+    ASSERT_EQ(t.nodes.size(), 2u);
+    EXPECT_EQ(t.nodes[1].id, 1);
+    EXPECT_EQ(t.nodes[1].cpus, (std::vector<int>{4, 5, 6, 7}));
+}
+
+TEST(CpuTopology, FallsBackToOneNodeWithoutNumaInfo) {
+    char tmpl[] = "/tmp/logos_sysfs_XXXXXX";
+    const fs::path root = ::mkdtemp(tmpl);
+    fs::create_directories(root / "devices/system/cpu");
+    std::ofstream(root / "devices/system/cpu/online") << "0-1\n";
+
+    auto t = CpuTopology::detect(root.string());
+    fs::remove_all(root);
+
+    ASSERT_EQ(t.nodes.size(), 1u);
+    EXPECT_EQ(t.nodes[0].cpus, (std::vector<int>{0, 1}));
+}
+
+// =============================================================================
+// CpuPlacement
+// =============================================================================
+
+TEST(CpuPlacement, ExplicitCpusFromMetadata) {
+    Recorder rec;
+    CpuPlacement p(twoNodes(), rec.fn());
+    auto cpus = p.place(descriptor("a", {{"cpus", "1-2,9"}}), 10);   // 9 is offline
+    ASSERT_TRUE(cpus.has_value());
+    EXPECT_EQ(*cpus, (std::vector<int>{1, 2}));
+    EXPECT_EQ(rec.applied[10], (std::vector<int>{1, 2}));
+    EXPECT_EQ(p.assignmentOf("a")->node, -1);
+}
+
+TEST(CpuPlacement, NumaNodeSkipsIsolatedCpus) {
+    Recorder rec;
+    CpuPlacement p(twoNodes(), rec.fn());
+    auto cpus = p.place(descriptor("a", {{"numa_node", 0}}), 10);
+    ASSERT_TRUE(cpus.has_value());
+    EXPECT_EQ(*cpus, (std::vector<int>{0, 1, 2}));
+    EXPECT_EQ(p.assignmentOf("a")->node, 0);
+}
+
+TEST(CpuPlacement, IsolatedUsesHostIsolatedList) {
+    Recorder rec;
+    CpuPlacement p(twoNodes(), rec.fn());
+    EXPECT_EQ(p.place(descriptor("a", {{"isolated", true}}), 10), std::vector<int>{3});
+
+    CpuPlacement none(oneNode(), rec.fn());
+    EXPECT_FALSE(none.place(descriptor("a", {{"isolated", true}}), 11).has_value());
+}
+
+TEST(CpuPlacement, HostPolicyBeatsMetadataWhichBeatsDefault) {
+    Recorder rec;
+    CpuPlacement p(twoNodes(), rec.fn());
+    p.setPolicy({
+        {"default", {{"cpus", "7"}}},
+        {"modules", {{"pinned", {{"cpus", "5"}}}}},
+    });
+    EXPECT_EQ(p.place(descriptor("pinned", {{"cpus", "1"}}), 10), std::vector<int>{5});
+    EXPECT_EQ(p.place(descriptor("meta", {{"cpus", "1"}}), 11), std::vector<int>{1});
+    EXPECT_EQ(p.place(descriptor("plain"), 12), std::vector<int>{7});
+}
+
+TEST(CpuPlacement, NoneLeavesAffinityAlone) {
+    Recorder rec;
+    CpuPlacement p(twoNodes(), rec.fn());
+    EXPECT_FALSE(p.place(descriptor("a", {{"none", true}}), 10).has_value());
+    EXPECT_TRUE(rec.applied.empty());
+    EXPECT_FALSE(p.assignmentOf("a").has_value());
+}
+
+TEST(CpuPlacement, BalancerSpreadsAcrossNodes) {
+    Recorder rec;
+    CpuPlacement p(twoNodes(), rec.fn());
+    p.place(descriptor("a"), 10);
+    p.place(descriptor("b"), 11);
+    p.place(descriptor("c"), 12);
+    EXPECT_EQ(p.assignmentOf("a")->node, 0);
+    EXPECT_EQ(p.assignmentOf("b")->node, 1);
+    EXPECT_EQ(p.assignmentOf("c")->node, 0);
+
+    // Releasing frees a slot: one each after "a" goes (tie → lowest id), then
+    // node 1 is empty once "b" goes.
+    p.release("a");
+    p.place(descriptor("d"), 13);
+    EXPECT_EQ(p.assignmentOf("d")->node, 0);
+    p.release("b");
+    p.place(descriptor("e"), 14);
+    EXPECT_EQ(p.assignmentOf("e")->node, 1);
+}
+
+TEST(CpuPlacement, ExplicitNodeCountsTowardBalance) {
+    Recorder rec;
+    CpuPlacement p(twoNodes(), rec.fn());
+    p.place(descriptor("pinned", {{"numa_node", 0}}), 10);
+    p.place(descriptor("auto"), 11);
+    EXPECT_EQ(p.assignmentOf("auto")->node, 1);
+}
+
+TEST(CpuPlacement, BalancerIsIdleOnSingleNodeHosts) {
+    Recorder rec;
+    CpuPlacement p(oneNode(), rec.fn());
+    EXPECT_FALSE(p.place(descriptor("a"), 10).has_value());
+    EXPECT_TRUE(rec.applied.empty());
+}
+
+TEST(CpuPlacement, FailedApplyLeavesNoAssignment) {
+    Recorder rec;
+    rec.succeed = false;
+    CpuPlacement p(twoNodes(), rec.fn());
+    EXPECT_FALSE(p.place(descriptor("a"), 10).has_value());
+    EXPECT_FALSE(p.assignmentOf("a").has_value());
+}
+
+#ifdef __linux__
+TEST(CpuPlacement, AppliesAffinityToOwnProcess) {
+    cpu_set_t original;
+    ASSERT_EQ(::sched_getaffinity(0, sizeof(original), &original), 0);
+    std::vector<int> cpus;
+    for (int c = 0; c < CPU_SETSIZE; ++c)
+        if (CPU_ISSET(c, &original)) cpus.push_back(c);
+
+    // Re-applying the current mask exercises the per-thread walk without
+    // changing anything for the rest of the suite.
+    EXPECT_TRUE(CpuPlacement::applyAffinity(static_cast<int64_t>(::getpid()), cpus));
+    EXPECT_FALSE(CpuPlacement::applyAffinity(static_cast<int64_t>(::getpid()), {}));
+}
+#endif
+
+// =============================================================================
+// CompositeModuleLoader placement
+// =============================================================================
+
+TEST(CpuPlacementWiring, CompositeLoaderPinsAfterLaunchAndReleases) {
+    Recorder rec;
+    auto placement = std::make_shared<CpuPlacement>(twoNodes(), rec.fn());
+
+    std::shared_ptr<ModuleContainer> container(new PlacementTestContainer);
+    std::shared_ptr<ModuleFormatLoader> loader(new PlacementTestLoader);
+    CompositeModuleLoader composite(container, loader);
+    composite.setPlacement(placement);
+
+    LoadedModuleHandle out;
+    ASSERT_TRUE(composite.load(descriptor("a", {{"cpus", "4-5"}}), nullptr, out));
+    EXPECT_EQ(rec.applied[out.pid], (std::vector<int>{4, 5}));
+    EXPECT_TRUE(placement->assignmentOf("a").has_value());
+
+    composite.terminate("a");
+    EXPECT_FALSE(placement->assignmentOf("a").has_value());
+}
@@ -0,0 +1,237 @@
+// =============================================================================
+// Tests for the binary lifecycle event journal (event_journal.h) and its C API,
+// logos_core_start_event_journal / logos_core_stop_event_journal.
+//
+// Round-trips records through the file and the decoder, checks overflow and
+// concurrent appends, and drives module loads through a FakeModuleLoader to
+// see the lifecycle hooks land. No child processes.
+// =============================================================================
+#include <gtest/gtest.h>
+#include "logos_core.h"
+#include "fake_module_loader.h"
+#include "event_journal.h"
+#include <nlohmann/json.hpp>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <map>
+#include <string>
+#include <thread>
+#include <unordered_set>
+#include <vector>
+#include <unistd.h>
+
+namespace fs = std::filesystem;
+using namespace LogosCore;
+
+namespace {
+
+std::string journalPath(const char* tag) {
+    return (fs::temp_directory_path() /
+            ("logos_journal_" + std::string(tag) + "_" + std::to_string(::getpid()) + ".bin"))
+        .string();
+}
+
+std::string nameOf(const EventJournal::Journal& journal, const EventJournal::Record& rec) {
+    auto it = journal.names.find(rec.moduleId);
+    return it != journal.names.end() ? it->second : std::string();
+}
+
+} // anonymous namespace
+
+class EventJournalTest : public ::testing::Test {
+protected:
+    std::string path;
+
+    void SetUp() override {
+        logos_core_stop_event_journal();
+        path = journalPath(::testing::UnitTest::GetInstance()->current_test_info()->name());
+    }
+
+    void TearDown() override {
+        logos_core_stop_event_journal();
+        std::remove(path.c_str());
+    }
+
+    EventJournal::Journal readBack() {
+        std::string error;
+        auto journal = EventJournal::read(path, &error);
+        EXPECT_TRUE(journal.has_value()) << error;
+        return journal ? std::move(*journal) : EventJournal::Journal{};
+    }
+};
+
+TEST_F(EventJournalTest, DisabledByDefault) {
+    EXPECT_FALSE(EventJournal::enabled());
+    EXPECT_EQ(EventJournal::moduleId("mod"), 0u);
+    EXPECT_EQ(logos_core_stop_event_journal(), 0);
+}
+
+TEST_F(EventJournalTest, StartTwiceFailsAndEmptyPathIsRejected) {
+    EXPECT_EQ(logos_core_start_event_journal("", 0), 0);
+    ASSERT_EQ(logos_core_start_event_journal(path.c_str(), 16), 1);
+    EXPECT_EQ(logos_core_start_event_journal(path.c_str(), 16), 0);
+    EXPECT_EQ(logos_core_stop_event_journal(), 1);
+    EXPECT_EQ(logos_core_stop_event_journal(), 0);
+}
+
+TEST_F(EventJournalTest, RoundTripsRecordsAndLongNames) {
+    const std::string longName = "a_module_name_longer_than_one_chunk";
+    ASSERT_TRUE(EventJournal::start(path, 64));
+    {
+        EventJournal::Scope scope(EventJournal::Event::Unload, longName);
+        scope.setResult(EventJournal::Failed);
+        scope.setAux(7);
+    }
+    EventJournal::record(EventJournal::Event::ProtocolGate, "gate", EventJournal::GateRefuse, 3);
+    ASSERT_TRUE(EventJournal::stop());
+
+    auto journal = readBack();
+    EXPECT_EQ(journal.header.pid, static_cast<uint32_t>(::getpid()));
+    EXPECT_EQ(journal.header.dropped, 0u);
+    ASSERT_EQ(journal.records.size(), 2u);
+
+    const auto& unload = journal.records[0];
+    EXPECT_EQ(unload.type, static_cast<uint16_t>(EventJournal::Event::Unload));
+    EXPECT_EQ(nameOf(journal, unload), longName);
+    EXPECT_EQ(unload.result, EventJournal::Failed);
+    EXPECT_EQ(unload.aux, 7u);
+
+    const auto& gate = journal.records[1];
+    EXPECT_EQ(nameOf(journal, gate), "gate");
+    EXPECT_STREQ(EventJournal::resultName(gate.type, gate.result), "refuse");
+    EXPECT_EQ(gate.aux, 3u);
+    EXPECT_GE(gate.timestampNs, unload.timestampNs + unload.durationNs);
+
+    // The file is trimmed to what was written: 3 name chunks + 1 name + 2 events.
+    EXPECT_EQ(fs::file_size(path), sizeof(EventJournal::FileHeader) + 6 * sizeof(EventJournal::Record));
+}
+
+TEST_F(EventJournalTest, CountsDropsOnceFull) {
+    ASSERT_TRUE(EventJournal::start(path, 4));
+    for (int i = 0; i < 10; ++i)
+        EventJournal::record(EventJournal::Event::Load, "m");   // 1 name + 3 events fit
+    EXPECT_EQ(EventJournal::dropped(), 7u);
+    ASSERT_TRUE(EventJournal::stop());
+
+    auto journal = readBack();
+    EXPECT_EQ(journal.header.written, 4u);
+    EXPECT_EQ(journal.header.dropped, 7u);
+    EXPECT_EQ(journal.records.size(), 3u);
+}
+
+TEST_F(EventJournalTest, ConcurrentWritersLoseNothing) {
+    constexpr int kThreads = 8;
+    constexpr int kPerThread = 2000;
+    ASSERT_TRUE(EventJournal::start(path, kThreads * kPerThread + kThreads));
+    std::vector<std::thread> writers;
+    for (int t = 0; t < kThreads; ++t) {
+        writers.emplace_back([t] {
+            const std::string name = "w" + std::to_string(t);
+            for (int i = 0; i < kPerThread; ++i)
+                EventJournal::record(EventJournal::Event::TokenNotify, name, EventJournal::Ok,
+                                     static_cast<uint32_t>(i));
+        });
+    }
+    for (auto& w : writers)
+        w.join();
+    ASSERT_TRUE(EventJournal::stop());
+
+    auto journal = readBack();
+    EXPECT_EQ(journal.header.dropped, 0u);
+    ASSERT_EQ(journal.records.size(), static_cast<std::size_t>(kThreads * kPerThread));
+    std::map<std::string, uint64_t> auxSum;
+    for (const auto& rec : journal.records)
+        auxSum[nameOf(journal, rec)] += rec.aux;
+    ASSERT_EQ(auxSum.size(), static_cast<std::size_t>(kThreads));
+    for (const auto& [name, sum] : auxSum)
+        EXPECT_EQ(sum, uint64_t{kPerThread} * (kPerThread - 1) / 2) << name;
+}
+
+TEST_F(EventJournalTest, ModuleIdsAreSharedAcrossThreadsAndRenewedPerSession) {
+    ASSERT_TRUE(EventJournal::start(path, 64));
+    const uint32_t first = EventJournal::moduleId("a");
+    uint32_t fromOtherThread = 0;
+    std::thread([&] { fromOtherThread = EventJournal::moduleId("a"); }).join();
+    EXPECT_EQ(fromOtherThread, first);
+    ASSERT_TRUE(EventJournal::stop());
+
+    // A new session numbers names afresh; ids this thread cached for the
+    // last one must not leak into it.
+    ASSERT_TRUE(EventJournal::start(path, 64));
+    EventJournal::record(EventJournal::Event::TokenNotify, "b");
+    EventJournal::record(EventJournal::Event::TokenNotify, "a");
+    ASSERT_TRUE(EventJournal::stop());
+
+    auto journal = readBack();
+    ASSERT_EQ(journal.records.size(), 2u);
+    EXPECT_EQ(nameOf(journal, journal.records[0]), "b");
+    EXPECT_EQ(nameOf(journal, journal.records[1]), "a");
+}
+
+TEST_F(EventJournalTest, DecodesToJsonAndCsv) {
+    ASSERT_TRUE(EventJournal::start(path, 16));
+    EventJournal::record(EventJournal::Event::Load, "plain", EventJournal::NoLoader);
+    EventJournal::record(EventJournal::Event::Unload, "with,comma");
+    ASSERT_TRUE(EventJournal::stop());
+
+    auto journal = readBack();
+    auto doc = nlohmann::json::parse(EventJournal::toJson(journal));
+    ASSERT_EQ(doc["events"].size(), 2u);
+    EXPECT_EQ(doc["events"][0]["event"], "load");
+    EXPECT_EQ(doc["events"][0]["module"], "plain");
+    EXPECT_EQ(doc["events"][0]["result"], "no_loader");
+    EXPECT_EQ(doc["events"][1]["event"], "unload");
+    EXPECT_EQ(doc["events"][1]["result"], "ok");
+    // Wall-clock, not steady-clock, nanoseconds.
+    const int64_t wallNow = std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+    EXPECT_NEAR(static_cast<double>(doc["events"][0]["time_ns"].get<int64_t>()),
+                static_cast<double>(wallNow), 60e9);
+
+    const std::string csv = EventJournal::toCsv(journal);
+    EXPECT_EQ(csv.rfind("time_ns,event,module,duration_ns,result,aux\n", 0), 0u);
+    EXPECT_NE(csv.find(",load,plain,0,no_loader,0\n"), std::string::npos);
+    EXPECT_NE(csv.find(",unload,\"with,comma\",0,ok,0\n"), std::string::npos);
+}
+
+TEST_F(EventJournalTest, RejectsFilesThatAreNotJournals) {
+    { std::ofstream(path) << std::string(256, 'x'); }
+    std::string error;
+    EXPECT_FALSE(EventJournal::read(path, &error).has_value());
+    EXPECT_NE(error.find("not an event journal"), std::string::npos);
+    EXPECT_FALSE(EventJournal::read(path + ".missing", &error).has_value());
+}
+
+TEST_F(EventJournalTest, ModuleLifecycleIsJournaled) {
+    auto fake = std::make_shared<FakeModuleLoader>();
+    fake->rejectToken.insert("bad");
+    useOnlyLoader(fake);
+
+    logos_core_register_module("good", "/fake/good_plugin.so");
+    logos_core_register_module("bad", "/fake/bad_plugin.so");
+
+    ASSERT_EQ(logos_core_start_event_journal(path.c_str(), 0), 1);
+    EXPECT_EQ(logos_core_load_module("good", false), 1);
+    EXPECT_EQ(logos_core_load_module("bad", false), 0);
+    EXPECT_EQ(logos_core_unload_module("good", false), 1);
+    ASSERT_EQ(logos_core_stop_event_journal(), 1);
+
+    restoreSubprocessLoader();
+
+    auto journal = readBack();
+    std::vector<std::string> seen;
+    for (const auto& rec : journal.records)
+        seen.push_back(std::string(EventJournal::eventName(rec.type)) + ":" + nameOf(journal, rec) + ":"
+                       + EventJournal::resultName(rec.type, rec.result));
+    // Scopes are ordered by their start, so each load precedes its phases.
+    EXPECT_EQ(seen, (std::vector<std::string>{
+        "load:good:loaded",
+        "protocol_gate:good:allow_legacy",
+        "token_issued:good:ok",
+        "load:bad:token_rejected",
+        "protocol_gate:bad:allow_legacy",
+        "token_issued:bad:failed",
+        "unload:good:ok",
+    }));
+}
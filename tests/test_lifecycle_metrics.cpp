@@ -0,0 +1,208 @@
+// =============================================================================
+// Tests for the lifecycle latency histograms (lifecycle_metrics.h) and their
+// C API, logos_core_get_lifecycle_metrics().
+//
+// The histogram tests feed synthetic durations; the end-to-end tests drive
+// loads/unloads through a FakeModuleLoader, so no child processes are spawned.
+// =============================================================================
+#include <gtest/gtest.h>
+#include "logos_core.h"
+#include "fake_module_loader.h"
+#include "lifecycle_metrics.h"
+#include <nlohmann/json.hpp>
+#include <chrono>
+#include <memory>
+#include <string>
+#include <thread>
+#include <unordered_set>
+#include <vector>
+
+using namespace LogosCore;
+using namespace std::chrono_literals;
+using LifecycleMetrics::LatencyHistogram;
+using LifecycleMetrics::Phase;
+
+namespace {
+
+nlohmann::json metricsFromCApi() {
+    char* raw = logos_core_get_lifecycle_metrics();
+    EXPECT_NE(raw, nullptr);
+    auto j = nlohmann::json::parse(raw);
+    delete[] raw;
+    return j;
+}
+
+} // anonymous namespace
+
+// =============================================================================
+// LatencyHistogram
+// =============================================================================
+
+TEST(LatencyHistogram, BucketsArePowersOfTwoMicroseconds) {
+    EXPECT_EQ(LatencyHistogram::bucketUpperUs(0), 1u);
+    EXPECT_EQ(LatencyHistogram::bucketUpperUs(10), 1024u);
+    EXPECT_EQ(LatencyHistogram::bucketUpperUs(LifecycleMetrics::kBucketCount - 1), UINT64_MAX);
+}
+
+TEST(LatencyHistogram, RecordsCountSumMinMax) {
+    LatencyHistogram h;
+    h.record(3us);
+    h.record(100us);
+    h.record(1ms);
+
+    auto j = h.toJson();
+    EXPECT_EQ(j["count"], 3);
+    EXPECT_EQ(j["sum_us"], 1103);
+    EXPECT_EQ(j["min_us"], 3);
+    EXPECT_EQ(j["max_us"], 1000);
+    // 3us -> <=4, 100us -> <=128, 1000us -> <=1024
+    EXPECT_EQ(j["buckets"][2], 1);
+    EXPECT_EQ(j["buckets"][7], 1);
+    EXPECT_EQ(j["buckets"][10], 1);
+}
+
+TEST(LatencyHistogram, SubMicrosecondSampleLandsInFirstBucket) {
+    LatencyHistogram h;
+    h.record(200ns);
+    EXPECT_EQ(h.toJson()["buckets"][0], 1);
+    EXPECT_EQ(h.toJson()["min_us"], 1);
+}
+
+TEST(LatencyHistogram, HugeSampleLandsInOverflowBucket) {
+    LatencyHistogram h;
+    h.record(std::chrono::hours(1));
+    EXPECT_EQ(h.toJson()["buckets"][LifecycleMetrics::kBucketCount - 1], 1);
+}
+
+TEST(LatencyHistogram, QuantilesAreBucketUpperBoundsCappedAtMax) {
+    LatencyHistogram h;
+    for (int i = 0; i < 99; ++i) h.record(10us);   // bucket <=16
+    h.record(5000us);                              // bucket <=8192
+
+    EXPECT_EQ(h.quantileUs(0.50), 16u);
+    EXPECT_EQ(h.quantileUs(0.99), 16u);
+    // Top sample: the bucket bound (8192) is capped at the observed max.
+    EXPECT_EQ(h.quantileUs(1.0), 5000u);
+}
+
+TEST(LatencyHistogram, EmptyHistogramReportsZeros) {
+    LatencyHistogram h;
+    auto j = h.toJson();
+    EXPECT_EQ(j["count"], 0);
+    EXPECT_EQ(j["min_us"], 0);
+    EXPECT_EQ(j["p99_us"], 0);
+}
+
+TEST(LatencyHistogram, ConcurrentRecordsAreAllCounted) {
+    LatencyHistogram h;
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; ++t)
+        threads.emplace_back([&] { for (int i = 0; i < 1000; ++i) h.record(50us); });
+    for (auto& t : threads) t.join();
+    EXPECT_EQ(h.count(), 4000u);
+    EXPECT_EQ(h.toJson()["sum_us"], 200000);
+}
+
+// =============================================================================
+// Module lifecycle through ModuleManager and the C API
+// =============================================================================
+
+class LifecycleMetricsTest : public ::testing::Test {
+protected:
+    std::shared_ptr<FakeModuleLoader> fake;
+
+    void SetUp() override {
+        fake = std::make_shared<FakeModuleLoader>();
+        useOnlyLoader(fake);
+    }
+
+    void TearDown() override {
+        restoreSubprocessLoader();
+    }
+
+    void registerModule(const std::string& name) {
+        std::string path = "/fake/" + name + "_plugin.so";
+        logos_core_register_module(name.c_str(), path.c_str());
+    }
+};
+
+TEST_F(LifecycleMetricsTest, EmptyAfterClear) {
+    auto j = metricsFromCApi();
+    EXPECT_EQ(j["bucket_upper_us"].size(), LifecycleMetrics::kBucketCount);
+    EXPECT_TRUE(j["bucket_upper_us"].back().is_null());
+    EXPECT_TRUE(j["aggregate"].empty());
+    EXPECT_TRUE(j["modules"].empty());
+}
+
+TEST_F(LifecycleMetricsTest, SuccessfulLoadRecordsEveryPhase) {
+    registerModule("foo");
+    ASSERT_EQ(logos_core_load_module("foo", false), 1);
+
+    auto j = metricsFromCApi();
+    for (const char* phase : {"load.metadata_extraction", "load.protocol_gate",
+                              "load.loader_selection", "load.container_launch",
+                              "load.capability_barrier", "load.send_token",
+                              "load.token_save", "load.restriction_refresh",
+                              "load.total"}) {
+        SCOPED_TRACE(phase);
+        EXPECT_EQ(j["aggregate"][phase]["count"], 1);
+        EXPECT_EQ(j["modules"]["foo"][phase]["count"], 1);
+    }
+    // capability_module is not loaded, so nothing was sent to it.
+    EXPECT_FALSE(j["aggregate"].contains("load.capability_notify"));
+    EXPECT_EQ(j["counters"]["loads"], 1);
+    EXPECT_EQ(j["modules"]["foo"]["counters"]["loads"], 1);
+}
+
+TEST_F(LifecycleMetricsTest, FailedLaunchCountsPhaseButNotTotal) {
+    registerModule("bad");
+    fake->failOn.insert("bad");
+    ASSERT_EQ(logos_core_load_module("bad", false), 0);
+
+    auto j = metricsFromCApi();
+    EXPECT_EQ(j["modules"]["bad"]["load.container_launch"]["count"], 1);
+    EXPECT_FALSE(j["modules"]["bad"].contains("load.total"));
+    EXPECT_FALSE(j["modules"]["bad"].contains("load.send_token"));
+    EXPECT_EQ(j["modules"]["bad"]["counters"]["load_failures"], 1);
+}
+
+TEST_F(LifecycleMetricsTest, AlreadyLoadedNoOpIsNotTimed) {
+    registerModule("foo");
+    ASSERT_EQ(logos_core_load_module("foo", false), 1);
+    ASSERT_EQ(logos_core_load_module("foo", false), 1);
+
+    EXPECT_EQ(metricsFromCApi()["modules"]["foo"]["load.total"]["count"], 1);
+}
+
+TEST_F(LifecycleMetricsTest, UnloadRecordsTerminateAndTotal) {
+    registerModule("foo");
+    ASSERT_EQ(logos_core_load_module("foo", false), 1);
+    ASSERT_EQ(logos_core_unload_module("foo", false), 1);
+
+    auto j = metricsFromCApi();
+    EXPECT_EQ(j["modules"]["foo"]["unload.terminate"]["count"], 1);
+    EXPECT_EQ(j["modules"]["foo"]["unload.total"]["count"], 1);
+}
+
+TEST_F(LifecycleMetricsTest, AggregateSumsAcrossModules) {
+    registerModule("a");
+    registerModule("b");
+    ASSERT_EQ(logos_core_load_module("a", false), 1);
+    ASSERT_EQ(logos_core_load_module("b", false), 1);
+
+    auto j = metricsFromCApi();
+    EXPECT_EQ(j["aggregate"]["load.total"]["count"], 2);
+    EXPECT_EQ(j["modules"]["a"]["load.total"]["count"], 1);
+    EXPECT_EQ(j["modules"]["b"]["load.total"]["count"], 1);
+}
+
+TEST_F(LifecycleMetricsTest, ClearResetsMetrics) {
+    registerModule("foo");
+    ASSERT_EQ(logos_core_load_module("foo", false), 1);
+    logos_core_terminate_all();
+    logos_core_clear();
+
+    auto j = metricsFromCApi();
+    EXPECT_TRUE(j["aggregate"].empty());
+    EXPECT_TRUE(j["modules"].empty());
+}
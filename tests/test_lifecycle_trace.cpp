@@ -0,0 +1,162 @@
+// =============================================================================
+// Tests for the opt-in Chrome trace-event recorder (lifecycle_trace.h) and its
+// C API, logos_core_start_trace / logos_core_stop_trace.
+//
+// Checks the written file is valid trace-event JSON, that spans from other
+// threads are captured, and that module loads driven through a
+// FakeModuleLoader show up as per-phase spans. No child processes.
+// =============================================================================
+#include <gtest/gtest.h>
+#include "logos_core.h"
+#include "fake_module_loader.h"
+#include "lifecycle_trace.h"
+#include <nlohmann/json.hpp>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <set>
+#include <string>
+#include <thread>
+#include <unordered_set>
+#include <unistd.h>
+
+namespace fs = std::filesystem;
+using namespace LogosCore;
+
+namespace {
+
+std::string tracePath(const char* tag) {
+    return (fs::temp_directory_path() /
+            ("logos_trace_" + std::string(tag) + "_" + std::to_string(::getpid()) + ".json"))
+        .string();
+}
+
+nlohmann::json readTrace(const std::string& path) {
+    std::ifstream in(path);
+    EXPECT_TRUE(in.good()) << path;
+    return nlohmann::json::parse(in);
+}
+
+std::set<std::string> spanNames(const nlohmann::json& doc) {
+    std::set<std::string> names;
+    for (const auto& ev : doc["traceEvents"])
+        if (ev["ph"] == "X") names.insert(ev["name"].get<std::string>());
+    return names;
+}
+
+} // anonymous namespace
+
+class LifecycleTraceTest : public ::testing::Test {
+protected:
+    std::string path;
+
+    void SetUp() override {
+        logos_core_stop_trace();
+        path = tracePath(::testing::UnitTest::GetInstance()->current_test_info()->name());
+    }
+
+    void TearDown() override {
+        logos_core_stop_trace();
+        std::remove(path.c_str());
+    }
+};
+
+TEST_F(LifecycleTraceTest, DisabledByDefault) {
+    EXPECT_FALSE(LifecycleTrace::enabled());
+    EXPECT_EQ(logos_core_stop_trace(), 0);
+}
+
+TEST_F(LifecycleTraceTest, StartTwiceFailsAndEmptyPathIsRejected) {
+    EXPECT_EQ(logos_core_start_trace(""), 0);
+    ASSERT_EQ(logos_core_start_trace(path.c_str()), 1);
+    EXPECT_EQ(logos_core_start_trace(path.c_str()), 0);
+    EXPECT_EQ(logos_core_stop_trace(), 1);
+}
+
+TEST_F(LifecycleTraceTest, WritesCompleteEvents) {
+    ASSERT_EQ(logos_core_start_trace(path.c_str()), 1);
+    { LifecycleTrace::Span span("unit_span", "test", "mod"); }
+    ASSERT_EQ(logos_core_stop_trace(), 1);
+
+    auto doc = readTrace(path);
+    ASSERT_TRUE(doc["traceEvents"].is_array());
+    bool found = false;
+    for (const auto& ev : doc["traceEvents"]) {
+        if (ev["name"] != "unit_span") continue;
+        found = true;
+        EXPECT_EQ(ev["ph"], "X");
+        EXPECT_EQ(ev["cat"], "test");
+        EXPECT_EQ(ev["args"]["module"], "mod");
+        EXPECT_GE(ev["dur"].get<int64_t>(), 0);
+        EXPECT_TRUE(ev.contains("ts"));
+        EXPECT_TRUE(ev.contains("pid"));
+        EXPECT_TRUE(ev.contains("tid"));
+    }
+    EXPECT_TRUE(found);
+}
+
+TEST_F(LifecycleTraceTest, SpansOutsideASessionAreNotRecorded) {
+    { LifecycleTrace::Span span("before", "test"); }
+    ASSERT_EQ(logos_core_start_trace(path.c_str()), 1);
+    { LifecycleTrace::Span span("during", "test"); }
+    ASSERT_EQ(logos_core_stop_trace(), 1);
+    { LifecycleTrace::Span span("after", "test"); }
+
+    auto names = spanNames(readTrace(path));
+    EXPECT_TRUE(names.count("during"));
+    EXPECT_FALSE(names.count("before"));
+    EXPECT_FALSE(names.count("after"));
+}
+
+TEST_F(LifecycleTraceTest, CapturesSpansFromExitedThreadsWithDistinctTids) {
+    ASSERT_EQ(logos_core_start_trace(path.c_str()), 1);
+    { LifecycleTrace::Span span("main_span", "test"); }
+    std::thread worker([] {
+        LifecycleTrace::setThreadName("worker");
+        LifecycleTrace::Span span("worker_span", "test");
+    });
+    worker.join();
+    ASSERT_EQ(logos_core_stop_trace(), 1);
+
+    auto doc = readTrace(path);
+    int64_t mainTid = -1, workerTid = -1;
+    bool named = false;
+    for (const auto& ev : doc["traceEvents"]) {
+        if (ev["name"] == "main_span") mainTid = ev["tid"];
+        if (ev["name"] == "worker_span") workerTid = ev["tid"];
+        if (ev["ph"] == "M" && ev["args"]["name"] == "worker") named = true;
+    }
+    ASSERT_NE(mainTid, -1);
+    ASSERT_NE(workerTid, -1);
+    EXPECT_NE(mainTid, workerTid);
+    EXPECT_TRUE(named);
+}
+
+TEST_F(LifecycleTraceTest, ModuleLoadEmitsPhaseAndResolverSpans) {
+    useOnlyLoader(std::make_shared<FakeModuleLoader>());
+
+    logos_core_register_module("a", "/fake/a_plugin.so");
+    logos_core_register_module("b", "/fake/b_plugin.so");
+    const char* deps[] = {"a"};
+    logos_core_register_module_dependencies("b", deps, 1);
+
+    ASSERT_EQ(logos_core_start_trace(path.c_str()), 1);
+    ASSERT_EQ(logos_core_load_module("b", true), 1);
+    ASSERT_EQ(logos_core_unload_module("b", false), 1);
+    ASSERT_EQ(logos_core_stop_trace(), 1);
+
+    restoreSubprocessLoader();
+
+    auto doc = readTrace(path);
+    auto names = spanNames(doc);
+    EXPECT_TRUE(names.count("resolve_dependencies"));
+    EXPECT_TRUE(names.count("load.container_launch"));
+    EXPECT_TRUE(names.count("load.total"));
+    EXPECT_TRUE(names.count("unload.total"));
+
+    std::set<std::string> loaded;
+    for (const auto& ev : doc["traceEvents"])
+        if (ev["name"] == "load.total") loaded.insert(ev["args"]["module"].get<std::string>());
+    EXPECT_EQ(loaded, (std::set<std::string>{"a", "b"}));
+}
@@ -0,0 +1,228 @@
+// =============================================================================
+// Tests for the load request scheduler (load_scheduler.h): admission by
+// priority class, aging of long-waiting requests, promotion of an interactive
+// request's dependency closure, and the priority-aware load path in
+// ModuleManager / logos_core_load_module_with_priority.
+// =============================================================================
+#include <gtest/gtest.h>
+#include "logos_core.h"
+#include "qt_test_adapter.h"
+#include "module_manager.h"
+#include "module_loader_registry.h"
+#include "module_loader.h"
+#include "load_scheduler.h"
+#include "subprocess_manager.h"
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <set>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace LogosCore;
+using namespace std::chrono_literals;
+
+namespace {
+
+// Runs requests against a scheduler on their own threads and records the
+// order they were admitted in.
+struct AdmissionLog {
+    LoadScheduler& scheduler;
+    std::mutex mutex;
+    std::vector<std::string> order;
+    std::vector<std::string> promoted;
+    std::vector<std::thread> threads;
+
+    explicit AdmissionLog(LoadScheduler& s) : scheduler(s) {}
+    ~AdmissionLog() { join(); }
+
+    // Queue a request and wait until it is actually waiting.
+    void submit(const std::string& label, LoadPriority priority, std::vector<std::string> modules) {
+        const std::size_t before = scheduler.queued();
+        threads.emplace_back([this, label, priority, modules = std::move(modules)]() mutable {
+            auto admission = scheduler.admit(priority, std::move(modules));
+            std::lock_guard lock(mutex);
+            order.push_back(label);
+            if (admission.promoted())
+                promoted.push_back(label);
+        });
+        waitFor([&] { return scheduler.queued() == before + 1; });
+    }
+
+    void join() {
+        for (auto& t : threads)
+            t.join();
+        threads.clear();
+    }
+
+    static void waitFor(const std::function<bool()>& done) {
+        const auto deadline = std::chrono::steady_clock::now() + 5s;
+        while (!done() && std::chrono::steady_clock::now() < deadline)
+            std::this_thread::sleep_for(1ms);
+        ASSERT_TRUE(done());
+    }
+};
+
+// Records load order; `gate` holds its load back until released.
+struct ScheduledLoader : public ModuleLoader {
+    std::string id() const override { return "scheduled"; }
+    bool canHandle(const ModuleDescriptor&) const override { return true; }
+    bool load(const ModuleDescriptor& desc,
+              std::function<void(const std::string&)>,
+              LoadedModuleHandle& out) override {
+        std::unique_lock lock(mutex);
+        if (desc.name == gate) {
+            entered = true;
+            cv.notify_all();
+            cv.wait(lock, [this] { return released; });
+        }
+        order.push_back(desc.name);
+        out.name = desc.name;
+        active.insert(desc.name);
+        return true;
+    }
+    bool sendToken(const std::string&, const std::string&) override { return true; }
+    void terminate(const std::string& name) override {
+        std::lock_guard lock(mutex);
+        active.erase(name);
+    }
+    void terminateAll() override {
+        std::lock_guard lock(mutex);
+        active.clear();
+    }
+    bool hasModule(const std::string& name) const override {
+        std::lock_guard lock(mutex);
+        return active.count(name) > 0;
+    }
+
+    void waitEntered() {
+        std::unique_lock lock(mutex);
+        cv.wait(lock, [this] { return entered; });
+    }
+    void release() {
+        std::lock_guard lock(mutex);
+        released = true;
+        cv.notify_all();
+    }
+
+    std::string gate;
+    mutable std::mutex mutex;
+    std::condition_variable cv;
+    bool entered = false;
+    bool released = false;
+    std::vector<std::string> order;
+    std::set<std::string> active;
+};
+
+} // anonymous namespace
+
+TEST(LoadScheduler, UncontendedRequestIsAdmittedImmediately) {
+    LoadScheduler scheduler;
+    auto admission = scheduler.admit(LoadPriority::Background, {"solo"});
+    EXPECT_EQ(admission.waited(), std::chrono::steady_clock::duration::zero());
+    EXPECT_FALSE(admission.promoted());
+    EXPECT_EQ(scheduler.queued(), 0u);
+}
+
+TEST(LoadScheduler, AdmitsByPriorityClassThenArrival) {
+    LoadScheduler scheduler(1h);
+    AdmissionLog log(scheduler);
+    {
+        auto running = scheduler.admit(LoadPriority::Normal, {"running"});
+        log.submit("bg1", LoadPriority::Background, {"a"});
+        log.submit("normal", LoadPriority::Normal, {"b"});
+        log.submit("bg2", LoadPriority::Background, {"c"});
+        log.submit("interactive", LoadPriority::Interactive, {"d"});
+    }
+    log.join();
+    EXPECT_EQ(log.order, (std::vector<std::string>{"interactive", "normal", "bg1", "bg2"}));
+    EXPECT_TRUE(log.promoted.empty());
+}
+
+TEST(LoadScheduler, AgingLetsOldBackgroundWorkGoFirst) {
+    LoadScheduler scheduler(10ms);
+    AdmissionLog log(scheduler);
+    {
+        auto running = scheduler.admit(LoadPriority::Normal, {"running"});
+        log.submit("old_background", LoadPriority::Background, {"a"});
+        std::this_thread::sleep_for(50ms);   // aged two classes: now interactive
+        log.submit("interactive", LoadPriority::Interactive, {"b"});
+    }
+    log.join();
+    EXPECT_EQ(log.order, (std::vector<std::string>{"old_background", "interactive"}));
+}
+
+TEST(LoadScheduler, InteractiveRequestPromotesItsDependencyClosure) {
+    LoadScheduler scheduler(1h);
+    AdmissionLog log(scheduler);
+    {
+        auto running = scheduler.admit(LoadPriority::Normal, {"running"});
+        log.submit("unrelated", LoadPriority::Normal, {"other"});
+        log.submit("dep_preload", LoadPriority::Background, {"dep"});
+        log.submit("click", LoadPriority::Interactive, {"dep", "app"});
+    }
+    log.join();
+    EXPECT_EQ(log.order, (std::vector<std::string>{"dep_preload", "click", "unrelated"}));
+    EXPECT_EQ(log.promoted, (std::vector<std::string>{"dep_preload"}));
+}
+
+class LoadSchedulerApiTest : public ::testing::Test {
+protected:
+    std::shared_ptr<ScheduledLoader> loader;
+
+    void SetUp() override {
+        logos_core_terminate_all();
+        logos_core_clear();
+        loader = std::make_shared<ScheduledLoader>();
+        ModuleManager::loaders().clearForTests();
+        ModuleManager::loaders().registerLoader(loader);
+    }
+
+    void TearDown() override {
+        logos_core_clear();
+        ModuleManager::loaders().clearForTests();
+        ModuleManager::loaders().registerLoader(std::make_shared<SubprocessManager>());
+    }
+
+    void registerModule(const std::string& name, const std::vector<std::string>& deps = {}) {
+        const std::string path = "/load_scheduler/" + name + "_plugin.so";
+        logos_core_register_module(name.c_str(), path.c_str());
+        std::vector<const char*> ptrs;
+        for (const auto& d : deps)
+            ptrs.push_back(d.c_str());
+        logos_core_register_module_dependencies(name.c_str(), ptrs.empty() ? nullptr : ptrs.data(),
+                                                static_cast<int>(ptrs.size()));
+    }
+};
+
+TEST_F(LoadSchedulerApiTest, InteractiveLoadOvertakesQueuedBackgroundLoads) {
+    registerModule("ls_blocker");
+    registerModule("ls_preload");
+    registerModule("ls_dep");
+    registerModule("ls_app", {"ls_dep"});
+    loader->gate = "ls_blocker";
+
+    std::thread blocker([] { EXPECT_EQ(logos_core_load_module("ls_blocker", false), 1); });
+    loader->waitEntered();
+    std::thread preload([] { EXPECT_EQ(logos_core_load_module_with_priority("ls_preload", false, 2), 1); });
+    AdmissionLog::waitFor([] { return ModuleManager::queuedLoadRequests() == 1; });
+    std::thread click([] { EXPECT_EQ(logos_core_load_module_with_priority("ls_app", true, 0), 1); });
+    AdmissionLog::waitFor([] { return ModuleManager::queuedLoadRequests() == 2; });
+
+    loader->release();
+    blocker.join();
+    preload.join();
+    click.join();
+    EXPECT_EQ(loader->order, (std::vector<std::string>{"ls_blocker", "ls_dep", "ls_app", "ls_preload"}));
+}
+
+TEST_F(LoadSchedulerApiTest, RejectsInvalidPriority) {
+    registerModule("ls_plain");
+    EXPECT_EQ(logos_core_load_module_with_priority("ls_plain", false, 3), 0);
+    EXPECT_EQ(logos_core_load_module_with_priority("ls_plain", false, -1), 0);
+    EXPECT_EQ(logos_core_is_module_loaded("ls_plain"), 0);
+    EXPECT_EQ(logos_core_load_module_with_priority("ls_plain", false, 1), 1);
+    EXPECT_EQ(logos_core_is_module_loaded("ls_plain"), 1);
+}
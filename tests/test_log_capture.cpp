@@ -0,0 +1,319 @@
+// =============================================================================
+// Tests for module stdout/stderr capture (log_capture.h) and its wiring into
+// CompositeModuleLoader.
+//
+// Lines are collected through an injected LineFn instead of the logger
+// channels. The end-to-end tests run the wrapped command with posix_spawn,
+// the way a container would.
+// =============================================================================
+#include <gtest/gtest.h>
+#include "log_capture.h"
+#include "composite_module_loader.h"
+#include <logos_container/module_container.h>
+#include <logos_module_loader/module_format_loader.h>
+#include <nlohmann/json.hpp>
+#include <chrono>
+#include <condition_variable>
+#include <filesystem>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include <fcntl.h>
+#include <spawn.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+extern char** environ;
+
+using namespace LogosCore;
+namespace fs = std::filesystem;
+
+// Records the command it was asked to launch. Outside the anonymous
+// namespace, as in test_composite_module_loader.cpp.
+struct CaptureTestContainer : public ModuleContainer {
+    std::string id() const override { return "capture-test-container"; }
+    bool canHandle(const ModuleDescriptor&) const override { return true; }
+    bool launch(const ModuleDescriptor& desc, const std::string& hostBinary, const std::vector<std::string>& args,
+                std::function<void(const std::string&)> onTerminated, LoadedModuleHandle& out) override {
+        host = hostBinary;
+        launchedArgs = args;
+        exited = std::move(onTerminated);
+        out.name = desc.name;
+        out.pid = 4242;
+        return succeed;
+    }
+    bool sendToken(const std::string&, const std::string&) override { return true; }
+    void terminate(const std::string&) override {}
+    void terminateAll() override {}
+    bool hasModule(const std::string&) const override { return true; }
+
+    bool succeed = true;
+    std::string host;
+    std::vector<std::string> launchedArgs;
+    std::function<void(const std::string&)> exited;
+};
+
+struct CaptureTestLoader : public ModuleFormatLoader {
+    std::string id() const override { return "capture-test-loader"; }
+    bool canHandle(const ModuleDescriptor&) const override { return true; }
+    std::string resolveHostBinary(const ModuleDescriptor&) const override { return "/opt/logos_host"; }
+    std::vector<std::string> buildArguments(const ModuleDescriptor&) const override { return {"--name", "x"}; }
+};
+
+#ifdef __linux__
+
+namespace {
+
+struct Collector {
+    struct Line {
+        std::string module;
+        LogCapture::Stream stream;
+        std::string text;
+    };
+
+    std::mutex mutex;
+    std::condition_variable cv;
+    std::vector<Line> lines;
+
+    LogCapture::LineFn fn() {
+        return [this](const std::string& module, LogCapture::Stream stream, std::string_view text) {
+            {
+                std::lock_guard lk(mutex);
+                lines.push_back({module, stream, std::string(text)});
+            }
+            cv.notify_all();
+        };
+    }
+
+    bool waitFor(std::size_t n) {
+        std::unique_lock lk(mutex);
+        return cv.wait_for(lk, std::chrono::seconds(5), [&] { return lines.size() >= n; });
+    }
+
+    std::vector<std::string> texts() {
+        std::lock_guard lk(mutex);
+        std::vector<std::string> out;
+        for (const auto& l : lines)
+            out.push_back(l.text);
+        return out;
+    }
+};
+
+void writeTo(const std::string& path, const std::string& data) {
+    const int fd = ::open(path.c_str(), O_WRONLY);
+    ASSERT_GE(fd, 0);
+    ASSERT_EQ(::write(fd, data.data(), data.size()), static_cast<ssize_t>(data.size()));
+    ::close(fd);
+}
+
+int spawnAndWait(const std::string& host, const std::vector<std::string>& args) {
+    std::vector<char*> argv;
+    argv.push_back(const_cast<char*>(host.c_str()));
+    for (const auto& a : args)
+        argv.push_back(const_cast<char*>(a.c_str()));
+    argv.push_back(nullptr);
+    pid_t pid = 0;
+    if (::posix_spawn(&pid, host.c_str(), nullptr, nullptr, argv.data(), environ) != 0)
+        return -1;
+    int status = 0;
+    ::waitpid(pid, &status, 0);
+    return WIFEXITED(status) ? WEXITSTATUS(status) : -1;
+}
+
+LogCaptureOptions unlimited() {
+    LogCaptureOptions o;
+    o.linesPerSecond = 0;
+    return o;
+}
+
+} // anonymous namespace
+
+TEST(LogCapture, SplitsLinesAndFlushesPartialOnClose) {
+    Collector c;
+    LogCapture capture(unlimited(), c.fn());
+    ASSERT_TRUE(capture.start());
+    auto redirect = capture.open("mod");
+    ASSERT_TRUE(redirect.has_value());
+
+    writeTo(redirect->stdoutPath, "one\ntwo\r\nthr");
+    writeTo(redirect->stdoutPath, "ee\npartial");
+    ASSERT_TRUE(c.waitFor(3));
+    capture.close("mod");
+
+    EXPECT_EQ(c.texts(), (std::vector<std::string>{"one", "two", "three", "partial"}));
+    EXPECT_FALSE(fs::exists(redirect->stdoutPath));
+    EXPECT_FALSE(capture.counters("mod").has_value());
+}
+
+TEST(LogCapture, SeparatesStreamsAndModules) {
+    Collector c;
+    LogCapture capture(unlimited(), c.fn());
+    ASSERT_TRUE(capture.start());
+    auto a = capture.open("a");
+    auto b = capture.open("b");
+    ASSERT_TRUE(a && b);
+
+    writeTo(a->stderrPath, "oops\n");
+    writeTo(b->stdoutPath, "hello\n");
+    ASSERT_TRUE(c.waitFor(2));
+    std::lock_guard lk(c.mutex);
+    for (const auto& line : c.lines) {
+        if (line.module == "a") {
+            EXPECT_EQ(line.stream, LogCapture::Stream::Stderr);
+            EXPECT_EQ(line.text, "oops");
+        } else {
+            EXPECT_EQ(line.module, "b");
+            EXPECT_EQ(line.stream, LogCapture::Stream::Stdout);
+            EXPECT_EQ(line.text, "hello");
+        }
+    }
+}
+
+TEST(LogCapture, SplitsOverlongLines) {
+    Collector c;
+    LogCaptureOptions o = unlimited();
+    o.maxLineBytes = 4;
+    LogCapture capture(o, c.fn());
+    ASSERT_TRUE(capture.start());
+    auto redirect = capture.open("mod");
+    ASSERT_TRUE(redirect);
+    writeTo(redirect->stdoutPath, "abcdefghij\n");
+    capture.close("mod");
+    EXPECT_EQ(c.texts(), (std::vector<std::string>{"abcd", "efgh", "ij"}));
+}
+
+TEST(LogCapture, RateLimitsPerModule) {
+    Collector c;
+    LogCaptureOptions o;
+    o.linesPerSecond = 0.001;   // effectively no refill during the test
+    o.burst = 3;
+    LogCapture capture(o, c.fn());
+    ASSERT_TRUE(capture.start());
+    auto redirect = capture.open("noisy");
+    ASSERT_TRUE(redirect);
+
+    std::string burst;
+    for (int i = 0; i < 10; ++i)
+        burst += "line " + std::to_string(i) + "\n";
+    writeTo(redirect->stdoutPath, burst);
+    ASSERT_TRUE(c.waitFor(3));
+    for (int i = 0; i < 100 && capture.counters("noisy")->lines < 10; ++i)
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+
+    auto counters = capture.counters("noisy");
+    EXPECT_EQ(counters->lines, 10u);
+    EXPECT_EQ(counters->suppressed, 7u);
+    EXPECT_EQ(c.texts().size(), 3u);
+}
+
+TEST(LogCapture, WritesRotatingFileUnthrottled) {
+    char tmpl[] = "/tmp/logos_capture_files_XXXXXX";
+    const fs::path dir = ::mkdtemp(tmpl);
+    Collector c;
+    LogCaptureOptions o;
+    o.fileDir = dir.string();
+    o.linesPerSecond = 0.001;
+    o.burst = 1;
+    o.maxFileBytes = 512;
+    o.maxFiles = 2;
+    {
+        LogCapture capture(o, c.fn());
+        ASSERT_TRUE(capture.start());
+        auto redirect = capture.open("mod");
+        ASSERT_TRUE(redirect);
+        std::string data;
+        for (int i = 0; i < 40; ++i)
+            data += "file line " + std::to_string(i) + "\n";
+        writeTo(redirect->stdoutPath, data);
+        capture.close("mod");
+    }
+    EXPECT_TRUE(fs::exists(dir / "mod.log"));
+    EXPECT_TRUE(fs::exists(dir / "mod.1.log"));
+    EXPECT_LE(fs::file_size(dir / "mod.log"), 512u);
+    EXPECT_EQ(c.texts().size(), 1u);
+    fs::remove_all(dir);
+}
+
+TEST(LogCapture, WrappedCommandRedirectsAChildProcess) {
+    Collector c;
+    LogCapture capture(unlimited(), c.fn());
+    ASSERT_TRUE(capture.start());
+    auto redirect = capture.open("child");
+    ASSERT_TRUE(redirect);
+
+    auto [host, args] = LogCapture::wrapCommand(*redirect, "/bin/sh", {"-c", "echo out; echo err >&2; exit 3"});
+    EXPECT_EQ(host, "/bin/sh");
+    EXPECT_EQ(spawnAndWait(host, args), 3);   // exit status passes through exec
+    capture.close("child");
+
+    std::lock_guard lk(c.mutex);
+    ASSERT_EQ(c.lines.size(), 2u);
+    for (const auto& line : c.lines)
+        EXPECT_EQ(line.text, line.stream == LogCapture::Stream::Stdout ? "out" : "err");
+}
+
+TEST(LogCapture, StaleCloseLeavesRestartedModuleAlone) {
+    Collector c;
+    LogCapture capture(unlimited(), c.fn());
+    ASSERT_TRUE(capture.start());
+    auto first = capture.open("mod");
+    auto second = capture.open("mod");
+    ASSERT_TRUE(first && second);
+    capture.close("mod", first->id);
+    EXPECT_TRUE(capture.counters("mod").has_value());
+    capture.close("mod", second->id);
+    EXPECT_FALSE(capture.counters("mod").has_value());
+}
+
+TEST(LogCaptureOptions, ParsesJson) {
+    auto o = LogCaptureOptions::fromJson({{"lines_per_second", 50}, {"file_dir", "/var/log/logos"}, {"max_files", 5}});
+    ASSERT_TRUE(o.has_value());
+    EXPECT_EQ(o->linesPerSecond, 50);
+    EXPECT_EQ(o->fileDir, "/var/log/logos");
+    EXPECT_EQ(o->maxFiles, 5u);
+    EXPECT_EQ(o->burst, LogCaptureOptions{}.burst);
+
+    EXPECT_TRUE(LogCaptureOptions::fromJson(nullptr).has_value());
+    EXPECT_FALSE(LogCaptureOptions::fromJson({{"max_files", "three"}}).has_value());
+    EXPECT_FALSE(LogCaptureOptions::fromJson(nlohmann::json::array()).has_value());
+}
+
+// =============================================================================
+// CompositeModuleLoader capture
+// =============================================================================
+
+TEST(LogCaptureWiring, CompositeLoaderWrapsLaunchAndClosesOnExit) {
+    auto capture = std::make_shared<LogCapture>(unlimited(), [](const std::string&, LogCapture::Stream, std::string_view) {});
+    ASSERT_TRUE(capture->start());
+
+    auto* container = new CaptureTestContainer;
+    std::shared_ptr<ModuleContainer> containerPtr(container);
+    std::shared_ptr<ModuleFormatLoader> loader(new CaptureTestLoader);
+    CompositeModuleLoader composite(containerPtr, loader);
+    composite.setLogCapture(capture);
+
+    ModuleDescriptor desc;
+    desc.name = "wrapped";
+    LoadedModuleHandle out;
+    ASSERT_TRUE(composite.load(desc, nullptr, out));
+    EXPECT_EQ(container->host, "/bin/sh");
+    ASSERT_EQ(container->launchedArgs.size(), 8u);
+    EXPECT_EQ(container->launchedArgs[5], "/opt/logos_host");
+    EXPECT_EQ(container->launchedArgs[6], "--name");
+    EXPECT_TRUE(capture->counters("wrapped").has_value());
+
+    container->exited("wrapped");
+    EXPECT_FALSE(capture->counters("wrapped").has_value());
+
+    container->succeed = false;
+    EXPECT_FALSE(composite.load(desc, nullptr, out));
+    EXPECT_FALSE(capture->counters("wrapped").has_value());
+
+    composite.setLogCapture(nullptr);
+    container->succeed = true;
+    ASSERT_TRUE(composite.load(desc, nullptr, out));
+    EXPECT_EQ(container->host, "/opt/logos_host");
+}
+
+#endif // __linux__
@@ -0,0 +1,271 @@
+// =============================================================================
+// Tests for the OpenMetrics exporter: the text renderer (openmetrics.h), the
+// local HTTP endpoint (metrics_exporter.h), and the ModuleManager / C API
+// wiring that feeds it lifecycle counters from real (fake-loader) loads.
+// =============================================================================
+#include <gtest/gtest.h>
+#include "logos_core.h"
+#include "fake_module_loader.h"
+#include "metrics_exporter.h"
+#include "openmetrics.h"
+#include <arpa/inet.h>
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <filesystem>
+#include <memory>
+#include <netinet/in.h>
+#include <string>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <thread>
+#include <unistd.h>
+#include <unordered_set>
+
+namespace fs = std::filesystem;
+using namespace LogosCore;
+using namespace std::chrono_literals;
+
+namespace {
+
+std::string readAll(int fd) {
+    std::string out;
+    char buf[4096];
+    ssize_t n;
+    while ((n = ::recv(fd, buf, sizeof(buf), 0)) > 0)
+        out.append(buf, static_cast<std::size_t>(n));
+    ::close(fd);
+    return out;
+}
+
+std::string httpGetTcp(int port, const std::string& path = "/metrics") {
+    int fd = ::socket(AF_INET, SOCK_STREAM, 0);
+    sockaddr_in addr{};
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    addr.sin_port = htons(static_cast<uint16_t>(port));
+    if (::connect(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0) {
+        ::close(fd);
+        return {};
+    }
+    const std::string req = "GET " + path + " HTTP/1.0\r\n\r\n";
+    ::send(fd, req.data(), req.size(), 0);
+    return readAll(fd);
+}
+
+std::string httpGetUnix(const std::string& sockPath) {
+    int fd = ::socket(AF_UNIX, SOCK_STREAM, 0);
+    sockaddr_un addr{};
+    addr.sun_family = AF_UNIX;
+    std::strncpy(addr.sun_path, sockPath.c_str(), sizeof(addr.sun_path) - 1);
+    if (::connect(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0) {
+        ::close(fd);
+        return {};
+    }
+    const std::string req = "GET /metrics HTTP/1.0\r\n\r\n";
+    ::send(fd, req.data(), req.size(), 0);
+    return readAll(fd);
+}
+
+bool contains(const std::string& haystack, const std::string& needle) {
+    return haystack.find(needle) != std::string::npos;
+}
+
+} // anonymous namespace
+
+// =============================================================================
+// renderOpenMetrics
+// =============================================================================
+
+TEST(OpenMetricsRender, EmptySampleHasGaugesAndEof) {
+    MetricsSample s;
+    const std::string text = renderOpenMetrics(s);
+    EXPECT_TRUE(contains(text, "# TYPE logos_core_modules_known gauge\n"));
+    EXPECT_TRUE(contains(text, "logos_core_modules_known 0\n"));
+    EXPECT_TRUE(contains(text, "logos_core_modules_loaded 0\n"));
+    ASSERT_GE(text.size(), 6u);
+    EXPECT_EQ(text.substr(text.size() - 6), "# EOF\n");
+}
+
+TEST(OpenMetricsRender, RendersCountersHistogramAndProcessStats) {
+    MetricsSample s;
+    s.knownModules = 3;
+    s.loadedModules = 1;
+    auto& a = s.lifecycle.modules["a"];
+    a.counters[static_cast<std::size_t>(LifecycleMetrics::Counter::Loads)] = 2;
+    a.counters[static_cast<std::size_t>(LifecycleMetrics::Counter::Restarts)] = 1;
+    auto& total = s.lifecycle.aggregate.phases[static_cast<std::size_t>(LifecycleMetrics::Phase::LoadTotal)];
+    total.count = 2;
+    total.sumUs = 3000;
+    total.buckets[10] = 1;   // <= 1024us
+    total.buckets[11] = 1;   // <= 2048us
+    a.phases[static_cast<std::size_t>(LifecycleMetrics::Phase::LoadTotal)] = total;
+    s.processes.push_back({"a", 42, 12.5, 1.25, 4096});
+
+    const std::string text = renderOpenMetrics(s);
+    EXPECT_TRUE(contains(text, "logos_core_modules_known 3\n"));
+    EXPECT_TRUE(contains(text, "# TYPE logos_core_module_loads counter\n"));
+    EXPECT_TRUE(contains(text, "logos_core_module_loads_total{module=\"a\"} 2\n"));
+    EXPECT_TRUE(contains(text, "logos_core_module_restarts_total{module=\"a\"} 1\n"));
+
+    // Histogram buckets are cumulative and end at +Inf == count.
+    EXPECT_TRUE(contains(text, "# TYPE logos_core_lifecycle_phase_seconds histogram\n"));
+    EXPECT_TRUE(contains(text, "logos_core_lifecycle_phase_seconds_bucket{phase=\"load.total\",le=\"0.001024\"} 1\n"));
+    EXPECT_TRUE(contains(text, "logos_core_lifecycle_phase_seconds_bucket{phase=\"load.total\",le=\"0.002048\"} 2\n"));
+    EXPECT_TRUE(contains(text, "logos_core_lifecycle_phase_seconds_bucket{phase=\"load.total\",le=\"+Inf\"} 2\n"));
+    EXPECT_TRUE(contains(text, "logos_core_lifecycle_phase_seconds_count{phase=\"load.total\"} 2\n"));
+    EXPECT_TRUE(contains(text, "logos_core_lifecycle_phase_seconds_sum{phase=\"load.total\"} 0.003\n"));
+    EXPECT_TRUE(contains(text, "logos_core_module_lifecycle_phase_seconds_count{module=\"a\",phase=\"load.total\"} 2\n"));
+
+    EXPECT_TRUE(contains(text, "logos_core_module_cpu_percent{module=\"a\"} 12.5\n"));
+    EXPECT_TRUE(contains(text, "logos_core_module_cpu_seconds_total{module=\"a\"} 1.25\n"));
+    EXPECT_TRUE(contains(text, "logos_core_module_memory_bytes{module=\"a\"} 4096\n"));
+}
+
+TEST(OpenMetricsRender, EscapesLabelValues) {
+    MetricsSample s;
+    s.processes.push_back({"we\"ird\\name", 1, 0, 0, 0});
+    EXPECT_TRUE(contains(renderOpenMetrics(s), "{module=\"we\\\"ird\\\\name\"}"));
+}
+
+TEST(OpenMetricsRender, RendersOnlyAvailableProcessDetail) {
+    MetricsSample s;
+    MetricsSample::ModuleProcess a{"a", 42, 0, 0, 0};
+    a.detail.fields = ProcessDetail::Threads | ProcessDetail::ContextSwitches | ProcessDetail::Io;
+    a.detail.threads = 7;
+    a.detail.voluntaryCtxSwitches = 10;
+    a.detail.involuntaryCtxSwitches = 2;
+    a.detail.ioReadBytes = 512;
+    a.detail.ioWriteBytes = 1024;
+    a.detail.pssBytes = 999;   // not flagged: must not be rendered
+    s.processes.push_back(a);
+
+    const std::string text = renderOpenMetrics(s);
+    EXPECT_TRUE(contains(text, "logos_core_module_threads{module=\"a\"} 7\n"));
+    EXPECT_TRUE(contains(text, "logos_core_module_context_switches_total{module=\"a\",kind=\"voluntary\"} 10\n"));
+    EXPECT_TRUE(contains(text, "logos_core_module_context_switches_total{module=\"a\",kind=\"involuntary\"} 2\n"));
+    EXPECT_TRUE(contains(text, "logos_core_module_io_bytes_total{module=\"a\",direction=\"write\"} 1024\n"));
+    EXPECT_TRUE(contains(text, "# TYPE logos_core_module_pss_bytes gauge\n"));
+    EXPECT_FALSE(contains(text, "logos_core_module_pss_bytes{"));
+    EXPECT_FALSE(contains(text, "logos_core_module_open_fds{"));
+}
+
+// =============================================================================
+// MetricsExporter endpoint
+// =============================================================================
+
+TEST(MetricsExporter, ServesCachedTextOverLoopbackTcp) {
+    std::atomic<int> renders{0};
+    MetricsExporter exporter([&] { ++renders; return std::string("x 1\n# EOF\n"); }, 1h);
+    ASSERT_TRUE(exporter.start("127.0.0.1:0"));
+    ASSERT_GT(exporter.boundPort(), 0);
+
+    const std::string resp = httpGetTcp(exporter.boundPort());
+    EXPECT_TRUE(contains(resp, "HTTP/1.0 200 OK\r\n"));
+    EXPECT_TRUE(contains(resp, "Content-Type: application/openmetrics-text"));
+    EXPECT_TRUE(contains(resp, "\r\n\r\nx 1\n# EOF\n"));
+
+    // Scrapes are served from the cache, not by re-rendering.
+    httpGetTcp(exporter.boundPort());
+    EXPECT_EQ(renders.load(), 1);
+}
+
+TEST(MetricsExporter, UnknownPathIs404) {
+    MetricsExporter exporter([] { return std::string("# EOF\n"); }, 1h);
+    ASSERT_TRUE(exporter.start("0"));
+    EXPECT_TRUE(contains(httpGetTcp(exporter.boundPort(), "/nope"), "404 Not Found"));
+}
+
+TEST(MetricsExporter, RefreshesOnInterval) {
+    std::atomic<int> renders{0};
+    MetricsExporter exporter([&] { return "n " + std::to_string(++renders) + "\n"; }, 20ms);
+    ASSERT_TRUE(exporter.start("127.0.0.1:0"));
+    for (int i = 0; i < 100 && renders.load() < 3; ++i)
+        std::this_thread::sleep_for(10ms);
+    EXPECT_GE(renders.load(), 3);
+    EXPECT_FALSE(contains(exporter.cachedText(), "n 1\n"));
+}
+
+TEST(MetricsExporter, ServesOverUnixSocketAndRemovesItOnStop) {
+    const std::string path = (fs::temp_directory_path() /
+        ("logos_metrics_" + std::to_string(::getpid()) + ".sock")).string();
+    {
+        MetricsExporter exporter([] { return std::string("u 1\n# EOF\n"); }, 1h);
+        ASSERT_TRUE(exporter.start("unix:" + path));
+        EXPECT_TRUE(fs::exists(path));
+        EXPECT_TRUE(contains(httpGetUnix(path), "u 1\n# EOF\n"));
+        EXPECT_EQ(exporter.boundPort(), 0);
+    }
+    EXPECT_FALSE(fs::exists(path));
+}
+
+TEST(MetricsExporter, RejectsNonLoopbackAndMalformedEndpoints) {
+    MetricsExporter exporter([] { return std::string(); }, 1h);
+    EXPECT_FALSE(exporter.start("0.0.0.0:9464"));
+    EXPECT_FALSE(exporter.start("example.com:9464"));
+    EXPECT_FALSE(exporter.start("notaport"));
+    EXPECT_FALSE(exporter.start("70000"));
+    EXPECT_FALSE(exporter.running());
+}
+
+TEST(MetricsExporter, StartTwiceFails) {
+    MetricsExporter exporter([] { return std::string(); }, 1h);
+    ASSERT_TRUE(exporter.start("0"));
+    EXPECT_FALSE(exporter.start("0"));
+    exporter.stop();
+    EXPECT_FALSE(exporter.running());
+}
+
+// =============================================================================
+// ModuleManager wiring
+// =============================================================================
+
+class MetricsExporterModuleTest : public ::testing::Test {
+protected:
+    std::shared_ptr<FakeModuleLoader> fake;
+
+    void SetUp() override {
+        fake = std::make_shared<FakeModuleLoader>();
+        useOnlyLoader(fake);
+    }
+
+    void TearDown() override {
+        logos_core_stop_metrics_exporter();
+        restoreSubprocessLoader();
+    }
+};
+
+TEST_F(MetricsExporterModuleTest, CountsLoadsFailuresUnloadsAndRestarts) {
+    logos_core_register_module("a", "/fake/a_plugin.so");
+    logos_core_register_module("bad", "/fake/bad_plugin.so");
+    fake->failOn.insert("bad");
+
+    ASSERT_EQ(logos_core_load_module("a", false), 1);
+    ASSERT_EQ(logos_core_unload_module("a", false), 1);
+    ASSERT_EQ(logos_core_load_module("a", false), 1);
+    ASSERT_EQ(logos_core_load_module("bad", false), 0);
+
+    const std::string text = ModuleManager::getOpenMetricsText();
+    EXPECT_TRUE(contains(text, "logos_core_modules_known 2\n"));
+    EXPECT_TRUE(contains(text, "logos_core_modules_loaded 1\n"));
+    EXPECT_TRUE(contains(text, "logos_core_module_loads_total{module=\"a\"} 2\n"));
+    EXPECT_TRUE(contains(text, "logos_core_module_unloads_total{module=\"a\"} 1\n"));
+    EXPECT_TRUE(contains(text, "logos_core_module_restarts_total{module=\"a\"} 1\n"));
+    EXPECT_TRUE(contains(text, "logos_core_module_load_failures_total{module=\"bad\"} 1\n"));
+}
+
+TEST_F(MetricsExporterModuleTest, CApiStartsAndStopsTheExporter) {
+    const std::string path = (fs::temp_directory_path() /
+        ("logos_metrics_capi_" + std::to_string(::getpid()) + ".sock")).string();
+    logos_core_register_module("a", "/fake/a_plugin.so");
+    ASSERT_EQ(logos_core_load_module("a", false), 1);
+
+    ASSERT_EQ(logos_core_start_metrics_exporter(path.c_str()), 1);
+    EXPECT_EQ(logos_core_start_metrics_exporter(path.c_str()), 0);
+
+    const std::string resp = httpGetUnix(path);
+    EXPECT_TRUE(contains(resp, "logos_core_module_loads_total{module=\"a\"} 1\n"));
+
+    logos_core_stop_metrics_exporter();
+    EXPECT_FALSE(fs::exists(path));
+}
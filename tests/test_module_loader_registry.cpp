@@ -6,6 +6,8 @@
 // =============================================================================
 #include <gtest/gtest.h>
 #include "module_loader_registry.h"
+#include <atomic>
+#include <thread>
 #include <string>
 #include <unordered_map>
 #include <vector>
@@ -26,6 +28,7 @@ struct FakeModuleLoader : public ModuleLoader {
     std::string id() const override { return m_id; }
 
     bool canHandle(const ModuleDescriptor& desc) const override {
+        ++canHandleCalls;
         if (m_handledFormat.empty()) return true; // accepts anything
         return desc.format == m_handledFormat;
     }
@@ -66,6 +69,7 @@ struct FakeModuleLoader : public ModuleLoader {
     std::vector<std::pair<std::string, std::string>>     sendTokenCalls;
     std::vector<std::string>                             terminateCalls;
     int                                                  terminateAllCount = 0;
+    mutable std::atomic<int>                             canHandleCalls{0};
 
     // Configurable pids for getAllPids()
     std::unordered_map<std::string, int64_t>             fakePids;
@@ -236,3 +240,89 @@ TEST(ModuleLoaderRegistryTest, ClearForTests_RemovesAllLoaders) {
     EXPECT_EQ(reg.select(desc), nullptr);
     EXPECT_NO_THROW(reg.terminateAll());
 }
+
+// =============================================================================
+// Selection memo
+// =============================================================================
+
+TEST(ModuleLoaderRegistryTest, SelectMemoizesPerFormatAndConfig) {
+    ModuleLoaderRegistry reg;
+    auto rtA = std::make_shared<FakeModuleLoader>("a", "wasm");
+    auto rtB = std::make_shared<FakeModuleLoader>("b", "qt-plugin");
+    reg.registerLoader(rtA);
+    reg.registerLoader(rtB);
+
+    ModuleDescriptor desc;
+    desc.format = "qt-plugin";
+    for (int i = 0; i < 5; ++i) {
+        desc.name = "mod" + std::to_string(i);
+        ASSERT_EQ(reg.select(desc), rtB);
+    }
+    EXPECT_EQ(rtA->canHandleCalls, 1);
+    EXPECT_EQ(rtB->canHandleCalls, 1);
+
+    // A different config is a different key, and an explicit id still wins.
+    desc.loaderConfig["id"] = "a";
+    EXPECT_EQ(reg.select(desc), rtA);
+    desc.loaderConfig = nlohmann::json::object();
+    desc.format = "wasm";
+    EXPECT_EQ(reg.select(desc), rtA);
+    EXPECT_EQ(rtA->canHandleCalls, 2);
+}
+
+TEST(ModuleLoaderRegistryTest, RegisterLoaderDropsTheMemo) {
+    ModuleLoaderRegistry reg;
+    reg.registerLoader(std::make_shared<FakeModuleLoader>("a", "qt-plugin"));
+
+    ModuleDescriptor desc;
+    desc.format = "wasm";
+    EXPECT_EQ(reg.select(desc), nullptr);   // "no loader" is memoized too
+
+    auto wasm = std::make_shared<FakeModuleLoader>("w", "wasm");
+    reg.registerLoader(wasm);
+    EXPECT_EQ(reg.select(desc), wasm);
+}
+
+TEST(ModuleLoaderRegistryTest, InvalidateSelectionsReconsultsLoaders) {
+    ModuleLoaderRegistry reg;
+    auto rt = std::make_shared<FakeModuleLoader>("a", "qt-plugin");
+    reg.registerLoader(rt);
+
+    ModuleDescriptor desc;
+    desc.format = "qt-plugin";
+    reg.select(desc);
+    reg.select(desc);
+    EXPECT_EQ(rt->canHandleCalls, 1);
+
+    reg.invalidateSelections();
+    EXPECT_EQ(reg.select(desc), rt);
+    EXPECT_EQ(rt->canHandleCalls, 2);
+}
+
+TEST(ModuleLoaderRegistryTest, ConcurrentSelectWhileRegistering) {
+    ModuleLoaderRegistry reg;
+    auto first = std::make_shared<FakeModuleLoader>("first", "qt-plugin");
+    reg.registerLoader(first);
+
+    std::atomic<bool> stop{false};
+    std::atomic<int> wrong{0};
+    std::vector<std::thread> readers;
+    for (int t = 0; t < 4; ++t) {
+        readers.emplace_back([&] {
+            ModuleDescriptor desc;
+            desc.format = "qt-plugin";
+            while (!stop.load()) {
+                if (reg.select(desc) != first)
+                    ++wrong;
+            }
+        });
+    }
+    for (int i = 0; i < 200; ++i)
+        reg.registerLoader(std::make_shared<FakeModuleLoader>("later" + std::to_string(i), "qt-plugin"));
+    stop = true;
+    for (auto& r : readers)
+        r.join();
+
+    EXPECT_EQ(wrong, 0);   // first registered still wins
+    EXPECT_EQ(reg.all().size(), 201u);
+}
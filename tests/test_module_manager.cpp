@@ -650,6 +650,93 @@ TEST_F(ModuleManagerTest, RegisterDependencies_PreservesLoadedFlag) {
     EXPECT_EQ(logos_core_get_module_dependencies_count("test_module"), 2);
 }
 
+TEST_F(ModuleManagerTest, RegisterModules_MatchesOneAtATimeRegistration) {
+    logos_core_register_module("a", "/path/a");
+    logos_core_mark_module_loaded("a");
+
+    // "c" names "b" before "b" is in the batch; the single rebuild still sees it.
+    ModuleManager::registry().registerModules({
+        {"c", "/path/c", {"b"}},
+        {"b", "/path/b", {"a"}},
+        {"a", "/path/a2", {}},
+    });
+
+    EXPECT_EQ(logos_core_is_module_loaded("a"), 1);
+    char* path = logos_core_get_module_path("a");
+    ASSERT_NE(path, nullptr);
+    EXPECT_EQ(std::string(path), "/path/a2");
+    delete[] path;
+    EXPECT_EQ(ModuleManager::registry().moduleDependents("a"), std::vector<std::string>{"b"});
+    EXPECT_EQ(ModuleManager::registry().moduleDependents("a", true),
+              (std::vector<std::string>{"b", "c"}));
+}
+
+// =============================================================================
+// Dependents x loaded matrix (ModuleRegistry::loadedDependents)
+// =============================================================================
+
+static std::set<std::string> loadedDependentsOf(const std::string& name) {
+    auto v = ModuleManager::registry().loadedDependents(name);
+    return std::set<std::string>(v.begin(), v.end());
+}
+
+TEST_F(ModuleManagerTest, LoadedDependents_TracksLoadAndUnloadIncrementally) {
+    logos_core_register_module("b", "/b");
+    logos_core_register_module("a1", "/a1");
+    logos_core_register_module("a2", "/a2");
+    const char* deps[] = {"b"};
+    logos_core_register_module_dependencies("a1", deps, 1);
+    logos_core_register_module_dependencies("a2", deps, 1);
+
+    EXPECT_TRUE(loadedDependentsOf("b").empty());
+
+    logos_core_mark_module_loaded("a1");
+    EXPECT_EQ(loadedDependentsOf("b"), (std::set<std::string>{"a1"}));
+
+    logos_core_mark_module_loaded("a2");
+    EXPECT_EQ(loadedDependentsOf("b"), (std::set<std::string>{"a1", "a2"}));
+
+    ModuleManager::registry().markUnloaded("a1");
+    EXPECT_EQ(loadedDependentsOf("b"), (std::set<std::string>{"a2"}));
+
+    ModuleManager::registry().clearLoaded();
+    EXPECT_TRUE(loadedDependentsOf("b").empty());
+}
+
+TEST_F(ModuleManagerTest, LoadedDependents_UnknownNameIsEmpty) {
+    EXPECT_TRUE(ModuleManager::registry().loadedDependents("nope").empty());
+}
+
+TEST_F(ModuleManagerTest, LoadedDependents_FollowsDependencyEdits) {
+    logos_core_register_module("b", "/b");
+    logos_core_register_module("a", "/a");
+    const char* deps[] = {"b"};
+    logos_core_register_module_dependencies("a", deps, 1);
+    logos_core_mark_module_loaded("a");
+    ASSERT_EQ(loadedDependentsOf("b"), (std::set<std::string>{"a"}));
+
+    // Dropping the edge must drop the matrix bit with it.
+    logos_core_register_module_dependencies("a", nullptr, 0);
+    EXPECT_TRUE(loadedDependentsOf("b").empty());
+}
+
+TEST_F(ModuleManagerTest, LoadedDependents_ManyModulesAcrossWordBoundaries) {
+    // More than one 64-bit word of ids, so the AND spans several words.
+    logos_core_register_module("hub", "/hub");
+    const char* deps[] = {"hub"};
+    std::set<std::string> expected;
+    for (int i = 0; i < 150; ++i) {
+        std::string n = "m" + std::to_string(i);
+        logos_core_register_module(n.c_str(), ("/" + n).c_str());
+        logos_core_register_module_dependencies(n.c_str(), deps, 1);
+        if (i % 3 == 0) {
+            logos_core_mark_module_loaded(n.c_str());
+            expected.insert(n);
+        }
+    }
+    EXPECT_EQ(loadedDependentsOf("hub"), expected);
+}
+
 // =============================================================================
 // End-to-end regression tests using a real Qt module.
 // =============================================================================
@@ -0,0 +1,323 @@
+// =============================================================================
+// Tests for blue-green module upgrades (ModuleManager::upgradeModule /
+// logos_core_upgrade_module): the new process starts under the module's
+// other container key, takes over the registry entry and token, and the old
+// one is retired without its dependents coming down; failures leave the
+// running version untouched.
+// =============================================================================
+#include <gtest/gtest.h>
+#include "logos_core.h"
+#include "qt_test_adapter.h"
+#include "module_manager.h"
+#include "module_registry.h"
+#include "module_loader_registry.h"
+#include "module_loader.h"
+#include "composite_module_loader.h"
+#include <logos_container/module_container.h>
+#include <logos_module_loader/module_format_loader.h>
+#include "subprocess_manager.h"
+#include "token_manager.h"
+#include <nlohmann/json.hpp>
+#include <chrono>
+#include <functional>
+#include <future>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <string>
+#include <vector>
+
+using namespace LogosCore;
+
+// What a real container does: the handle carries the container key it was
+// launched under. Outside the anonymous namespace for std::make_shared (see
+// test_composite_module_loader.cpp).
+struct KeyedContainer : public ModuleContainer {
+    std::string id() const override { return "keyed"; }
+    bool canHandle(const ModuleDescriptor&) const override { return true; }
+    bool launch(const ModuleDescriptor& desc, const std::string&, const std::vector<std::string>&,
+                std::function<void(const std::string&)>, LoadedModuleHandle& out) override {
+        out.name = desc.name;
+        out.pid = nextPid--;
+        pids[desc.name] = out.pid;
+        return true;
+    }
+    bool sendToken(const std::string& name, const std::string&) override { return pids.count(name) > 0; }
+    void terminate(const std::string& name) override { pids.erase(name); }
+    void terminateAll() override { pids.clear(); }
+    bool hasModule(const std::string& name) const override { return pids.count(name) > 0; }
+    std::optional<int64_t> pid(const std::string& name) const override {
+        auto it = pids.find(name);
+        return it == pids.end() ? std::nullopt : std::optional<int64_t>(it->second);
+    }
+    std::unordered_map<std::string, int64_t> getAllPids() const override { return {pids.begin(), pids.end()}; }
+
+    std::map<std::string, int64_t> pids;   // negative: never a real process
+    int64_t nextPid = -2000;
+};
+
+struct PluginFormat : public ModuleFormatLoader {
+    std::string id() const override { return "plugin"; }
+    bool canHandle(const ModuleDescriptor&) const override { return true; }
+    std::string resolveHostBinary(const ModuleDescriptor&) const override { return "/usr/bin/host"; }
+    std::vector<std::string> buildArguments(const ModuleDescriptor& desc) const override {
+        return {"--name", desc.name, "--path", desc.path};
+    }
+};
+
+namespace {
+
+// Processes keyed by container key. Like a real container, terminate()
+// reports the exit through the load's termination callback.
+struct UpgradeLoader : public ModuleLoader {
+    std::string id() const override { return "upgrade"; }
+    bool canHandle(const ModuleDescriptor&) const override { return true; }
+    bool load(const ModuleDescriptor& desc,
+              std::function<void(const std::string&)> onTerminated,
+              LoadedModuleHandle& out) override {
+        std::lock_guard lock(mutex);
+        launched.push_back(desc);
+        if (failLaunch.count(desc.name))
+            return false;
+        out.name = desc.name;
+        out.pid = nextPid++;
+        events.push_back("load " + desc.name);
+        pids[desc.name] = out.pid;
+        callbacks[desc.name] = std::move(onTerminated);
+        return true;
+    }
+    bool sendToken(const std::string& name, const std::string& token) override {
+        std::lock_guard lock(mutex);
+        events.push_back("token " + name);
+        if (rejectToken.count(name))
+            return false;
+        tokens[name] = token;
+        return true;
+    }
+    void terminate(const std::string& name) override {
+        // Unlocked, so the hook may load through this loader.
+        if (onTerminate)
+            onTerminate(name);
+        std::function<void(const std::string&)> callback;
+        {
+            std::lock_guard lock(mutex);
+            terminated.push_back(name);
+            events.push_back("terminate " + name);
+            if (!pids.erase(name))
+                return;
+            callback = callbacks[name];
+        }
+        if (callback)
+            callback(name);
+    }
+    void terminateAll() override {
+        std::lock_guard lock(mutex);
+        pids.clear();
+    }
+    bool hasModule(const std::string& name) const override {
+        std::lock_guard lock(mutex);
+        return pids.count(name) > 0;
+    }
+    std::optional<int64_t> pid(const std::string& name) const override {
+        std::lock_guard lock(mutex);
+        auto it = pids.find(name);
+        return it == pids.end() ? std::nullopt : std::optional<int64_t>(it->second);
+    }
+    std::unordered_map<std::string, int64_t> getAllPids() const override {
+        std::lock_guard lock(mutex);
+        return {pids.begin(), pids.end()};
+    }
+
+    mutable std::mutex mutex;
+    std::set<std::string> failLaunch;
+    std::set<std::string> rejectToken;
+    std::vector<ModuleDescriptor> launched;
+    std::vector<std::string> terminated;
+    std::vector<std::string> events;
+    std::map<std::string, std::string> tokens;
+    std::function<void(const std::string&)> onTerminate;
+    // Negative so the retire step's SIGTERM never reaches a real process.
+    std::map<std::string, int64_t> pids;
+    std::map<std::string, std::function<void(const std::string&)>> callbacks;
+    int64_t nextPid = -1000;
+};
+
+class ModuleUpgradeTest : public ::testing::Test {
+protected:
+    std::shared_ptr<UpgradeLoader> loader;
+
+    void SetUp() override {
+        logos_core_terminate_all();
+        logos_core_clear();
+        loader = std::make_shared<UpgradeLoader>();
+        ModuleManager::loaders().clearForTests();
+        ModuleManager::loaders().registerLoader(loader);
+
+        logos_core_register_module("up_base", "/upgrade/v1/up_base_plugin.so");
+        logos_core_register_module("up_app", "/upgrade/v1/up_app_plugin.so");
+        const char* deps[] = {"up_base"};
+        logos_core_register_module_dependencies("up_app", deps, 1);
+        ASSERT_EQ(logos_core_load_module("up_app", true), 1);
+        loader->launched.clear();
+        loader->terminated.clear();
+        loader->events.clear();
+    }
+
+    void TearDown() override {
+        logos_core_clear();
+        ModuleManager::loaders().clearForTests();
+        ModuleManager::loaders().registerLoader(std::make_shared<SubprocessManager>());
+    }
+
+    int64_t modulePid(const std::string& name) {
+        auto pids = ModuleManager::getModuleProcessIds();
+        auto it = pids.find(name);
+        return it == pids.end() ? 0 : it->second;
+    }
+};
+
+} // anonymous namespace
+
+TEST_F(ModuleUpgradeTest, SwapsToNewProcessWithoutTouchingDependents) {
+    const int64_t oldPid = modulePid("up_base");
+    ASSERT_EQ(logos_core_upgrade_module("up_base", "/upgrade/v2/up_base_plugin.so"), 1);
+
+    ASSERT_EQ(loader->launched.size(), 1u);
+    EXPECT_EQ(loader->launched[0].name, "up_base_next");
+    EXPECT_EQ(loader->launched[0].path, "/upgrade/v2/up_base_plugin.so");
+    EXPECT_EQ(loader->launched[0].loaderConfig["upgrade_of"], "up_base");
+    EXPECT_EQ(loader->terminated, (std::vector<std::string>{"up_base"}));
+
+    EXPECT_EQ(logos_core_is_module_loaded("up_base"), 1);
+    EXPECT_EQ(logos_core_is_module_loaded("up_app"), 1);
+    EXPECT_EQ(ModuleManager::registry().modulePath("up_base"), "/upgrade/v2/up_base_plugin.so");
+    EXPECT_NE(modulePid("up_base"), oldPid);
+    EXPECT_EQ(modulePid("up_base"), loader->pids["up_base_next"]);
+    EXPECT_EQ(ModuleManager::getModuleProcessIds().count("up_base_next"), 0u);
+    EXPECT_EQ(TokenManager::instance().getToken("up_base"), loader->tokens["up_base_next"]);
+}
+
+TEST_F(ModuleUpgradeTest, AlternatesKeysAndUnloadFollowsTheCurrentProcess) {
+    ASSERT_EQ(logos_core_upgrade_module("up_base", nullptr), 1);
+    ASSERT_EQ(logos_core_upgrade_module("up_base", nullptr), 1);
+    ASSERT_EQ(loader->launched.size(), 2u);
+    EXPECT_EQ(loader->launched[1].name, "up_base");
+    EXPECT_EQ(loader->terminated, (std::vector<std::string>{"up_base", "up_base_next"}));
+    EXPECT_EQ(logos_core_is_module_loaded("up_base"), 1);
+
+    ASSERT_EQ(logos_core_upgrade_module("up_base", nullptr), 1);
+    loader->terminated.clear();
+    ASSERT_EQ(logos_core_unload_module("up_base", true), 1);
+    EXPECT_EQ(loader->terminated, (std::vector<std::string>{"up_app", "up_base_next"}));
+    EXPECT_EQ(logos_core_is_module_loaded("up_base"), 0);
+}
+
+TEST_F(ModuleUpgradeTest, NewProcessExitUnloadsTheModule) {
+    ASSERT_EQ(logos_core_upgrade_module("up_base", nullptr), 1);
+    auto callback = loader->callbacks["up_base_next"];
+    loader->pids.erase("up_base_next");
+    callback("up_base_next");
+    EXPECT_EQ(logos_core_is_module_loaded("up_base"), 0);
+}
+
+TEST_F(ModuleUpgradeTest, FailedStartLeavesRunningVersion) {
+    const int64_t oldPid = modulePid("up_base");
+    const std::string oldToken = TokenManager::instance().getToken("up_base");
+    loader->failLaunch = {"up_base_next"};
+    EXPECT_EQ(logos_core_upgrade_module("up_base", "/upgrade/v2/up_base_plugin.so"), 0);
+    EXPECT_TRUE(loader->terminated.empty());
+    EXPECT_EQ(modulePid("up_base"), oldPid);
+    EXPECT_EQ(TokenManager::instance().getToken("up_base"), oldToken);
+    EXPECT_EQ(ModuleManager::registry().modulePath("up_base"), "/upgrade/v1/up_base_plugin.so");
+}
+
+TEST_F(ModuleUpgradeTest, RejectedTokenRetiresTheNewProcess) {
+    const int64_t oldPid = modulePid("up_base");
+    loader->rejectToken = {"up_base_next"};
+    EXPECT_EQ(logos_core_upgrade_module("up_base", nullptr), 0);
+    EXPECT_EQ(loader->terminated, (std::vector<std::string>{"up_base_next"}));
+    EXPECT_EQ(logos_core_is_module_loaded("up_base"), 1);
+    EXPECT_EQ(modulePid("up_base"), oldPid);
+}
+
+TEST_F(ModuleUpgradeTest, RefusesModulesThatAreNotLoaded) {
+    logos_core_register_module("up_idle", "/upgrade/v1/up_idle_plugin.so");
+    EXPECT_EQ(logos_core_upgrade_module("up_idle", nullptr), 0);
+    EXPECT_EQ(logos_core_upgrade_module("up_unknown", nullptr), 0);
+    EXPECT_TRUE(loader->launched.empty());
+}
+
+TEST_F(ModuleUpgradeTest, TokenGoesToNewProcessBeforeOldOneIsRetired) {
+    // Outlives the test: TearDown's clear() terminates through the hook too.
+    auto savedToken = std::make_shared<std::string>();
+    loader->onTerminate = [savedToken](const std::string& name) {
+        if (name == "up_base")
+            *savedToken = TokenManager::instance().getToken("up_base");
+    };
+    ASSERT_EQ(logos_core_upgrade_module("up_base", nullptr), 1);
+    // Launch, hand over the token, then — with the registry and saved token
+    // already switched — stop the old process.
+    EXPECT_EQ(loader->events, (std::vector<std::string>{
+        "load up_base_next", "token up_base_next", "terminate up_base"}));
+    EXPECT_EQ(*savedToken, loader->tokens["up_base_next"]);
+}
+
+TEST_F(ModuleUpgradeTest, OldProcessIsRetiredWithoutHoldingUpLoads) {
+    logos_core_register_module("up_idle", "/upgrade/v1/up_idle_plugin.so");
+    auto loadedDuringRetire = std::make_shared<std::future<int>>();
+    auto loadFinished = std::make_shared<bool>(false);
+    loader->onTerminate = [loadedDuringRetire, loadFinished](const std::string& name) {
+        if (name != "up_base" || loadedDuringRetire->valid())
+            return;
+        *loadedDuringRetire = std::async(std::launch::async,
+                                         [] { return logos_core_load_module("up_idle", false); });
+        *loadFinished = loadedDuringRetire->wait_for(std::chrono::seconds(5))
+            == std::future_status::ready;
+    };
+    ASSERT_EQ(logos_core_upgrade_module("up_base", nullptr), 1);
+    ASSERT_TRUE(loadedDuringRetire->valid());
+    EXPECT_TRUE(*loadFinished);
+    EXPECT_EQ(loadedDuringRetire->get(), 1);
+    EXPECT_EQ(logos_core_is_module_loaded("up_idle"), 1);
+}
+
+TEST_F(ModuleUpgradeTest, SkipsContainerKeysThatAreTaken) {
+    logos_core_register_module("up_base_next", "/upgrade/v1/up_base_next_plugin.so");
+    ASSERT_EQ(logos_core_upgrade_module("up_base", nullptr), 1);
+    ASSERT_EQ(loader->launched.size(), 1u);
+    EXPECT_EQ(loader->launched[0].name, "up_base_next2");
+    EXPECT_EQ(modulePid("up_base"), loader->pids["up_base_next2"]);
+
+    ASSERT_EQ(logos_core_upgrade_module("up_base", nullptr), 1);
+    EXPECT_EQ(loader->launched[1].name, "up_base");
+}
+
+TEST_F(ModuleUpgradeTest, CallersAreHandedTheNewContainerKey) {
+    EXPECT_EQ(ModuleManager::acquireModuleReplica("up_base"), "up_base");
+    ASSERT_EQ(logos_core_upgrade_module("up_base", nullptr), 1);
+    EXPECT_EQ(ModuleManager::acquireModuleReplica("up_base"), "up_base_next");
+    auto replicas = nlohmann::json::parse(ModuleManager::getModuleReplicasJson("up_base"));
+    EXPECT_EQ(replicas["replicas"][0]["instance"], "up_base_next");
+    ASSERT_EQ(logos_core_upgrade_module("up_base", nullptr), 1);
+    EXPECT_EQ(ModuleManager::acquireModuleReplica("up_base"), "up_base");
+}
+
+TEST_F(ModuleUpgradeTest, UpgradesThroughACompositeLoader) {
+    logos_core_clear();
+    auto container = std::make_shared<KeyedContainer>();
+    ModuleManager::loaders().clearForTests();
+    ModuleManager::loaders().registerLoader(
+        std::make_shared<CompositeModuleLoader>(container, std::make_shared<PluginFormat>()));
+    logos_core_register_module("up_base", "/upgrade/v1/up_base_plugin.so");
+    ASSERT_EQ(logos_core_load_module("up_base", false), 1);
+
+    ASSERT_EQ(logos_core_upgrade_module("up_base", "/upgrade/v2/up_base_plugin.so"), 1);
+    EXPECT_EQ(container->pids.count("up_base"), 0u);
+    ASSERT_EQ(container->pids.count("up_base_next"), 1u);
+    EXPECT_EQ(modulePid("up_base"), container->pids["up_base_next"]);
+    EXPECT_EQ(ModuleManager::acquireModuleReplica("up_base"), "up_base_next");
+
+    ASSERT_EQ(logos_core_unload_module("up_base", false), 1);
+    EXPECT_TRUE(container->pids.empty());
+}
@@ -0,0 +1,233 @@
+// =============================================================================
+// Tests for multi-instance module replicas (replica_set.h): round-robin and
+// least-loaded dispatch, instance naming, and the replica lifecycle through
+// ModuleManager / logos_core_set_module_replicas — launch, dispatch, a replica
+// exiting on its own, and unload taking every instance down.
+// =============================================================================
+#include <gtest/gtest.h>
+#include "logos_core.h"
+#include "qt_test_adapter.h"
+#include "module_manager.h"
+#include "module_loader_registry.h"
+#include "module_loader.h"
+#include "replica_set.h"
+#include "subprocess_manager.h"
+#include <nlohmann/json.hpp>
+#include <map>
+#include <mutex>
+#include <string>
+#include <vector>
+
+using namespace LogosCore;
+
+namespace {
+
+// Keeps every descriptor it was asked to launch and each instance's
+// termination callback, so a test can make one exit on its own.
+struct ReplicaLoader : public ModuleLoader {
+    std::string id() const override { return "replica"; }
+    bool canHandle(const ModuleDescriptor&) const override { return true; }
+    bool load(const ModuleDescriptor& desc,
+              std::function<void(const std::string&)> onTerminated,
+              LoadedModuleHandle& out) override {
+        std::lock_guard lock(mutex);
+        launched.push_back(desc);
+        out.name = desc.name;
+        out.pid = nextPid++;
+        pids[desc.name] = out.pid;
+        callbacks[desc.name] = std::move(onTerminated);
+        return true;
+    }
+    bool sendToken(const std::string&, const std::string&) override { return true; }
+    void terminate(const std::string& name) override {
+        std::lock_guard lock(mutex);
+        terminated.push_back(name);
+        pids.erase(name);
+    }
+    void terminateAll() override {
+        std::lock_guard lock(mutex);
+        pids.clear();
+    }
+    bool hasModule(const std::string& name) const override {
+        std::lock_guard lock(mutex);
+        return pids.count(name) > 0;
+    }
+    std::optional<int64_t> pid(const std::string& name) const override {
+        std::lock_guard lock(mutex);
+        auto it = pids.find(name);
+        return it == pids.end() ? std::nullopt : std::optional<int64_t>(it->second);
+    }
+
+    // The process behind `name` exits without being asked to.
+    void exit(const std::string& name) {
+        std::function<void(const std::string&)> callback;
+        {
+            std::lock_guard lock(mutex);
+            pids.erase(name);
+            callback = callbacks[name];
+        }
+        if (callback)
+            callback(name);
+    }
+
+    mutable std::mutex mutex;
+    std::vector<ModuleDescriptor> launched;
+    std::vector<std::string> terminated;
+    std::map<std::string, int64_t> pids;
+    std::map<std::string, std::function<void(const std::string&)>> callbacks;
+    int64_t nextPid = 1000;
+};
+
+std::string acquire(const char* module) {
+    char* raw = logos_core_acquire_module_replica(module);
+    if (!raw)
+        return "";
+    std::string instance(raw);
+    delete[] raw;
+    return instance;
+}
+
+nlohmann::json replicasOf(const char* module) {
+    char* raw = logos_core_get_module_replicas(module);
+    if (!raw)
+        return nullptr;
+    auto json = nlohmann::json::parse(raw);
+    delete[] raw;
+    return json;
+}
+
+class ReplicaApiTest : public ::testing::Test {
+protected:
+    std::shared_ptr<ReplicaLoader> loader;
+
+    void SetUp() override {
+        logos_core_terminate_all();
+        logos_core_clear();
+        loader = std::make_shared<ReplicaLoader>();
+        ModuleManager::loaders().clearForTests();
+        ModuleManager::loaders().registerLoader(loader);
+    }
+
+    void TearDown() override {
+        logos_core_clear();
+        ModuleManager::loaders().clearForTests();
+        ModuleManager::loaders().registerLoader(std::make_shared<SubprocessManager>());
+    }
+};
+
+} // anonymous namespace
+
+TEST(ReplicaSet, RoundRobinTakesTurns) {
+    ReplicaSet set(ReplicaPolicy::RoundRobin);
+    EXPECT_FALSE(set.acquire().has_value());
+    set.add("a");
+    set.add("b");
+    set.add("c");
+    set.add("b");   // already there
+    std::vector<std::string> picks;
+    for (int i = 0; i < 6; ++i)
+        picks.push_back(*set.acquire());
+    EXPECT_EQ(picks, (std::vector<std::string>{"a", "b", "c", "a", "b", "c"}));
+    EXPECT_EQ(set.toJson()[1]["dispatched"], 2);
+    EXPECT_EQ(set.toJson()[1]["in_flight"], 2);
+}
+
+TEST(ReplicaSet, LeastLoadedAvoidsBusyInstances) {
+    ReplicaSet set(ReplicaPolicy::LeastLoaded);
+    set.add("a");
+    set.add("b");
+    set.add("c");
+    EXPECT_EQ(*set.acquire(), "a");
+    EXPECT_EQ(*set.acquire(), "b");
+    EXPECT_EQ(*set.acquire(), "c");
+    set.release("b");
+    EXPECT_EQ(*set.acquire(), "b");   // the only one with nothing in flight
+    set.release("a");
+    set.release("c");
+    EXPECT_EQ(*set.acquire(), "c");   // a and c tie; the scan resumes after b
+    EXPECT_EQ(*set.acquire(), "a");
+    set.release("nobody");
+}
+
+TEST(ReplicaSet, RemoveKeepsRotationOnTheRest) {
+    ReplicaSet set(ReplicaPolicy::RoundRobin);
+    set.add("a");
+    set.add("b");
+    set.add("c");
+    EXPECT_EQ(*set.acquire(), "a");
+    EXPECT_TRUE(set.remove("a"));
+    EXPECT_FALSE(set.remove("a"));
+    EXPECT_EQ(*set.acquire(), "b");
+    EXPECT_EQ(*set.acquire(), "c");
+    EXPECT_EQ(set.instances(), (std::vector<std::string>{"b", "c"}));
+}
+
+TEST(ReplicaSet, NamesAndPolicies) {
+    EXPECT_EQ(replicaInstanceName("hasher", 0), "hasher");
+    EXPECT_EQ(replicaInstanceName("hasher", 2), "hasher_r2");
+    EXPECT_EQ(parseReplicaPolicy("least_loaded"), ReplicaPolicy::LeastLoaded);
+    EXPECT_EQ(parseReplicaPolicy("round_robin"), ReplicaPolicy::RoundRobin);
+    EXPECT_FALSE(parseReplicaPolicy("random").has_value());
+}
+
+TEST_F(ReplicaApiTest, LaunchesReplicasAndSpreadsCalls) {
+    logos_core_register_module("rep_hasher", "/replica/rep_hasher_plugin.so");
+    ASSERT_EQ(logos_core_set_module_replicas("rep_hasher", 3, nullptr), 1);
+    ASSERT_EQ(logos_core_load_module("rep_hasher", false), 1);
+
+    ASSERT_EQ(loader->launched.size(), 3u);
+    EXPECT_EQ(loader->launched[0].name, "rep_hasher");
+    EXPECT_EQ(loader->launched[1].name, "rep_hasher_r1");
+    EXPECT_EQ(loader->launched[2].name, "rep_hasher_r2");
+    EXPECT_EQ(loader->launched[2].loaderConfig["replica_of"], "rep_hasher");
+    EXPECT_EQ(loader->launched[2].loaderConfig["replica_index"], 2);
+    EXPECT_EQ(loader->launched[1].path, loader->launched[0].path);
+
+    EXPECT_EQ(acquire("rep_hasher"), "rep_hasher");
+    EXPECT_EQ(acquire("rep_hasher"), "rep_hasher_r1");
+    EXPECT_EQ(acquire("rep_hasher"), "rep_hasher_r2");
+    EXPECT_EQ(acquire("rep_hasher"), "rep_hasher");
+    logos_core_release_module_replica("rep_hasher", "rep_hasher");
+
+    const auto info = replicasOf("rep_hasher");
+    ASSERT_TRUE(info.is_object());
+    EXPECT_EQ(info["policy"], "round_robin");
+    ASSERT_EQ(info["replicas"].size(), 3u);
+    EXPECT_EQ(info["replicas"][0]["in_flight"], 1);
+    EXPECT_EQ(info["replicas"][0]["dispatched"], 2);
+    EXPECT_TRUE(info["replicas"][1]["pid"].is_number());
+
+    ASSERT_EQ(logos_core_unload_module("rep_hasher", false), 1);
+    EXPECT_EQ(loader->terminated,
+              (std::vector<std::string>{"rep_hasher_r1", "rep_hasher_r2", "rep_hasher"}));
+    EXPECT_EQ(acquire("rep_hasher"), "");
+    EXPECT_TRUE(replicasOf("rep_hasher").is_null());
+}
+
+TEST_F(ReplicaApiTest, ExitedReplicaLeavesDispatch) {
+    logos_core_register_module("rep_worker", "/replica/rep_worker_plugin.so");
+    ASSERT_EQ(logos_core_set_module_replicas("rep_worker", 2, "least_loaded"), 1);
+    ASSERT_EQ(logos_core_load_module("rep_worker", false), 1);
+    EXPECT_EQ(replicasOf("rep_worker")["policy"], "least_loaded");
+
+    loader->exit("rep_worker_r1");
+    EXPECT_EQ(logos_core_is_module_loaded("rep_worker"), 1);
+    EXPECT_EQ(acquire("rep_worker"), "rep_worker");
+    EXPECT_EQ(acquire("rep_worker"), "rep_worker");
+    EXPECT_EQ(replicasOf("rep_worker")["replicas"].size(), 1u);
+}
+
+TEST_F(ReplicaApiTest, SingleInstanceByDefaultAndValidation) {
+    logos_core_register_module("rep_plain", "/replica/rep_plain_plugin.so");
+    EXPECT_EQ(logos_core_set_module_replicas("rep_plain", 0, nullptr), 0);
+    EXPECT_EQ(logos_core_set_module_replicas("rep_plain", 65, nullptr), 0);
+    EXPECT_EQ(logos_core_set_module_replicas("rep_plain", 2, "random"), 0);
+    EXPECT_EQ(acquire("rep_plain"), "");   // not loaded
+
+    ASSERT_EQ(logos_core_load_module("rep_plain", false), 1);
+    EXPECT_EQ(loader->launched.size(), 1u);
+    EXPECT_EQ(acquire("rep_plain"), "rep_plain");
+    const auto info = replicasOf("rep_plain");
+    ASSERT_EQ(info["replicas"].size(), 1u);
+    EXPECT_EQ(info["replicas"][0]["instance"], "rep_plain");
+}
@@ -0,0 +1,409 @@
+// =============================================================================
+// Tests for the background ProcessStats sampler (stats_sampler.h), its raw
+// /proc reader (proc_reader.h), and the C API built on them:
+// logos_core_start_stats_sampler / logos_core_get_module_stats_history.
+//
+// Sampler tests drive sampleOnce() with a scripted ReadFn; the end-to-end
+// tests point a FakeModuleLoader's module at this test process's own pid.
+// =============================================================================
+#include <gtest/gtest.h>
+#include "logos_core.h"
+#include "fake_module_loader.h"
+#include "stats_sampler.h"
+#include "proc_reader.h"
+#include <nlohmann/json.hpp>
+#include <unistd.h>
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <unordered_set>
+
+using namespace LogosCore;
+using namespace std::chrono_literals;
+
+namespace {
+
+// Scripted process table: pid -> reading. Absent pids read as gone.
+struct FakeProc {
+    std::unordered_map<int64_t, ProcessReading> table;
+    uint32_t lastDetail = 0;
+
+    StatsSampler::ReadFn reader() {
+        return [this](int64_t pid, uint32_t detail, ProcessReading& out) {
+            auto it = table.find(pid);
+            if (it == table.end()) return false;
+            out = it->second;
+            out.detail.fields &= detail;
+            lastDetail = detail;
+            return true;
+        };
+    }
+};
+
+StatsSample sampleAt(int64_t ms, uint64_t rss) {
+    StatsSample s;
+    s.timestampMs = ms;
+    s.rssBytes = rss;
+    return s;
+}
+
+} // anonymous namespace
+
+// =============================================================================
+// StatsRing
+// =============================================================================
+
+TEST(StatsRing, EmptyRingHasNoLatest) {
+    StatsRing ring(4);
+    EXPECT_FALSE(ring.latest().has_value());
+    EXPECT_TRUE(ring.since(0).empty());
+}
+
+TEST(StatsRing, LatestIsLastPushed) {
+    StatsRing ring(4);
+    ring.push(sampleAt(10, 1));
+    ring.push(sampleAt(20, 2));
+    auto latest = ring.latest();
+    ASSERT_TRUE(latest.has_value());
+    EXPECT_EQ(latest->timestampMs, 20);
+    EXPECT_EQ(latest->rssBytes, 2u);
+}
+
+TEST(StatsRing, WrapsAroundKeepingNewestCapacitySamples) {
+    StatsRing ring(3);
+    for (int i = 1; i <= 7; ++i)
+        ring.push(sampleAt(i * 10, static_cast<uint64_t>(i)));
+
+    auto all = ring.since(0);
+    ASSERT_EQ(all.size(), 3u);
+    EXPECT_EQ(all[0].rssBytes, 7u);   // newest first
+    EXPECT_EQ(all[1].rssBytes, 6u);
+    EXPECT_EQ(all[2].rssBytes, 5u);
+}
+
+TEST(StatsRing, SinceStopsAtTimestamp) {
+    StatsRing ring(8);
+    for (int i = 1; i <= 5; ++i)
+        ring.push(sampleAt(i * 10, static_cast<uint64_t>(i)));
+    auto recent = ring.since(30);
+    ASSERT_EQ(recent.size(), 3u);
+    EXPECT_EQ(recent.back().timestampMs, 30);
+}
+
+TEST(StatsRing, ConcurrentReadersNeverSeeTornSamples) {
+    // Every pushed sample has rssBytes == timestampMs; a torn read would
+    // break the invariant.
+    StatsRing ring(4);
+    std::atomic<bool> done{false};
+    std::atomic<int> torn{0};
+
+    std::thread reader([&] {
+        while (!done.load()) {
+            if (auto s = ring.latest())
+                if (static_cast<int64_t>(s->rssBytes) != s->timestampMs) ++torn;
+            for (const auto& s : ring.since(0))
+                if (static_cast<int64_t>(s.rssBytes) != s.timestampMs) ++torn;
+        }
+    });
+    for (int i = 1; i <= 100000; ++i)
+        ring.push(sampleAt(i, static_cast<uint64_t>(i)));
+    done = true;
+    reader.join();
+    EXPECT_EQ(torn.load(), 0);
+}
+
+// =============================================================================
+// StatsSampler
+// =============================================================================
+
+TEST(StatsSampler, FirstSampleHasNoCpuPercent) {
+    FakeProc proc;
+    proc.table[100] = {2.0, 4096};
+    StatsSampler sampler([] { return std::unordered_map<std::string, int64_t>{{"a", 100}}; },
+                         1s, 8, proc.reader());
+    sampler.sampleOnce();
+
+    auto latest = sampler.latest("a");
+    ASSERT_TRUE(latest.has_value());
+    EXPECT_DOUBLE_EQ(latest->cpuPercent, 0.0);
+    EXPECT_DOUBLE_EQ(latest->cpuSeconds, 2.0);
+    EXPECT_EQ(latest->rssBytes, 4096u);
+    EXPECT_EQ(sampler.pidOf("a"), 100);
+}
+
+TEST(StatsSampler, CpuPercentComesFromDeltas) {
+    FakeProc proc;
+    proc.table[100] = {1.0, 0};
+    StatsSampler sampler([] { return std::unordered_map<std::string, int64_t>{{"a", 100}}; },
+                         1s, 8, proc.reader());
+    sampler.sampleOnce();
+    std::this_thread::sleep_for(50ms);
+    proc.table[100].cpuSeconds = 11.0;   // far more CPU than wall time elapsed
+    sampler.sampleOnce();
+
+    auto latest = sampler.latest("a");
+    ASSERT_TRUE(latest.has_value());
+    EXPECT_GT(latest->cpuPercent, 100.0);
+}
+
+TEST(StatsSampler, PidChangeStartsFreshHistory) {
+    FakeProc proc;
+    proc.table[100] = {5.0, 1};
+    proc.table[200] = {0.5, 2};
+    int64_t pid = 100;
+    StatsSampler sampler([&] { return std::unordered_map<std::string, int64_t>{{"a", pid}}; },
+                         1s, 8, proc.reader());
+    sampler.sampleOnce();
+    sampler.sampleOnce();
+    EXPECT_EQ(sampler.window("a", 1h).count, 2u);
+
+    pid = 200;   // restarted
+    sampler.sampleOnce();
+    EXPECT_EQ(sampler.pidOf("a"), 200);
+    EXPECT_EQ(sampler.window("a", 1h).count, 1u);
+    // No CPU% across pids: the new process's counters start from scratch.
+    EXPECT_DOUBLE_EQ(sampler.latest("a")->cpuPercent, 0.0);
+}
+
+TEST(StatsSampler, VanishedModuleIsDropped) {
+    FakeProc proc;
+    proc.table[100] = {0.0, 1};
+    std::unordered_map<std::string, int64_t> pids{{"a", 100}};
+    StatsSampler sampler([&] { return pids; }, 1s, 8, proc.reader());
+    sampler.sampleOnce();
+    ASSERT_EQ(sampler.modules(), std::vector<std::string>{"a"});
+
+    pids.clear();
+    sampler.sampleOnce();
+    EXPECT_TRUE(sampler.modules().empty());
+    EXPECT_FALSE(sampler.latest("a").has_value());
+}
+
+TEST(StatsSampler, MemoryBudgetIsSharedAcrossModules) {
+    FakeProc proc;
+    proc.table[100] = {0.0, 1};
+    proc.table[200] = {0.0, 2};
+    std::unordered_map<std::string, int64_t> pids{{"a", 100}};
+    StatsSampler sampler([&] { return pids; }, 1s, 8, proc.reader(),
+                         StatsRing::slotBytes() * 10);
+    for (int i = 0; i < 6; ++i) sampler.sampleOnce();
+    EXPECT_EQ(sampler.capacityOf("a"), 8u);   // alone: full capacity fits
+    EXPECT_EQ(sampler.window("a", 1h).count, 6u);
+
+    pids["b"] = 200;
+    for (int i = 0; i < 20; ++i) sampler.sampleOnce();
+    EXPECT_EQ(sampler.capacityOf("a"), 5u);   // 10 slots split two ways
+    EXPECT_EQ(sampler.capacityOf("b"), 5u);
+    EXPECT_EQ(sampler.window("a", 1h).count, 5u);
+    EXPECT_EQ(sampler.window("b", 1h).count, 5u);
+
+    pids.erase("b");
+    sampler.sampleOnce();
+    EXPECT_EQ(sampler.capacityOf("a"), 8u);   // grown back, history kept
+    EXPECT_EQ(sampler.window("a", 1h).count, 6u);
+    EXPECT_EQ(sampler.latest("a")->rssBytes, 1u);
+}
+
+TEST(StatsSampler, WindowReportsMinMaxAvg) {
+    FakeProc proc;
+    StatsSampler sampler([] { return std::unordered_map<std::string, int64_t>{{"a", 100}}; },
+                         1s, 8, proc.reader());
+    for (uint64_t rss : {100u, 300u, 200u}) {
+        proc.table[100] = {0.0, rss};
+        sampler.sampleOnce();
+    }
+    auto w = sampler.window("a", 1h);
+    EXPECT_EQ(w.count, 3u);
+    EXPECT_EQ(w.rssBytesMin, 100u);
+    EXPECT_EQ(w.rssBytesMax, 300u);
+    EXPECT_DOUBLE_EQ(w.rssBytesAvg, 200.0);
+    EXPECT_LE(w.fromMs, w.toMs);
+}
+
+TEST(StatsSampler, MemoryDetailIsRefreshedPeriodicallyAndCarriedForward) {
+    FakeProc proc;
+    proc.table[100].detail.fields = ProcessDetail::All;
+    proc.table[100].detail.pssBytes = 1000;
+    StatsSampler sampler([] { return std::unordered_map<std::string, int64_t>{{"a", 100}}; },
+                         1s, 32, proc.reader());
+
+    sampler.sampleOnce();
+    EXPECT_TRUE(proc.lastDetail & ProcessDetail::MemoryDetail);
+    proc.table[100].detail.pssBytes = 2000;
+
+    sampler.sampleOnce();
+    EXPECT_FALSE(proc.lastDetail & ProcessDetail::MemoryDetail);
+    auto latest = sampler.latest("a");
+    ASSERT_TRUE(latest.has_value());
+    EXPECT_TRUE(latest->detail.has(ProcessDetail::MemoryDetail));
+    EXPECT_EQ(latest->detail.pssBytes, 1000u);   // carried forward
+
+    for (unsigned i = 2; i <= StatsSampler::kMemoryDetailEvery; ++i)
+        sampler.sampleOnce();
+    EXPECT_TRUE(proc.lastDetail & ProcessDetail::MemoryDetail);
+    EXPECT_EQ(sampler.latest("a")->detail.pssBytes, 2000u);
+}
+
+TEST(StatsSampler, UnknownModuleHasEmptyWindow) {
+    StatsSampler sampler([] { return std::unordered_map<std::string, int64_t>{}; });
+    EXPECT_EQ(sampler.window("nope", 1h).count, 0u);
+    EXPECT_FALSE(sampler.latest("nope").has_value());
+}
+
+TEST(StatsSampler, ThreadSamplesAtInterval) {
+    FakeProc proc;
+    proc.table[100] = {0.0, 1};
+    StatsSampler sampler([] { return std::unordered_map<std::string, int64_t>{{"a", 100}}; },
+                         5ms, 64, proc.reader());
+    sampler.start();
+    EXPECT_TRUE(sampler.running());
+    for (int i = 0; i < 200 && sampler.window("a", 1h).count < 3; ++i)
+        std::this_thread::sleep_for(5ms);
+    sampler.stop();
+    EXPECT_FALSE(sampler.running());
+    EXPECT_GE(sampler.window("a", 1h).count, 3u);
+}
+
+#ifdef __linux__
+TEST(ProcReader, ReadsOwnProcess) {
+    ProcessReading r;
+    ASSERT_TRUE(readProcess(static_cast<int64_t>(::getpid()), r));
+    EXPECT_GT(r.rssBytes, 0u);
+    EXPECT_GE(r.cpuSeconds, 0.0);
+}
+
+TEST(ProcReader, ReadsOwnProcessDetail) {
+    ProcReader reader;
+    ProcessReading r;
+    ASSERT_TRUE(reader.read(static_cast<int64_t>(::getpid()), r));
+    ASSERT_TRUE(r.detail.has(ProcessDetail::Threads));
+    EXPECT_GE(r.detail.threads, 1u);
+    ASSERT_TRUE(r.detail.has(ProcessDetail::ContextSwitches));
+    EXPECT_GT(r.detail.voluntaryCtxSwitches + r.detail.involuntaryCtxSwitches, 0u);
+    ASSERT_TRUE(r.detail.has(ProcessDetail::OpenFds));
+    EXPECT_GE(r.detail.openFds, 3u);   // stdin/stdout/stderr at least
+    // smaps_rollup (4.14+) and io (task accounting) depend on the kernel.
+    if (r.detail.has(ProcessDetail::MemoryDetail)) {
+        EXPECT_GT(r.detail.pssBytes, 0u);
+        EXPECT_LE(r.detail.ussBytes, r.detail.pssBytes);
+    }
+}
+
+TEST(ProcReader, OpenFdCountTracksDescriptors) {
+    ProcReader reader;
+    ProcessReading before, after;
+    ASSERT_TRUE(reader.read(static_cast<int64_t>(::getpid()), before));
+    int fds[2];
+    ASSERT_EQ(::pipe(fds), 0);
+    ASSERT_TRUE(reader.read(static_cast<int64_t>(::getpid()), after));
+    ::close(fds[0]);
+    ::close(fds[1]);
+    EXPECT_EQ(after.detail.openFds, before.detail.openFds + 2);
+}
+#endif
+
+TEST(StatsRing, CarriesProcessDetail) {
+    StatsRing ring(2);
+    StatsSample s = sampleAt(1, 1);
+    s.detail.fields = ProcessDetail::OpenFds | ProcessDetail::MemoryDetail;
+    s.detail.openFds = 17;
+    s.detail.pssBytes = 1 << 20;
+    ring.push(s);
+    auto latest = ring.latest();
+    ASSERT_TRUE(latest.has_value());
+    EXPECT_TRUE(latest->detail.has(ProcessDetail::OpenFds));
+    EXPECT_FALSE(latest->detail.has(ProcessDetail::Io));
+    EXPECT_EQ(latest->detail.openFds, 17u);
+    EXPECT_EQ(latest->detail.pssBytes, 1u << 20);
+}
+
+TEST(ProcReader, RejectsInvalidPid) {
+    ProcessReading r;
+    EXPECT_FALSE(readProcess(0, r));
+    EXPECT_FALSE(readProcess(-1, r));
+}
+
+// =============================================================================
+// C API
+// =============================================================================
+
+class StatsSamplerApiTest : public ::testing::Test {
+protected:
+    std::shared_ptr<FakeModuleLoader> fake;
+
+    void SetUp() override {
+        logos_core_stop_stats_sampler();
+        fake = std::make_shared<FakeModuleLoader>();
+        fake->pid = static_cast<int64_t>(::getpid());
+        useOnlyLoader(fake);
+    }
+
+    void TearDown() override {
+        logos_core_stop_stats_sampler();
+        restoreSubprocessLoader();
+    }
+
+    void registerModule(const std::string& name) {
+        std::string path = "/fake/" + name + "_plugin.so";
+        logos_core_register_module(name.c_str(), path.c_str());
+    }
+};
+
+TEST_F(StatsSamplerApiTest, HistoryIsNullWithoutSampler) {
+    registerModule("foo");
+    ASSERT_EQ(logos_core_load_module("foo", false), 1);
+    EXPECT_EQ(logos_core_get_module_stats_history("foo", 1000), nullptr);
+}
+
+TEST_F(StatsSamplerApiTest, StartTwiceFails) {
+    EXPECT_EQ(logos_core_start_stats_sampler(50, 10), 1);
+    EXPECT_EQ(logos_core_start_stats_sampler(50, 10), 0);
+    EXPECT_TRUE(ModuleManager::isStatsSamplerRunning());
+    logos_core_stop_stats_sampler();
+    EXPECT_FALSE(ModuleManager::isStatsSamplerRunning());
+}
+
+TEST_F(StatsSamplerApiTest, RejectsNonPositiveHistorySize) {
+    EXPECT_EQ(logos_core_start_stats_sampler(50, 0), 0);
+    EXPECT_EQ(logos_core_start_stats_sampler(50, -5), 0);
+    EXPECT_FALSE(ModuleManager::isStatsSamplerRunning());
+    EXPECT_FALSE(ModuleManager::startStatsSampler(std::chrono::milliseconds(50), 0));
+
+    // Oversized histories are capped rather than allocated as asked.
+    EXPECT_EQ(logos_core_start_stats_sampler(50, 2000000000), 1);
+    logos_core_stop_stats_sampler();
+}
+
+#ifdef __linux__
+TEST_F(StatsSamplerApiTest, HistoryReportsSampledModule) {
+    registerModule("foo");
+    ASSERT_EQ(logos_core_load_module("foo", false), 1);
+    ASSERT_EQ(logos_core_start_stats_sampler(5, 16), 1);
+
+    char* raw = nullptr;
+    for (int i = 0; i < 200 && !raw; ++i) {
+        raw = logos_core_get_module_stats_history("foo", 60000);
+        if (!raw) std::this_thread::sleep_for(5ms);
+    }
+    ASSERT_NE(raw, nullptr);
+    auto j = nlohmann::json::parse(raw);
+    delete[] raw;
+
+    EXPECT_EQ(j["name"], "foo");
+    EXPECT_EQ(j["pid"], static_cast<int64_t>(::getpid()));
+    EXPECT_GT(j["latest"]["memory_mb"].get<double>(), 0.0);
+    EXPECT_GE(j["window"]["count"].get<int>(), 1);
+    EXPECT_LE(j["window"]["memory_mb"]["min"].get<double>(),
+              j["window"]["memory_mb"]["max"].get<double>());
+
+    char* stats = logos_core_get_module_stats();
+    ASSERT_NE(stats, nullptr);
+    auto arr = nlohmann::json::parse(stats);
+    delete[] stats;
+    ASSERT_EQ(arr.size(), 1u);
+    EXPECT_EQ(arr[0]["name"], "foo");
+}
+#endif
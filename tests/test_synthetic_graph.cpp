@@ -0,0 +1,205 @@
+// =============================================================================
+// Tests for the synthetic module graph generator (tools/synthetic_graph.h):
+// determinism, shape constraints, cycle injection, registry loading and the
+// stub packages written for discovery.
+// =============================================================================
+#include <gtest/gtest.h>
+#include "synthetic_graph.h"
+#include "module_registry.h"
+#include "dependency_resolver.h"
+
+#include <nlohmann/json.hpp>
+#include <algorithm>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <map>
+#include <sstream>
+#include <string>
+#include <unistd.h>
+
+namespace fs = std::filesystem;
+
+namespace {
+
+std::map<std::string, int> dependentCounts(const SyntheticGraph::Graph& g) {
+    std::map<std::string, int> counts;
+    for (const auto& deps : g.dependencies)
+        for (const auto& d : deps)
+            ++counts[d];
+    return counts;
+}
+
+DependencyResolver::ResolveResult resolveAll(const SyntheticGraph::Graph& g) {
+    std::map<std::string, std::vector<std::string>> deps;
+    for (std::size_t i = 0; i < g.names.size(); ++i)
+        deps[g.names[i]] = g.dependencies[i];
+    return DependencyResolver::resolve(
+        g.names,
+        [&](const std::string& n) { return deps.count(n) > 0; },
+        [&](const std::string& n) { return deps.at(n); });
+}
+
+std::string readFile(const fs::path& path) {
+    std::ifstream in(path, std::ios::binary);
+    std::ostringstream ss;
+    ss << in.rdbuf();
+    return ss.str();
+}
+
+struct TmpDir {
+    fs::path path;
+    TmpDir() {
+        char tmpl[] = "/tmp/logos_synth_XXXXXX";
+        if (::mkdtemp(tmpl))
+            path = tmpl;
+    }
+    ~TmpDir() {
+        std::error_code ec;
+        if (!path.empty())
+            fs::remove_all(path, ec);
+    }
+};
+
+} // anonymous namespace
+
+TEST(SyntheticGraph, SameSeedSameGraph) {
+    SyntheticGraph::Options o;
+    o.modules = 200;
+    o.depth = 10;
+    o.seed = 7;
+    auto a = SyntheticGraph::generate(o);
+    auto b = SyntheticGraph::generate(o);
+    EXPECT_EQ(a.names, b.names);
+    EXPECT_EQ(a.dependencies, b.dependencies);
+    o.seed = 8;
+    EXPECT_NE(SyntheticGraph::generate(o).dependencies, a.dependencies);
+}
+
+TEST(SyntheticGraph, HonoursDepthFanInAndFanOut) {
+    SyntheticGraph::Options o;
+    o.modules = 300;
+    o.depth = 12;
+    o.minFanIn = 2;
+    o.maxFanIn = 4;
+    o.maxFanOut = 6;
+    auto g = SyntheticGraph::generate(o);
+
+    ASSERT_EQ(g.names.size(), 300u);
+    EXPECT_EQ(g.names.front(), "synth_000");
+    for (std::size_t i = 0; i < g.names.size(); ++i) {
+        if (g.layer[i] == 0) {
+            EXPECT_TRUE(g.dependencies[i].empty()) << g.names[i];
+            continue;
+        }
+        EXPECT_GE(g.dependencies[i].size(), 1u) << g.names[i];
+        EXPECT_LE(g.dependencies[i].size(), 4u) << g.names[i];
+    }
+    for (const auto& [name, count] : dependentCounts(g))
+        EXPECT_LE(count, 6) << name;
+
+    auto resolved = resolveAll(g);
+    EXPECT_TRUE(resolved.ok());
+    EXPECT_EQ(resolved.order.size(), 300u);
+
+    // Longest chain is exactly `depth` modules.
+    std::map<std::string, int> longest;
+    for (const auto& n : resolved.order) {
+        auto i = std::find(g.names.begin(), g.names.end(), n) - g.names.begin();
+        int best = 0;
+        for (const auto& d : g.dependencies[i])
+            best = std::max(best, longest[d]);
+        longest[n] = best + 1;
+    }
+    int depth = 0;
+    for (const auto& [n, l] : longest)
+        depth = std::max(depth, l);
+    EXPECT_EQ(depth, 12);
+}
+
+TEST(SyntheticGraph, InjectsRequestedCycles) {
+    SyntheticGraph::Options o;
+    o.modules = 100;
+    o.depth = 6;
+    o.cycles = 3;
+    auto g = SyntheticGraph::generate(o);
+    EXPECT_EQ(g.backEdges.size(), 3u);
+    EXPECT_TRUE(resolveAll(g).hasCycle);
+
+    o.cycles = 0;
+    EXPECT_FALSE(resolveAll(SyntheticGraph::generate(o)).hasCycle);
+}
+
+TEST(SyntheticGraph, OptionsFromJson) {
+    auto o = SyntheticGraph::optionsFromJson(
+        {{"seed", 3}, {"modules", 50}, {"depth", 5}, {"max_fan_out", 2}, {"prefix", "g_"}});
+    EXPECT_EQ(o.seed, 3u);
+    EXPECT_EQ(o.modules, 50);
+    EXPECT_EQ(o.depth, 5);
+    EXPECT_EQ(o.maxFanOut, 2);
+    EXPECT_EQ(o.maxFanIn, SyntheticGraph::Options{}.maxFanIn);
+    EXPECT_EQ(o.prefix, "g_");
+}
+
+TEST(SyntheticGraph, RegistersIntoRegistry) {
+    SyntheticGraph::Options o;
+    o.modules = 500;
+    o.depth = 20;
+    auto g = SyntheticGraph::generate(o);
+    ModuleRegistry registry;
+    SyntheticGraph::registerInto(registry, g);
+
+    EXPECT_EQ(registry.knownModuleNames().size(), 500u);
+    EXPECT_EQ(registry.modulePath(g.names[42]), "/synthetic/" + g.names[42] + "_plugin.so");
+    EXPECT_EQ(registry.moduleDependencies(g.names.back()), g.dependencies.back());
+    const auto counts = dependentCounts(g);
+    EXPECT_EQ(registry.moduleDependents(g.names.front()).size(),
+              static_cast<std::size_t>(counts.count(g.names.front()) ? counts.at(g.names.front()) : 0));
+}
+
+TEST(SyntheticGraph, CborRoundTrips) {
+    nlohmann::json v = {
+        {"name", "m"}, {"n", 70000}, {"neg", -300}, {"f", 1.5}, {"ok", true},
+        {"none", nullptr}, {"list", {1, "two", 3.25}}, {"nested", {{"k", "v"}}},
+    };
+    const std::string bytes = SyntheticGraph::encodeCbor(v);
+    EXPECT_EQ(nlohmann::json::from_cbor(bytes), v);
+}
+
+#if defined(__x86_64__) || defined(__aarch64__)
+
+TEST(SyntheticGraph, WritesDiscoverablePackages) {
+    SyntheticGraph::Options o;
+    o.modules = 12;
+    o.depth = 3;
+    auto g = SyntheticGraph::generate(o);
+    TmpDir dir;
+    ASSERT_FALSE(dir.path.empty());
+    std::string error;
+    ASSERT_TRUE(SyntheticGraph::writePackages(g, dir.path.string(), &error)) << error;
+
+    for (std::size_t i = 0; i < g.names.size(); ++i) {
+        const fs::path pkg = dir.path / g.names[i];
+        auto manifest = nlohmann::json::parse(readFile(pkg / "manifest.json"));
+        EXPECT_EQ(manifest["name"], g.names[i]);
+        EXPECT_EQ(manifest["main"], g.names[i] + "_plugin.so");
+        EXPECT_EQ(manifest.value("dependencies", std::vector<std::string>{}), g.dependencies[i]);
+
+        const std::string image = readFile(pkg / (g.names[i] + "_plugin.so"));
+        ASSERT_GT(image.size(), 64u);
+        EXPECT_EQ(image.compare(0, 4, "\x7f" "ELF"), 0);
+        uint16_t type = 0;
+        std::memcpy(&type, image.data() + 16, sizeof(type));
+        EXPECT_EQ(type, 3);   // ET_DYN
+
+        // .qtmetadata carries the magic and the module's metadata as CBOR.
+        const auto magic = image.find("QTMETADATA !");
+        ASSERT_NE(magic, std::string::npos);
+        EXPECT_EQ(image[magic + 13], '\x06');   // Qt major version
+        const std::string cbor = SyntheticGraph::encodeCbor(SyntheticGraph::moduleMetadata(g, i));
+        EXPECT_NE(image.find(cbor, magic), std::string::npos);
+        EXPECT_NE(image.find(".qtmetadata"), std::string::npos);
+    }
+}
+
+#endif
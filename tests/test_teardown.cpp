@@ -0,0 +1,326 @@
+// =============================================================================
+// Tests for bulk teardown (teardown.h): leaves-first wave planning, the shared
+// deadline with SIGKILL escalation against real child processes, and the
+// order ModuleManager::terminateAll() and cascade unload stop modules in.
+// =============================================================================
+#include <gtest/gtest.h>
+#include "logos_core.h"
+#include "qt_test_adapter.h"
+#include "module_manager.h"
+#include "module_loader_registry.h"
+#include "module_loader.h"
+#include "teardown.h"
+#include "subprocess_manager.h"
+#include <algorithm>
+#include <chrono>
+#include <map>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <thread>
+#include <unordered_set>
+#include <vector>
+
+#ifndef _WIN32
+#include <csignal>
+#include <spawn.h>
+#include <sys/wait.h>
+#include <unistd.h>
+extern char** environ;
+#endif
+
+using namespace LogosCore;
+
+namespace {
+
+using Graph = std::map<std::string, std::vector<std::string>>;
+
+std::vector<std::vector<std::string>> waves(const std::vector<std::string>& modules, const Graph& deps) {
+    return teardownWaves(modules, [&](const std::string& n) {
+        auto it = deps.find(n);
+        return it == deps.end() ? std::vector<std::string>{} : it->second;
+    });
+}
+
+struct TeardownRecordingLoader : public ModuleLoader {
+    std::string id() const override { return "teardown-recording"; }
+    bool canHandle(const ModuleDescriptor&) const override { return true; }
+    bool load(const ModuleDescriptor& desc,
+              std::function<void(const std::string&)>,
+              LoadedModuleHandle& out) override {
+        out.name = desc.name;
+        active.insert(desc.name);
+        return true;
+    }
+    bool sendToken(const std::string&, const std::string&) override { return true; }
+    void terminate(const std::string& name) override {
+        terminated.push_back(name);
+        active.erase(name);
+    }
+    void terminateAll() override { active.clear(); }
+    bool hasModule(const std::string& name) const override { return active.count(name) > 0; }
+
+    std::unordered_set<std::string> active;
+    std::vector<std::string> terminated;
+};
+
+#ifndef _WIN32
+pid_t spawnShell(const char* script) {
+    const char* argv[] = {"/bin/sh", "-c", script, nullptr};
+    pid_t pid = 0;
+    if (::posix_spawn(&pid, "/bin/sh", nullptr, nullptr, const_cast<char**>(argv), environ) != 0)
+        return -1;
+    return pid;
+}
+
+int reap(pid_t pid) {
+    int status = 0;
+    ::waitpid(pid, &status, 0);
+    return status;
+}
+
+// Backs each module with a real `sleep` process and records, at terminate(),
+// whether the process had already been stopped by its wave. Like a real
+// container, a watcher per child reports an exit it was not asked for through
+// the load's termination callback — so a module stopped by its wave may
+// already be marked unloaded by the time the cascade cleans it up.
+struct ProcessBackedLoader : public ModuleLoader {
+    ~ProcessBackedLoader() override { terminateAll(); }
+
+    std::string id() const override { return "teardown-process"; }
+    bool canHandle(const ModuleDescriptor&) const override { return true; }
+    bool load(const ModuleDescriptor& desc,
+              std::function<void(const std::string&)> onTerminated,
+              LoadedModuleHandle& out) override {
+        const pid_t pid = spawnShell("exec sleep 30");
+        if (pid <= 0)
+            return false;
+        out.name = desc.name;
+        std::lock_guard lock(mutex);
+        pids[desc.name] = pid;
+        watchers[desc.name] = std::thread([this, name = desc.name, pid,
+                                           onTerminated = std::move(onTerminated)] {
+            siginfo_t info{};
+            // Observe without reaping; terminate() reaps.
+            if (::waitid(P_PID, static_cast<id_t>(pid), &info, WEXITED | WNOWAIT) != 0)
+                return;
+            {
+                std::lock_guard lock(mutex);
+                auto it = pids.find(name);
+                if (it == pids.end() || it->second != pid)
+                    return;   // terminated on request
+                exitsReported.push_back(name);
+            }
+            if (onTerminated)
+                onTerminated(name);
+        });
+        return true;
+    }
+    bool sendToken(const std::string&, const std::string&) override { return true; }
+    void terminate(const std::string& name) override {
+        pid_t pid = 0;
+        std::thread watcher;
+        {
+            std::lock_guard lock(mutex);
+            auto it = pids.find(name);
+            if (it == pids.end())
+                return;
+            pid = it->second;
+            pids.erase(it);
+            watcher = std::move(watchers[name]);
+            watchers.erase(name);
+        }
+        int status = 0;
+        const bool exited = ::waitpid(pid, &status, WNOHANG) == pid;
+        if (!exited) {
+            ::kill(pid, SIGKILL);
+            ::waitpid(pid, &status, 0);
+        }
+        if (watcher.joinable())
+            watcher.join();
+        std::lock_guard lock(mutex);
+        terminated.push_back(name);
+        stoppedByWave[name] = exited;
+    }
+    void terminateAll() override {
+        std::map<std::string, pid_t> live;
+        std::map<std::string, std::thread> threads;
+        {
+            std::lock_guard lock(mutex);
+            live.swap(pids);
+            threads.swap(watchers);
+        }
+        for (auto& [name, pid] : live) {
+            ::kill(pid, SIGKILL);
+            ::waitpid(pid, nullptr, 0);
+        }
+        for (auto& [name, thread] : threads) {
+            if (thread.joinable())
+                thread.join();
+        }
+    }
+    bool hasModule(const std::string& name) const override {
+        std::lock_guard lock(mutex);
+        return pids.count(name) > 0;
+    }
+    std::optional<int64_t> pid(const std::string& name) const override {
+        std::lock_guard lock(mutex);
+        auto it = pids.find(name);
+        if (it == pids.end())
+            return std::nullopt;
+        return it->second;
+    }
+
+    mutable std::mutex mutex;
+    std::map<std::string, pid_t> pids;
+    std::map<std::string, std::thread> watchers;
+    std::vector<std::string> terminated;
+    std::vector<std::string> exitsReported;
+    std::map<std::string, bool> stoppedByWave;
+};
+#endif
+
+} // anonymous namespace
+
+TEST(TeardownWaves, ChainComesDownLeavesFirst) {
+    // c -> b -> a
+    auto w = waves({"a", "b", "c"}, {{"b", {"a"}}, {"c", {"b"}}});
+    EXPECT_EQ(w, (std::vector<std::vector<std::string>>{{"c"}, {"b"}, {"a"}}));
+}
+
+TEST(TeardownWaves, IndependentSiblingsShareAWave) {
+    // b, c, d all depend on a; d also on c.
+    auto w = waves({"a", "b", "c", "d"}, {{"b", {"a"}}, {"c", {"a"}}, {"d", {"a", "c"}}});
+    EXPECT_EQ(w, (std::vector<std::vector<std::string>>{{"b", "d"}, {"c"}, {"a"}}));
+}
+
+TEST(TeardownWaves, IgnoresEdgesLeavingTheSetAndDuplicates) {
+    auto w = waves({"x", "y", "x"}, {{"x", {"outside", "y", "y"}}, {"y", {"outside"}}});
+    EXPECT_EQ(w, (std::vector<std::vector<std::string>>{{"x"}, {"y"}}));
+}
+
+TEST(TeardownWaves, CyclesFormTheLastWave) {
+    // leaf -> p <-> q
+    auto w = waves({"p", "q", "leaf"}, {{"p", {"q"}}, {"q", {"p"}}, {"leaf", {"p"}}});
+    EXPECT_EQ(w, (std::vector<std::vector<std::string>>{{"leaf"}, {"p", "q"}}));
+    EXPECT_TRUE(waves({}, {}).empty());
+}
+
+#ifndef _WIN32
+
+TEST(StopProcesses, SignalsAllAtOnceAndKillsStragglersAtTheDeadline) {
+    std::vector<pid_t> polite;
+    for (int i = 0; i < 4; ++i)
+        polite.push_back(spawnShell("exec sleep 30"));
+    const pid_t stubborn = spawnShell("trap '' TERM; exec sleep 30");
+    ASSERT_GT(stubborn, 0);
+    // Let the stubborn shell install its trap before it is signalled.
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+
+    std::vector<int64_t> pids(polite.begin(), polite.end());
+    pids.push_back(stubborn);
+    pids.push_back(-1);   // non-process module: skipped
+
+    const auto begin = std::chrono::steady_clock::now();
+    auto killed = stopProcesses(pids, begin + std::chrono::milliseconds(300));
+    const auto elapsed = std::chrono::steady_clock::now() - begin;
+
+    EXPECT_EQ(killed, (std::vector<int64_t>{stubborn}));
+    EXPECT_GE(elapsed, std::chrono::milliseconds(300));
+    EXPECT_LT(elapsed, std::chrono::seconds(3));   // one shared deadline, not one per process
+    for (pid_t pid : polite) {
+        int status = reap(pid);
+        EXPECT_TRUE(WIFSIGNALED(status) && WTERMSIG(status) == SIGTERM);
+    }
+    int status = reap(stubborn);
+    EXPECT_TRUE(WIFSIGNALED(status) && WTERMSIG(status) == SIGKILL);
+}
+
+TEST(StopProcesses, ReturnsAsSoonAsEveryoneHasExited) {
+    const pid_t pid = spawnShell("exec sleep 30");
+    const auto begin = std::chrono::steady_clock::now();
+    EXPECT_TRUE(stopProcesses({pid}, begin + std::chrono::seconds(10)).empty());
+    EXPECT_LT(std::chrono::steady_clock::now() - begin, std::chrono::seconds(5));
+    reap(pid);
+}
+
+TEST(CascadeUnload, StopsSiblingsTogetherAndDependentsFirst) {
+    logos_core_terminate_all();
+    logos_core_clear();
+    auto loader = std::make_shared<ProcessBackedLoader>();
+    ModuleManager::loaders().clearForTests();
+    ModuleManager::loaders().registerLoader(loader);
+
+    // left, right -> root; top -> left; bystander is unrelated.
+    for (const char* n : {"root", "left", "right", "top", "bystander"}) {
+        std::string path = std::string("/fake/") + n + "_plugin.so";
+        logos_core_register_module(n, path.c_str());
+    }
+    const char* rootDeps[] = {"root"};
+    const char* leftDeps[] = {"left"};
+    logos_core_register_module_dependencies("left", rootDeps, 1);
+    logos_core_register_module_dependencies("right", rootDeps, 1);
+    logos_core_register_module_dependencies("top", leftDeps, 1);
+    ASSERT_EQ(logos_core_load_module("top", true), 1);
+    ASSERT_EQ(logos_core_load_module("right", true), 1);
+    ASSERT_EQ(logos_core_load_module("bystander", false), 1);
+
+    EXPECT_EQ(logos_core_unload_module("root", true), 1);
+
+    const auto& order = loader->terminated;
+    auto pos = [&](const char* n) { return std::find(order.begin(), order.end(), n) - order.begin(); };
+    ASSERT_EQ(order.size(), 4u);
+    EXPECT_LT(pos("top"), pos("left"));
+    EXPECT_LT(pos("left"), pos("root"));
+    EXPECT_LT(pos("right"), pos("root"));
+    for (const char* n : {"root", "left", "right", "top"}) {
+        EXPECT_TRUE(loader->stoppedByWave[n]) << n;
+        // Cleaned up even when its exit was reported before the cascade got
+        // to it.
+        EXPECT_FALSE(loader->hasModule(n)) << n;
+        EXPECT_EQ(logos_core_is_module_loaded(n), 0) << n;
+    }
+    EXPECT_EQ(logos_core_is_module_loaded("bystander"), 1);
+    EXPECT_TRUE(loader->hasModule("bystander"));
+
+    logos_core_terminate_all();
+    logos_core_clear();
+    ModuleManager::loaders().clearForTests();
+    ModuleManager::loaders().registerLoader(std::make_shared<SubprocessManager>());
+}
+
+#endif // _WIN32
+
+TEST(TerminateAll, StopsDependentsBeforeDependencies) {
+    logos_core_terminate_all();
+    logos_core_clear();
+    auto loader = std::make_shared<TeardownRecordingLoader>();
+    ModuleManager::loaders().clearForTests();
+    ModuleManager::loaders().registerLoader(loader);
+
+    logos_core_register_module("base", "/fake/base_plugin.so");
+    logos_core_register_module("mid", "/fake/mid_plugin.so");
+    logos_core_register_module("top", "/fake/top_plugin.so");
+    logos_core_register_module("side", "/fake/side_plugin.so");
+    const char* midDeps[] = {"base"};
+    const char* topDeps[] = {"mid"};
+    const char* sideDeps[] = {"base"};
+    logos_core_register_module_dependencies("mid", midDeps, 1);
+    logos_core_register_module_dependencies("top", topDeps, 1);
+    logos_core_register_module_dependencies("side", sideDeps, 1);
+    ASSERT_EQ(logos_core_load_module("top", true), 1);
+    ASSERT_EQ(logos_core_load_module("side", true), 1);
+
+    logos_core_terminate_all();
+    const auto& order = loader->terminated;
+    auto pos = [&](const char* n) { return std::find(order.begin(), order.end(), n) - order.begin(); };
+    ASSERT_EQ(order.size(), 4u);
+    EXPECT_LT(pos("top"), pos("mid"));
+    EXPECT_LT(pos("mid"), pos("base"));
+    EXPECT_LT(pos("side"), pos("base"));
+    EXPECT_TRUE(loader->active.empty());
+
+    logos_core_clear();
+    ModuleManager::loaders().clearForTests();
+    ModuleManager::loaders().registerLoader(std::make_shared<SubprocessManager>());
+}
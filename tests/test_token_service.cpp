@@ -0,0 +1,100 @@
+// =============================================================================
+// Tests for TokenService (token_service.h): pooled token minting and the
+// cached capability_module token, plus the load path drawing from it.
+// =============================================================================
+#include <gtest/gtest.h>
+#include "logos_core.h"
+#include "fake_module_loader.h"
+#include "token_service.h"
+#include <regex>
+#include <set>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+using namespace LogosCore;
+
+namespace {
+
+bool looksLikeUuidV4(const std::string& token) {
+    static const std::regex uuid("[0-9a-f]{8}-[0-9a-f]{4}-4[0-9a-f]{3}-[89ab][0-9a-f]{3}-[0-9a-f]{12}");
+    return std::regex_match(token, uuid);
+}
+
+} // anonymous namespace
+
+TEST(TokenService, IssuesDistinctUuidTokens) {
+    TokenService service(4);
+    std::set<std::string> seen;
+    for (int i = 0; i < 50; ++i) {
+        const std::string token = service.issue();
+        EXPECT_TRUE(looksLikeUuidV4(token)) << token;
+        EXPECT_TRUE(seen.insert(token).second) << "duplicate " << token;
+    }
+}
+
+TEST(TokenService, RefillsInBatchesAndPrefills) {
+    TokenService service(8);
+    EXPECT_EQ(service.pooled(), 0u);
+    service.issue();
+    EXPECT_EQ(service.pooled(), 7u);
+
+    service.prefill(20);
+    EXPECT_EQ(service.pooled(), 20u);
+    service.prefill(5);   // already enough
+    EXPECT_EQ(service.pooled(), 20u);
+
+    service.discardPool();
+    EXPECT_EQ(service.pooled(), 0u);
+}
+
+TEST(TokenService, ConcurrentIssueNeverRepeats) {
+    TokenService service(16);
+    constexpr int kThreads = 8;
+    constexpr int kPerThread = 500;
+    std::vector<std::vector<std::string>> issued(kThreads);
+    std::vector<std::thread> threads;
+    for (int t = 0; t < kThreads; ++t) {
+        threads.emplace_back([&, t] {
+            for (int i = 0; i < kPerThread; ++i)
+                issued[t].push_back(service.issue());
+        });
+    }
+    for (auto& th : threads)
+        th.join();
+
+    std::set<std::string> all;
+    for (const auto& v : issued)
+        all.insert(v.begin(), v.end());
+    EXPECT_EQ(all.size(), static_cast<std::size_t>(kThreads * kPerThread));
+}
+
+TEST(TokenService, CachesCapabilityToken) {
+    TokenService service;
+    EXPECT_EQ(service.capabilityToken(), "");
+    service.setCapabilityToken("cap-token");
+    EXPECT_EQ(service.capabilityToken(), "cap-token");
+    service.clearCapabilityToken();
+    EXPECT_EQ(service.capabilityToken(), "");
+}
+
+TEST(TokenService, LoadHandsOutAPooledTokenAndSavesIt) {
+    auto loader = std::make_shared<FakeModuleLoader>();
+    useOnlyLoader(loader);
+    logos_core_register_module("tokened", "/fake/tokened_plugin.so");
+
+    ModuleManager::tokens().prefill(3);
+    const std::size_t before = ModuleManager::tokens().pooled();
+    ASSERT_EQ(logos_core_load_module("tokened", false), 1);
+    EXPECT_EQ(ModuleManager::tokens().pooled(), before - 1);
+
+    const std::string sent = loader->received["tokened"];
+    EXPECT_TRUE(looksLikeUuidV4(sent)) << sent;
+    char* saved = logos_core_get_token("tokened");
+    ASSERT_NE(saved, nullptr);
+    EXPECT_EQ(std::string(saved), sent);
+    delete[] saved;
+
+    restoreSubprocessLoader();
+}